@@ -17,92 +17,68 @@
 #ifndef CALLBACKABLE_H_
 #define CALLBACKABLE_H_
 
-#include <pthread.h>
-
 using namespace std;
 
 /**
- * ObjectSQL class. Provides a SQL backend interface, it should be implemented
- * by persistent objects.
+ * Callbackable class. Base class for the objects that process the rows
+ * returned by SQL commands with callback functions (see SqlCallback).
  */
 class Callbackable
 {
 public:
 
-    Callbackable():cb(0),arg(0)
-    {
-        pthread_mutex_init(&mutex,0);
-    };
-
-    virtual ~Callbackable()
-    {
-        pthread_mutex_destroy(&mutex);
-    };
+    virtual ~Callbackable(){};
 
     /**
      *  Datatype for call back pointers
      */
     typedef int (Callbackable::*Callback)(void *, int, char ** ,char **);
+};
 
-    /**
-     *  Set the callback function and custom arguments to be executed by the
-     *  next SQL command, and locks the mutex until unset_callback is called.
-     *    @param ptr to the callback function
-     *    @param arg custom arguments for the callback function
-     */
-    void set_callback(Callback _cb, void * _arg = 0)
-    {
-        pthread_mutex_lock(&mutex);
-
-        cb  = _cb;
-        arg = _arg;
-    };
+/**
+ * SqlCallback class. Binds a callback function of a Callbackable object and
+ * its custom arguments to a single SQL command. As the state of the call is
+ * not stored in the object, several commands can use its callbacks at the
+ * same time.
+ */
+class SqlCallback
+{
+public:
 
     /**
-     *  Test if the CallBack is set for the object.
-     *    @return true if the callback is set
+     *  @param _obj the object that implements the callback
+     *  @param _cb the callback function, called for each row of the result
+     *  @param _arg custom arguments for the callback function
      */
-    bool isCallBackSet()
-    {
-        return (cb != 0);
-    };
+    SqlCallback(Callbackable * _obj, Callbackable::Callback _cb,
+                void * _arg = 0):obj(_obj), cb(_cb), arg(_arg){};
+
+    ~SqlCallback(){};
 
     /**
-     *  Call the callback funcion set. This method must be called only if
-     *  isCallBackSet returns true.
+     *  Call the callback function for a row
      *      @return the callback function return value.
      */
     int do_callback(int num, char **values, char **names)
     {
-        return (this->*cb)(arg, num, values, names);
+        return (obj->*cb)(arg, num, values, names);
     };
 
+private:
     /**
-     *  Unset the callback function.
+     *  Object that implements the callback
      */
-    void unset_callback()
-    {
-        cb  = 0;
-        arg = 0;
-
-        pthread_mutex_unlock(&mutex);
-    }
+    Callbackable *          obj;
 
-private:
     /**
      *  SQL callback to be executed for each row result of an SQL statement
      */
-    Callback cb;
+    Callbackable::Callback  cb;
 
     /**
      *  Custom arguments for the callback
      */
-    void *   arg;
-
-    /**
-     *  Mutex for locking the callback function.
-     */
-    pthread_mutex_t             mutex;
+    void *                  arg;
 };
 
 #endif /*CALLBACKABLE_H_*/
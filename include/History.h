@@ -79,6 +79,10 @@ private:
 
     static const char * db_bootstrap;
 
+    static const char * stime_db_index;
+
+    static const char * etime_db_index;
+
     void non_persistent_data();
 
     // ----------------------------------------
@@ -204,9 +208,15 @@ private:
      */
     int from_xml_node(const xmlNodePtr node)
     {
+        int rc;
+
         ObjectXML::update_from_node(node);
 
-        return rebuild_attributes();
+        rc = rebuild_attributes();
+
+        ObjectXML::free_xml();
+
+        return rc;
     }
 
     /**
@@ -217,9 +227,15 @@ private:
      */
     int from_xml(const string &xml_str)
     {
+        int rc;
+
         ObjectXML::update_from_str(xml_str);
 
-        return rebuild_attributes();
+        rc = rebuild_attributes();
+
+        ObjectXML::free_xml();
+
+        return rc;
     }
 
     /**
@@ -126,12 +126,11 @@ public:
     int update_info(string &parse_str);
 
     /**
-     * Inserts the last monitoring, and deletes old monitoring entries.
-     *
-     * @param db pointer to the db
-     * @return 0 on success
+     *  Gets the current values of the monitoring metrics, in the same order
+     *  as Host::monit_metrics
+     *    @param values of the metrics
      */
-    int update_monitoring(SqlDB * db);
+    void get_monitoring(vector<long long>& values) const;
 
     /**
      * Retrives host state
@@ -417,14 +416,24 @@ private:
 
     static const char * db_bootstrap;
 
-    static const char * table;
+    static const char * db_index;
 
-    static const char * monit_db_names;
+    static const char * table;
 
     static const char * monit_db_bootstrap;
 
+    static const char * monit_db_index;
+
     static const char * monit_table;
 
+    static const char * monit_metrics[];
+
+    static const char * monit_rollup_table;
+
+    static const char * monit_rollup_db_bootstrap;
+
+    static const char * monit_rollup_db_index;
+
     /**
      *  Execute an INSERT or REPLACE Sql query.
      *    @param db The SQL DB
@@ -443,10 +452,18 @@ private:
         int rc;
 
         ostringstream oss_host(Host::db_bootstrap);
+        ostringstream oss_index(Host::db_index);
         ostringstream oss_monit(Host::monit_db_bootstrap);
+        ostringstream oss_monit_idx(Host::monit_db_index);
+        ostringstream oss_rollup(Host::monit_rollup_db_bootstrap);
+        ostringstream oss_rollup_idx(Host::monit_rollup_db_index);
 
         rc =  db->exec(oss_host);
+        rc += db->exec(oss_index);
         rc += db->exec(oss_monit);
+        rc += db->exec(oss_monit_idx);
+        rc += db->exec(oss_rollup);
+        rc += db->exec(oss_rollup_idx);
 
         return rc;
     };
@@ -19,6 +19,7 @@
 
 #include "PoolSQL.h"
 #include "Host.h"
+#include "MonitoringStore.h"
 
 #include <time.h>
 #include <sstream>
@@ -39,7 +40,8 @@ public:
              vector<const Attribute *> hook_mads,
              const string&             hook_location,
              const string&             remotes_location,
-             time_t                    expire_time);
+             time_t                    expire_time,
+             const vector<const Attribute *>& rollups);
 
     ~HostPool(){};
 
@@ -110,7 +112,7 @@ public:
     /**
      * Get the least monitored hosts
      *   @param discovered hosts, map to store the retrieved hosts hids and
-     *   hostnames
+     *   IM drivers
      *   @param host_limit max. number of hosts to monitor at a time
      *   @return int 0 if success
      */
@@ -205,11 +207,13 @@ public:
      *
      *  @param oss the output stream to dump the pool contents
      *  @param where filter for the objects, defaults to all
+     *  @param resolution of the monitoring rollups, 0 for the samples
      *
      *  @return 0 on success
      */
     int dump_monitoring(ostringstream& oss,
-                        const string&  where);
+                        const string&  where,
+                        int            resolution = 0);
 
     /**
      *  Dumps the HOST monitoring information for a single HOST
@@ -230,29 +234,39 @@ public:
     }
 
     /**
-     * Inserts the last monitoring, and deletes old monitoring entries for this
-     * host
+     * Adds the last monitoring values of the host to its monitoring series
      *
      * @param host pointer to the host object
      * @return 0 on success
      */
     int update_monitoring(Host * host)
     {
-        if ( _monitor_expiration <= 0 )
-        {
-            return 0;
-        }
+        vector<long long> values;
+
+        host->get_monitoring(values);
 
-        return host->update_monitoring(db);
+        return monitoring.add(db, host->get_oid(), host->get_last_monitored(),
+                              values);
     };
 
     /**
-     * Deletes the expired monitoring entries for all hosts
+     * Deletes the expired monitoring entries and rollups for all hosts
      *
      * @return 0 on success
      */
     int clean_expired_monitoring();
 
+    /**
+     * Checks if the monitoring information is available with a resolution
+     *
+     * @param resolution of the rollups, 0 for the samples
+     * @return true if there are rollups of the given resolution
+     */
+    bool has_monitoring_resolution(int resolution)
+    {
+        return monitoring.has_resolution(resolution);
+    };
+
 private:
 
     /**
@@ -285,6 +299,11 @@ private:
      * Size, in seconds, of the historical monitoring information
      */
     static time_t _monitor_expiration;
+
+    /**
+     * Monitoring samples of the hosts
+     */
+    MonitoringStore monitoring;
 };
 
 #endif /*HOST_POOL_H_*/
@@ -20,6 +20,8 @@
 #include "MadManager.h"
 #include "ActionManager.h"
 #include "InformationManagerDriver.h"
+#include "MonitorScheduler.h"
+#include "MonitorReceiver.h"
 #include "HostPool.h"
 
 using namespace std;
@@ -35,6 +37,10 @@ public:
         time_t                      _timer_period,
         time_t                      _monitor_period,
         int                         _host_limit,
+        int                         _max_inflight,
+        const string&               _receiver_address,
+        int                         _receiver_port,
+        const string&               _receiver_key,
         const string&               _remotes_location,
         vector<const Attribute*>&   _mads)
             :MadManager(_mads),
@@ -42,12 +48,28 @@ public:
             timer_period(_timer_period),
             monitor_period(_monitor_period),
             host_limit(_host_limit),
-            remotes_location(_remotes_location)
+            remotes_location(_remotes_location),
+            scheduler(_monitor_period, _max_inflight),
+            receiver(0)
     {
+        if ( _receiver_port > 0 )
+        {
+            receiver = new MonitorReceiver(_hpool,
+                                           _receiver_address,
+                                           _receiver_port,
+                                           _receiver_key);
+        }
+
         am.addListener(this);
     };
 
-    ~InformationManager(){};
+    ~InformationManager()
+    {
+        if ( receiver != 0 )
+        {
+            delete receiver;
+        }
+    };
 
     /**
      *  This functions starts the associated listener thread, and creates a
@@ -110,6 +132,17 @@ private:
     */
     string          remotes_location;
 
+    /**
+     *  Spreads the host probes over the monitoring interval and limits the
+     *  probes in progress for each driver
+     */
+    MonitorScheduler scheduler;
+
+    /**
+     *  Receiver of the monitoring reports pushed by the hosts, 0 if disabled
+     */
+    MonitorReceiver * receiver;
+
     /**
      *  Action engine for the Manager
      */
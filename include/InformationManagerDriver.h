@@ -23,6 +23,7 @@
 
 #include "Mad.h"
 #include "HostPool.h"
+#include "MonitorScheduler.h"
 
 
 using namespace std;
@@ -41,8 +42,9 @@ public:
         int                     userid,
         const map<string,string>&     attrs,
         bool                    sudo,
-        HostPool *              pool):
-            Mad(userid,attrs,sudo),hpool(pool){};
+        HostPool *              pool,
+        MonitorScheduler *      _scheduler):
+            Mad(userid,attrs,sudo),hpool(pool),scheduler(_scheduler){};
 
     virtual ~InformationManagerDriver(){};
 
@@ -65,12 +67,31 @@ public:
      */
     void monitor(int oid, const string& host, bool update) const;
 
+    /**
+     *  Updates a host with the result of a monitoring probe, reported by an
+     *  IM driver or pushed by the host (MonitorReceiver)
+     *    @param hpool the host pool
+     *    @param id of the host
+     *    @param success true if the host was successfully monitored
+     *    @param hinfo the host information (KEY=VALUE pairs) or the error
+     *    message
+     */
+    static void process_monitor(HostPool *    hpool,
+                                int           id,
+                                bool          success,
+                                const string& hinfo);
+
 private:
     /**
      *  Pointer to the Virtual Machine Pool, to access VMs
      */
     HostPool * hpool;
 
+    /**
+     *  Scheduler of the host probes, notified when a probe ends
+     */
+    MonitorScheduler * scheduler;
+
     friend class InformationManager;
 };
 
@@ -23,6 +23,7 @@
 #include <map>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include <unistd.h>
 
@@ -30,6 +31,97 @@
 
 using namespace std;
 
+class Mad;
+
+/**
+ *  A driver process. A Mad runs one or more copies of the driver (INSTANCES
+ *  attribute) and balances the messages among them.
+ */
+class MadInstance
+{
+private:
+    friend class Mad;
+    friend class MadManager;
+
+    MadInstance(Mad * _mad):
+        mad(_mad),
+        mad_nebula_pipe(-1),
+        nebula_mad_pipe(-1),
+        pid(-1),
+        write_offset(0),
+        requests(0),
+        framed(false),
+        restarting(false),
+        pending_size(0){};
+
+    ~MadInstance(){};
+
+    /**
+     *  The driver of this process
+     */
+    Mad *               mad;
+
+    /**
+     *  Communication pipe file descriptor. Represents the MAD to nebula 
+     *  communication stream (nebula<-mad)
+     */
+    int                 mad_nebula_pipe;
+
+    /**
+     *  Communication pipe file descriptor. Represents the nebula to MAD 
+     *  communication stream (nebula->mad)
+     */
+    int                 nebula_mad_pipe;
+
+    /**
+     *  Process ID of the running MAD.
+     */
+    pid_t               pid;
+
+    /**
+     *  Data read from the driver that does not form a complete message
+     *  (line) yet
+     */
+    string              read_buffer;
+
+    /**
+     *  Messages to the driver not written to the pipe yet, starting at
+     *  write_offset. Protected by Mad::write_mutex.
+     */
+    string              write_buffer;
+
+    string::size_type   write_offset;
+
+    /**
+     *  Requests sent to the process without a final answer (SUCCESS or
+     *  FAILURE) yet. Protected by Mad::write_mutex.
+     */
+    int                 requests;
+
+    /**
+     *  The process accepted the framed protocol in the INIT command: after
+     *  it, the messages in both directions are "<length>\n<message>", where
+     *  length is the size in bytes of the message. Messages can include new
+     *  lines and do not need to be encoded.
+     */
+    bool                framed;
+
+    /**
+     *  The process is being restarted (Mad::reload) without holding the
+     *  write_mutex. Messages are routed to other processes, or kept in
+     *  pending until it is started if all of them are restarting. Protected
+     *  by Mad::write_mutex.
+     */
+    bool                restarting;
+
+    vector<string>      pending;
+
+    string::size_type   pending_size;
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 /**
  * Base class to build specific middleware access drivers (MAD).
  * This class provides generic MAD functionality. 
@@ -47,35 +139,42 @@ protected:
     Mad(
         int userid,
         const map<string,string> &attrs,
-        bool sudo):
-            uid(userid),
-            attributes(attrs),
-            sudo_execution(sudo),
-            pid(-1)
-    {};
+        bool sudo);
     
     /**
-     *  The destructor of the class finalizes the driver process, and all its
+     *  The destructor of the class finalizes the driver processes, and all their
      *  associated resources (i.e. pipes)
      */
     virtual ~Mad();
     
     /**
-     *  Send a command to the driver
+     *  Send a command to the driver. The pipe is not blocking, the part of the
+     *  message that does not fit in it is queued and written by the MadManager
+     *  listener as the driver reads its input. Messages for a process being
+     *  restarted wait for it.
      *    @param os an output string stream with the message, it must be
      *    terminated with the end of line character.
+     *    @return 0 on success, -1 if the message was not sent because the
+     *    queue of the driver is full (or the driver is not running)
      */
-    void write(
-        ostringstream&  os) const
-    {
-        string        str;
-        const char *  cstr;
-        
-        str  = os.str();
-        cstr = str.c_str();
+    int write(
+        ostringstream&  os) const;
 
-        ::write(nebula_mad_pipe, cstr, str.size());
-    };
+    /**
+     *  Checks if the driver is not reading its input as fast as the messages
+     *  are sent. Managers should hold the messages that can be sent later
+     *  (e.g. monitoring) while the driver is busy.
+     *    @return true if there are messages queued for every driver process
+     */
+    bool busy() const;
+
+    /**
+     *  Checks if the driver uses the framed protocol. Messages with new lines
+     *  (e.g. raw XML) can only be sent to framed drivers, the rest of the
+     *  drivers need them encoded.
+     *    @return true if every driver process accepted the framed protocol
+     */
+    bool framed() const;
 
     /**
      *  Send a DRIVER_CANCEL command to the driver
@@ -120,18 +219,6 @@ protected:
 private:
     friend class MadManager;
 
-    /**
-     *  Communication pipe file descriptor. Represents the MAD to nebula 
-     *  communication stream (nebula<-mad)
-     */
-    int                 mad_nebula_pipe;
-
-    /**
-     *  Communication pipe file descriptor. Represents the nebula to MAD 
-     *  communication stream (nebula->mad)
-     */
-    int                 nebula_mad_pipe;
-        
     /**
      *  User running this MAD as defined in the upool DB
      */
@@ -150,24 +237,149 @@ private:
     bool                sudo_execution;
 
     /**
-     *  Process ID of the running MAD.
+     *  Driver processes, started by start()
      */
-    pid_t               pid;
+    vector<MadInstance *> instances;
+
+    /**
+     *  Process and number of requests in progress of each object (id). The
+     *  requests of an object are sent to the same process while it has
+     *  requests in progress, so they are processed in order and can be
+     *  cancelled. Protected by write_mutex.
+     */
+    mutable map<int, pair<MadInstance *, int> > routes;
+
+    /**
+     *  Max. size (bytes) of the messages queued for a driver process
+     */
+    static const unsigned int max_write_buffer = 16777216;
+
+    /**
+     *  MadManager epoll descriptor, the listener is notified through it when
+     *  the driver can read the queued messages
+     */
+    int                 epoll_fd;
+
+    /**
+     *  Serializes the writes of the manager threads, and protects the
+     *  queued messages and requests of the driver processes
+     */
+    mutable pthread_mutex_t write_mutex;
+
+    /**
+     *  Max. size of the queue of a driver process and messages not sent
+     *  because the queue was full, since the last MadManager::log_stats
+     */
+    mutable unsigned int    max_write_size;
+
+    mutable int             write_rejected;
+
+    /**
+     *  Messages of the driver queued to the MadManager workers, or being
+     *  processed, and the max. since the last MadManager::log_stats
+     */
+    int                 queued;
+
+    int                 max_queued;
+
+    /**
+     *  Messages processed since the last MadManager::log_stats, and their
+     *  latency (queue and protocol time, in microseconds)
+     */
+    int                 processed;
+
+    long long           latency_sum;
+
+    long long           latency_max;
+
+    /**
+     *  The driver could not be reloaded, it is deleted once its queued
+     *  messages are processed
+     */
+    bool                failed;
     
     /**
-     *  Starts the MAD. This function creates a new process, sets up the 
-     *  communication pipes and sends the initialization command to the driver.
+     *  Starts the MAD. This function creates the driver processes, sets up the
+     *  communication pipes and sends the initialization command to them.
      *    @return 0 on success
      */
     int start();
 
     /**
-     *  Reloads the driver: sends the finalize command, "waits" for the 
-     *  driver process and closes the communication pipes. Then the driver is
-     *  started again by calling the start() function
+     *  Starts a driver process, and sends the initialization command to it.
+     *    @param inst the driver process
+     *    @return 0 on success
+     */
+    int start(MadInstance * inst);
+
+    /**
+     *  Sends the finalize command to a driver process, "waits" for it and
+     *  closes the communication pipes.
+     *    @param inst the driver process
+     */
+    void finalize(MadInstance * inst);
+
+    /**
+     *  Reloads a driver process: the process is finalized and started again
+     *  by calling the start() function. The messages queued and the requests
+     *  in progress of the process are lost. The write_mutex is not held
+     *  while the process is restarted, so other processes of the driver can
+     *  still be used.
+     *    @param inst the driver process
      *    @return 0 on success
      */
-    int reload();
+    int reload(MadInstance * inst);
+
+    /**
+     *  Writes a message to a driver process pipe, or queues it if the pipe
+     *  is full. The message is framed if the process uses the framed
+     *  protocol. write_mutex MUST be locked.
+     *    @param inst the driver process
+     *    @param str the message, terminated with the end of line character
+     *    @return 0 on success, -1 if the message was not sent
+     */
+    int send(MadInstance * inst, string& str) const;
+
+    /**
+     *  Selects the driver process for a message: the process with requests of
+     *  the object in progress, or the one with less requests in progress that
+     *  is not restarting. write_mutex MUST be locked.
+     *    @param message to the driver "ACTION ID ..."
+     *    @param id of the object, -1 if none
+     *    @return the driver process
+     */
+    MadInstance * route(const string& message, int& id) const;
+
+    /**
+     *  Accounts a request sent to a driver process. A DRIVER_CANCEL ends
+     *  the requests in progress of the object. write_mutex MUST be locked.
+     *    @param inst the driver process
+     *    @param message to the driver "ACTION ID ..."
+     *    @param id of the object, as returned by route()
+     */
+    void request(MadInstance * inst, const string& message, int id) const;
+
+    /**
+     *  Accounts a message from a driver process, a final answer (SUCCESS or
+     *  FAILURE) ends a request of the object.
+     *    @param inst the driver process
+     *    @param message from the driver "ACTION RESULT ID ..."
+     */
+    void answer(MadInstance * inst, const string& message);
+
+    /**
+     *  Writes the queued messages to a driver process pipe, as much as it
+     *  takes. Called by the MadManager listener when the driver can read.
+     *    @param inst the driver process
+     */
+    void flush(MadInstance * inst);
+
+    /**
+     *  Clears the queued messages of a driver process and stops waiting for
+     *  it to read them. write_mutex MUST be locked.
+     *    @param inst the driver process
+     */
+    void clear_write_buffer(MadInstance * inst);
 
     /**
      *  Implements the driver specific protocol, this function should trigger
@@ -27,13 +27,75 @@
 
 #include "Mad.h"
 #include "Attribute.h"
+#include "ActionManager.h"
 
 using namespace std;
 
 class SyncRequest;
+class MadManager;
 
 extern "C" void * mad_manager_listener(void * _mm);
 
+extern "C" void * mad_worker_loop(void * _mw);
+
+/**
+ *  A MadWorker processes driver messages in its own thread. The messages of
+ *  an object are always sent to the same worker, so they are processed in
+ *  the order they were received.
+ */
+class MadWorker : public ActionListener
+{
+public:
+    MadWorker(MadManager * _mm):mm(_mm)
+    {
+        am.addListener(this);
+    };
+
+    ~MadWorker(){};
+
+    /**
+     *  Starts the worker thread
+     *    @return 0 on success
+     */
+    int start();
+
+    /**
+     *  Processes the queued messages and stops the worker thread
+     */
+    void stop();
+
+    /**
+     *  Queues a message to be processed by the worker
+     *    @param msg the message, freed by the worker
+     */
+    void trigger(void * msg)
+    {
+        am.trigger(MESSAGE, msg);
+    };
+
+private:
+    friend void * mad_worker_loop(void * _mw);
+
+    static const string MESSAGE;
+
+    /**
+     *  The manager of the drivers
+     */
+    MadManager *    mm;
+
+    /**
+     *  Thread id of the worker
+     */
+    pthread_t       worker_thread;
+
+    /**
+     *  Queue of messages of the worker
+     */
+    ActionManager   am;
+
+    void do_action(const string& action, void * arg);
+};
+
 /**
  * Provides general functionality for driver management. The MadManager serves
  * Nebula managers as base clase.
@@ -47,7 +109,7 @@ public:
      *  blocks the SIG_PIPE (broken pipe) signal that may occur when a driver
      *  crashes
      */
-    static void mad_manager_system_init();
+    static void mad_manager_system_init(int _workers = 0);
     
     /**
      *  Loads Virtual Machine Manager Mads defined in configuration file
@@ -87,6 +149,13 @@ protected:
      */
     virtual void stop();    
 
+    /**
+     *  Logs the message queue and latency counters of each driver, and
+     *  resets them
+     *    @param module for the log messages
+     */
+    void log_stats(const char * module);
+
     /**
      *  Get a mad
      */
@@ -94,8 +163,9 @@ protected:
 
     /**
      *  Register a new mad in the manager. The Mad is previously started, and
-     *  then the listener thread is notified through the pipe_w stream. In case
-     *  of failure the calling function MUST free the Mad.
+     *  then its read pipes are added to the listener epoll set. In case
+     *  of failure (the Mad does not start or a pipe cannot be added) the
+     *  calling function MUST free the Mad.
      *    @param mad pointer to the mad to be added to the manager.
      *    @return 0 on success.
      */
@@ -156,43 +226,102 @@ private:
     pthread_t               listener_thread;
 
     /**
-     *  Communication pipe (read end) to link the Manager and the listener 
-     *  thread
+     *  epoll instance of the listener, the read pipes of the drivers are
+     *  registered in it with their Mad as user data
      */
-    int                     pipe_r;
+    int                     epoll_fd;
+
+    /**
+     *  The sets of Mads managed by the MadManager
+     */
+    vector<Mad *>           mads;
+        
+    /**
+     *  List of pending requests
+     */
+    map<int, SyncRequest *> sync_requests;
     
     /**
-     *  Communication pipe (write end) to link the Manager and the listener 
-     *  thread
-     */    
-    int                     pipe_w;
+     *  Size of the chunks read from the driver pipes
+     */
+    static const int read_chunk_size = 65536;
 
     /**
-     *  This vector contains the file descriptors of the driver pipes (to read
-     *  Mads responses)
+     *  Number of workers of each manager to process the driver messages, 0
+     *  to process them in the listener thread
      */
-    vector<int>             fds;
-    
+    static int              workers_size;
+
     /**
-     *  The sets of Mads managed by the MadManager
+     *  Workers to process the driver messages
      */
-    vector<Mad *>           mads;
-        
+    vector<MadWorker *>     workers;
+
     /**
-     *  Read buffer for the listener. This variable is in the class so it
-     *  can be free upon listener thread cancellation.
+     *  Mutex for the message counters of the drivers
      */
-    ostringstream           buffer;
+    pthread_mutex_t         stats_mutex;
 
     /**
-     *  List of pending requests
+     *  A driver message queued to a worker
      */
-    map<int, SyncRequest *> sync_requests;
-    
+    struct MadMessage
+    {
+        Mad *       mad;
+        string      message;
+        long long   queued_time;
+    };
+
+    friend class MadWorker;
+
+    /**
+     *  Sends a message to the worker of its object (the id that follows the
+     *  action and result), or processes it if there are no workers.
+     *    @param mad the driver
+     *    @param message the driver message
+     */
+    void dispatch(Mad * mad, string& message);
+
+    /**
+     *  Processes a queued message with the driver protocol, called by the
+     *  workers
+     *    @param msg the message
+     */
+    void process(MadMessage * msg);
+
+    /**
+     *  Current time in microseconds
+     */
+    static long long now_us();
+
     /**
      *  Listener thread implementation.
      */
     void listener();
+
+    /**
+     *  Reads the available data of a driver process, and processes the
+     *  complete messages (lines) with the driver protocol.
+     *    @param inst the driver process
+     *    @param chunk buffer to read the data
+     *    @return 0 on success, -1 if the driver pipe was closed or failed
+     */
+    int read_messages(MadInstance * inst, char * chunk);
+
+    /**
+     *  Processes the complete frames ("<length>\n<message>") in the read
+     *  buffer of a driver process that uses the framed protocol.
+     *    @param inst the driver process
+     *    @return 0 on success, -1 if a frame header is not valid
+     */
+    int read_frames(MadInstance * inst);
+
+    /**
+     *  Reloads a driver process after a read failure. The driver is removed
+     *  from the manager if the process can not be started again
+     *    @param inst the driver process
+     */
+    void reload_mad(MadInstance * inst);
 };
 
 #endif /*MAD_MANAGER_H_*/
@@ -0,0 +1,232 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef MONITOR_RECEIVER_H_
+#define MONITOR_RECEIVER_H_
+
+#include <map>
+#include <string>
+#include <pthread.h>
+#include <time.h>
+
+#include "HostPool.h"
+
+using namespace std;
+
+extern "C" void * mr_loop(void *arg);
+
+/**
+ *  The MonitorReceiver accepts monitoring reports pushed by the hosts, over
+ *  UDP, and updates the hosts with them as if they were sent by an IM driver.
+ *  Each report is a datagram:
+ *
+ *    MONITOR <host_id> <timestamp> <signature>\n<host information>
+ *
+ *  The host information are the KEY=VALUE pairs of the probes (run_probes),
+ *  and the signature is the hex HMAC-SHA1 of "<host_id> <timestamp>\n<host
+ *  information>" with the key of the host. Each host has its own key, derived
+ *  from the receiver key (host_key), so a host cannot send reports for other
+ *  hosts. Reports with a wrong signature, out of the allowed clock skew, or
+ *  not newer than the last one of the host are discarded.
+ */
+class MonitorReceiver
+{
+public:
+    /**
+     *    @param _hpool the host pool, to update the hosts
+     *    @param _address to listen to
+     *    @param _port UDP port, 0 to use any free port
+     *    @param _key secret to derive the keys of the hosts
+     */
+    MonitorReceiver(HostPool *      _hpool,
+                    const string&   _address,
+                    int             _port,
+                    const string&   _key):
+        hpool(_hpool),
+        address(_address),
+        port(_port),
+        key(_key),
+        socket_fd(-1),
+        received(0),
+        discarded(0)
+    {
+        pthread_mutex_init(&mutex, 0);
+    };
+
+    virtual ~MonitorReceiver()
+    {
+        pthread_mutex_destroy(&mutex);
+    };
+
+    /**
+     *  Binds the socket and starts the receiver thread
+     *    @return 0 on success
+     */
+    int start();
+
+    /**
+     *  Stops the receiver thread and closes the socket
+     */
+    void stop();
+
+    /**
+     *  Gets the UDP port the receiver is bound to
+     *    @return the port
+     */
+    int get_port() const
+    {
+        return port;
+    };
+
+    /**
+     *  Gets the number of reports received, and the discarded ones
+     *    @param _received number of reports received
+     *    @param _discarded number of reports discarded
+     */
+    void get_stats(int& _received, int& _discarded) const
+    {
+        pthread_mutex_lock(&mutex);
+
+        _received  = received;
+        _discarded = discarded;
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    /**
+     *  Derives the key of a host, used by the host to sign its reports
+     *    @param key the receiver key
+     *    @param hid the host id
+     *    @return the hex HMAC-SHA1 of the host id with the receiver key
+     */
+    static string host_key(const string& key, int hid);
+
+    /**
+     *  Builds a signed monitoring report
+     *    @param key the key of the host (host_key)
+     *    @param hid the host id
+     *    @param timestamp of the report
+     *    @param info the host information
+     *    @return the report
+     */
+    static string format_report(const string& key,
+                                int           hid,
+                                time_t        timestamp,
+                                const string& info);
+
+    /**
+     *  Max. difference between the time of a report and the current time, in
+     *  seconds
+     */
+    static const time_t max_skew;
+
+protected:
+    /**
+     *  Updates a host with a monitoring report, called by the receiver
+     *  thread for each valid report
+     *    @param hid the host id
+     *    @param info the host information
+     */
+    virtual void process_report(int hid, const string& info);
+
+private:
+    friend void * mr_loop(void *arg);
+
+    /**
+     *  Thread id of the receiver
+     */
+    pthread_t   mr_thread;
+
+    /**
+     *  Pointer to the Host Pool, to update the hosts
+     */
+    HostPool *  hpool;
+
+    /**
+     *  Address and port to listen to
+     */
+    string      address;
+
+    int         port;
+
+    /**
+     *  Secret to derive the keys of the hosts
+     */
+    string      key;
+
+    /**
+     *  UDP socket of the receiver
+     */
+    int         socket_fd;
+
+    /**
+     *  Time of the last report of each host, to discard replayed reports
+     */
+    map<int, time_t>    last_report;
+
+    /**
+     *  Number of reports received and discarded, protected by mutex
+     */
+    int         received;
+
+    int         discarded;
+
+    mutable pthread_mutex_t mutex;
+
+    /**
+     *  Maximum size of a report
+     */
+    static const int max_report_size = 65536;
+
+    /**
+     *  Receives the reports until the thread is cancelled
+     */
+    void loop();
+
+    /**
+     *  Parses and checks a report
+     *    @param report the datagram
+     *    @param hid the host id
+     *    @param info the host information
+     *    @param error_str describes the error
+     *    @return 0 if the report is valid
+     */
+    int parse_report(const string& report,
+                     int&          hid,
+                     string&       info,
+                     string&       error_str);
+
+    /**
+     *  Signs the host information of a report
+     *    @param key the key of the host
+     *    @param hid the host id
+     *    @param timestamp of the report
+     *    @param info the host information
+     *    @return the hex HMAC-SHA1 signature
+     */
+    static string sign(const string& key,
+                       int           hid,
+                       time_t        timestamp,
+                       const string& info);
+
+    /**
+     *  Compares two signatures in constant time
+     *    @return true if they are equal
+     */
+    static bool equal_signature(const string& s1, const string& s2);
+};
+
+#endif /*MONITOR_RECEIVER_H_*/
@@ -0,0 +1,171 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef MONITOR_SCHEDULER_H_
+#define MONITOR_SCHEDULER_H_
+
+#include <map>
+#include <string>
+#include <pthread.h>
+#include <time.h>
+
+using namespace std;
+
+/**
+ *  The MonitorScheduler decides when each host is monitored. Hosts are spread
+ *  over the monitoring interval: each one gets a fixed phase offset derived
+ *  from its id, and it is probed once per interval at its own slot instead of
+ *  all of them at the same timer tick. It also caps the number of probes in
+ *  progress for each IM driver, and keeps statistics about the probes (queue
+ *  length and latency). The probes are started by the InformationManager and
+ *  ended by the InformationManagerDriver, so the class is thread safe.
+ */
+class MonitorScheduler
+{
+public:
+    /**
+     *    @param _period the host monitoring interval
+     *    @param _max_inflight maximum number of probes in progress for each
+     *    driver, 0 for no limit
+     */
+    MonitorScheduler(time_t _period, int _max_inflight);
+
+    ~MonitorScheduler()
+    {
+        pthread_mutex_destroy(&mutex);
+    };
+
+    /**
+     *  Statistics of the probes. Counters and latencies refer to the probes
+     *  ended since the last call to MonitorScheduler::get_stats with reset
+     */
+    struct Stats
+    {
+        int         queued;      /**< Due hosts not probed (driver limit)  */
+        int         inflight;    /**< Probes in progress                   */
+        int         probes;      /**< Probes ended                         */
+        int         timeouts;    /**< Probes expired without a response    */
+        long long   latency_avg; /**< Average probe latency (ms)           */
+        long long   latency_max; /**< Maximum probe latency (ms)           */
+    };
+
+    /**
+     *  Phase offset of a host in the monitoring interval
+     *    @param hid the host id
+     *    @return the offset in seconds, in [0, period)
+     */
+    time_t phase(int hid) const;
+
+    /**
+     *  Checks if a host has to be probed. A host is due when it has not been
+     *  monitored since the start of its current slot (now aligned to the
+     *  host phase)
+     *    @param hid the host id
+     *    @param last_monitored time of the last monitoring of the host
+     *    @param now current time
+     *    @return true if the host has to be probed
+     */
+    bool is_due(int hid, time_t last_monitored, time_t now) const;
+
+    /**
+     *  Registers a new probe for a host, if the driver is below its limit of
+     *  probes in progress
+     *    @param hid the host id
+     *    @param driver name of the IM driver used to monitor the host
+     *    @return true if the probe can be sent to the driver
+     */
+    bool start(int hid, const string& driver);
+
+    /**
+     *  Ends the probe of a host, and records its latency. Hosts without a
+     *  probe in progress are ignored
+     *    @param hid the host id
+     */
+    void end(int hid);
+
+    /**
+     *  Removes the probes in progress for more than the given time, they are
+     *  accounted as timeouts
+     *    @param expire_time in seconds
+     */
+    void expire(time_t expire_time);
+
+    /**
+     *  Sets the number of due hosts that were not probed in the last
+     *  scheduling round because their driver reached the limit
+     *    @param queued number of hosts
+     */
+    void set_queued(int queued);
+
+    /**
+     *  Gets the probe statistics
+     *    @param stats the statistics
+     *    @param reset the probe counters and latencies
+     */
+    void get_stats(Stats& stats, bool reset);
+
+private:
+    /**
+     *  A probe in progress
+     */
+    struct Probe
+    {
+        string      driver;
+        long long   start;
+    };
+
+    /**
+     *  Host monitoring interval
+     */
+    time_t      period;
+
+    /**
+     *  Maximum number of probes in progress per driver (0 = no limit)
+     */
+    int         max_inflight;
+
+    /**
+     *  Probes in progress indexed by host id, and their number per driver
+     */
+    map<int, Probe>     probes;
+
+    map<string, int>    inflight;
+
+    /**
+     *  Statistics
+     */
+    int         queued;
+
+    int         ended;
+
+    int         timeouts;
+
+    long long   latency_sum;
+
+    long long   latency_max;
+
+    /**
+     *  Mutex to access the probes and statistics
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     *  Current time in milliseconds
+     */
+    static long long now_ms();
+};
+
+#endif /*MONITOR_SCHEDULER_H_*/
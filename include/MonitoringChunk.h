@@ -0,0 +1,160 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+
+#ifndef MONITORING_CHUNK_H_
+#define MONITORING_CHUNK_H_
+
+#include <string>
+#include <vector>
+#include <time.h>
+
+using namespace std;
+
+/**
+ *  A MonitoringChunk stores a series of monitoring samples of an object. Each
+ *  sample is a timestamp and a fixed set of integer metrics. The first sample
+ *  is stored as is, the following ones store the delta of the delta of each
+ *  value with a variable length bit encoding, so a metric that does not change
+ *  (or changes at a constant rate) takes a single bit per sample.
+ *
+ *  Encoding of each delta-of-delta (zig-zag encoded as an unsigned value):
+ *    '0'                 value is 0
+ *    '10'   +  7 bits    value < 2^7
+ *    '110'  + 12 bits    value < 2^12
+ *    '1110' + 20 bits    value < 2^20
+ *    '1111' + 64 bits    any other value
+ *
+ *  The chunk starts with the number of samples (16 bits).
+ */
+class MonitoringChunk
+{
+public:
+    /**
+     *  @param _num_metrics number of metrics of each sample
+     */
+    MonitoringChunk(int _num_metrics);
+
+    ~MonitoringChunk(){};
+
+    /**
+     *  Max. number of samples in a chunk. Chunks are rewritten in the DB with
+     *  each new sample, so this limits the cost of each update
+     */
+    static const int MAX_SAMPLES;
+
+    /**
+     *  Adds a new sample to the chunk
+     *    @param time of the sample, must be greater than the last one
+     *    @param values of the metrics
+     *    @return 0 on success, -1 if the sample can not be added (the chunk
+     *    is full, the time is not valid or the number of metrics is wrong)
+     */
+    int add(time_t time, const vector<long long>& values);
+
+    /**
+     *  @return true if no more samples can be added to this chunk
+     */
+    bool full() const
+    {
+        return samples >= MAX_SAMPLES;
+    };
+
+    /**
+     *  @return the number of samples of the chunk
+     */
+    int size() const
+    {
+        return samples;
+    };
+
+    /**
+     *  @return the time of the first sample
+     */
+    time_t get_start_time() const
+    {
+        return start_time;
+    };
+
+    /**
+     *  @return the time of the last sample
+     */
+    time_t get_last_time() const
+    {
+        return last_time;
+    };
+
+    /**
+     *  Encodes the chunk in a string, suitable to be stored in the DB
+     *    @param str the resulting string (base64)
+     *    @return a reference to the generated string
+     */
+    string& to_str(string& str) const;
+
+    /**
+     *  Decodes the samples of a chunk
+     *    @param str the encoded chunk, as generated by to_str
+     *    @param num_metrics number of metrics of each sample
+     *    @param times of the samples (the vectors are cleared first)
+     *    @param values of the samples, one vector of metrics per sample
+     *    @return 0 on success, -1 if the chunk can not be decoded
+     */
+    static int decode(const string&               str,
+                      int                         num_metrics,
+                      vector<time_t>&             times,
+                      vector< vector<long long> >& values);
+
+private:
+    /**
+     *  Number of metrics of each sample
+     */
+    int         num_metrics;
+
+    /**
+     *  Number of samples in the chunk
+     */
+    int         samples;
+
+    time_t      start_time;
+
+    time_t      last_time;
+
+    /**
+     *  Encoded samples and the number of bits used
+     */
+    string      data;
+
+    size_t      num_bits;
+
+    /**
+     *  Last time (position 0) and metric values, and their last deltas
+     */
+    vector<unsigned long long> prev;
+
+    vector<unsigned long long> prev_delta;
+
+    /**
+     *  Appends the n less significant bits of value to the chunk
+     */
+    void write_bits(unsigned long long value, int n);
+
+    /**
+     *  Appends a delta-of-delta to the chunk
+     */
+    void write_dod(unsigned long long dod);
+};
+
+#endif /*MONITORING_CHUNK_H_*/
@@ -0,0 +1,114 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+
+#ifndef MONITORING_ROLLUP_H_
+#define MONITORING_ROLLUP_H_
+
+#include <string>
+#include <vector>
+#include <time.h>
+
+using namespace std;
+
+/**
+ *  A MonitoringRollup aggregates the monitoring samples of an object in a
+ *  time interval. It keeps the number of samples and the min, max and sum of
+ *  each metric, so it can be updated as the samples arrive.
+ */
+class MonitoringRollup
+{
+public:
+    /**
+     *  @param _start_time of the interval
+     *  @param _num_metrics number of metrics of each sample
+     */
+    MonitoringRollup(time_t _start_time, int _num_metrics);
+
+    ~MonitoringRollup(){};
+
+    /**
+     *  Adds the values of a sample to the rollup
+     *    @param values of the metrics
+     *    @return 0 on success, -1 if the number of metrics is wrong
+     */
+    int add(const vector<long long>& values);
+
+    /**
+     *  @return the start time of the interval
+     */
+    time_t get_start_time() const
+    {
+        return start_time;
+    };
+
+    /**
+     *  @return the number of samples in the rollup
+     */
+    int size() const
+    {
+        return samples;
+    };
+
+    /**
+     *  @param i index of the metric
+     *  @return the min, max or average value of the metric
+     */
+    long long get_min(int i) const
+    {
+        return min[i];
+    };
+
+    long long get_max(int i) const
+    {
+        return max[i];
+    };
+
+    long long get_avg(int i) const
+    {
+        return samples == 0 ? 0 : sum[i] / samples;
+    };
+
+    /**
+     *  Encodes the rollup in a string, suitable to be stored in the DB:
+     *  "<samples> <min> <max> <sum> <min> <max> <sum> ..."
+     *    @param str the resulting string
+     *    @return a reference to the generated string
+     */
+    string& to_str(string& str) const;
+
+    /**
+     *  Rebuilds the rollup values from a string
+     *    @param str the encoded rollup, as generated by to_str
+     *    @return 0 on success, -1 if the string can not be decoded
+     */
+    int from_str(const string& str);
+
+private:
+    time_t              start_time;
+
+    int                 num_metrics;
+
+    int                 samples;
+
+    vector<long long>   min;
+
+    vector<long long>   max;
+
+    vector<long long>   sum;
+};
+
+#endif /*MONITORING_ROLLUP_H_*/
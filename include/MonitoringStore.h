@@ -0,0 +1,284 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+
+#ifndef MONITORING_STORE_H_
+#define MONITORING_STORE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <pthread.h>
+
+#include "SqlDB.h"
+#include "Attribute.h"
+#include "MonitoringChunk.h"
+#include "MonitoringRollup.h"
+
+using namespace std;
+
+/**
+ *  The MonitoringStore keeps the monitoring samples of the objects of a pool
+ *  as series of compressed chunks (see MonitoringChunk). Only the numeric
+ *  metrics of each sample are stored, the XML representation of a sample is
+ *  built from the current object body with the metric values of the sample.
+ *
+ *  The monitoring table has the following columns:
+ *    <id column> INTEGER, start_time INTEGER, last_time INTEGER, body TEXT
+ *
+ *  The samples can be also aggregated in rollups (min/avg/max of each metric)
+ *  of a fixed resolution (e.g. 5 minutes, 1 hour), that are kept for longer
+ *  periods than the samples. The rollup table has the following columns:
+ *    <id column> INTEGER, resolution INTEGER, start_time INTEGER, body TEXT
+ *
+ *  The last chunk and the current rollups of each object are kept in memory
+ *  and written to the DB with each new sample.
+ *
+ *  The tables are expired in time buckets (EXPIRATION_BUCKET), the DB is only
+ *  hit when a new bucket expires and then only the rows of that bucket are
+ *  deleted (the tables are indexed by time).
+ */
+class MonitoringStore : public Callbackable
+{
+public:
+    /**
+     *  @param _table name of the monitoring table
+     *  @param _rollup_table name of the monitoring rollup table
+     *  @param _id_column column of the monitoring tables with the object id
+     *  @param _obj_table table of the pool objects
+     *  @param _time_element XML element of the object with the sample time
+     *  @param _metrics XML elements of the object with the metrics, 0
+     *  terminated. Each element is replaced in the first position it appears
+     *  in the object body
+     *  @param _expiration time, in seconds, to keep the samples. If 0 the
+     *  samples are not stored
+     */
+    MonitoringStore(const char *  _table,
+                    const char *  _rollup_table,
+                    const char *  _id_column,
+                    const char *  _obj_table,
+                    const char *  _time_element,
+                    const char ** _metrics,
+                    time_t        _expiration);
+
+    ~MonitoringStore();
+
+    /**
+     *  Adds a rollup level
+     *    @param resolution size, in seconds, of the rollup intervals
+     *    @param expiration time, in seconds, to keep the rollups. If 0 the
+     *    rollups are kept forever
+     *    @return 0 on success, -1 if the level is not valid
+     */
+    int add_rollup(time_t resolution, time_t expiration);
+
+    /**
+     *  Adds the rollup levels defined by a set of attributes:
+     *    MONITORING_ROLLUP = [ RESOLUTION = <secs>, EXPIRATION = <secs> ]
+     *    @param rollups the vector attributes
+     */
+    void add_rollups(const vector<const Attribute *>& rollups);
+
+    /**
+     *  Checks if there is a rollup level for a resolution
+     *    @param resolution of the rollups, 0 for the samples
+     *    @return true if the level exists
+     */
+    bool has_resolution(time_t resolution) const;
+
+    /**
+     *  Adds a new sample for an object, and updates its rollups
+     *    @param db pointer to the db
+     *    @param oid of the object
+     *    @param time of the sample
+     *    @param values of the metrics, in the order of the metric elements
+     *    @return 0 on success
+     */
+    int add(SqlDB * db, int oid, time_t time, const vector<long long>& values);
+
+    /**
+     *  Dumps the monitoring samples in XML format, in the same format as the
+     *  object bodies:
+     *    <MONITORING_DATA><OBJ>...</OBJ><OBJ>...</OBJ></MONITORING_DATA>
+     *
+     *  For the rollups each metric has the average value, the time is the
+     *  start of the interval, and the min and max values are added as:
+     *    <MONITORING_ROLLUP><RESOLUTION/><SAMPLES/><MIN/><MAX/>
+     *    </MONITORING_ROLLUP>
+     *
+     *    @param db pointer to the db
+     *    @param oss the output stream
+     *    @param where filter for the objects
+     *    @param resolution of the rollups, 0 to dump the samples
+     *    @return 0 on success
+     */
+    int dump(SqlDB *        db,
+             ostringstream& oss,
+             const string&  where,
+             time_t         resolution = 0);
+
+    /**
+     *  Deletes the chunks with all its samples expired, and the expired
+     *  rollups. The rows are deleted once per expiration bucket, so this
+     *  function can be called often
+     *    @param db pointer to the db
+     *    @return 0 on success
+     */
+    int clean_expired(SqlDB * db);
+
+    /**
+     *  Size, in seconds, of the expiration buckets
+     */
+    static const time_t EXPIRATION_BUCKET;
+
+    /**
+     *  Deletes all the monitoring samples, the rollups are not deleted
+     *    @param db pointer to the db
+     *    @return 0 on success
+     */
+    int clean_all(SqlDB * db);
+
+private:
+    /**
+     *  Rollups of a given resolution
+     */
+    struct RollupLevel
+    {
+        time_t  resolution;
+
+        time_t  expiration;
+
+        /**
+         *  Current rollup of each object
+         */
+        map<int, MonitoringRollup *> rollups;
+    };
+
+    string          table;
+
+    string          rollup_table;
+
+    string          id_column;
+
+    string          obj_table;
+
+    string          time_element;
+
+    vector<string>  metrics;
+
+    time_t          expiration;
+
+    /**
+     *  Start of the last expiration bucket (clean_expired)
+     */
+    time_t          last_bucket;
+
+    /**
+     *  Last chunk of each object
+     */
+    map<int, MonitoringChunk *> chunks;
+
+    vector<RollupLevel>         levels;
+
+    pthread_mutex_t mutex;
+
+    void lock()
+    {
+        pthread_mutex_lock(&mutex);
+    };
+
+    void unlock()
+    {
+        pthread_mutex_unlock(&mutex);
+    };
+
+    /**
+     *  Reads a rollup from the DB, used when the current rollup of an
+     *  object is not in memory (e.g. after a restart)
+     *    @param db pointer to the db
+     *    @param oid of the object
+     *    @param resolution of the rollup
+     *    @param start_time of the rollup interval
+     *    @return the rollup, empty if it is not in the DB
+     */
+    MonitoringRollup * load_rollup(SqlDB * db,
+                                   int     oid,
+                                   time_t  resolution,
+                                   time_t  start_time);
+
+    /**
+     *  Position of the metric values in an object body, indexed by the start
+     *  of each value: (start, (end, metric)). The time element has metric -1
+     */
+    typedef map<size_t, pair<size_t, int> > Slots;
+
+    /**
+     *  Gets the position of the metric values in an object body
+     *    @param body of the object
+     *    @param slots the positions
+     */
+    void find_slots(const string& body, Slots& slots);
+
+    /**
+     *  Writes an object body with the values of a sample
+     *    @param oss the output stream
+     *    @param body of the object
+     *    @param slots position of the values, as returned by find_slots
+     *    @param time of the sample
+     *    @param values of the metrics
+     *    @param extra XML to be added before the closing element of the body
+     */
+    void render(ostringstream *          oss,
+                const string&            body,
+                const Slots&             slots,
+                time_t                   time,
+                const vector<long long>& values,
+                const string&            extra = "");
+
+    /**
+     *  Callback function to read a rollup (load_rollup)
+     *    @param _rollup the rollup
+     *    @param num the number of columns read from the DB
+     *    @param values the rollup body
+     *    @param names the column names
+     *    @return 0 on success
+     */
+    int load_cb(void * _rollup, int num, char **values, char **names);
+
+    /**
+     *  Callback function to dump the rollups (dump)
+     *    @param _oss the output stream
+     *    @param num the number of columns read from the DB
+     *    @param values the object body, the rollup start time, resolution
+     *    and body
+     *    @param names the column names
+     *    @return 0 on success
+     */
+    int dump_rollup_cb(void * _oss, int num, char **values, char **names);
+
+    /**
+     *  Callback function to dump the samples of a chunk (dump)
+     *    @param _oss the output stream
+     *    @param num the number of columns read from the DB
+     *    @param values the object body and the chunk
+     *    @param names the column names
+     *    @return 0 on success
+     */
+    int dump_cb(void * _oss, int num, char **values, char **names);
+};
+
+#endif /*MONITORING_STORE_H_*/
@@ -20,6 +20,8 @@
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <queue>
+#include <vector>
 
 #include <sys/time.h>
 #include <sys/types.h>
@@ -37,27 +39,55 @@ using namespace std;
 #include <mysql.h>
 
 /**
- * SqliteDB class. Provides a wrapper to the mysql database interface.
+ * MySqlDB class. Provides a wrapper to the mysql database interface. Queries
+ * are executed over a pool of connections, each exec() checks out a free
+ * connection for the duration of the query and the processing of its results
  */
 class MySqlDB : public SqlDB
 {
 public:
 
+    /**
+     *  Opens the connection pool. The database is created if it does not
+     *  exist, and selected as the default one in every connection.
+     *    @param _connections number of connections to the server
+     */
     MySqlDB(const string& _server,
             int           _port,
             const string& _user,
             const string& _password,
-            const string& _database);
+            const string& _database,
+            int           _connections = 1);
 
     ~MySqlDB();
 
     /**
      *  Wraps the mysql_query function call
      *    @param cmd the SQL command
-     *    @param obj Callbackable obj to call if the query succeeds
+     *    @param cb callback to execute on each row returned
+     *    @return 0 on success
+     */
+    int exec(ostringstream& cmd, SqlCallback* cb=0);
+
+    /**
+     *  Starts a transaction. A connection is checked out and reserved for
+     *  the calling thread, that uses it for all its queries until the
+     *  transaction ends.
+     *    @return 0 on success
+     */
+    int begin();
+
+    /**
+     *  Commits the transaction of the calling thread
+     *    @return 0 on success
+     */
+    int commit();
+
+    /**
+     *  Rolls back the transaction of the calling thread
      *    @return 0 on success
      */
-    int exec(ostringstream& cmd, Callbackable* obj=0);
+    int rollback();
 
     /**
      *  This function returns a legal SQL string that can be used in an SQL
@@ -74,12 +104,69 @@ public:
      */
     void free_str(char * str);
 
+    /**
+     *  Gets the usage statistics of the connection pool
+     *    @param checkouts number of times a connection was requested
+     *    @param waits number of requests that had to wait for a connection
+     *    @param wait_usec total time spent waiting for a connection
+     *    @param in_use connections currently checked out
+     *    @param max_in_use maximum number of connections used at the same time
+     */
+    void get_stats(unsigned long& checkouts,
+                   unsigned long& waits,
+                   unsigned long& wait_usec,
+                   unsigned int&  in_use,
+                   unsigned int&  max_in_use);
+
+    /**
+     *  Prints the usage statistics of the connection pool
+     *    @param oss the output stream
+     */
+    void print_stats(ostringstream& oss);
+
 private:
 
     /**
-     * The MySql connection handler
+     *  Connections to the MySQL server
+     */
+    vector<MYSQL *>     connections;
+
+    /**
+     *  Connections not checked out by any thread
+     */
+    queue<MYSQL *>      free_connections;
+
+    /**
+     *  Signaled each time a connection is returned to the pool
+     */
+    pthread_cond_t      cond;
+
+    /**
+     *  Connection pool statistics
+     */
+    unsigned long       checkouts;
+
+    unsigned long       waits;
+
+    unsigned long       wait_usec;
+
+    unsigned int        max_in_use;
+
+    /**
+     *  Transaction of a thread: the connection reserved for it, nesting
+     *  level and whether a nested transaction was rolled back
+     */
+    struct Transaction
+    {
+        MYSQL * db;
+        int     depth;
+        bool    rollback;
+    };
+
+    /**
+     *  Thread specific key to get the Transaction of the calling thread
      */
-    MYSQL *             db;
+    pthread_key_t       tx_key;
 
     /**
      *  MySQL Connection parameters
@@ -95,12 +182,12 @@ private:
     string              database;
 
     /**
-     *  Fine-grain mutex for DB access
+     *  Mutex for the connection pool
      */
     pthread_mutex_t     mutex;
 
     /**
-     *  Function to lock the DB
+     *  Function to lock the connection pool
      */
     void lock()
     {
@@ -108,12 +195,49 @@ private:
     };
 
     /**
-     *  Function to unlock the DB
+     *  Function to unlock the connection pool
      */
     void unlock()
     {
         pthread_mutex_unlock(&mutex);
     };
+
+    /**
+     *  Opens a new connection to the server
+     *    @param database to use, empty to not select one
+     *    @return the connection handler or 0 in case of failure
+     */
+    MYSQL * connect(const string& _database);
+
+    /**
+     *  Gets a free connection from the pool, blocks until one is available.
+     *  If the calling thread is in a transaction its connection is returned.
+     *    @return the connection handler
+     */
+    MYSQL * get_db_connection();
+
+    /**
+     *  Returns a connection to the pool, unless it is reserved for the
+     *  transaction of the calling thread
+     *    @param db the connection handler
+     */
+    void free_db_connection(MYSQL * db);
+
+    /**
+     *  Ends the transaction of the calling thread and returns its connection
+     *  to the pool
+     *    @param do_commit true to commit the transaction
+     *    @return 0 on success
+     */
+    int end_transaction(bool do_commit);
+
+    /**
+     *  Re-opens a connection lost to the server. The connection must be
+     *  checked out by the caller.
+     *    @param db the connection handler, updated with the new one
+     *    @return 0 on success
+     */
+    int reconnect(MYSQL *& db);
 };
 #else
 //CLass stub
@@ -126,18 +250,33 @@ public:
             int    port,
             string user,
             string password,
-            string database)
+            string database,
+            int    connections = 1)
     {
         throw runtime_error("Aborting oned, MySQL support not compiled!");
     };
 
     ~MySqlDB(){};
 
-    int exec(ostringstream& cmd, Callbackable* obj=0){return -1;};
+    int exec(ostringstream& cmd, SqlCallback* cb=0){return -1;};
+
+    int begin(){return -1;};
+
+    int commit(){return -1;};
+
+    int rollback(){return -1;};
 
     char * escape_str(const string& str){return 0;};
 
     void free_str(char * str){};
+
+    void get_stats(unsigned long& checkouts,
+                   unsigned long& waits,
+                   unsigned long& wait_usec,
+                   unsigned int&  in_use,
+                   unsigned int&  max_in_use){};
+
+    void print_stats(ostringstream& oss){};
 };
 #endif
 
@@ -176,6 +176,13 @@ public:
      */
     int update_from_node(const xmlNodePtr node);
 
+    /**
+     *   Frees the XML document and XPath context of the object. Once freed,
+     *   xpath queries return the default values until the object is updated
+     *   again.
+     */
+    void free_xml();
+
     /**
      *  Validates the xml string
      *
@@ -216,6 +223,11 @@ public:
         xmlChar * mem;
         int       size;
 
+        if ( oxml.xml == 0 )
+        {
+            return os;
+        }
+
         xmlDocDumpMemory(oxml.xml,&mem,&size);
 
         string str(reinterpret_cast<char *>(mem));
@@ -111,6 +111,7 @@ public:
              other_m(0),
              other_a(0),
              obj_template(0), 
+             referenced(false),
              table(_table)
     {
         pthread_mutex_init(&mutex,0);
@@ -429,7 +430,22 @@ protected:
             return -1;
         }
 
-        return from_xml(values[0]);
+        return from_db_body(values[0]);
+    };
+
+    /**
+     *  Rebuilds the object from the body stored in the DB. All the attributes
+     *  are copied to the object, so the XML document is freed afterwards.
+     *    @param body the xml-formatted string
+     *    @return 0 on success, -1 otherwise
+     */
+    int from_db_body(const string& body)
+    {
+        int rc = from_xml(body);
+
+        free_xml();
+
+        return rc;
     };
 
     /**
@@ -439,6 +455,17 @@ protected:
      */
     virtual int select(SqlDB *db);
 
+    /**
+     *  Reads the object data not stored in its body (e.g. history records or
+     *  leases). It is called once the object is rebuilt from the database.
+     *    @param db pointer to the db
+     *    @return 0 on success
+     */
+    virtual int post_select(SqlDB *db)
+    {
+        return 0;
+    };
+
     /**
      *  Reads the PoolObjectSQL (identified by its OID) from the database.
      *    @param db pointer to the db
@@ -582,6 +609,12 @@ private:
      */
     pthread_mutex_t mutex;
 
+    /**
+     *  Reference bit for the pool cache replacement policy, set each time the
+     *  object is retrieved from the pool. Protected by the pool mutex.
+     */
+    bool referenced;
+
     /**
      *  Pointer to the SQL table for the PoolObjectSQL
      */
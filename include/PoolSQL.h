@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include <queue>
+#include <set>
 
 #include "SqlDB.h"
 #include "PoolObjectSQL.h"
@@ -31,8 +32,9 @@ using namespace std;
 /**
  * PoolSQL class. Provides a base class to implement persistent generic pools.
  * The PoolSQL provides a synchronization mechanism (mutex) to operate in
- * multithreaded applications. Any modification or access function to the pool
- * SHOULD block the mutex.
+ * multithreaded applications. The object cache is split in partitions, each
+ * one protected by its own mutex. Any modification or access function to the
+ * pool SHOULD block the mutex of the partition.
  */
 class PoolSQL: public Callbackable, public Hookable
 {
@@ -70,6 +72,20 @@ public:
      */
     PoolObjectSQL * get(int oid, bool lock);
 
+    /**
+     *  Gets a set of objects from the pool. Cached objects are resolved from
+     *  memory and the rest are loaded from the database with a single query.
+     *  Objects are returned (and locked if requested) in ascending oid order.
+     *   @param oids the object unique identifiers
+     *   @param objects the objects found, those that do not exist are skipped
+     *   @param lock locks the objects if true
+     *
+     *   @return the number of objects loaded from the database
+     */
+    int get_many(const vector<int>&        oids,
+                 vector<PoolObjectSQL *>&  objects,
+                 bool                      lock);
+
     /**
      * Updates the cache name index. Must be called when the owner of an object
      * is changed
@@ -148,6 +164,17 @@ public:
      */
     void clean();
 
+    /**
+     *  Gets the database of the pool, to group several updates in a single
+     *  transaction (see SqlTransaction). Object locks MUST NOT be requested
+     *  while the transaction is active.
+     *    @return pointer to the DB
+     */
+    SqlDB * get_db()
+    {
+        return db;
+    };
+
     /**
      *  Dumps the pool in XML format. A filter can be also added to the
      *  query
@@ -199,6 +226,41 @@ public:
     static void oid_filter(int     start_id,
                            int     end_id,
                            string& filter);
+
+    // -------------------------------------------------------------------------
+    // Object cache configuration and statistics
+    // -------------------------------------------------------------------------
+
+    /**
+     *  Number of partitions of the object cache. Objects are assigned to a
+     *  partition by their oid, so get() calls for objects in different
+     *  partitions do not block each other.
+     */
+    static const unsigned int CACHE_PARTITIONS;
+
+    /**
+     *  Sets the max. number of objects kept in memory by the pool. The size is
+     *  evenly split among the cache partitions. Values below 1 are ignored.
+     *    @param size of the cache
+     */
+    void set_cache_size(unsigned int size);
+
+    /**
+     *  Gets the cache counters of the pool
+     *    @param hits number of get() calls served from memory
+     *    @param misses number of get() calls that loaded the object from the DB
+     *    @param evictions number of objects removed from the cache
+     */
+    void get_cache_stats(unsigned long& hits,
+                         unsigned long& misses,
+                         unsigned long& evictions);
+
+    /**
+     *  Prints the cache counters and current occupation of the pool
+     *    @param oss the output stream
+     */
+    void print_cache_stats(ostringstream& oss);
+
 protected:
 
     /**
@@ -228,6 +290,13 @@ protected:
      */
     SqlDB * db;
 
+    /**
+     *  Store the new objects and the lastOID in a single transaction. Pools
+     *  whose objects lock other objects when inserted must disable it, as
+     *  the transaction holds the DB while the insert waits for those locks.
+     */
+    bool allocate_in_transaction;
+
     /**
      *  Dumps the pool in XML format. A filter can be also added to the
      *  query
@@ -282,15 +351,73 @@ protected:
 
 private:
 
+    /**
+     *  The pool mutex protects the lastOID counter
+     */
     pthread_mutex_t mutex;
 
     /**
-     *  Max size for the pool, to control the memory footprint of the pool. This
-     *  number MUST be greater than the max. number of objects that are
-     *  accessed simultaneously.
+     *  Default max size for the pool, to control the memory footprint of the
+     *  pool. It can be adjusted for each pool with set_cache_size.
      */
     static const unsigned int MAX_POOL_SIZE;
 
+    /**
+     *  A partition of the object cache. Each partition has its own mutex,
+     *  object map and replacement clock.
+     */
+    struct CachePartition
+    {
+        /**
+         *  Protects all the partition attributes
+         */
+        pthread_mutex_t mutex;
+
+        /**
+         *  Signaled each time an object load from the DB finishes
+         */
+        pthread_cond_t  cond;
+
+        /**
+         *  Cached objects of the partition, using the OID as key.
+         */
+        map<int,PoolObjectSQL *> pool;
+
+        /**
+         *  OIDs of the objects being loaded from the DB. Other threads wait
+         *  for the load to finish instead of querying the DB again.
+         */
+        set<int> loading;
+
+        /**
+         *  OID queue used as the clock of the CLOCK (second chance)
+         *  replacement policy.
+         */
+        queue<int> oid_queue;
+
+        /**
+         *  Max number of objects in the partition
+         */
+        unsigned int size;
+
+        /**
+         *  Cache counters
+         */
+        unsigned long hits;
+        unsigned long misses;
+        unsigned long evictions;
+    };
+
+    /**
+     *  The pool is implemented with an array of cache partitions
+     */
+    CachePartition * partitions;
+
+    /**
+     *  Max number of objects in the cache for this pool
+     */
+    unsigned int cache_size;
+
     /**
      *  Last object ID assigned to an object. It must be initialized by the
      *  target pool.
@@ -303,21 +430,22 @@ private:
     string table;
 
     /**
-     *  The pool is implemented with a Map of SQL object pointers, using the
-     *  OID as key.
+     * Whether or not this pool uses the name_pool index
      */
-    map<int,PoolObjectSQL *> pool;
+    bool uses_name_pool;
 
     /**
-     * Whether or not this pool uses the name_pool index
+     *  This is a name index for the pool. The key is the name of the object
+     *  , that may be combained with the owner id. The value is the object oid
+     *  that is then looked up in the cache partitions.
      */
-    bool uses_name_pool;
+    map<string,int> name_pool;
 
     /**
-     *  This is a name index for the pool map. The key is the name of the object
-     *  , that may be combained with the owner id.
+     *  Protects the name index. It is never held while locking a partition or
+     *  an object.
      */
-    map<string,PoolObjectSQL *> name_pool;
+    pthread_mutex_t name_mutex;
 
     /**
      *  Factory method, must return an ObjectSQL pointer to an allocated pool
@@ -325,12 +453,6 @@ private:
      */
     virtual PoolObjectSQL * create() = 0;
 
-    /**
-     *  OID queue to implement a FIFO-like replacement policy for the pool
-     *  cache.
-     */
-    queue<int> oid_queue;
-
     /**
      *  Function to lock the pool
      */
@@ -348,12 +470,53 @@ private:
     };
 
     /**
-     *  FIFO-like replacement policy function. Before removing an object (pop)
-     *  from  the cache its lock is checked. The object is removed only if
-     *  the associated mutex IS NOT blocked. Otherwise the oid is sent to the
-     *  back of the queue.
+     *  Gets the cache partition of an object
+     *    @param oid of the object
+     *    @return the partition
+     */
+    CachePartition& partition(int oid)
+    {
+        return partitions[oid % CACHE_PARTITIONS];
+    };
+
+    /**
+     *  CLOCK replacement policy function. Before removing an object (pop)
+     *  from the cache its lock and reference bit are checked. The object is
+     *  removed only if the associated mutex IS NOT blocked and it has not been
+     *  accessed since the last pass. Otherwise its reference bit is cleared
+     *  and the oid is sent to the back of the queue. If every object in the
+     *  partition is locked the partition is allowed to grow over its size.
+     *  The partition MUST be locked.
+     *    @param part the cache partition
+     */
+    void replace(CachePartition& part);
+
+    /**
+     *  Inserts an object loaded from the DB in its cache partition, evicting
+     *  other objects if the partition is full. If the object was cached in the
+     *  meantime the loaded copy is deleted and the cached one is used.
+     *  The partition MUST be locked.
+     *    @param part the cache partition
+     *    @param objectsql the object loaded from the DB
+     *    @return the cached object
+     */
+    PoolObjectSQL * cache_insert(CachePartition& part,
+                                 PoolObjectSQL * objectsql);
+
+    /**
+     *  Checks that a cached object is still valid, locking it if requested.
+     *  The partition MUST be locked.
+     *    @param objectsql the cached object
+     *    @param olock locks the object if true
+     *    @return the object or 0 if it is no longer valid
+     */
+    PoolObjectSQL * check_object(PoolObjectSQL * objectsql, bool olock);
+
+    /**
+     *  Removes the name index entry of an object, if it still points to it
+     *    @param objectsql the object
      */
-    void replace();
+    void erase_name_index(PoolObjectSQL * objectsql);
 
     /**
      *  Generate an index key for the object
@@ -384,6 +547,11 @@ private:
      */
     int  init_cb(void *nil, int num, char **values, char **names);
 
+    /**
+     *  Callback to store the bodies of pool objects (PoolSQL::get_many)
+     */
+    int  get_many_cb(void *_bodies, int num, char **values, char **names);
+
     /**
      *  Callback to store the IDs of pool objects (PoolSQL::search)
      */
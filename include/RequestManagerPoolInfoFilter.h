@@ -139,7 +139,7 @@ public:
     VirtualMachinePoolMonitoring():
         RequestManagerPoolInfoFilter("VirtualMachinePoolMonitoring",
                                      "Returns the virtual machine monitoring records",
-                                     "A:si")
+                                     "A:si,A:sii")
     {
         Nebula& nd  = Nebula::instance();
         pool        = nd.get_vmpool();
@@ -245,7 +245,7 @@ public:
     HostPoolMonitoring():
         RequestManagerPoolInfoFilter("HostPoolMonitoring",
                                      "Returns the host monitoring records",
-                                     "A:s")
+                                     "A:s,A:si")
     {
         Nebula& nd  = Nebula::instance();
         pool        = nd.get_hpool();
@@ -35,6 +35,14 @@ public:
      */
     static string sha1_digest(const string& in);
 
+    /**
+     *  HMAC-SHA1 of a string
+     *  @param key the secret key
+     *  @param in the string to be signed
+     *  @return hex encoded HMAC of in with key
+     */
+    static string hmac_sha1(const string& key, const string& in);
+
    /**
     *  Base 64 encoding
     *    @param in the string to encoded
@@ -43,6 +51,14 @@ public:
     */
     static string * base64_encode(const string& in);
 
+   /**
+    *  Base 64 decoding
+    *    @param in the base64 encoded string (without new lines)
+    *    @return a pointer to the decoded string (must be freed) or 0 in case of
+    *    error
+    */
+    static string * base64_decode(const string& in);
+
 private:
     SSLTools(){};
     ~SSLTools(){};
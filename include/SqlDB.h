@@ -18,10 +18,117 @@
 #define SQL_DB_H_
 
 #include <sstream>
+#include <string>
+#include <vector>
+
 #include "Callbackable.h"
 
 using namespace std;
 
+/**
+ *  SqlParams class. Values for the '?' placeholders of a SQL statement, they
+ *  are bound in the same order they are added. Text values are passed to the
+ *  backend as is, they MUST NOT be escaped.
+ */
+class SqlParams
+{
+public:
+
+    enum ParamType
+    {
+        INTEGER = 0,
+        TEXT    = 1
+    };
+
+    SqlParams(){};
+
+    ~SqlParams(){};
+
+    SqlParams& add(int value)
+    {
+        return add_integer(value);
+    };
+
+    SqlParams& add(long value)
+    {
+        return add_integer(value);
+    };
+
+    SqlParams& add(long long value)
+    {
+        return add_integer(value);
+    };
+
+    SqlParams& add(const string& value)
+    {
+        Param p;
+
+        p.type = TEXT;
+        p.ival = 0;
+        p.sval = value;
+
+        params.push_back(p);
+
+        return *this;
+    };
+
+    /**
+     *  @return the number of parameters
+     */
+    unsigned int size() const
+    {
+        return params.size();
+    };
+
+    /**
+     *  @param i index of the parameter, starting at 0
+     *  @return the type of the i-th parameter
+     */
+    ParamType type(unsigned int i) const
+    {
+        return params[i].type;
+    };
+
+    /**
+     *  @param i index of an INTEGER parameter, starting at 0
+     */
+    long long integer(unsigned int i) const
+    {
+        return params[i].ival;
+    };
+
+    /**
+     *  @param i index of a TEXT parameter, starting at 0
+     */
+    const string& text(unsigned int i) const
+    {
+        return params[i].sval;
+    };
+
+private:
+
+    struct Param
+    {
+        ParamType type;
+        long long ival;
+        string    sval;
+    };
+
+    vector<Param> params;
+
+    SqlParams& add_integer(long long value)
+    {
+        Param p;
+
+        p.type = INTEGER;
+        p.ival = value;
+
+        params.push_back(p);
+
+        return *this;
+    };
+};
+
 /**
  * SqlDB class.Provides an abstract interface to implement a SQL backend
  */
@@ -36,11 +143,47 @@ public:
     /**
      *  Performs a DB transaction
      *    @param sql_cmd the SQL command
-     *    @param callbak function to execute on each data returned
-     *    @param arg to pass to the callback function
+     *    @param cb callback to execute on each row returned, 0 if none
      *    @return 0 on success
      */
-    virtual int exec(ostringstream& cmd, Callbackable* obj=0) = 0;
+    virtual int exec(ostringstream& cmd, SqlCallback* cb=0) = 0;
+
+    /**
+     *  Performs a DB transaction with a parametrized statement. The '?'
+     *  placeholders in the command are replaced by the values in params.
+     *  Backends that support it re-use the prepared statement for the same
+     *  command, so the command should not include any variable value. This
+     *  default implementation escapes the values and expands the command.
+     *    @param cmd the SQL command with '?' placeholders
+     *    @param params values for the placeholders
+     *    @param cb callback to execute on each row returned, 0 if none
+     *    @return 0 on success
+     */
+    virtual int exec(ostringstream&   cmd,
+                     const SqlParams& params,
+                     SqlCallback*     cb=0);
+
+    /**
+     *  Starts a transaction for the calling thread, the following statements
+     *  of the thread are executed in it until commit or rollback is called.
+     *  Transactions can be nested, only the outermost commit or rollback ends
+     *  the transaction.
+     *    @return 0 on success
+     */
+    virtual int begin() = 0;
+
+    /**
+     *  Commits the transaction of the calling thread. If any of the nested
+     *  transactions was rolled back the whole transaction is rolled back.
+     *    @return 0 on success
+     */
+    virtual int commit() = 0;
+
+    /**
+     *  Rolls back the transaction of the calling thread
+     *    @return 0 on success
+     */
+    virtual int rollback() = 0;
 
     /**
      *  This function returns a legal SQL string that can be used in an SQL
@@ -57,4 +200,68 @@ public:
     virtual void free_str(char * str) = 0;
 };
 
+/**
+ *  SqlTransaction class. Scoped DB transaction, it is started when the object
+ *  is created and rolled back when it is destroyed unless it was committed.
+ */
+class SqlTransaction
+{
+public:
+
+    /**
+     *  Starts a transaction in the given database
+     *    @param _db the database, if 0 no transaction is started and the
+     *    statements are executed one by one
+     */
+    SqlTransaction(SqlDB * _db):db(_db)
+    {
+        active = ( db != 0 && db->begin() == 0 );
+    };
+
+    ~SqlTransaction()
+    {
+        rollback();
+    };
+
+    /**
+     *  Commits the transaction. If it could not be started, the statements
+     *  were executed (and committed) one by one.
+     *    @return 0 on success
+     */
+    int commit()
+    {
+        if ( !active )
+        {
+            return 0;
+        }
+
+        active = false;
+
+        return db->commit();
+    };
+
+    /**
+     *  Rolls back the transaction, if still active
+     */
+    void rollback()
+    {
+        if ( active )
+        {
+            active = false;
+
+            db->rollback();
+        }
+    };
+
+private:
+
+    SqlDB * db;
+
+    bool    active;
+
+    SqlTransaction(const SqlTransaction&);
+
+    SqlTransaction& operator=(const SqlTransaction&);
+};
+
 #endif /*SQL_DB_H_*/
@@ -20,6 +20,9 @@
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <map>
+#include <queue>
+#include <vector>
 
 #include <sys/time.h>
 #include <sys/types.h>
@@ -39,25 +42,67 @@ using namespace std;
 /**
  * SqliteDB class. Provides a wrapper to the sqlite3 database interface. It also
  * provides "global" synchronization mechanism to use it in a multithread
- * environment.
+ * environment. The database is opened in WAL mode with a writer connection
+ * and a pool of read-only connections, so queries run concurrently with the
+ * updates.
  */
 class SqliteDB : public SqlDB
 {
 public:
 
-    SqliteDB(string& db_name);
+    /**
+     *  Opens the database
+     *    @param db_name path to the database file
+     *    @param readers number of read-only connections, 0 to execute all
+     *    the statements through the writer connection
+     *    @param group_commit time in ms to wait for other writes before
+     *    committing a write, so they are committed together. 0 commits each
+     *    statement as it is executed
+     */
+    SqliteDB(string& db_name, int readers = 0, int group_commit = 0);
 
     ~SqliteDB();
 
     /**
-     *  Wraps the sqlite3_exec function call, and locks the DB mutex.
+     *  Wraps the sqlite3_exec function call. SELECT statements are executed
+     *  in a read-only connection, the rest in the writer one.
      *    @param sql_cmd the SQL command
-     *    @param callbak function to execute on each data returned, watch the
+     *    @param cb callback to execute on each row returned, watch the
      *    mutex you block in the callback.
-     *    @param arg to pass to the callback function
      *    @return 0 on success
      */
-    int exec(ostringstream& cmd, Callbackable* obj=0);
+    int exec(ostringstream& cmd, SqlCallback* cb=0);
+
+    /**
+     *  Executes a parametrized statement. The statement is prepared the first
+     *  time the command is used in a connection and cached for the next
+     *  executions, the parameters are bound with sqlite3_bind_*.
+     *    @param cmd the SQL command with '?' placeholders
+     *    @param params values for the placeholders
+     *    @param cb callback to execute on each row returned
+     *    @return 0 on success
+     */
+    int exec(ostringstream& cmd, const SqlParams& params, SqlCallback* cb=0);
+
+    /**
+     *  Starts a transaction in the writer connection. Other threads cannot
+     *  write to the DB until the transaction ends. SELECT statements of the
+     *  calling thread use the writer connection to see its own changes.
+     *    @return 0 on success
+     */
+    int begin();
+
+    /**
+     *  Commits the transaction of the calling thread
+     *    @return 0 on success
+     */
+    int commit();
+
+    /**
+     *  Rolls back the transaction of the calling thread
+     *    @return 0 on success
+     */
+    int rollback();
 
     /**
      *  This function returns a legal SQL string that can be used in an SQL
@@ -75,17 +120,112 @@ public:
 
 private:
     /**
-     *  Fine-grain mutex for DB access
+     *  Max. number of prepared statements kept in the cache
+     */
+    static const unsigned int STMT_CACHE_SIZE;
+
+    /**
+     *  Time in ms that a connection waits for a lock held by other process
+     */
+    static const int BUSY_TIMEOUT;
+
+    /**
+     *  A prepared statement in the cache of a connection, with the reference
+     *  bit of the CLOCK replacement policy
+     */
+    struct CachedStmt
+    {
+        sqlite3_stmt *  stmt;
+        bool            referenced;
+    };
+
+    /**
+     *  A connection to the database with its prepared statements, indexed by
+     *  their SQL command. A connection is used by one thread at a time.
+     */
+    struct Connection
+    {
+        sqlite3 *                   db;
+
+        map<string, CachedStmt>     stmt_cache;
+
+        /**
+         *  SQL commands of the cache used as the clock of the CLOCK (second
+         *  chance) replacement policy
+         */
+        queue<string>               stmt_queue;
+    };
+
+    /**
+     *  Connection for the statements that modify the database
+     */
+    Connection          writer;
+
+    /**
+     *  Mutex for the writer connection, it is recursive as it is held for
+     *  the duration of a transaction
      */
     pthread_mutex_t     mutex;
 
     /**
-     *  Pointer to the database.
+     *  Thread specific key with the nesting level of the transaction of the
+     *  calling thread (0 if none). Only the thread holding the writer lock
+     *  can have a transaction.
+     */
+    pthread_key_t       tx_key;
+
+    /**
+     *  A nested transaction was rolled back, the transaction will not commit
+     */
+    bool                tx_rollback;
+
+    /**
+     *  Writes committed in the same transaction (group commit). The batch is
+     *  shared by the threads that executed a write in it, that wait for the
+     *  commit before returning.
+     */
+    struct Batch
+    {
+        int             rc;
+        int             refs;
+        bool            done;
+        struct timespec deadline;
+    };
+
+    /**
+     *  Time in ms the first write of a batch waits before committing it
+     */
+    int                 group_commit;
+
+    /**
+     *  Batch with an open transaction in the writer connection, if any
+     */
+    Batch *             batch;
+
+    /**
+     *  Signaled when a batch is committed
+     */
+    pthread_cond_t      batch_cond;
+
+    /**
+     *  Read-only connections
+     */
+    vector<Connection *> readers;
+
+    /**
+     *  Read-only connections not being used by any thread
      */
-    sqlite3 *           db;
+    queue<Connection *>  free_readers;
 
     /**
-     *  Function to lock the DB
+     *  Mutex and condition for the read-only connection pool
+     */
+    pthread_mutex_t     readers_mutex;
+
+    pthread_cond_t      readers_cond;
+
+    /**
+     *  Function to lock the writer connection
      */
     void lock()
     {
@@ -93,12 +233,106 @@ private:
     };
 
     /**
-     *  Function to unlock the DB
+     *  Function to unlock the writer connection
      */
     void unlock()
     {
         pthread_mutex_unlock(&mutex);
     };
+
+    /**
+     *  Gets a connection to execute a SQL command, a read-only one for
+     *  SELECT statements (if any) and the writer for the rest. The connection
+     *  MUST be returned with put_connection.
+     *    @param sql the SQL command
+     *    @return the connection
+     */
+    Connection * get_connection(const string& sql);
+
+    /**
+     *  Returns a connection obtained with get_connection. For writes in group
+     *  commit mode waits for the batch to be committed; the first thread
+     *  that reaches the deadline of the batch commits it.
+     *    @param conn the connection
+     *    @param joined batch of the statement, as returned by join_batch
+     *    @param rc result of the statement
+     *    @return the result of the statement, -1 if it was not committed
+     */
+    int put_connection(Connection * conn, Batch * joined = 0, int rc = 0);
+
+    /**
+     *  @return true if the calling thread has a transaction in progress
+     */
+    bool in_transaction()
+    {
+        return get_tx_depth() > 0;
+    };
+
+    /**
+     *  Gets and sets the nesting level of the transaction of the calling
+     *  thread
+     */
+    int get_tx_depth()
+    {
+        return static_cast<int>(
+                reinterpret_cast<long>(pthread_getspecific(tx_key)));
+    };
+
+    void set_tx_depth(int depth)
+    {
+        pthread_setspecific(tx_key,
+                reinterpret_cast<void *>(static_cast<long>(depth)));
+    };
+
+    /**
+     *  Adds the next write to the open batch, starting a new one if needed.
+     *  Must be called with the writer connection locked.
+     *    @return the batch or 0 if the write is not part of a batch
+     */
+    Batch * join_batch();
+
+    /**
+     *  Commits the open batch, if any. Must be called with the writer
+     *  connection locked.
+     */
+    void close_batch();
+
+    /**
+     *  Ends the transaction of the calling thread
+     *    @param do_commit true to commit the transaction
+     *    @return 0 if the transaction was committed
+     */
+    int end_transaction(bool do_commit);
+
+    /**
+     *  Opens a connection to the database
+     *    @param db_name path to the database file
+     *    @param flags for sqlite3_open_v2
+     *    @param conn the connection
+     *    @return 0 on success
+     */
+    int open_connection(const string& db_name, int flags, Connection& conn);
+
+    /**
+     *  Finalizes the statements and closes a connection
+     */
+    void close_connection(Connection& conn);
+
+    /**
+     *  Gets the prepared statement for a SQL command, the statement is
+     *  prepared and added to the connection cache if needed.
+     *    @param conn the connection, must be checked out by the caller
+     *    @param sql the SQL command
+     *    @return the statement or 0 in case of error
+     */
+    sqlite3_stmt * get_stmt(Connection * conn, const string& sql);
+
+    /**
+     *  Finalizes a statement of the connection cache to make room for a new
+     *  one, recently used statements get a second chance.
+     *    @param conn the connection, must be checked out by the caller
+     */
+    void replace_stmt(Connection * conn);
 };
 #else
 //CLass stub
@@ -106,14 +340,20 @@ class SqliteDB : public SqlDB
 {
 public:
 
-    SqliteDB(string& db_name)
+    SqliteDB(string& db_name, int readers = 0, int group_commit = 0)
     {
         throw runtime_error("Aborting oned, Sqlite support not compiled!");
     };
 
     ~SqliteDB(){};
 
-    int exec(ostringstream& cmd, Callbackable* obj=0){return -1;};
+    int exec(ostringstream& cmd, SqlCallback* cb=0){return -1;};
+
+    int begin(){return -1;};
+
+    int commit(){return -1;};
+
+    int rollback(){return -1;};
 
     char * escape_str(const string& str){return 0;};
 
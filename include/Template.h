@@ -85,6 +85,18 @@ public:
      */
     int parse(const char * filename, char **error_msg);
 
+    /**
+     *  Parse a string of KEY=VALUE pairs separated by commas or new lines, as
+     *  produced by the monitoring probes. Single attributes are parsed in one
+     *  pass without the template grammar, vector
+     *  attributes are handed to parse(const string&, char **).
+     *    @param parse_str string with the attributes
+     *    @param error_msg error string, must be freed by the calling function.
+     *    This string is null if no error occurred.
+     *    @return 0 on success.
+     */
+    int parse_kv(const string &parse_str, char **error_msg);
+
     /**
      *  Parse a string representing the template, automatically detecting if
      *  it is the default syntax, or an XML template. Each attribute is inserted
@@ -338,10 +350,6 @@ protected:
 private:
 
     bool                            replace_mode;
-    /**
-     *  Mutex to perform just one flex-bison parsing at a time
-     */
-    static pthread_mutex_t			mutex;
 
     /**
      * Character to separate key from value when dump onto a string
@@ -206,6 +206,22 @@ private:
                (MadManager::get(0,_name,transfer_driver_name));
     };
 
+    /**
+     *  Sends a transfer script to the driver.
+     *    @param tm_md the TM driver
+     *    @param vid the VM id
+     *    @param xfr_name path of the transfer script
+     *    @param action name of the action, for the error message
+     *    @param os error message if the transfer could not be sent
+     *    @return 0 on success, -1 if the driver is busy
+     */
+    int send_transfer(
+        const TransferManagerDriver *   tm_md,
+        int                             vid,
+        const string&                   xfr_name,
+        const char *                    action,
+        ostringstream&                  os);
+
     /**
      *  Function to execute the Manager action loop method within a new pthread
      * (requires C linkage)
@@ -68,8 +68,9 @@ private:
      *  Sends a transfer request to the MAD: "TRANSFER    ID    XFR_FILE"
      *    @param oid the virtual machine id.
      *    @param xfr_file is the path to the transfer script
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void transfer (const int oid, const string& xfr_file) const;
+    int transfer (const int oid, const string& xfr_file) const;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -1057,12 +1057,24 @@ private:
         int rc;
 
         ostringstream oss_vm(VirtualMachine::db_bootstrap);
+        ostringstream oss_index(VirtualMachine::db_index);
         ostringstream oss_monit(VirtualMachine::monit_db_bootstrap);
+        ostringstream oss_monit_idx(VirtualMachine::monit_db_index);
+        ostringstream oss_rollup(VirtualMachine::monit_rollup_db_bootstrap);
+        ostringstream oss_rollup_idx(VirtualMachine::monit_rollup_db_index);
         ostringstream oss_hist(History::db_bootstrap);
+        ostringstream oss_stime(History::stime_db_index);
+        ostringstream oss_etime(History::etime_db_index);
 
         rc =  db->exec(oss_vm);
+        rc += db->exec(oss_index);
         rc += db->exec(oss_monit);
+        rc += db->exec(oss_monit_idx);
+        rc += db->exec(oss_rollup);
+        rc += db->exec(oss_rollup_idx);
         rc += db->exec(oss_hist);
+        rc += db->exec(oss_stime);
+        rc += db->exec(oss_etime);
 
         return rc;
     };
@@ -1117,22 +1129,16 @@ private:
     };
 
     /**
-     * Inserts the last monitoring, and deletes old monitoring entries.
-     *
-     * @param db pointer to the db
-     * @return 0 on success
+     *  Gets the current values of the monitoring metrics, in the same order
+     *  as VirtualMachine::monit_metrics
+     *    @param values of the metrics
      */
-    int update_monitoring(SqlDB * db);
+    void get_monitoring(vector<long long>& values) const;
 
     // -------------------------------------------------------------------------
     // Attribute Parser
     // -------------------------------------------------------------------------
 
-    /**
-     * Mutex to perform just one attribute parse at a time
-     */
-    static pthread_mutex_t lex_mutex;
-
     /**
      *  Generates image attributes (DS_ID, TM_MAD, SOURCE...) for KERNEL and
      *  INITRD files.
@@ -1221,18 +1227,29 @@ protected:
 
     static const char * db_bootstrap;
 
-    static const char * monit_table;
+    static const char * db_index;
 
-    static const char * monit_db_names;
+    static const char * monit_table;
 
     static const char * monit_db_bootstrap;
 
+    static const char * monit_db_index;
+
+    static const char * monit_metrics[];
+
+    static const char * monit_rollup_table;
+
+    static const char * monit_rollup_db_bootstrap;
+
+    static const char * monit_rollup_db_index;
+
     /**
-     *  Reads the Virtual Machine (identified with its OID) from the database.
+     *  Reads the Virtual Machine history records from the database, and
+     *  creates its log and support directories.
      *    @param db pointer to the db
      *    @return 0 on success
      */
-    int select(SqlDB * db);
+    int post_select(SqlDB * db);
 
     /**
      *  Writes the Virtual Machine and its associated template in the database.
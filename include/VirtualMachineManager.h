@@ -97,6 +97,31 @@ public:
      */
     void load_mads(int uid);
 
+    /**
+     *  Formats the driver message for the POLL action. Polling only needs
+     *  the host and the hypervisor id of the VM, so the message is a plain
+     *  list of attributes without the VM XML representation (not base64
+     *  encoded): "HOST=<hostname>,DEPLOY_ID=<domain>"
+     *    @param hostname of the host where the VM is running
+     *    @param domain domain id as returned by the hypervisor
+     *    @return the driver message
+     */
+    static string format_poll_message(
+        const string& hostname,
+        const string& domain);
+
+    /**
+     *  Formats the driver message for the POLL_HOST action, same format as
+     *  the POLL message with a VM attribute for each VM to poll:
+     *  "HOST=<hostname>,VM=<vid>:<domain>,VM=<vid>:<domain>..."
+     *    @param hostname of the host to poll
+     *    @param vms the VMs to poll, pairs of VM id and domain id
+     *    @return the driver message
+     */
+    static string format_poll_host_message(
+        const string&                     hostname,
+        const vector< pair<int,string> >& vms);
+
 private:
     /**
      *  Thread id for the Virtual Machine Manager
@@ -205,6 +230,8 @@ private:
      *    @param tm_command Transfer Manager command to attach/detach, if any
      *    @param disk_target_path Path of the disk to attach, if any
      *    @param tmpl the VM information in XML
+     *    @return the XML document, it has to be freed by the caller. It is
+     *    encoded (if needed) when sent to the driver.
      */
     string * format_message(
         const string& hostname,
@@ -219,6 +246,7 @@ private:
         const string& disk_target_path,
         const string& tmpl);
 
+
     /**
      *  Function executed when a DEPLOY action is received. It deploys a VM on
      *  a Host.
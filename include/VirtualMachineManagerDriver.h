@@ -43,7 +43,10 @@ public:
         bool                        sudo,
         VirtualMachinePool *        pool);
 
-    virtual ~VirtualMachineManagerDriver(){};
+    virtual ~VirtualMachineManagerDriver()
+    {
+        pthread_mutex_destroy(&poll_host_mutex);
+    };
 
     /**
      *  Implements the VM Manager driver protocol.
@@ -67,6 +70,16 @@ public:
     virtual int deployment_description(
         const VirtualMachine *  vm,
         const string&           file_name) const = 0;
+
+    /**
+     *  Checks if the driver can monitor all the VMs of a host in a single
+     *  POLL_HOST action (POLL_HOST = "yes" in the VM_MAD configuration)
+     *    @return true if POLL_HOST is supported
+     */
+    bool is_poll_host() const
+    {
+        return poll_host_enabled;
+    };
     
 protected:	
     /**
@@ -107,90 +120,138 @@ private:
      */
     VirtualMachinePool * vmpool;
 
+    /**
+     *  True if the driver implements the POLL_HOST action
+     */
+    bool                 poll_host_enabled;
+
+    /**
+     *  VMs of the POLL_HOST requests in progress of each host, the errors
+     *  of a request are reported in its VMs. Protected by poll_host_mutex.
+     */
+    mutable map<int, vector<int> > poll_host_vms;
+
+    mutable pthread_mutex_t        poll_host_mutex;
+
+    /**
+     *  Updates the VM with the monitoring information sent by the driver in
+     *  a POLL or POLL_HOST response: "VAR=VAL VAR=VAL ...". The VM has to be
+     *  locked, it is not unlocked by this function.
+     *    @param vm the virtual machine
+     *    @param monitor_str the monitoring information
+     */
+    void process_poll(VirtualMachine * vm, const string& monitor_str);
+
+    /**
+     *  Updates the VMs of a host with a POLL_HOST response. Each VM is
+     *  reported in a VM=[ID=<vid>,DEPLOY_ID=<deploy_id>,POLL="<info>"]
+     *  attribute.
+     *    @param hid the host id
+     *    @param result of the driver action (SUCCESS or FAILURE)
+     *    @param info the rest of the driver message
+     */
+    void process_poll_host(int hid, const string& result, const string& info);
+
+    /**
+     *  Gets a VM of a POLL_HOST response, if it is still in the host
+     *    @param vid the VM id
+     *    @param hid the host id
+     *    @return the VM locked, or 0 if it no longer exists or has left the
+     *    host since the POLL_HOST was sent
+     */
+    VirtualMachine * get_host_vm(int vid, int hid);
+
     friend class VirtualMachineManager;
       
     /**
      *  Sends a deploy request to the MAD: "DEPLOY ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void deploy (
+    int deploy (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("DEPLOY", oid, drv_msg);
+        return write_drv_xml("DEPLOY", oid, drv_msg);
     }
 
     /**
      *  Sends a shutdown request to the MAD: "SHUTDOWN ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void shutdown (
+    int shutdown (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("SHUTDOWN", oid, drv_msg);
+        return write_drv_xml("SHUTDOWN", oid, drv_msg);
     }
 
     /**
      *  Sends a reset request to the MAD: "RESET ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void reset (
+    int reset (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("RESET", oid, drv_msg);
+        return write_drv_xml("RESET", oid, drv_msg);
     }
 
     /**
      *  Sends a reboot request to the MAD: "REBOOT ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void reboot (
+    int reboot (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("REBOOT", oid, drv_msg);
+        return write_drv_xml("REBOOT", oid, drv_msg);
     }
 
     /**
      *  Sends a cancel request to the MAD: "CANCEL ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void cancel (
+    int cancel (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("CANCEL", oid, drv_msg);
+        return write_drv_xml("CANCEL", oid, drv_msg);
     }
 
     /**
      *  Sends a checkpoint request to the MAD: "CHECKPOINT ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void checkpoint (
+    int checkpoint (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("CHECKPOINT", oid, drv_msg);
+        return write_drv_xml("CHECKPOINT", oid, drv_msg);
     }
 
     /**
      *  Sends a save request to the MAD: "SAVE ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void save (
+    int save (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("SAVE", oid, drv_msg);
+        return write_drv_xml("SAVE", oid, drv_msg);
     }
 
 
@@ -198,12 +259,13 @@ private:
      *  Sends a save request to the MAD: "RESTORE ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void restore (
+    int restore (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("RESTORE", oid, drv_msg);
+        return write_drv_xml("RESTORE", oid, drv_msg);
     }
 
 
@@ -211,61 +273,90 @@ private:
      *  Sends a migrate request to the MAD: "MIGRATE ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void migrate (
+    int migrate (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("MIGRATE", oid, drv_msg);
+        return write_drv_xml("MIGRATE", oid, drv_msg);
     }
 
     /**
-     *  Sends a poll request to the MAD: "POLL ID XML_DRV_MSG"
+     *  Sends a poll request to the MAD: "POLL ID DRV_MSG"
      *    @param oid the virtual machine id.
-     *    @param drv_msg xml data for the mad operation
+     *    @param drv_msg data for the mad operation, as formatted by
+     *    VirtualMachineManager::format_poll_message
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void poll (
+    int poll (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("POLL", oid, drv_msg);
-
+        return write_drv("POLL", oid, drv_msg);
     }
 
+    /**
+     *  Sends a poll request for all the VMs in a host to the MAD:
+     *  "POLL_HOST HID DRV_MSG"
+     *    @param hid the host id.
+     *    @param vids the VMs in the request
+     *    @param drv_msg data for the mad operation, as formatted by
+     *    VirtualMachineManager::format_poll_host_message
+     *    @return 0 on success, -1 if the message could not be sent
+     */
+    int poll_host (
+        const int           hid,
+        const vector<int>&  vids,
+        const string&       drv_msg) const;
+
     /**
      *  Sends an attach request to the MAD: "ATTACH ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void attach (
+    int attach (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("ATTACHDISK", oid, drv_msg);
+        return write_drv_xml("ATTACHDISK", oid, drv_msg);
     }
 
     /**
      *  Sends a detach request to the MAD: "DETACH ID XML_DRV_MSG"
      *    @param oid the virtual machine id.
      *    @param drv_msg xml data for the mad operation
+     *    @return 0 on success, -1 if the message could not be sent
      */
-    void detach (
+    int detach (
         const int     oid,
         const string& drv_msg) const
     {
-        write_drv("DETACHDISK", oid, drv_msg);
+        return write_drv_xml("DETACHDISK", oid, drv_msg);
     }
 
 private:
 
-    void write_drv(const char * aname, const int oid, const string& msg) const
+    int write_drv(const char * aname, const int oid, const string& msg) const
     {
         ostringstream os;
 
         os << aname << " " << oid << " " << msg << endl;
     
-        write(os);
+        return write(os);
     }
+
+    /**
+     *  Sends an action with a VMM_DRIVER_ACTION_DATA document to the driver.
+     *  The XML is sent as is to framed drivers, and base64 encoded to the
+     *  rest of the drivers.
+     *    @param aname name of the action
+     *    @param oid the virtual machine id
+     *    @param xml the VMM_DRIVER_ACTION_DATA document
+     *    @return 0 on success, -1 if the message could not be sent
+     */
+    int write_drv_xml(const char * aname, const int oid, const string& xml) const;
 };
 
 /* -------------------------------------------------------------------------- */
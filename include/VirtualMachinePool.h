@@ -19,6 +19,7 @@
 
 #include "PoolSQL.h"
 #include "VirtualMachine.h"
+#include "MonitoringStore.h"
 
 #include <time.h>
 
@@ -38,6 +39,7 @@ public:
                        const string&                remotes_location,
                        vector<const Attribute *>&   restricted_attrs,
                        time_t                       expire_time,
+                       const vector<const Attribute *>& rollups,
                        bool                         on_hold);
 
     ~VirtualMachinePool(){};
@@ -145,8 +147,7 @@ public:
     }
 
     /**
-     * Inserts the last monitoring, and deletes old monitoring entries for this
-     * VM
+     * Adds the last monitoring values of the VM to its monitoring series
      *
      * @param vm pointer to the virtual machine object
      * @return 0 on success
@@ -154,21 +155,31 @@ public:
     int update_monitoring(
         VirtualMachine * vm)
     {
-        if ( _monitor_expiration <= 0 )
-        {
-            return 0;
-        }
+        vector<long long> values;
+
+        vm->get_monitoring(values);
 
-        return vm->update_monitoring(db);
+        return monitoring.add(db, vm->get_oid(), vm->get_last_poll(), values);
     };
 
     /**
-     * Deletes the expired monitoring entries for all VMs
+     * Deletes the expired monitoring entries and rollups for all VMs
      *
      * @return 0 on success
      */
     int clean_expired_monitoring();
 
+    /**
+     * Checks if the monitoring information is available with a resolution
+     *
+     * @param resolution of the rollups, 0 for the samples
+     * @return true if there are rollups of the given resolution
+     */
+    bool has_monitoring_resolution(int resolution)
+    {
+        return monitoring.has_resolution(resolution);
+    };
+
     /**
      * Deletes all monitoring entries for all VMs
      *
@@ -218,11 +229,13 @@ public:
      *
      *  @param oss the output stream to dump the pool contents
      *  @param where filter for the objects, defaults to all
+     *  @param resolution of the monitoring rollups, 0 for the samples
      *
      *  @return 0 on success
      */
     int dump_monitoring(ostringstream& oss,
-                        const string&  where);
+                        const string&  where,
+                        int            resolution = 0);
 
     /**
      *  Dumps the VM monitoring information  for a single VM
@@ -257,6 +270,11 @@ private:
      */
     static time_t _monitor_expiration;
 
+    /**
+     * Monitoring samples of the VMs
+     */
+    MonitoringStore monitoring;
+
     /**
      * True or false whether to submit new VM on HOLD or not
      */
@@ -316,21 +316,15 @@ private:
     static const char * db_bootstrap;
 
     /**
-     *  Reads the Virtual Network (identified with its OID) from the database.
+     *  Reads the Virtual Network leases once the network is rebuilt from the
+     *  database.
      *    @param db pointer to the db
      *    @return 0 on success
      */
-    int select(SqlDB * db);
-
-    /**
-     *  Reads the Virtual Network (identified with its OID) from the database.
-     *    @param db pointer to the db
-     *    @param name of the network
-     *    @param uid of the owner 
-     * 
-     *    @return 0 on success
-     */
-    int select(SqlDB * db, const string& name, int uid);
+    int post_select(SqlDB * db)
+    {
+        return select_leases(db);
+    };
 
     /**
      *  Reads the Virtual Network leases from the database.
@@ -0,0 +1,171 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <pthread.h>
+#include <time.h>
+#include <sys/time.h>
+
+using namespace std;
+
+/**
+ *  Column of a benchmark report. A negative width aligns the column to the
+ *  left.
+ */
+struct BenchColumn
+{
+    const char * name;
+    int          width;
+    int          precision;
+};
+
+/**
+ *  Timing and report helpers of the benchmark programs in the test
+ *  directories.
+ */
+class Benchmark
+{
+public:
+    /**
+     *  Prints the title of the report and the header of its columns. The
+     *  values of each row are then written with operator<<, one per column.
+     *    @param title of the report
+     *    @param columns of the report
+     *    @param num number of columns
+     */
+    Benchmark(const string& title, const BenchColumn * _columns, int num):
+        columns(_columns), num_columns(num), column(0)
+    {
+        cout << title << endl << endl;
+
+        for (int i = 0 ; i < num_columns ; i++)
+        {
+            set_column(i);
+
+            cout << columns[i].name;
+        }
+
+        cout << endl;
+    };
+
+    ~Benchmark(){};
+
+    Benchmark& operator<<(double value)
+    {
+        set_column(column);
+
+        cout << fixed << setprecision(columns[column].precision) << value;
+
+        return next();
+    };
+
+    Benchmark& operator<<(const string& value)
+    {
+        set_column(column);
+
+        cout << value;
+
+        return next();
+    };
+
+    /**
+     *  Wall clock time
+     *    @return the time in milliseconds
+     */
+    static double now_ms()
+    {
+        struct timeval tv;
+
+        gettimeofday(&tv, 0);
+
+        return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+    };
+
+    /**
+     *  CPU time of the process
+     *    @return the time in milliseconds
+     */
+    static double cpu_ms()
+    {
+        return clock() * 1000.0 / CLOCKS_PER_SEC;
+    };
+
+    /**
+     *  Runs a function in several threads, each one gets its own element of
+     *  the args array.
+     *    @param loop function run by the threads
+     *    @param args of the threads, num_threads elements
+     *    @param num_threads number of threads
+     *    @return the time in milliseconds until all the threads end
+     */
+    template<class T>
+    static double run_threads(void * (*loop)(void *), T * args,
+                              int num_threads)
+    {
+        pthread_t * threads = new pthread_t[num_threads];
+        double      start   = now_ms();
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_create(&threads[i], 0, loop, &args[i]);
+        }
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_join(threads[i], 0);
+        }
+
+        delete [] threads;
+
+        return now_ms() - start;
+    };
+
+private:
+    const BenchColumn * columns;
+    int                 num_columns;
+    int                 column;
+
+    void set_column(int i)
+    {
+        if ( columns[i].width < 0 )
+        {
+            cout << left << setw(-columns[i].width);
+        }
+        else
+        {
+            cout << right << setw(columns[i].width);
+        }
+    };
+
+    Benchmark& next()
+    {
+        if ( ++column == num_columns )
+        {
+            cout << endl;
+
+            column = 0;
+        }
+
+        return *this;
+    };
+};
+
+#endif /*BENCHMARK_H_*/
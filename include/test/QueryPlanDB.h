@@ -0,0 +1,161 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#ifndef QUERY_PLAN_DB_H_
+#define QUERY_PLAN_DB_H_
+
+#include <string>
+#include <sstream>
+#include <vector>
+
+#include "SqlDB.h"
+
+using namespace std;
+
+/**
+ *  SqlDB wrapper to check the query plans of the pools. Every statement is
+ *  executed in the wrapped Sqlite DB, and the plan of the SELECT statements
+ *  is obtained first with EXPLAIN QUERY PLAN.
+ */
+class QueryPlanDB : public SqlDB, public Callbackable
+{
+public:
+
+    QueryPlanDB(SqlDB * _db):db(_db){};
+
+    ~QueryPlanDB(){};
+
+    int exec(ostringstream& cmd, SqlCallback* cb=0)
+    {
+        string sql = cmd.str();
+
+        if ( sql.compare(0, 6, "SELECT") == 0 )
+        {
+            ostringstream oss;
+
+            SqlCallback plan_cb(this,
+                static_cast<Callbackable::Callback>(&QueryPlanDB::plan_cb));
+
+            oss << "EXPLAIN QUERY PLAN " << sql;
+
+            db->exec(oss, &plan_cb);
+        }
+
+        return db->exec(cmd, cb);
+    };
+
+    int begin()
+    {
+        return db->begin();
+    };
+
+    int commit()
+    {
+        return db->commit();
+    };
+
+    int rollback()
+    {
+        return db->rollback();
+    };
+
+    char * escape_str(const string& str)
+    {
+        return db->escape_str(str);
+    };
+
+    void free_str(char * str)
+    {
+        db->free_str(str);
+    };
+
+    /**
+     *  Removes the plans of the previous statements
+     */
+    void clear()
+    {
+        plan.clear();
+    };
+
+    /**
+     *  @return true if a table is scanned without an index
+     */
+    bool full_scan()
+    {
+        for (unsigned int i = 0; i < plan.size(); i++)
+        {
+            if ( plan[i].compare(0, 4, "SCAN") == 0 &&
+                 plan[i].find("INDEX") == string::npos )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    /**
+     *  @return true if the results are sorted in a temporary b-tree
+     */
+    bool temp_sort()
+    {
+        return find("TEMP B-TREE");
+    };
+
+    /**
+     *  @param index name
+     *  @return true if the index is used
+     */
+    bool uses_index(const string& index)
+    {
+        return find("INDEX " + index);
+    };
+
+    /**
+     *  Plan of the executed SELECT statements, one step per element
+     */
+    vector<string> plan;
+
+private:
+
+    SqlDB * db;
+
+    bool find(const string& str)
+    {
+        for (unsigned int i = 0; i < plan.size(); i++)
+        {
+            if ( plan[i].find(str) != string::npos )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    int plan_cb(void * nil, int num, char **values, char **names)
+    {
+        // The step description is the last column of the plan
+        if ( num > 0 && values[num-1] != 0 )
+        {
+            plan.push_back(values[num-1]);
+        }
+
+        return 0;
+    };
+};
+
+#endif /*QUERY_PLAN_DB_H_*/
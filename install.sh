@@ -780,7 +780,8 @@ VMM_EXEC_VMWARE_SCRIPTS="src/vmm_mad/remotes/vmware/cancel \
 # Information Manager Probes, to be installed under $REMOTES_LOCATION/im
 #-------------------------------------------------------------------------------
 
-IM_PROBES_FILES="src/im_mad/remotes/run_probes"
+IM_PROBES_FILES="src/im_mad/remotes/run_probes \
+                 src/im_mad/remotes/push_probes"
 
 IM_PROBES_KVM_FILES="src/im_mad/remotes/kvm.d/kvm.rb \
                      src/im_mad/remotes/kvm.d/architecture.sh \
@@ -10,6 +10,8 @@ TESTS="$TWD_DIR/vnm/test \
        $TWD_DIR/scheduler/src/pool/test \
        $TWD_DIR/common/test \
        $TWD_DIR/host/test \
+       $TWD_DIR/im/test \
+       $TWD_DIR/mad/test \
        $TWD_DIR/template/test \
        $TWD_DIR/image/test \
        $TWD_DIR/authm/test \
@@ -53,14 +53,13 @@ AclManager::AclManager(SqlDB * _db) : db(_db), lastOID(-1)
 
     pthread_mutex_init(&mutex, 0);
 
-    set_callback(static_cast<Callbackable::Callback> (&AclManager::init_cb));
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&AclManager::init_cb));
 
     oss << "SELECT last_oid FROM pool_control WHERE tablename='" << table
             << "'";
 
-    db->exec(oss, this);
-
-    unset_callback();
+    db->exec(oss, &cb);
 
     if (lastOID == -1)
     {
@@ -850,11 +849,10 @@ int AclManager::select()
 
     oss << "SELECT " << db_names << " FROM " << table;
 
-    set_callback(static_cast<Callbackable::Callback>(&AclManager::select_cb));
-
-    rc = db->exec(oss,this);
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&AclManager::select_cb));
 
-    unset_callback();
+    rc = db->exec(oss, &cb);
 
     return rc;
 }
@@ -70,6 +70,48 @@ string * SSLTools::base64_encode(const string& in)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+string * SSLTools::base64_decode(const string& in)
+{
+    BIO *     bio_mem;
+    BIO *     bio_64;
+
+    char *    decoded_c;
+    int       size = 0;
+    int       rc;
+
+    decoded_c = new char[in.length() + 1];
+
+    bio_64  = BIO_new(BIO_f_base64());
+    bio_mem = BIO_new_mem_buf((void *) in.c_str(), in.length());
+
+    BIO_push(bio_64, bio_mem);
+
+    BIO_set_flags(bio_64,BIO_FLAGS_BASE64_NO_NL);
+
+    // The base64 BIO may return the decoded data in several reads
+    while ((rc = BIO_read(bio_64, decoded_c + size, in.length() - size)) > 0)
+    {
+        size += rc;
+    }
+
+    BIO_free_all(bio_64);
+
+    if ( rc < 0 )
+    {
+        delete [] decoded_c;
+        return 0;
+    }
+
+    string * decoded = new string(decoded_c, size);
+
+    delete [] decoded_c;
+
+    return decoded;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 string SSLTools::sha1_digest(const string& in)
 {
     EVP_MD_CTX     mdctx;
@@ -96,3 +138,22 @@ string SSLTools::sha1_digest(const string& in)
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
+
+string SSLTools::hmac_sha1(const string& key, const string& in)
+{
+    unsigned char  md_value[EVP_MAX_MD_SIZE];
+    unsigned int   md_len;
+    ostringstream  oss;
+
+    HMAC(EVP_sha1(), key.c_str(), key.length(),
+         reinterpret_cast<const unsigned char *>(in.c_str()), in.length(),
+         md_value, &md_len);
+
+    for(unsigned int i = 0; i<md_len; i++)
+    {
+        oss << setfill('0') << setw(2) << hex << nouppercase
+            << (unsigned short) md_value[i];
+    }
+
+    return oss.str();
+}
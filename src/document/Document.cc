@@ -104,32 +104,14 @@ int Document::insert(SqlDB *db, string& error_str)
 int Document::insert_replace(SqlDB *db, bool replace, string& error_str)
 {
     ostringstream   oss;
+    SqlParams       params;
 
-    int    rc;
     string xml_body;
 
-    char * sql_name;
-    char * sql_xml;
-
-   // Update the Object
-
-    sql_name = db->escape_str(name.c_str());
-
-    if ( sql_name == 0 )
+    if ( validate_xml(to_xml(xml_body)) != 0 )
     {
-        goto error_name;
-    }
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
-    if ( validate_xml(sql_xml) != 0 )
-    {
-        goto error_xml;
+        error_str = "Error transforming the Document to XML.";
+        return -1;
     }
 
     if(replace)
@@ -144,42 +126,19 @@ int Document::insert_replace(SqlDB *db, bool replace, string& error_str)
     // Construct the SQL statement to Insert or Replace
 
     oss <<" INTO " << table <<" ("<< db_names <<") VALUES ("
-        <<            oid        << ","
-        << "'"     << sql_name   << "',"
-        << "'"     << sql_xml    << "',"
-        <<            type       << ","
-        <<            uid        << ","
-        <<            gid        << ","
-        <<            owner_u    << ","
-        <<            group_u    << ","
-        <<            other_u    << ")";
-
-    rc = db->exec(oss);
-
-    db->free_str(sql_name);
-    db->free_str(sql_xml);
-
-    return rc;
-
-error_xml:
-    db->free_str(sql_name);
-    db->free_str(sql_xml);
-
-    error_str = "Error transforming the Document to XML.";
-
-    goto error_common;
-
-error_body:
-    db->free_str(sql_name);
-    goto error_generic;
-
-error_name:
-    goto error_generic;
-
-error_generic:
-    error_str = "Error inserting Document in DB.";
-error_common:
-    return -1;
+        << "?,?,?,?,?,?,?,?,?)";
+
+    params.add(oid)
+          .add(name)
+          .add(xml_body)
+          .add(type)
+          .add(uid)
+          .add(gid)
+          .add(owner_u)
+          .add(group_u)
+          .add(other_u);
+
+    return db->exec(oss, params);
 }
 
 /* ************************************************************************ */
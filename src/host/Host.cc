@@ -61,58 +61,71 @@ Host::~Host()
 
 const char * Host::table = "host_pool";
 
-const char * Host::db_names =
-    "oid, name, body, state, last_mon_time, uid, gid, owner_u, group_u, other_u";
+const char * Host::db_names = "oid, name, body, state, last_mon_time, uid, "
+    "gid, owner_u, group_u, other_u, im_mad";
 
+// The IM driver is also stored in a column, so the hosts to monitor are
+// discovered without parsing their bodies (HostPool::discover)
 const char * Host::db_bootstrap = "CREATE TABLE IF NOT EXISTS host_pool ("
     "oid INTEGER PRIMARY KEY, name VARCHAR(128), body TEXT, state INTEGER, "
     "last_mon_time INTEGER, uid INTEGER, gid INTEGER, owner_u INTEGER, "
-    "group_u INTEGER, other_u INTEGER, UNIQUE(name))";
+    "group_u INTEGER, other_u INTEGER, im_mad VARCHAR(128), UNIQUE(name))";
 
+// Index to discover the hosts to monitor (HostPool::discover)
+const char * Host::db_index =
+    "CREATE INDEX host_pool_mon_idx ON host_pool (last_mon_time)";
 
-const char * Host::monit_table = "host_monitoring";
 
-const char * Host::monit_db_names = "hid, last_mon_time, body";
+const char * Host::monit_table = "host_monitoring";
 
 const char * Host::monit_db_bootstrap = "CREATE TABLE IF NOT EXISTS "
-    "host_monitoring (hid INTEGER, last_mon_time INTEGER, body TEXT, "
-    "PRIMARY KEY(hid, last_mon_time))";
+    "host_monitoring (hid INTEGER, start_time INTEGER, last_time INTEGER, "
+    "body TEXT, PRIMARY KEY(hid, start_time))";
+
+// Index to delete the expired samples (MonitoringStore::clean_expired)
+const char * Host::monit_db_index = "CREATE INDEX host_monitoring_time_idx "
+    "ON host_monitoring (last_time)";
+
+const char * Host::monit_rollup_table = "host_monitoring_rollup";
+
+const char * Host::monit_rollup_db_bootstrap = "CREATE TABLE IF NOT EXISTS "
+    "host_monitoring_rollup (hid INTEGER, resolution INTEGER, "
+    "start_time INTEGER, body TEXT, PRIMARY KEY(hid, resolution, start_time))";
+
+// Index to delete the expired rollups (MonitoringStore::clean_expired)
+const char * Host::monit_rollup_db_index = "CREATE INDEX "
+    "host_monitoring_rollup_idx ON host_monitoring_rollup (resolution, "
+    "start_time)";
+
+// Metrics of the monitoring samples (MonitoringStore), the sample time is
+// LAST_MON_TIME
+const char * Host::monit_metrics[] = {
+    "STATE",
+    "DISK_USAGE", "MEM_USAGE", "CPU_USAGE",
+    "MAX_DISK",   "MAX_MEM",   "MAX_CPU",
+    "FREE_DISK",  "FREE_MEM",  "FREE_CPU",
+    "USED_DISK",  "USED_MEM",  "USED_CPU",
+    "RUNNING_VMS",
+    0
+};
 /* ------------------------------------------------------------------------ */
 /* ------------------------------------------------------------------------ */
 
 int Host::insert_replace(SqlDB *db, bool replace, string& error_str)
 {
     ostringstream   oss;
+    SqlParams       params;
 
-    int    rc;
     string xml_body;
 
-    char * sql_hostname;
-    char * sql_xml;
-
     // Set the owner and group to oneadmin
     set_user(0, "");
     set_group(GroupPool::ONEADMIN_ID, GroupPool::ONEADMIN_NAME);
 
-   // Update the Host
-
-    sql_hostname = db->escape_str(name.c_str());
-
-    if ( sql_hostname == 0 )
+    if ( validate_xml(to_xml(xml_body)) != 0 )
     {
-        goto error_hostname;
-    }
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
-    if ( validate_xml(sql_xml) != 0 )
-    {
-        goto error_xml;
+        error_str = "Error transforming the Host to XML.";
+        return -1;
     }
 
     if(replace)
@@ -127,43 +140,21 @@ int Host::insert_replace(SqlDB *db, bool replace, string& error_str)
     // Construct the SQL statement to Insert or Replace
 
     oss <<" INTO "<<table <<" ("<< db_names <<") VALUES ("
-        <<          oid                 << ","
-        << "'" <<   sql_hostname        << "',"
-        << "'" <<   sql_xml             << "',"
-        <<          state               << ","
-        <<          last_monitored      << ","
-        <<          uid                 << ","
-        <<          gid                 << ","
-        <<          owner_u             << ","
-        <<          group_u             << ","
-        <<          other_u             << ")";
-
-    rc = db->exec(oss);
-
-    db->free_str(sql_hostname);
-    db->free_str(sql_xml);
-
-    return rc;
-
-error_xml:
-    db->free_str(sql_hostname);
-    db->free_str(sql_xml);
-
-    error_str = "Error transforming the Host to XML.";
-
-    goto error_common;
-
-error_body:
-    db->free_str(sql_hostname);
-    goto error_generic;
-
-error_hostname:
-    goto error_generic;
-
-error_generic:
-    error_str = "Error inserting Host in DB.";
-error_common:
-    return -1;
+        << "?,?,?,?,?,?,?,?,?,?,?)";
+
+    params.add(oid)
+          .add(name)
+          .add(xml_body)
+          .add(state)
+          .add(last_monitored)
+          .add(uid)
+          .add(gid)
+          .add(owner_u)
+          .add(group_u)
+          .add(other_u)
+          .add(im_mad_name);
+
+    return db->exec(oss, params);
 }
 
 /* ------------------------------------------------------------------------ */
@@ -175,7 +166,7 @@ int Host::update_info(string &parse_str)
     int     rc;
     float   fv;
 
-    rc = obj_template->parse(parse_str, &error_msg);
+    rc = obj_template->parse_kv(parse_str, &error_msg);
 
     if ( rc != 0 )
     {
@@ -206,55 +197,29 @@ int Host::update_info(string &parse_str)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int Host::update_monitoring(SqlDB * db)
+void Host::get_monitoring(vector<long long>& values) const
 {
-    ostringstream   oss;
-    int             rc;
-
-    string xml_body;
-    string error_str;
-    char * sql_xml;
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
-    if ( validate_xml(sql_xml) != 0 )
-    {
-        goto error_xml;
-    }
-
-    oss << "INSERT INTO " << monit_table << " ("<< monit_db_names <<") VALUES ("
-        <<          oid             << ","
-        <<          last_monitored       << ","
-        << "'" <<   sql_xml         << "')";
-
-    db->free_str(sql_xml);
-
-    rc = db->exec(oss);
-
-    return rc;
-
-error_xml:
-    db->free_str(sql_xml);
+    values.clear();
 
-    error_str = "could not transform the Host to XML.";
+    values.push_back(state);
 
-    goto error_common;
+    values.push_back(host_share.disk_usage);
+    values.push_back(host_share.mem_usage);
+    values.push_back(host_share.cpu_usage);
 
-error_body:
-    error_str = "could not insert the Host in the DB.";
+    values.push_back(host_share.max_disk);
+    values.push_back(host_share.max_mem);
+    values.push_back(host_share.max_cpu);
 
-error_common:
-    oss.str("");
-    oss << "Error updating Host monitoring information, " << error_str;
+    values.push_back(host_share.free_disk);
+    values.push_back(host_share.free_mem);
+    values.push_back(host_share.free_cpu);
 
-    NebulaLog::log("ONE",Log::ERROR, oss);
+    values.push_back(host_share.used_disk);
+    values.push_back(host_share.used_mem);
+    values.push_back(host_share.used_cpu);
 
-    return -1;
+    values.push_back(host_share.running_vms);
 }
 
 /* ************************************************************************ */
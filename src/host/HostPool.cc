@@ -38,8 +38,13 @@ HostPool::HostPool(SqlDB*                    db,
                    vector<const Attribute *> hook_mads,
                    const string&             hook_location,
                    const string&             remotes_location,
-                   time_t                    expire_time)
-                        : PoolSQL(db, Host::table, true)
+                   time_t                    expire_time,
+                   const vector<const Attribute *>& rollups)
+                        : PoolSQL(db, Host::table, true),
+                          monitoring(Host::monit_table,
+                                     Host::monit_rollup_table, "hid",
+                                     Host::table, "LAST_MON_TIME",
+                                     Host::monit_metrics, expire_time)
 {
 
     _monitor_expiration = expire_time;
@@ -49,6 +54,8 @@ HostPool::HostPool(SqlDB*                    db,
         clean_all_monitoring();
     }
 
+    monitoring.add_rollups(rollups);
+
     // ------------------ Initialize Hooks for the pool ----------------------
 
     const VectorAttribute * vattr;
@@ -246,9 +253,7 @@ error_common:
 int HostPool::discover_cb(void * _map, int num, char **values, char **names)
 {
     map<int, string> *  discovered_hosts;
-    string              im_mad;
     int                 hid;
-    int                 rc;
 
     discovered_hosts = static_cast<map<int, string> *>(_map);
 
@@ -258,14 +263,8 @@ int HostPool::discover_cb(void * _map, int num, char **values, char **names)
     }
 
     hid = atoi(values[0]);
-    rc  = ObjectXML::xpath_value(im_mad,values[1],"/HOST/IM_MAD");
 
-    if( rc != 0)
-    {
-        return -1;
-    }
-
-    discovered_hosts->insert(make_pair(hid,im_mad));
+    discovered_hosts->insert(make_pair(hid, string(values[1])));
 
     return 0;
 }
@@ -277,16 +276,15 @@ int HostPool::discover(map<int, string> * discovered_hosts, int host_limit)
     ostringstream   sql;
     int             rc;
 
-    set_callback(static_cast<Callbackable::Callback>(&HostPool::discover_cb),
-                 static_cast<void *>(discovered_hosts));
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&HostPool::discover_cb),
+                   static_cast<void *>(discovered_hosts));
 
-    sql << "SELECT oid, body FROM "
+    sql << "SELECT oid, im_mad FROM "
         << Host::table << " WHERE state != "
         << Host::DISABLED << " ORDER BY last_mon_time ASC LIMIT " << host_limit;
 
-    rc = db->exec(sql,this);
-
-    unset_callback();
+    rc = db->exec(sql, &cb);
 
     return rc;
 }
@@ -296,22 +294,10 @@ int HostPool::discover(map<int, string> * discovered_hosts, int host_limit)
 
 int HostPool::dump_monitoring(
         ostringstream& oss,
-        const string&  where)
+        const string&  where,
+        int            resolution)
 {
-    ostringstream cmd;
-
-    cmd << "SELECT " << Host::monit_table << ".body FROM " << Host::monit_table
-        << " INNER JOIN " << Host::table
-        << " WHERE hid = oid";
-
-    if ( !where.empty() )
-    {
-        cmd << " AND " << where;
-    }
-
-    cmd << " ORDER BY hid, " << Host::monit_table << ".last_mon_time;";
-
-    return PoolSQL::dump(oss, "MONITORING_DATA", cmd);
+    return monitoring.dump(db, oss, where, resolution);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -319,23 +305,7 @@ int HostPool::dump_monitoring(
 
 int HostPool::clean_expired_monitoring()
 {
-    if ( _monitor_expiration == 0 )
-    {
-        return 0;
-    }
-
-    int             rc;
-    time_t          max_mon_time;
-    ostringstream   oss;
-
-    max_mon_time = time(0) - _monitor_expiration;
-
-    oss << "DELETE FROM " << Host::monit_table
-        << " WHERE last_mon_time < " << max_mon_time;
-
-    rc = db->exec(oss);
-
-    return rc;
+    return monitoring.clean_expired(db);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -343,12 +313,5 @@ int HostPool::clean_expired_monitoring()
 
 int HostPool::clean_all_monitoring()
 {
-    ostringstream   oss;
-    int             rc;
-
-    oss << "DELETE FROM " << Host::monit_table;
-
-    rc = db->exec(oss);
-
-    return rc;
+    return monitoring.clean_all(db);
 }
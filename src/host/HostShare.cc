@@ -112,6 +112,8 @@ int HostShare::from_xml_node(const xmlNodePtr node)
 
     rc += xpath(running_vms,"/HOST_SHARE/RUNNING_VMS",-1);
 
+    ObjectXML::free_xml();
+
     if (rc != 0)
     {
         return -1;
@@ -20,6 +20,7 @@
 
 #include "HostPool.h"
 #include "PoolTest.h"
+#include "QueryPlanDB.h"
 
 using namespace std;
 
@@ -43,6 +44,7 @@ class HostPoolTest : public PoolTest
     CPPUNIT_TEST (discover);
     CPPUNIT_TEST (duplicates);
     CPPUNIT_TEST (name_index);
+    CPPUNIT_TEST (query_plans);
 
 //    CPPUNIT_TEST (scale_test);
 
@@ -58,8 +60,9 @@ protected:
     PoolSQL* create_pool(SqlDB* db)
     {
         vector<const Attribute *> hook;
+        vector<const Attribute *> rollups;
 
-        return new HostPool(db,hook,"./", "./", 0);
+        return new HostPool(db,hook,"./", "./", 0, rollups);
     };
 
     int allocate(int index)
@@ -395,6 +398,32 @@ public:
 
         CPPUNIT_ASSERT(host_oid == host_name);
     }
+
+    /* ********************************************************************* */
+
+    // The hosts to monitor are read in last_mon_time order from its index
+    void query_plans()
+    {
+        if ( mysql )
+        {
+            return;
+        }
+
+        vector<const Attribute *> hook;
+        vector<const Attribute *> rollups;
+        map<int, string>          dh;
+
+        QueryPlanDB plan_db(db);
+        HostPool    hp(&plan_db, hook, "./", "./", 0, rollups);
+
+        plan_db.clear();
+
+        CPPUNIT_ASSERT(hp.discover(&dh, 10) == 0);
+
+        CPPUNIT_ASSERT(plan_db.uses_index("host_pool_mon_idx"));
+        CPPUNIT_ASSERT(plan_db.full_scan() == false);
+        CPPUNIT_ASSERT(plan_db.temp_sort() == false);
+    }
 };
 
 
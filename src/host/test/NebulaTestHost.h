@@ -81,7 +81,8 @@ public:
         host_hooks.push_back(hook);
 
 
-        return new HostPool(db, host_hooks, hook_location, var_location, 0);
+        return new HostPool(db, host_hooks, hook_location, var_location, 0,
+                            vector<const Attribute *>());
     }
 };
 
@@ -0,0 +1,232 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "NebulaLog.h"
+#include "SqliteDB.h"
+#include "HostPool.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// Time to discover the hosts to monitor (HostPool::discover), with the old
+// query that reads the host bodies and parses them to get the IM driver, and
+// with the current one that reads the im_mad column.
+//
+// Usage: discover_bench [num_hosts] [rounds]
+
+static const char * host_names = "oid, name, body, state, last_mon_time, uid, "
+    "gid, owner_u, group_u, other_u, im_mad";
+
+/* -------------------------------------------------------------------------- */
+
+static string host_body(int oid)
+{
+    ostringstream oss;
+
+    oss << "<HOST><ID>" << oid << "</ID><NAME>host-" << oid << "</NAME>"
+        << "<STATE>2</STATE><IM_MAD>im_kvm</IM_MAD><VM_MAD>vmm_kvm</VM_MAD>"
+        << "<VN_MAD>dummy</VN_MAD><LAST_MON_TIME>" << oid << "</LAST_MON_TIME>"
+        << "<CLUSTER_ID>-1</CLUSTER_ID><CLUSTER></CLUSTER><HOST_SHARE>"
+        << "<DISK_USAGE>0</DISK_USAGE><MEM_USAGE>0</MEM_USAGE>"
+        << "<CPU_USAGE>0</CPU_USAGE><MAX_DISK>0</MAX_DISK>"
+        << "<MAX_MEM>16777216</MAX_MEM><MAX_CPU>800</MAX_CPU>"
+        << "<FREE_DISK>0</FREE_DISK><FREE_MEM>8388608</FREE_MEM>"
+        << "<FREE_CPU>700</FREE_CPU><USED_DISK>0</USED_DISK>"
+        << "<USED_MEM>8388608</USED_MEM><USED_CPU>100</USED_CPU>"
+        << "<RUNNING_VMS>20</RUNNING_VMS></HOST_SHARE><VMS>";
+
+    for (int i = 0 ; i < 20 ; i++)
+    {
+        oss << "<ID>" << oid * 20 + i << "</ID>";
+    }
+
+    oss << "</VMS><TEMPLATE>"
+        << "<ARCH><![CDATA[x86_64]]></ARCH>"
+        << "<CPUSPEED><![CDATA[2400]]></CPUSPEED>"
+        << "<HOSTNAME><![CDATA[host-" << oid << "]]></HOSTNAME>"
+        << "<HYPERVISOR><![CDATA[kvm]]></HYPERVISOR>"
+        << "<MODELNAME><![CDATA[Intel(R) Xeon(R) CPU E5620 @ 2.40GHz]]>"
+        << "</MODELNAME><NETRX><![CDATA[123456789]]></NETRX>"
+        << "<NETTX><![CDATA[987654321]]></NETTX>"
+        << "<TOTALCPU><![CDATA[800]]></TOTALCPU>"
+        << "<TOTALMEMORY><![CDATA[16777216]]></TOTALMEMORY>"
+        << "</TEMPLATE></HOST>";
+
+    return oss.str();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  The discovery before the im_mad column: the IM driver is read from the
+ *  host body
+ */
+class BodyDiscover : public Callbackable
+{
+public:
+    int discover(SqlDB * db, map<int, string> * hosts, int host_limit)
+    {
+        ostringstream sql;
+
+        SqlCallback cb(this,
+                       static_cast<Callbackable::Callback>(&BodyDiscover::cb),
+                       static_cast<void *>(hosts));
+
+        sql << "SELECT oid, body FROM host_pool WHERE state != "
+            << Host::DISABLED << " ORDER BY last_mon_time ASC LIMIT "
+            << host_limit;
+
+        return db->exec(sql, &cb);
+    };
+
+private:
+    int cb(void * _map, int num, char **values, char **names)
+    {
+        map<int, string> * hosts = static_cast<map<int, string> *>(_map);
+        string             im_mad;
+
+        if ( (num<2) || (values[0] == 0) || (values[1] == 0) )
+        {
+            return -1;
+        }
+
+        if ( ObjectXML::xpath_value(im_mad, values[1], "/HOST/IM_MAD") != 0 )
+        {
+            return -1;
+        }
+
+        hosts->insert(make_pair(atoi(values[0]), im_mad));
+
+        return 0;
+    };
+};
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    string db_name   = "ONE_discover_bench";
+    int    num_hosts = 5000;
+    int    rounds    = 20;
+
+    vector<const Attribute *> hooks;
+    vector<const Attribute *> rollups;
+
+    ostringstream title;
+
+    BenchColumn columns[] = {
+        {"limit", 12, 0}, {"body (ms)", 16, 3}, {"column (ms)", 16, 3}};
+
+    if ( argc > 1 )
+    {
+        num_hosts = atoi(argv[1]);
+    }
+
+    if ( argc > 2 )
+    {
+        rounds = atoi(argv[2]);
+    }
+
+    NebulaLog::init_log_system(NebulaLog::FILE, Log::ERROR, "bench.log");
+
+    unlink(db_name.c_str());
+
+    SqlDB * db = new SqliteDB(db_name);
+
+    HostPool::bootstrap(db);
+
+    HostPool     hpool(db, hooks, "./", "./", 0, rollups);
+    BodyDiscover body_discover;
+
+    db->begin();
+
+    for (int i = 0 ; i < num_hosts ; i++)
+    {
+        ostringstream oss;
+        SqlParams     params;
+        ostringstream name;
+
+        name << "host-" << i;
+
+        oss << "INSERT INTO host_pool (" << host_names
+            << ") VALUES (?,?,?,?,?,?,?,?,?,?,?)";
+
+        params.add(i).add(name.str()).add(host_body(i)).add(Host::MONITORED)
+              .add(i).add(0).add(0).add(1).add(0).add(0).add(string("im_kvm"));
+
+        db->exec(oss, params);
+    }
+
+    db->commit();
+
+    title << "Host discovery, " << num_hosts << " hosts, " << rounds
+          << " rounds, " << host_body(0).size() << " bytes body";
+
+    Benchmark bench(title.str(), columns, 3);
+
+    int limits[] = {15, 100, num_hosts};
+
+    for (int l = 0 ; l < 3 ; l++)
+    {
+        map<int, string> body_hosts;
+        map<int, string> column_hosts;
+        double           start;
+        double           body_ms;
+        double           column_ms;
+
+        start = Benchmark::now_ms();
+
+        for (int i = 0 ; i < rounds ; i++)
+        {
+            body_hosts.clear();
+            body_discover.discover(db, &body_hosts, limits[l]);
+        }
+
+        body_ms = (Benchmark::now_ms() - start) / rounds;
+
+        start = Benchmark::now_ms();
+
+        for (int i = 0 ; i < rounds ; i++)
+        {
+            column_hosts.clear();
+            hpool.discover(&column_hosts, limits[l]);
+        }
+
+        column_ms = (Benchmark::now_ms() - start) / rounds;
+
+        if ( body_hosts != column_hosts )
+        {
+            cout << "Discovered hosts differ for limit " << limits[l] << endl;
+            return -1;
+        }
+
+        bench << limits[l] << body_ms << column_ms;
+    }
+
+    delete db;
+
+    unlink(db_name.c_str());
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
@@ -68,7 +68,8 @@ void InformationManager::load_mads(int uid)
 
         NebulaLog::log("InM",Log::INFO,oss);
 
-        im_mad = new InformationManagerDriver(0,vattr->value(),false,hpool);
+        im_mad = new InformationManagerDriver(0,vattr->value(),false,hpool,
+                                              &scheduler);
 
         rc = add(im_mad);
 
@@ -99,6 +100,11 @@ int InformationManager::start()
 
     NebulaLog::log("InM",Log::INFO,"Starting Information Manager...");
 
+    if ( receiver != 0 && receiver->start() != 0 )
+    {
+        return -1;
+    }
+
     pthread_attr_init (&pattr);
     pthread_attr_setdetachstate (&pattr, PTHREAD_CREATE_JOINABLE);
 
@@ -120,6 +126,11 @@ void InformationManager::do_action(const string &action, void * arg)
     {
         NebulaLog::log("InM",Log::INFO,"Stopping Information Manager...");
 
+        if ( receiver != 0 )
+        {
+            receiver->stop();
+        }
+
         MadManager::stop();
     }
     else
@@ -147,24 +158,59 @@ void InformationManager::timer_action()
     map<int, string>            discovered_hosts;
     map<int, string>::iterator  it;
 
+    vector<int>                 oids;
+    vector<PoolObjectSQL *>     hosts;
+
     const InformationManagerDriver * imd;
 
     Host *          host;
     istringstream   iss;
 
     time_t          monitor_length;
+    int             queued = 0;
 
     mark = mark + timer_period;
 
     if ( mark >= 600 )
     {
+        MonitorScheduler::Stats stats;
+
         NebulaLog::log("InM",Log::INFO,"--Mark--");
         mark = 0;
+
+        scheduler.get_stats(stats, true);
+
+        oss << "Host monitoring: " << stats.inflight << " in progress, "
+            << stats.queued << " queued, " << stats.probes << " completed "
+            << "(latency avg " << stats.latency_avg << " ms, max "
+            << stats.latency_max << " ms), " << stats.timeouts << " expired";
+
+        NebulaLog::log("InM",Log::INFO,oss);
+
+        if ( receiver != 0 )
+        {
+            int received;
+            int discarded;
+
+            receiver->get_stats(received, discarded);
+
+            oss.str("");
+
+            oss << "Monitoring receiver: " << received << " reports received, "
+                << discarded << " discarded";
+
+            NebulaLog::log("InM",Log::INFO,oss);
+        }
+
+        log_stats("InM");
     }
 
     // Clear the expired monitoring records
     hpool->clean_expired_monitoring();
 
+    // Forget the probes with no answer, hosts are set to INIT below
+    scheduler.expire(monitor_expire);
+
     rc = hpool->discover(&discovered_hosts, host_limit);
 
     if ((rc != 0) || (discovered_hosts.empty() == true))
@@ -182,6 +228,15 @@ void InformationManager::timer_action()
         "will not update remotes.");
     }
 
+    for(it=discovered_hosts.begin();it!=discovered_hosts.end();it++)
+    {
+        oids.push_back(it->first);
+    }
+
+    // Load the hosts not in the pool cache with a single query. They are not
+    // locked here, each host is locked only while it is processed
+    hpool->get_many(oids, hosts, false);
+
     for(it=discovered_hosts.begin();it!=discovered_hosts.end();it++)
     {
         host = hpool->get(it->first,true);
@@ -200,15 +255,10 @@ void InformationManager::timer_action()
             hpool->update(host);
         }
 
-        if ( host->isEnabled() && !(host->isMonitoring()) && 
-            (monitor_length >= monitor_period))
+        // Each host is probed once per interval, at its own phase
+        if ( host->isEnabled() && !(host->isMonitoring()) &&
+            scheduler.is_due(it->first, host->get_last_monitored(), now))
         {
-            oss.str("");
-            oss << "Monitoring host " << host->get_name()
-                << " (" << it->first << ")";
-
-            NebulaLog::log("InM",Log::INFO,oss);
-
             imd = get(it->second);
 
             if (imd == 0)
@@ -219,8 +269,23 @@ void InformationManager::timer_action()
 
                 host->set_state(Host::ERROR);
             }
+            else if (imd->busy() || !scheduler.start(it->first, it->second))
+            {
+                // Driver limit reached or the driver is not reading its
+                // input, the host is still due in next timer
+                queued++;
+
+                host->unlock();
+                continue;
+            }
             else
             {
+                oss.str("");
+                oss << "Monitoring host " << host->get_name()
+                    << " (" << it->first << ")";
+
+                NebulaLog::log("InM",Log::INFO,oss);
+
                 bool update_remotes = false;
 
                 if ((sb.st_mtime != 0) &&
@@ -239,4 +304,6 @@ void InformationManager::timer_action()
 
         host->unlock();
     }
+
+    scheduler.set_queued(queued);
 }
@@ -50,7 +50,6 @@ void InformationManagerDriver::protocol(
 
     ostringstream   ess;
     string          hinfo;
-    Host *          host;
 
     // Parse the driver message
 
@@ -87,68 +86,88 @@ void InformationManagerDriver::protocol(
 
     if ( action == "MONITOR" )
     {
-        host = hpool->get(id,true);
+        scheduler->end(id);
 
-        if ( host == 0 )
-        {
-            goto error_host;
-        }
+        getline(is,hinfo);
 
-        if (result == "SUCCESS")
-        {
-            size_t  pos;
-            int     rc;
-
-            ostringstream oss;
+        process_monitor(hpool, id, result == "SUCCESS", hinfo);
+    }
+    else if (action == "LOG")
+    {
+        string info;
 
-            getline (is,hinfo);
+        getline(is,info);
+        NebulaLog::log("InM",log_type(result[0]),info.c_str());
+    }
 
-            for (pos=hinfo.find(',');pos!=string::npos;pos=hinfo.find(','))
-            {
-                hinfo.replace(pos,1,"\n");
-            }
+    return;
 
-            hinfo += "\n";
+error_parse:
 
-            oss << "Host " << id << " successfully monitored."; 
-            NebulaLog::log("InM",Log::DEBUG,oss);
+    ess << "Error while parsing driver message: " << message;
+    NebulaLog::log("InM",Log::ERROR,ess);
 
-            rc = host->update_info(hinfo);
+    return;
+}
 
-            if (rc != 0)
-            {
-                goto error_parse_info;
-            }
-        }
-        else
-        {
-        	goto error_driver_info;
-        }
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 
-        host->touch(true);
+void InformationManagerDriver::process_monitor(HostPool *    hpool,
+                                               int           id,
+                                               bool          success,
+                                               const string& hinfo)
+{
+    ostringstream   ess;
+    Host *          host;
+    string          info;
 
-        hpool->update(host);
-        hpool->update_monitoring(host);
+    host = hpool->get(id,true);
 
-        host->unlock();
+    if ( host == 0 )
+    {
+        goto error_host;
     }
-    else if (action == "LOG")
+
+    if ( success )
     {
-        string info;
+        int     rc;
 
-        getline(is,info);
-        NebulaLog::log("InM",log_type(result[0]),info.c_str());
+        ostringstream oss;
+
+        info = hinfo;
+
+        oss << "Host " << id << " successfully monitored.";
+        NebulaLog::log("InM",Log::DEBUG,oss);
+
+        rc = host->update_info(info);
+
+        if (rc != 0)
+        {
+            goto error_parse_info;
+        }
+    }
+    else
+    {
+        goto error_driver_info;
     }
 
+    host->touch(true);
+
+    hpool->update(host);
+    hpool->update_monitoring(host);
+
+    host->unlock();
+
     return;
 
 error_driver_info:
-	ess << "Error monitoring host " << id << " : " << is.str();
-	goto  error_common_info;
+    ess << "Error monitoring host " << id << " : " << hinfo;
+    goto  error_common_info;
 
 error_parse_info:
     ess << "Error parsing host information: " << hinfo;
-	goto  error_common_info;
+    goto  error_common_info;
 
 error_common_info:
     NebulaLog::log("InM",Log::ERROR,ess);
@@ -167,13 +186,6 @@ error_host:
     ess << "Could not get host " << id;
     NebulaLog::log("InM",Log::ERROR,ess);
 
-    return;
-
-error_parse:
-
-    ess << "Error while parsing driver message: " << message;
-    NebulaLog::log("InM",Log::ERROR,ess);
-
     return;
 }
 
@@ -0,0 +1,348 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "MonitorReceiver.h"
+#include "InformationManagerDriver.h"
+#include "NebulaLog.h"
+#include "SSLTools.h"
+
+#include <sstream>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+const time_t MonitorReceiver::max_skew = 300;
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+extern "C" void * mr_loop(void *arg)
+{
+    MonitorReceiver * mr;
+
+    if ( arg == 0 )
+    {
+        return 0;
+    }
+
+    mr = static_cast<MonitorReceiver *>(arg);
+
+    mr->loop();
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitorReceiver::start()
+{
+    int                 rc;
+    struct sockaddr_in  mr_addr;
+    socklen_t           addr_len = sizeof(struct sockaddr_in);
+    pthread_attr_t      pattr;
+    ostringstream       oss;
+
+    if ( key.empty() )
+    {
+        NebulaLog::log("InM",Log::ERROR,
+                       "A KEY is needed to receive the monitoring reports");
+        return -1;
+    }
+
+    memset(&mr_addr, 0, sizeof(struct sockaddr_in));
+
+    mr_addr.sin_family = AF_INET;
+    mr_addr.sin_port   = htons(port);
+
+    if ( inet_pton(AF_INET, address.c_str(), &mr_addr.sin_addr) != 1 )
+    {
+        oss << "Wrong address for the monitoring receiver: " << address;
+        NebulaLog::log("InM",Log::ERROR,oss);
+
+        return -1;
+    }
+
+    socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if ( socket_fd == -1 )
+    {
+        oss << "Cannot open monitoring receiver socket: " << strerror(errno);
+        NebulaLog::log("InM",Log::ERROR,oss);
+
+        return -1;
+    }
+
+    fcntl(socket_fd,F_SETFD,FD_CLOEXEC); // Close socket in MADs
+
+    rc = bind(socket_fd, (struct sockaddr *) &mr_addr, addr_len);
+
+    if ( rc == -1 )
+    {
+        oss << "Cannot bind monitoring receiver to " << address << ":" << port
+            << " : " << strerror(errno);
+        NebulaLog::log("InM",Log::ERROR,oss);
+
+        close(socket_fd);
+        socket_fd = -1;
+
+        return -1;
+    }
+
+    getsockname(socket_fd, (struct sockaddr *) &mr_addr, &addr_len);
+
+    port = ntohs(mr_addr.sin_port);
+
+    oss << "Starting monitoring receiver, " << address << ":" << port
+        << " (udp)...";
+    NebulaLog::log("InM",Log::INFO,oss);
+
+    pthread_attr_init (&pattr);
+    pthread_attr_setdetachstate (&pattr, PTHREAD_CREATE_JOINABLE);
+
+    rc = pthread_create(&mr_thread,&pattr,mr_loop,(void *) this);
+
+    if ( rc != 0 )
+    {
+        close(socket_fd);
+        socket_fd = -1;
+
+        return -1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorReceiver::stop()
+{
+    if ( socket_fd == -1 )
+    {
+        return;
+    }
+
+    pthread_cancel(mr_thread);
+
+    pthread_join(mr_thread,0);
+
+    close(socket_fd);
+
+    socket_fd = -1;
+
+    NebulaLog::log("InM",Log::INFO,"Monitoring receiver stopped.");
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorReceiver::loop()
+{
+    char    buffer[max_report_size];
+    ssize_t rc;
+
+    int     hid;
+    string  info;
+    string  error_str;
+
+    while (true)
+    {
+        // Cancellation point, the thread is only cancelled here
+        rc = recvfrom(socket_fd, buffer, max_report_size, 0, 0, 0);
+
+        if ( rc <= 0 )
+        {
+            continue;
+        }
+
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, 0);
+
+        if ( parse_report(string(buffer, rc), hid, info, error_str) == 0 )
+        {
+            process_report(hid, info);
+
+            pthread_mutex_lock(&mutex);
+
+            received++;
+
+            pthread_mutex_unlock(&mutex);
+        }
+        else
+        {
+            ostringstream oss;
+
+            oss << "Discarding monitoring report: " << error_str;
+            NebulaLog::log("InM",Log::WARNING,oss);
+
+            pthread_mutex_lock(&mutex);
+
+            received++;
+            discarded++;
+
+            pthread_mutex_unlock(&mutex);
+        }
+
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitorReceiver::parse_report(const string& report,
+                                  int&          hid,
+                                  string&       info,
+                                  string&       error_str)
+{
+    istringstream   is;
+    ostringstream   oss;
+    string          action;
+    string          signature;
+    time_t          timestamp;
+    time_t          now;
+    size_t          pos;
+
+    map<int, time_t>::iterator it;
+
+    pos = report.find('\n');
+
+    if ( pos == string::npos )
+    {
+        error_str = "missing host information";
+        return -1;
+    }
+
+    is.str(report.substr(0, pos));
+
+    is >> action >> hid >> timestamp >> signature;
+
+    if ( is.fail() || action != "MONITOR" )
+    {
+        error_str = "wrong header: " + report.substr(0, pos);
+        return -1;
+    }
+
+    info = report.substr(pos + 1);
+
+    if ( !equal_signature(sign(host_key(key, hid), hid, timestamp, info),
+                          signature) )
+    {
+        oss << "wrong signature for host " << hid;
+        error_str = oss.str();
+
+        return -1;
+    }
+
+    now = time(0);
+
+    if ( timestamp > now + max_skew || timestamp < now - max_skew )
+    {
+        oss << "report of host " << hid << " out of time (" << timestamp
+            << ")";
+        error_str = oss.str();
+
+        return -1;
+    }
+
+    it = last_report.find(hid);
+
+    if ( it != last_report.end() && it->second >= timestamp )
+    {
+        oss << "report of host " << hid << " already received (" << timestamp
+            << ")";
+        error_str = oss.str();
+
+        return -1;
+    }
+
+    last_report[hid] = timestamp;
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+string MonitorReceiver::sign(const string& key,
+                             int           hid,
+                             time_t        timestamp,
+                             const string& info)
+{
+    ostringstream oss;
+
+    oss << hid << " " << timestamp << "\n" << info;
+
+    return SSLTools::hmac_sha1(key, oss.str());
+}
+
+/* -------------------------------------------------------------------------- */
+
+string MonitorReceiver::host_key(const string& key, int hid)
+{
+    ostringstream oss;
+
+    oss << hid;
+
+    return SSLTools::hmac_sha1(key, oss.str());
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool MonitorReceiver::equal_signature(const string& s1, const string& s2)
+{
+    unsigned char diff = 0;
+
+    if ( s1.length() != s2.length() )
+    {
+        return false;
+    }
+
+    // Compare every char, the time does not depend on the first difference
+    for (string::size_type i = 0; i < s1.length(); i++)
+    {
+        diff |= s1[i] ^ s2[i];
+    }
+
+    return diff == 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+string MonitorReceiver::format_report(const string& key,
+                                      int           hid,
+                                      time_t        timestamp,
+                                      const string& info)
+{
+    ostringstream oss;
+
+    oss << "MONITOR " << hid << " " << timestamp << " "
+        << sign(key, hid, timestamp, info) << "\n" << info;
+
+    return oss.str();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorReceiver::process_report(int hid, const string& info)
+{
+    InformationManagerDriver::process_monitor(hpool, hid, true, info);
+}
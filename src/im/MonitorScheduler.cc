@@ -0,0 +1,223 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "MonitorScheduler.h"
+
+#include <sys/time.h>
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MonitorScheduler::MonitorScheduler(time_t _period, int _max_inflight):
+    period(_period),
+    max_inflight(_max_inflight),
+    queued(0),
+    ended(0),
+    timeouts(0),
+    latency_sum(0),
+    latency_max(0)
+{
+    pthread_mutex_init(&mutex, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+long long MonitorScheduler::now_ms()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, 0);
+
+    return static_cast<long long>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+time_t MonitorScheduler::phase(int hid) const
+{
+    if ( period <= 0 )
+    {
+        return 0;
+    }
+
+    // Multiplicative hash (Knuth), consecutive ids are spread over the period
+    unsigned int hash = static_cast<unsigned int>(hid) * 2654435761U;
+
+    return static_cast<time_t>(hash % static_cast<unsigned int>(period));
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool MonitorScheduler::is_due(int hid, time_t last_monitored, time_t now) const
+{
+    time_t slot_start;
+
+    if ( period <= 0 )
+    {
+        return true;
+    }
+
+    slot_start = now - ((now - phase(hid)) % period);
+
+    return last_monitored < slot_start;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool MonitorScheduler::start(int hid, const string& driver)
+{
+    Probe probe;
+
+    pthread_mutex_lock(&mutex);
+
+    if ( probes.count(hid) != 0 )
+    {
+        pthread_mutex_unlock(&mutex);
+        return false;
+    }
+
+    int& driver_inflight = inflight[driver];
+
+    if ( max_inflight > 0 && driver_inflight >= max_inflight )
+    {
+        pthread_mutex_unlock(&mutex);
+        return false;
+    }
+
+    probe.driver = driver;
+    probe.start  = now_ms();
+
+    probes.insert(make_pair(hid, probe));
+
+    driver_inflight++;
+
+    pthread_mutex_unlock(&mutex);
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorScheduler::end(int hid)
+{
+    map<int, Probe>::iterator it;
+    long long                 latency;
+
+    pthread_mutex_lock(&mutex);
+
+    it = probes.find(hid);
+
+    if ( it != probes.end() )
+    {
+        latency = now_ms() - it->second.start;
+
+        ended++;
+
+        latency_sum += latency;
+
+        if ( latency > latency_max )
+        {
+            latency_max = latency;
+        }
+
+        inflight[it->second.driver]--;
+
+        probes.erase(it);
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorScheduler::expire(time_t expire_time)
+{
+    map<int, Probe>::iterator it;
+    long long                 limit;
+
+    pthread_mutex_lock(&mutex);
+
+    limit = now_ms() - static_cast<long long>(expire_time) * 1000;
+
+    for ( it = probes.begin(); it != probes.end(); )
+    {
+        if ( it->second.start <= limit )
+        {
+            timeouts++;
+
+            inflight[it->second.driver]--;
+
+            probes.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorScheduler::set_queued(int _queued)
+{
+    pthread_mutex_lock(&mutex);
+
+    queued = _queued;
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitorScheduler::get_stats(Stats& stats, bool reset)
+{
+    pthread_mutex_lock(&mutex);
+
+    stats.queued      = queued;
+    stats.inflight    = probes.size();
+    stats.probes      = ended;
+    stats.timeouts    = timeouts;
+    stats.latency_max = latency_max;
+
+    if ( ended > 0 )
+    {
+        stats.latency_avg = latency_sum / ended;
+    }
+    else
+    {
+        stats.latency_avg = 0;
+    }
+
+    if ( reset )
+    {
+        ended       = 0;
+        timeouts    = 0;
+        latency_sum = 0;
+        latency_max = 0;
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,310 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "test/OneUnitTest.h"
+#include "MonitorReceiver.h"
+
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/**
+ *  Receiver that keeps the accepted reports instead of updating the hosts
+ */
+class FakeReceiver : public MonitorReceiver
+{
+public:
+    FakeReceiver(const string& key):MonitorReceiver(0, "127.0.0.1", 0, key)
+    {
+        pthread_mutex_init(&mutex, 0);
+    };
+
+    ~FakeReceiver()
+    {
+        pthread_mutex_destroy(&mutex);
+    };
+
+    /**
+     *  Waits until the receiver handles num reports (accepted or discarded)
+     */
+    bool wait_reports(int num)
+    {
+        int received;
+        int discarded;
+
+        for (int i = 0; i < 200; i++)
+        {
+            get_stats(received, discarded);
+
+            if ( received >= num )
+            {
+                return true;
+            }
+
+            usleep(10000);
+        }
+
+        return false;
+    };
+
+    vector< pair<int, string> > get_reports()
+    {
+        vector< pair<int, string> > copy;
+
+        pthread_mutex_lock(&mutex);
+
+        copy = reports;
+
+        pthread_mutex_unlock(&mutex);
+
+        return copy;
+    };
+
+protected:
+    void process_report(int hid, const string& info)
+    {
+        pthread_mutex_lock(&mutex);
+
+        reports.push_back(make_pair(hid, info));
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+private:
+    pthread_mutex_t             mutex;
+
+    vector< pair<int, string> > reports;
+};
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+class MonitorReceiverTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (MonitorReceiverTest);
+
+    CPPUNIT_TEST (test_report);
+    CPPUNIT_TEST (test_signature);
+    CPPUNIT_TEST (test_replay);
+    CPPUNIT_TEST (test_skew);
+    CPPUNIT_TEST (test_malformed);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+private:
+    FakeReceiver * mr;
+
+    int            sender_fd;
+
+    static const string key;
+
+    static const string info;
+
+    /**
+     *  Builds a report signed with the key of the host
+     */
+    static string host_report(int hid, time_t timestamp)
+    {
+        return MonitorReceiver::format_report(
+                MonitorReceiver::host_key(key, hid), hid, timestamp, info);
+    };
+
+    /**
+     *  Sends a report to the receiver, as a host would do
+     */
+    void send_report(const string& report)
+    {
+        struct sockaddr_in addr;
+
+        memset(&addr, 0, sizeof(struct sockaddr_in));
+
+        addr.sin_family      = AF_INET;
+        addr.sin_port        = htons(mr->get_port());
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        sendto(sender_fd, report.c_str(), report.length(), 0,
+               (struct sockaddr *) &addr, sizeof(struct sockaddr_in));
+    };
+
+public:
+    void setUp()
+    {
+        mr = new FakeReceiver(key);
+
+        CPPUNIT_ASSERT(mr->start() == 0);
+        CPPUNIT_ASSERT(mr->get_port() > 0);
+
+        sender_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    };
+
+    void tearDown()
+    {
+        close(sender_fd);
+
+        mr->stop();
+
+        delete mr;
+    };
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_report()
+    {
+        vector< pair<int, string> > reports;
+        time_t                      now = time(0);
+
+        send_report(host_report(3, now));
+        send_report(host_report(5, now));
+        send_report(host_report(3, now + 1));
+
+        CPPUNIT_ASSERT(mr->wait_reports(3));
+
+        reports = mr->get_reports();
+
+        CPPUNIT_ASSERT(reports.size() == 3);
+
+        CPPUNIT_ASSERT(reports[0].first  == 3);
+        CPPUNIT_ASSERT(reports[0].second == info);
+        CPPUNIT_ASSERT(reports[1].first  == 5);
+        CPPUNIT_ASSERT(reports[2].first  == 3);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_signature()
+    {
+        int     received;
+        int     discarded;
+        time_t  now = time(0);
+        string  report;
+
+        // Signed with other key
+        send_report(MonitorReceiver::format_report("other", 3, now, info));
+
+        // Signed by other host
+        send_report(MonitorReceiver::format_report(
+                MonitorReceiver::host_key(key, 3), 7, now, info));
+
+        // Information modified after signing
+        report = host_report(4, now);
+        report.replace(report.length() - 3, 3, "100");
+
+        send_report(report);
+
+        // Host id modified after signing
+        report = host_report(5, now);
+        report.replace(8, 1, "6");
+
+        send_report(report);
+
+        CPPUNIT_ASSERT(mr->wait_reports(4));
+
+        mr->get_stats(received, discarded);
+
+        CPPUNIT_ASSERT(discarded == 4);
+        CPPUNIT_ASSERT(mr->get_reports().empty());
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_replay()
+    {
+        int     received;
+        int     discarded;
+        time_t  now = time(0);
+        string  report;
+
+        report = host_report(3, now);
+
+        send_report(report);
+        send_report(report);
+
+        // Older than the last report of the host
+        send_report(host_report(3, now - 10));
+
+        CPPUNIT_ASSERT(mr->wait_reports(3));
+
+        mr->get_stats(received, discarded);
+
+        CPPUNIT_ASSERT(discarded == 2);
+        CPPUNIT_ASSERT(mr->get_reports().size() == 1);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_skew()
+    {
+        int     received;
+        int     discarded;
+        time_t  now  = time(0);
+        time_t  skew = MonitorReceiver::max_skew;
+
+        send_report(host_report(3, now-skew-10));
+        send_report(host_report(4, now+skew+10));
+        send_report(host_report(5, now-skew+10));
+
+        CPPUNIT_ASSERT(mr->wait_reports(3));
+
+        mr->get_stats(received, discarded);
+
+        CPPUNIT_ASSERT(discarded == 2);
+        CPPUNIT_ASSERT(mr->get_reports().size() == 1);
+        CPPUNIT_ASSERT(mr->get_reports()[0].first == 5);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_malformed()
+    {
+        int     received;
+        int     discarded;
+
+        send_report("MONITOR 3 1234");
+        send_report("POLL 3 1234 abcd\nFREECPU=100");
+        send_report("MONITOR three 1234 abcd\nFREECPU=100");
+
+        CPPUNIT_ASSERT(mr->wait_reports(3));
+
+        mr->get_stats(received, discarded);
+
+        CPPUNIT_ASSERT(discarded == 3);
+        CPPUNIT_ASSERT(mr->get_reports().empty());
+    }
+};
+
+const string MonitorReceiverTest::key  = "0123456789abcdef";
+
+const string MonitorReceiverTest::info = "HYPERVISOR=kvm TOTALCPU=800 "
+    "FREECPU=700 USEDCPU=100 TOTALMEMORY=16777216 FREEMEMORY=8388608 "
+    "USEDMEMORY=8388608 NETRX=0 NETTX=0 HOSTNAME=host01";
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+int main(int argc, char ** argv)
+{
+    return OneUnitTest::main(argc, argv, MonitorReceiverTest::suite(),
+                            "MonitorReceiverTest.xml");
+}
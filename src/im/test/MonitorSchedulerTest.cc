@@ -0,0 +1,224 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "test/OneUnitTest.h"
+#include "MonitorScheduler.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class MonitorSchedulerTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (MonitorSchedulerTest);
+
+    CPPUNIT_TEST (test_phase);
+    CPPUNIT_TEST (test_spread);
+    CPPUNIT_TEST (test_due);
+    CPPUNIT_TEST (test_inflight);
+    CPPUNIT_TEST (test_end);
+    CPPUNIT_TEST (test_expire);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+public:
+    void setUp(){};
+
+    void tearDown(){};
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_phase()
+    {
+        MonitorScheduler ms(600, 0);
+
+        for (int i = 0; i < 1000; i++)
+        {
+            CPPUNIT_ASSERT(ms.phase(i) >= 0);
+            CPPUNIT_ASSERT(ms.phase(i) < 600);
+            CPPUNIT_ASSERT(ms.phase(i) == ms.phase(i));
+        }
+
+        MonitorScheduler ms_zero(0, 0);
+
+        CPPUNIT_ASSERT(ms_zero.phase(7) == 0);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_spread()
+    {
+        // 600 hosts over 60s, no second should take more than a few of them
+        MonitorScheduler ms(60, 0);
+        vector<int>      slots(60, 0);
+
+        for (int i = 0; i < 600; i++)
+        {
+            slots[ms.phase(i)]++;
+        }
+
+        for (int i = 0; i < 60; i++)
+        {
+            CPPUNIT_ASSERT(slots[i] > 0);
+            CPPUNIT_ASSERT(slots[i] <= 30);
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_due()
+    {
+        MonitorScheduler ms(600, 0);
+
+        time_t now   = 1000000;
+        time_t phase = ms.phase(3);
+        time_t slot  = now - ((now - phase) % 600);
+
+        // Never monitored
+        CPPUNIT_ASSERT(ms.is_due(3, 0, now) == true);
+
+        // Monitored in the current slot
+        CPPUNIT_ASSERT(ms.is_due(3, slot, now) == false);
+        CPPUNIT_ASSERT(ms.is_due(3, now, now) == false);
+
+        // Monitored just before the current slot
+        CPPUNIT_ASSERT(ms.is_due(3, slot - 1, now) == true);
+
+        // Each host is due exactly once per period
+        int times = 0;
+        time_t last = now;
+
+        for (time_t t = now + 1; t <= now + 600; t++)
+        {
+            if ( ms.is_due(3, last, t) )
+            {
+                times++;
+                last = t;
+            }
+        }
+
+        CPPUNIT_ASSERT(times == 1);
+        CPPUNIT_ASSERT((last - phase) % 600 == 0);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_inflight()
+    {
+        MonitorScheduler           ms(600, 2);
+        MonitorScheduler::Stats    stats;
+
+        CPPUNIT_ASSERT(ms.start(0, "im_kvm") == true);
+        CPPUNIT_ASSERT(ms.start(0, "im_kvm") == false);
+        CPPUNIT_ASSERT(ms.start(1, "im_kvm") == true);
+        CPPUNIT_ASSERT(ms.start(2, "im_kvm") == false);
+
+        // The limit is per driver
+        CPPUNIT_ASSERT(ms.start(3, "im_xen") == true);
+
+        ms.end(0);
+
+        CPPUNIT_ASSERT(ms.start(2, "im_kvm") == true);
+
+        ms.set_queued(4);
+        ms.get_stats(stats, false);
+
+        CPPUNIT_ASSERT(stats.inflight == 3);
+        CPPUNIT_ASSERT(stats.queued   == 4);
+        CPPUNIT_ASSERT(stats.probes   == 1);
+
+        MonitorScheduler ms_unlimited(600, 0);
+
+        for (int i = 0; i < 100; i++)
+        {
+            CPPUNIT_ASSERT(ms_unlimited.start(i, "im_kvm") == true);
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_end()
+    {
+        MonitorScheduler           ms(600, 0);
+        MonitorScheduler::Stats    stats;
+
+        ms.start(0, "im_kvm");
+        ms.start(1, "im_kvm");
+
+        usleep(20000);
+
+        ms.end(0);
+        ms.end(1);
+        ms.end(5); // Not in progress, ignored
+
+        ms.get_stats(stats, true);
+
+        CPPUNIT_ASSERT(stats.inflight == 0);
+        CPPUNIT_ASSERT(stats.probes   == 2);
+        CPPUNIT_ASSERT(stats.timeouts == 0);
+        CPPUNIT_ASSERT(stats.latency_avg >= 20);
+        CPPUNIT_ASSERT(stats.latency_max >= stats.latency_avg);
+
+        ms.get_stats(stats, false);
+
+        CPPUNIT_ASSERT(stats.probes      == 0);
+        CPPUNIT_ASSERT(stats.latency_avg == 0);
+        CPPUNIT_ASSERT(stats.latency_max == 0);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_expire()
+    {
+        MonitorScheduler           ms(600, 1);
+        MonitorScheduler::Stats    stats;
+
+        ms.start(0, "im_kvm");
+
+        ms.expire(600);
+
+        CPPUNIT_ASSERT(ms.start(1, "im_kvm") == false);
+
+        ms.expire(0);
+
+        ms.get_stats(stats, true);
+
+        CPPUNIT_ASSERT(stats.inflight == 0);
+        CPPUNIT_ASSERT(stats.timeouts == 1);
+        CPPUNIT_ASSERT(stats.probes   == 0);
+
+        // The driver slot is released
+        CPPUNIT_ASSERT(ms.start(1, "im_kvm") == true);
+
+        // A late response of an expired probe is ignored
+        ms.end(0);
+
+        ms.get_stats(stats, false);
+
+        CPPUNIT_ASSERT(stats.probes   == 0);
+        CPPUNIT_ASSERT(stats.inflight == 1);
+    }
+};
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+int main(int argc, char ** argv)
+{
+    return OneUnitTest::main(argc, argv, MonitorSchedulerTest::suite(),
+                            "MonitorSchedulerTest.xml");
+}
@@ -57,6 +57,8 @@ void  LifeCycleManager::deploy_action(int vid)
 
         vm->set_state(vm_state);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_stime(thetime);
@@ -65,6 +67,8 @@ void  LifeCycleManager::deploy_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->get_requirements(cpu,mem,disk);
 
         hpool->add_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
@@ -206,12 +210,16 @@ void  LifeCycleManager::migrate_action(int vid)
 
         vm->set_resched(false);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_stime(time(0));
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->get_requirements(cpu,mem,disk);
 
         hpool->add_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
@@ -262,12 +270,16 @@ void  LifeCycleManager::live_migrate_action(int vid)
 
         vm->set_resched(false);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_stime(time(0));
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->get_requirements(cpu,mem,disk);
 
         hpool->add_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
@@ -412,6 +424,8 @@ void  LifeCycleManager::restore_action(int vid)
 
         vm->cp_history();
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm); //update last_seq & state
 
         vm->set_stime(the_time);
@@ -420,6 +434,8 @@ void  LifeCycleManager::restore_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->log("LCM", Log::INFO, "New state is BOOT_SUSPENDED");
 
         //----------------------------------------------------
@@ -539,6 +555,8 @@ void  LifeCycleManager::restart_action(int vid)
 
             vm->cp_history();
 
+            SqlTransaction tx(vmpool->get_db());
+
             vmpool->update(vm);
 
             vm->set_stime(the_time);
@@ -547,6 +565,8 @@ void  LifeCycleManager::restart_action(int vid)
 
             vmpool->update_history(vm);
 
+            tx.commit();
+
             vm->log("LCM", Log::INFO, "New VM state is BOOT_POWEROFF");
         }
 
@@ -45,6 +45,8 @@ void  LifeCycleManager::save_success_action(int vid)
 
         vm->set_state(VirtualMachine::PROLOG_MIGRATE);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_previous_etime(the_time);
@@ -61,6 +63,8 @@ void  LifeCycleManager::save_success_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->get_requirements(cpu,mem,disk);
 
         hpool->del_capacity(vm->get_previous_hid(), vm->get_oid(), cpu, mem, disk);
@@ -107,6 +111,8 @@ void  LifeCycleManager::save_success_action(int vid)
 
         vm->set_state(VirtualMachine::EPILOG_STOP);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_epilog_stime(the_time);
@@ -117,6 +123,8 @@ void  LifeCycleManager::save_success_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->log("LCM", Log::INFO, "New VM state is EPILOG_STOP");
 
         //----------------------------------------------------
@@ -147,7 +155,7 @@ void  LifeCycleManager::save_failure_action(int vid)
 
     if ( vm->get_lcm_state() == VirtualMachine::SAVE_MIGRATE )
     {
-        int                     cpu,mem,disk;
+        int                     cpu,mem,disk,hid;
         time_t                  the_time = time(0);
 
         Nebula&                 nd = Nebula::instance();
@@ -165,12 +173,12 @@ void  LifeCycleManager::save_failure_action(int vid)
 
         vm->set_reason(History::ERROR);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update_history(vm);
 
         vm->get_requirements(cpu,mem,disk);
 
-        hpool->del_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
-
         vm->set_previous_etime(the_time);
 
         vm->set_previous_vm_info();
@@ -181,7 +189,10 @@ void  LifeCycleManager::save_failure_action(int vid)
 
         vmpool->update_previous_history(vm);
 
-        // --- Add new record by copying the previous one
+        // --- Add new record by copying the previous one, the capacity is
+        // --- freed in the failed host, not in the new record
+
+        hid = vm->get_hid();
 
         vm->cp_previous_history();
 
@@ -193,6 +204,10 @@ void  LifeCycleManager::save_failure_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
+        hpool->del_capacity(hid, vm->get_oid(), cpu, mem, disk);
+
         vm->log("LCM", Log::INFO, "Fail to save VM state while migrating."
                 " Assuming that the VM is still RUNNING (will poll VM).");
 
@@ -254,6 +269,8 @@ void  LifeCycleManager::deploy_success_action(int vid)
 
         vm->set_running_stime(the_time);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update_history(vm);
 
         vm->set_previous_etime(the_time);
@@ -268,12 +285,14 @@ void  LifeCycleManager::deploy_success_action(int vid)
 
         vm->get_requirements(cpu,mem,disk);
 
-        hpool->del_capacity(vm->get_previous_hid(), vm->get_oid(), cpu, mem, disk);
-
         vm->set_state(VirtualMachine::RUNNING);
 
         vmpool->update(vm);
 
+        tx.commit();
+
+        hpool->del_capacity(vm->get_previous_hid(), vm->get_oid(), cpu, mem, disk);
+
         vm->log("LCM", Log::INFO, "New VM state is RUNNING");
     }
     else if ( vm->get_lcm_state() == VirtualMachine::BOOT ||
@@ -313,7 +332,7 @@ void  LifeCycleManager::deploy_failure_action(int vid)
 
     if ( vm->get_lcm_state() == VirtualMachine::MIGRATE )
     {
-        int     cpu,mem,disk;
+        int     cpu,mem,disk,hid;
         time_t  the_time = time(0);
 
         Nebula&                 nd = Nebula::instance();
@@ -325,6 +344,8 @@ void  LifeCycleManager::deploy_failure_action(int vid)
 
         vm->set_state(VirtualMachine::RUNNING);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_etime(the_time);
@@ -347,9 +368,10 @@ void  LifeCycleManager::deploy_failure_action(int vid)
 
         vm->get_requirements(cpu,mem,disk);
 
-        hpool->del_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
+        // --- Add new record by copying the previous one, the capacity is
+        // --- freed in the failed host, not in the new record
 
-        // --- Add new record by copying the previous one
+        hid = vm->get_hid();
 
         vm->cp_previous_history();
 
@@ -361,6 +383,10 @@ void  LifeCycleManager::deploy_failure_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
+        hpool->del_capacity(hid, vm->get_oid(), cpu, mem, disk);
+
         vm->log("LCM", Log::INFO, "Fail to live migrate VM."
                 " Assuming that the VM is still RUNNING (will poll VM).");
 
@@ -414,6 +440,8 @@ void  LifeCycleManager::deploy_failure_action(int vid)
 
         vm->set_state(VirtualMachine::EPILOG_STOP);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_epilog_stime(the_time);
@@ -424,6 +452,8 @@ void  LifeCycleManager::deploy_failure_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->log("LCM", Log::INFO, "Fail to boot VM. New VM state is EPILOG_STOP");
 
         //----------------------------------------------------
@@ -464,6 +494,8 @@ void  LifeCycleManager::shutdown_success_action(int vid)
 
         vm->set_state(VirtualMachine::EPILOG);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_epilog_stime(the_time);
@@ -472,6 +504,8 @@ void  LifeCycleManager::shutdown_success_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->log("LCM", Log::INFO, "New VM state is EPILOG");
 
         //----------------------------------------------------
@@ -602,6 +636,8 @@ void  LifeCycleManager::prolog_success_action(int vid)
         vm->set_state(VirtualMachine::BOOT);
     }
 
+    SqlTransaction tx(vmpool->get_db());
+
     vmpool->update(vm);
 
     vm->set_prolog_etime(the_time);
@@ -610,6 +646,8 @@ void  LifeCycleManager::prolog_success_action(int vid)
 
     vmpool->update_history(vm);
 
+    tx.commit();
+
     vm->log("LCM", Log::INFO, "New VM state is BOOT");
 
     //----------------------------------------------------
@@ -662,6 +700,8 @@ void  LifeCycleManager::prolog_failure_action(int vid)
 
         vm->set_resched(false);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_etime(the_time);
@@ -672,6 +712,8 @@ void  LifeCycleManager::prolog_failure_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->get_requirements(cpu,mem,disk);
 
         hpool->del_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
@@ -823,6 +865,8 @@ void  LifeCycleManager::cancel_success_action(int vid)
 
         vm->set_state(VirtualMachine::EPILOG);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_reason(History::CANCEL);
@@ -833,6 +877,8 @@ void  LifeCycleManager::cancel_success_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->log("LCM", Log::INFO, "New VM state is EPILOG");
 
         //----------------------------------------------------
@@ -951,6 +997,8 @@ void  LifeCycleManager::monitor_suspend_action(int vid)
 
         vm->set_resched(false);
 
+        SqlTransaction tx(vmpool->get_db());
+
         vmpool->update(vm);
 
         vm->set_running_etime(the_time);
@@ -963,6 +1011,8 @@ void  LifeCycleManager::monitor_suspend_action(int vid)
 
         vmpool->update_history(vm);
 
+        tx.commit();
+
         vm->get_requirements(cpu,mem,disk);
 
         hpool->del_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
@@ -1037,6 +1087,8 @@ void  LifeCycleManager::failure_action(VirtualMachine * vm)
 
     vm->set_resched(false);
 
+    SqlTransaction tx(vmpool->get_db());
+
     vmpool->update(vm);
 
     vm->set_etime(the_time);
@@ -1047,6 +1099,8 @@ void  LifeCycleManager::failure_action(VirtualMachine * vm)
 
     vmpool->update_history(vm);
 
+    tx.commit();
+
     vm->get_requirements(cpu,mem,disk);
 
     hpool->del_capacity(vm->get_hid(), vm->get_oid(), cpu, mem, disk);
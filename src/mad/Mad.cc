@@ -21,7 +21,10 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
 #include <string.h> 
+#include <stdio.h>
+#include <stdlib.h>
 
 #include "Mad.h"
 #include "NebulaLog.h"
@@ -31,39 +34,124 @@
 #include <cerrno>
 
 
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Mad::Mad(
+    int userid,
+    const map<string,string> &attrs,
+    bool sudo):
+        uid(userid),
+        attributes(attrs),
+        sudo_execution(sudo),
+        epoll_fd(-1),
+        max_write_size(0),
+        write_rejected(0),
+        queued(0),
+        max_queued(0),
+        processed(0),
+        latency_sum(0),
+        latency_max(0),
+        failed(false)
+{
+    map<string,string>::iterator it;
+    int                          num = 1;
+
+    it = attributes.find("INSTANCES");
+
+    if ( it != attributes.end() )
+    {
+        num = atoi(it->second.c_str());
+
+        if ( num < 1 )
+        {
+            num = 1;
+        }
+    }
+
+    for (int i = 0; i < num; i++)
+    {
+        instances.push_back(new MadInstance(this));
+    }
+
+    pthread_mutex_init(&write_mutex, 0);
+}
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
 Mad::~Mad()
 {
-    char    buf[]="FINALIZE\n";
-    int     status;
-    pid_t   rp;
-    
-    if ( pid==-1)
+    for (unsigned int i = 0; i < instances.size(); i++)
+    {
+        finalize(instances[i]);
+
+        delete instances[i];
+    }
+
+    pthread_mutex_destroy(&write_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Mad::start()
+{
+    for (unsigned int i = 0; i < instances.size(); i++)
+    {
+        if ( start(instances[i]) != 0 )
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void Mad::finalize(MadInstance * inst)
+{
+    const char * buf = "FINALIZE\n";
+    int          status;
+    pid_t        rp;
+
+    if ( inst->pid == -1 )
     {
         return;
     }
-    
+
+    clear_write_buffer(inst);
+
+    if ( inst->framed )
+    {
+        buf = "8\nFINALIZE";
+    }
+
     // Finish the driver
-    ::write(nebula_mad_pipe, buf, strlen(buf));
+    ::write(inst->nebula_mad_pipe, buf, strlen(buf));
 
-    close(mad_nebula_pipe);
-    close(nebula_mad_pipe);
+    close(inst->mad_nebula_pipe);
+    close(inst->nebula_mad_pipe);
 
-    rp = waitpid(pid, &status, WNOHANG);
+    rp = waitpid(inst->pid, &status, WNOHANG);
 
     if ( rp == 0 )
     {
         sleep(1);
-        waitpid(pid, &status, WNOHANG);
+        waitpid(inst->pid, &status, WNOHANG);
     }
+
+    inst->mad_nebula_pipe = -1;
+    inst->nebula_mad_pipe = -1;
+    inst->pid             = -1;
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int Mad::start()
+int Mad::start(MadInstance * inst)
 {
     int                            ne_mad_pipe[2];
     int                            mad_ne_pipe[2];
@@ -75,7 +163,7 @@ int Mad::start()
     const char *                   arguments = 0;
     string                         exec_path;
     
-    char                           buf[]="INIT\n";
+    char                           buf[]="INIT FRAMED\n";
     char                           c;
 
     stringbuf                      sbuf;
@@ -139,9 +227,9 @@ int Mad::start()
 
     //Create a new process for the driver
 
-    pid = fork();
+    inst->pid = fork();
 
-    switch (pid)
+    switch (inst->pid)
     {
     case -1: // Error
         goto error_fork;
@@ -181,33 +269,36 @@ int Mad::start()
         close(ne_mad_pipe[0]);
         close(mad_ne_pipe[1]);
 
-        nebula_mad_pipe = ne_mad_pipe[1];
-        mad_nebula_pipe = mad_ne_pipe[0];
+        inst->nebula_mad_pipe = ne_mad_pipe[1];
+        inst->mad_nebula_pipe = mad_ne_pipe[0];
+
+        inst->read_buffer.clear();
+        inst->framed = false;
 
         // Close pipes in other MADs
 
-        fcntl(nebula_mad_pipe, F_SETFD, FD_CLOEXEC);
-        fcntl(mad_nebula_pipe, F_SETFD, FD_CLOEXEC);
+        fcntl(inst->nebula_mad_pipe, F_SETFD, FD_CLOEXEC);
+        fcntl(inst->mad_nebula_pipe, F_SETFD, FD_CLOEXEC);
 
-        ::write(nebula_mad_pipe, buf, strlen(buf));
+        ::write(inst->nebula_mad_pipe, buf, strlen(buf));
                     
         do
         {
             FD_ZERO(&rfds);
-            FD_SET(mad_nebula_pipe, &rfds);
+            FD_SET(inst->mad_nebula_pipe, &rfds);
 
             // Wait up to 5 seconds
             tv.tv_sec  = 5;
             tv.tv_usec = 0;
 
-            rc = select(mad_nebula_pipe+1,&rfds,0,0, &tv);
+            rc = select(inst->mad_nebula_pipe+1,&rfds,0,0, &tv);
                         
             if ( rc <= 0 ) // MAD did not answered
             {
                 goto error_mad_init;
             }
                                     
-            rc = read(mad_nebula_pipe, (void *) &c, sizeof(char));
+            rc = read(inst->mad_nebula_pipe, (void *) &c, sizeof(char));
             mstream.put(c);            
         }
         while ( rc > 0 && c != '\n');
@@ -226,12 +317,19 @@ int Mad::start()
             {
                 goto error_mad_result;
             }
+
+            // The framed protocol is offered, drivers that do not support
+            // it just answer "INIT SUCCESS"
+            inst->framed = (info == "FRAMED");
         }
         else
         {
             goto error_mad_action;
         }
 
+        // Messages that do not fit in the pipe are queued, see write()
+        fcntl(inst->nebula_mad_pipe, F_SETFL, O_NONBLOCK);
+
         break;
     }
 
@@ -283,30 +381,70 @@ error_pipes:
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int Mad::reload()
+int Mad::reload(MadInstance * inst)
 {
-    char    buf[]="FINALIZE\n";
-    int     status;
-    int     rc;
-    pid_t   rp;
-
-    // Finish the driver
-    ::write(nebula_mad_pipe, buf, strlen(buf));
+    MadInstance                 old(this);
+    vector<string>::iterator    it;
+    int                         rc;
 
-    close(nebula_mad_pipe);
-    close(mad_nebula_pipe);
+    // The process is swapped out under the lock, and restarted without it.
+    // Messages sent meanwhile go to other processes or wait for the new one,
+    // the queued ones and the requests in progress are lost with the old one
+    pthread_mutex_lock(&write_mutex);
 
-    rp = waitpid(pid, &status, WNOHANG);
+    clear_write_buffer(inst);
 
-    if ( rp == 0 )
+    for (map<int, pair<MadInstance *, int> >::iterator it = routes.begin();
+         it != routes.end(); )
     {
-        sleep(1);
-        waitpid(pid, &status, WNOHANG);
+        if ( it->second.first == inst )
+        {
+            routes.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
     }
 
+    inst->requests = 0;
+
+    old.mad_nebula_pipe = inst->mad_nebula_pipe;
+    old.nebula_mad_pipe = inst->nebula_mad_pipe;
+    old.pid             = inst->pid;
+    old.framed          = inst->framed;
+
+    inst->mad_nebula_pipe = -1;
+    inst->nebula_mad_pipe = -1;
+    inst->pid             = -1;
+    inst->restarting      = true;
+
+    pthread_mutex_unlock(&write_mutex);
+
+    finalize(&old);
+
     // Start the MAD again
 
-    rc = start();
+    rc = start(inst);
+
+    pthread_mutex_lock(&write_mutex);
+
+    inst->restarting = false;
+
+    for (it = inst->pending.begin(); it != inst->pending.end(); it++)
+    {
+        if ( rc != 0 || send(inst, *it) != 0 )
+        {
+            NebulaLog::log("MAD", Log::ERROR,
+                "Message lost while the driver was restarted");
+        }
+    }
+
+    vector<string>().swap(inst->pending);
+
+    inst->pending_size = 0;
+
+    pthread_mutex_unlock(&write_mutex);
 
     return rc;
 }
@@ -314,3 +452,386 @@ int Mad::reload()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+MadInstance * Mad::route(const string& message, int& id) const
+{
+    map<int, pair<MadInstance *, int> >::iterator it;
+
+    MadInstance *       inst = 0;
+    string::size_type   pos;
+
+    id = -1;
+
+    if ( instances.size() == 1 )
+    {
+        return instances[0];
+    }
+
+    // Object id: the second token of the message, "ACTION ID ..."
+    pos = message.find(' ');
+
+    if ( pos == string::npos ||
+         sscanf(message.c_str() + pos + 1, "%d", &id) != 1 )
+    {
+        id = -1;
+    }
+    else
+    {
+        it = routes.find(id);
+
+        if ( it != routes.end() )
+        {
+            return it->second.first;
+        }
+
+        // Cancel requests go to the process of the object, if any
+        if ( message.compare(0, pos, "DRIVER_CANCEL") == 0 )
+        {
+            id = -1;
+        }
+    }
+
+    for (unsigned int i = 0; i < instances.size(); i++)
+    {
+        if ( instances[i]->restarting )
+        {
+            continue;
+        }
+
+        if ( inst == 0 || instances[i]->requests < inst->requests )
+        {
+            inst = instances[i];
+        }
+    }
+
+    // All the processes are restarting, the message waits for one of them
+    if ( inst == 0 )
+    {
+        inst = instances[0];
+    }
+
+    return inst;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void Mad::request(MadInstance * inst, const string& message, int id) const
+{
+    map<int, pair<MadInstance *, int> >::iterator it;
+
+    if ( id == -1 )
+    {
+        return;
+    }
+
+    it = routes.find(id);
+
+    // The cancelled actions are not answered by the driver, their requests
+    // are no longer in progress. Cancel requests do not get an answer either
+    if ( message.compare(0, 14, "DRIVER_CANCEL ") == 0 )
+    {
+        if ( it != routes.end() && it->second.first == inst )
+        {
+            inst->requests -= it->second.second;
+
+            routes.erase(it);
+        }
+
+        return;
+    }
+
+    if ( it == routes.end() )
+    {
+        it = routes.insert(make_pair(id, make_pair(inst, 0))).first;
+    }
+
+    it->second.second++;
+
+    inst->requests++;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void Mad::answer(MadInstance * inst, const string& message)
+{
+    map<int, pair<MadInstance *, int> >::iterator it;
+
+    string::size_type   pos;
+    int                 id;
+
+    if ( instances.size() == 1 )
+    {
+        return;
+    }
+
+    // Final answers: "ACTION SUCCESS ID ..." or "ACTION FAILURE ID ..."
+    pos = message.find(' ');
+
+    if ( pos == string::npos )
+    {
+        return;
+    }
+
+    if ( message.compare(pos + 1, 8, "SUCCESS ") != 0 &&
+         message.compare(pos + 1, 8, "FAILURE ") != 0 )
+    {
+        return;
+    }
+
+    if ( sscanf(message.c_str() + pos + 9, "%d", &id) != 1 )
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&write_mutex);
+
+    it = routes.find(id);
+
+    if ( it != routes.end() && it->second.first == inst )
+    {
+        inst->requests--;
+
+        if ( --it->second.second <= 0 )
+        {
+            routes.erase(it);
+        }
+    }
+
+    pthread_mutex_unlock(&write_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Mad::write(ostringstream& os) const
+{
+    string          str = os.str();
+    string          action;
+    MadInstance *   inst;
+    int             id;
+    int             rc;
+
+    // Only the action is needed to account the request, str may be framed
+    action = str.substr(0, 14);
+
+    pthread_mutex_lock(&write_mutex);
+
+    inst = route(str, id);
+
+    if ( inst->restarting )
+    {
+        if ( inst->pending_size + str.size() > max_write_buffer )
+        {
+            write_rejected++;
+
+            pthread_mutex_unlock(&write_mutex);
+            return -1;
+        }
+
+        inst->pending.push_back(str);
+        inst->pending_size += str.size();
+
+        rc = 0;
+    }
+    else
+    {
+        rc = send(inst, str);
+    }
+
+    if ( rc == 0 )
+    {
+        request(inst, action, id);
+    }
+
+    pthread_mutex_unlock(&write_mutex);
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int Mad::send(MadInstance * inst, string& str) const
+{
+    ssize_t rc = 0;
+
+    if ( inst->framed )
+    {
+        ostringstream       header;
+        string::size_type   length = str.size();
+
+        if ( length > 0 && str[length - 1] == '\n' )
+        {
+            length--;
+        }
+
+        header << length << "\n";
+
+        str.erase(length);
+        str.insert(0, header.str());
+    }
+    else if ( str.find('\n') < str.size() - 1 )
+    {
+        NebulaLog::log("MAD", Log::ERROR,
+            "Message with new lines for a driver without framed protocol");
+
+        return -1;
+    }
+
+    // Write directly to the pipe, unless there are messages queued before
+    if ( inst->write_buffer.empty() )
+    {
+        do
+        {
+            rc = ::write(inst->nebula_mad_pipe, str.c_str(), str.size());
+        }
+        while ( rc == -1 && errno == EINTR );
+
+        if ( rc == -1 )
+        {
+            if ( errno != EAGAIN )
+            {
+                return -1;
+            }
+
+            rc = 0;
+        }
+        else if ( static_cast<string::size_type>(rc) == str.size() )
+        {
+            return 0;
+        }
+    }
+
+    // A message partially written is always queued to keep the stream valid
+    if ( rc == 0 && inst->write_buffer.size() - inst->write_offset +
+            str.size() > max_write_buffer )
+    {
+        write_rejected++;
+
+        return -1;
+    }
+
+    if ( inst->write_buffer.empty() )
+    {
+        struct epoll_event ev;
+
+        ev.events   = EPOLLOUT;
+        ev.data.ptr = static_cast<void *>(inst);
+
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, inst->nebula_mad_pipe, &ev);
+    }
+
+    inst->write_buffer.append(str, rc, string::npos);
+
+    if ( inst->write_buffer.size() - inst->write_offset > max_write_size )
+    {
+        max_write_size = inst->write_buffer.size() - inst->write_offset;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool Mad::framed() const
+{
+    bool rc = true;
+
+    pthread_mutex_lock(&write_mutex);
+
+    // The protocol of a process being restarted is not known yet
+    for (unsigned int i = 0; i < instances.size() && rc; i++)
+    {
+        rc = !instances[i]->restarting && instances[i]->framed;
+    }
+
+    pthread_mutex_unlock(&write_mutex);
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+bool Mad::busy() const
+{
+    bool rc = true;
+
+    pthread_mutex_lock(&write_mutex);
+
+    for (unsigned int i = 0; i < instances.size() && rc; i++)
+    {
+        rc = !instances[i]->write_buffer.empty() ||
+             !instances[i]->pending.empty();
+    }
+
+    pthread_mutex_unlock(&write_mutex);
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void Mad::flush(MadInstance * inst)
+{
+    ssize_t rc;
+
+    pthread_mutex_lock(&write_mutex);
+
+    if ( inst->write_buffer.empty() )
+    {
+        pthread_mutex_unlock(&write_mutex);
+        return;
+    }
+
+    do
+    {
+        rc = ::write(inst->nebula_mad_pipe,
+                     inst->write_buffer.data() + inst->write_offset,
+                     inst->write_buffer.size() - inst->write_offset);
+    }
+    while ( rc == -1 && errno == EINTR );
+
+    if ( rc > 0 )
+    {
+        inst->write_offset += rc;
+
+        if ( inst->write_offset == inst->write_buffer.size() )
+        {
+            clear_write_buffer(inst);
+        }
+        else if ( inst->write_offset >=
+                  inst->write_buffer.size() - inst->write_offset )
+        {
+            inst->write_buffer.erase(0, inst->write_offset);
+            inst->write_offset = 0;
+        }
+    }
+    else if ( rc == -1 && errno != EAGAIN )
+    {
+        // The driver is gone, it is reloaded when its output is closed
+        clear_write_buffer(inst);
+    }
+
+    pthread_mutex_unlock(&write_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void Mad::clear_write_buffer(MadInstance * inst)
+{
+    struct epoll_event ev;
+
+    if ( !inst->write_buffer.empty() )
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, inst->nebula_mad_pipe, &ev);
+    }
+
+    string().swap(inst->write_buffer);
+
+    inst->write_offset = 0;
+}
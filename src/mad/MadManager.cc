@@ -16,13 +16,27 @@
 
 #include <signal.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/time.h>
 
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 
 #include "MadManager.h"
 #include "SyncRequest.h"
+#include "NebulaLog.h"
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MadManager::workers_size = 0;
+
+const string MadWorker::MESSAGE = "MESSAGE";
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
@@ -30,6 +44,7 @@
 MadManager::MadManager(vector<const Attribute*>& _mads):mad_conf(_mads)
 {
     pthread_mutex_init(&mutex,0);
+    pthread_mutex_init(&stats_mutex,0);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -38,6 +53,7 @@ MadManager::MadManager(vector<const Attribute*>& _mads):mad_conf(_mads)
 MadManager::~MadManager()
 {   
     pthread_mutex_destroy(&mutex);
+    pthread_mutex_destroy(&stats_mutex);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -58,10 +74,12 @@ extern "C" void * mad_manager_listener(
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void MadManager::mad_manager_system_init()
+void MadManager::mad_manager_system_init(int _workers)
 {
     struct sigaction  act;
 
+    workers_size = _workers;
+
     act.sa_handler = SIG_IGN;
     act.sa_flags   = SA_RESTART;
     sigemptyset(&act.sa_mask);
@@ -74,25 +92,31 @@ void MadManager::mad_manager_system_init()
 
 int MadManager::start()
 {
-    int             rc;
-    int             pipes[2];
+    int rc;
 
     lock();
 
-    rc = pipe(pipes);
+    epoll_fd = epoll_create(16);
 
-    if ( rc == -1)
+    if ( epoll_fd == -1 )
     {
-        goto error_pipe;
+        goto error_epoll;
     }
 
-    pipe_r = pipes[0];
-    pipe_w = pipes[1];
+    fcntl(epoll_fd, F_SETFD, FD_CLOEXEC);
+
+    for (int i = 0; i < workers_size; i++)
+    {
+        MadWorker * mw = new MadWorker(this);
 
-    fcntl(pipe_r, F_SETFD, FD_CLOEXEC);
-    fcntl(pipe_w, F_SETFD, FD_CLOEXEC);
+        if ( mw->start() != 0 )
+        {
+            delete mw;
+            goto error_create;
+        }
 
-    fds.push_back(pipe_r);
+        workers.push_back(mw);
+    }
 
     rc = pthread_create(&listener_thread,
                         0,
@@ -108,10 +132,18 @@ int MadManager::start()
     return 0;
 
 error_create:
-    close(pipe_r);
-    close(pipe_w);
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i]->stop();
+
+        delete workers[i];
+    }
+
+    workers.clear();
+
+    close(epoll_fd);
 
-error_pipe:
+error_epoll:
 
     unlock();
 
@@ -126,12 +158,20 @@ void MadManager::stop()
     pthread_cancel(listener_thread);
 
     pthread_join(listener_thread,0);
-    
+
+    // Process the queued messages before finalizing the drivers
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i]->stop();
+
+        delete workers[i];
+    }
+
+    workers.clear();
+
     lock();
        
-    close(pipe_r);
-    
-    close(pipe_w);
+    close(epoll_fd);
     
     for (unsigned int i=0;i<mads.size();i++)
     {
@@ -146,8 +186,8 @@ void MadManager::stop()
 
 int MadManager::add(Mad *mad)
 {
-    char    buf = 'A';
-    int     rc;
+    struct epoll_event  ev;
+    int                 rc;
 
     if ( mad == 0 )
     {
@@ -156,6 +196,8 @@ int MadManager::add(Mad *mad)
     
     lock();
 
+    mad->epoll_fd = epoll_fd;
+
     rc = mad->start();
 
     if ( rc != 0 )
@@ -165,9 +207,36 @@ int MadManager::add(Mad *mad)
         return -1;
     }
 
-    mads.push_back(mad);
+    for (unsigned int i = 0; i < mad->instances.size(); i++)
+    {
+        ev.events   = EPOLLIN;
+        ev.data.ptr = static_cast<void *>(mad->instances[i]);
+
+        rc = epoll_ctl(epoll_fd, EPOLL_CTL_ADD,
+                       mad->instances[i]->mad_nebula_pipe, &ev);
+
+        if ( rc != 0 )
+        {
+            ostringstream oss;
+
+            oss << "Error adding driver pipe to the listener: "
+                << strerror(errno);
 
-    write(pipe_w, &buf, sizeof(char));
+            NebulaLog::log("MAD", Log::ERROR, oss);
+
+            for (unsigned int j = 0; j < i; j++)
+            {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL,
+                          mad->instances[j]->mad_nebula_pipe, &ev);
+            }
+
+            unlock();
+
+            return -1;
+        }
+    }
+
+    mads.push_back(mad);
 
     unlock();
 
@@ -213,128 +282,428 @@ const Mad * MadManager::get(
 
 void MadManager::listener()
 {
-    int             greater;
-    unsigned int    i,j;
-    int             rc,mrc;
-
-    char            c;
-
-    Mad *           mad;
-    int             fd;
-    fd_set          in_pipes;
-    fd_set          rfds;
-    struct timeval  tv;
-        
+    int                 rc;
+    MadInstance *       inst;
+
+    struct epoll_event  events[16];
+    char                chunk[read_chunk_size];
+
+    vector<MadInstance *>   reloaded;
+
     pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
     
     pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED,0); 
     
     while (1)
     {
-        lock();
-        
-        FD_ZERO(&in_pipes);
+        // Wait for a message
+        rc = epoll_wait(epoll_fd, events, 16, -1);
+
+        reloaded.clear();
+
+        for (int i = 0; i < rc; i++)
+        {
+            inst = static_cast<MadInstance *>(events[i].data.ptr);
+
+            // Events of the old pipes of a driver reloaded in this loop
+            if ( !reloaded.empty() &&
+                find(reloaded.begin(), reloaded.end(), inst) != reloaded.end())
+            {
+                continue;
+            }
+
+            // Both pipes of a driver process are registered with the same
+            // pointer. The input (write end) only reports EPOLLOUT and
+            // EPOLLERR, the output (read end) EPOLLIN and EPOLLHUP.
+            if ( events[i].events & (EPOLLOUT | EPOLLERR) )
+            {
+                inst->mad->flush(inst);
+            }
+            else if ( read_messages(inst, chunk) != 0 )
+            {
+                // The driver may be removed, skip the events of all its
+                // processes
+                reloaded.insert(reloaded.end(),
+                                inst->mad->instances.begin(),
+                                inst->mad->instances.end());
+
+                reload_mad(inst);
+            }
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 
-        for (i=0,greater=0; i < fds.size() ; i++)
+int MadManager::read_messages(MadInstance * inst, char * chunk)
+{
+    Mad *               mad = inst->mad;
+    ssize_t             rc;
+    string::size_type   start = 0;
+    string::size_type   end;
+
+    do
+    {
+        rc = read(inst->mad_nebula_pipe, (void *) chunk, read_chunk_size);
+    }
+    while ( rc == -1 && errno == EINTR );
+
+    if ( rc <= 0 )
+    {
+        return -1;
+    }
+
+    inst->read_buffer.append(chunk, rc);
+
+    if ( inst->framed )
+    {
+        return read_frames(inst);
+    }
+
+    // Process the complete messages, keep the last partial line (if any)
+    while ((end = inst->read_buffer.find('\n', start)) != string::npos)
+    {
+        string msg = inst->read_buffer.substr(start, end - start + 1);
+
+        mad->answer(inst, msg);
+
+        dispatch(mad, msg);
+
+        start = end + 1;
+    }
+
+    inst->read_buffer.erase(0, start);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MadManager::read_frames(MadInstance * inst)
+{
+    Mad *               mad = inst->mad;
+    string &            buffer = inst->read_buffer;
+    string::size_type   start = 0;
+    string::size_type   end;
+    string::size_type   length;
+
+    // Process the complete frames, keep the last partial one (if any)
+    while ((end = buffer.find('\n', start)) != string::npos)
+    {
+        if ( end == start ||
+             buffer.find_first_not_of("0123456789", start) != end )
+        {
+            NebulaLog::log("MAD", Log::ERROR,
+                "Wrong frame header in a message from a driver");
+
+            return -1;
+        }
+
+        length = strtoul(buffer.c_str() + start, 0, 10);
+
+        if ( buffer.size() - (end + 1) < length )
         {
-            FD_SET(fds[i], &in_pipes);
+            break;
+        }
+
+        // The messages are handled as in the line protocol, '\n' terminated
+        string msg = buffer.substr(end + 1, length);
+
+        msg += '\n';
+
+        mad->answer(inst, msg);
+
+        dispatch(mad, msg);
+
+        start = end + 1 + length;
+    }
+
+    buffer.erase(0, start);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 
-            if ( fds[i] > greater )
+void MadManager::reload_mad(MadInstance * inst)
+{
+    struct epoll_event  ev;
+    int                 rc;
+    Mad *               mad = inst->mad;
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, inst->mad_nebula_pipe, &ev);
+
+    rc = mad->reload(inst);
+
+    if ( rc == 0 )
+    {
+        ev.events   = EPOLLIN;
+        ev.data.ptr = static_cast<void *>(inst);
+
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, inst->mad_nebula_pipe, &ev);
+
+        mad->recover();
+    }
+    else
+    {
+        bool delete_mad;
+
+        for (unsigned int i = 0; i < mad->instances.size(); i++)
+        {
+            if ( mad->instances[i]->pid != -1 )
             {
-                greater = fds[i];
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL,
+                          mad->instances[i]->mad_nebula_pipe, &ev);
+            }
+        }
+
+        lock();
+
+        for (vector<Mad *>::iterator it = mads.begin(); it != mads.end(); ++it)
+        {
+            if ( *it == mad )
+            {
+                mads.erase(it);
+                break;
             }
         }
 
         unlock();
 
-        // Wait for a message        
-        rc = select(greater+1, &in_pipes, NULL, NULL, NULL);
+        // The workers may still have messages of the driver
+        pthread_mutex_lock(&stats_mutex);
 
-        if ( rc <= 0 )
+        mad->failed = true;
+        delete_mad  = (mad->queued == 0);
+
+        pthread_mutex_unlock(&stats_mutex);
+
+        if ( delete_mad )
         {
-            continue;
+            delete mad;
         }
-        
-        for (i=0; i< fds.size(); i++)
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+long long MadManager::now_us()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, 0);
+
+    return static_cast<long long>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MadManager::dispatch(Mad * mad, string& message)
+{
+    MadMessage *        msg;
+    string::size_type   pos;
+    unsigned int        oid = 0;
+
+    if ( workers.empty() )
+    {
+        mad->protocol(message);
+        return;
+    }
+
+    // Object id: the third token of the message, "ACTION RESULT ID ..."
+    pos = message.find(' ');
+
+    if ( pos != string::npos )
+    {
+        pos = message.find(' ', pos + 1);
+    }
+
+    if ( pos != string::npos )
+    {
+        oid = static_cast<unsigned int>(atoi(message.c_str() + pos + 1));
+    }
+
+    msg = new MadMessage;
+
+    msg->mad         = mad;
+    msg->message     = message;
+    msg->queued_time = now_us();
+
+    pthread_mutex_lock(&stats_mutex);
+
+    mad->queued++;
+
+    if ( mad->queued > mad->max_queued )
+    {
+        mad->max_queued = mad->queued;
+    }
+
+    pthread_mutex_unlock(&stats_mutex);
+
+    workers[oid % workers.size()]->trigger(static_cast<void *>(msg));
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MadManager::process(MadMessage * msg)
+{
+    Mad *       mad = msg->mad;
+    long long   latency;
+    bool        delete_mad;
+
+    mad->protocol(msg->message);
+
+    latency = now_us() - msg->queued_time;
+
+    pthread_mutex_lock(&stats_mutex);
+
+    mad->queued--;
+    mad->processed++;
+
+    mad->latency_sum += latency;
+
+    if ( latency > mad->latency_max )
+    {
+        mad->latency_max = latency;
+    }
+
+    delete_mad = (mad->failed && mad->queued == 0);
+
+    pthread_mutex_unlock(&stats_mutex);
+
+    if ( delete_mad )
+    {
+        delete mad;
+    }
+
+    delete msg;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MadManager::log_stats(const char * module)
+{
+    map<string,string>::iterator it;
+
+    lock();
+
+    for (unsigned int i = 0; i < mads.size(); i++)
+    {
+        ostringstream oss;
+        Mad *         mad = mads[i];
+
+        it = mad->attributes.find("NAME");
+
+        pthread_mutex_lock(&stats_mutex);
+
+        oss << "Driver " << (it != mad->attributes.end() ? it->second : "-")
+            << ": " << mad->queued << " messages queued (max "
+            << mad->max_queued << "), " << mad->processed << " processed "
+            << "(latency avg "
+            << (mad->processed > 0 ? mad->latency_sum/mad->processed/1000 : 0)
+            << " ms, max " << mad->latency_max / 1000 << " ms)";
+
+        mad->max_queued  = mad->queued;
+        mad->processed   = 0;
+        mad->latency_sum = 0;
+        mad->latency_max = 0;
+
+        pthread_mutex_unlock(&stats_mutex);
+
+        pthread_mutex_lock(&mad->write_mutex);
+
+        unsigned int  to_send  = 0;
+        unsigned int  max_size = 0;
+        ostringstream requests;
+
+        for (unsigned int j = 0; j < mad->instances.size(); j++)
         {
-            fd  = fds[i];
+            MadInstance * inst = mad->instances[j];
+            unsigned int  size = inst->write_buffer.size() - inst->write_offset;
+
+            to_send += size;
 
-            if ( FD_ISSET(fd, &in_pipes) )
+            if ( size > max_size )
             {
-                if ( fd == pipe_r ) // Driver added, update the fd vector
-                {
-                    read(fd, (void *) &c, sizeof(char));
-                    
-                    lock();
-
-                    fds.clear();
-
-                    fds.push_back(pipe_r);
-
-                    for (j=0;j<mads.size();j++)
-                    {
-                        fds.push_back(mads[j]->mad_nebula_pipe);
-                    }
-
-                    unlock();
-                    
-                    continue;
-                }
-
-                mad = mads[i-1];
-
-                buffer.str("");
-
-                do
-                {
-                    FD_ZERO(&rfds);
-                    FD_SET(mad->mad_nebula_pipe, &rfds);
-
-                    tv.tv_sec  = 0;
-                    tv.tv_usec = 25000;
-
-                    rc = select(mad->mad_nebula_pipe+1,&rfds,0,0,&tv);
-            
-                    if ( rc <= 0 )
-                    {
-                        break;
-                    }
-
-                    rc = read(mad->mad_nebula_pipe,(void *) &c,sizeof(char));
-                    buffer.put(c);
-                }
-                while ( rc > 0 && c != '\n');
-                                
-                if ( rc <= 0 ) // Error reload the driver and recover
-                {
-                    mrc = mad->reload();
-
-                    if ( mrc == 0 )
-                    {
-                        mad->recover();
-                    }
-                    else
-                    {                        
-                        lock();
-
-                        mads.erase(mads.begin() + i - 1);
-
-                        delete mad;
-
-                        unlock();
-                        
-                    }
-
-                    continue;
-                }
-                else //MAD specific protocol
-                {
-                    string msg = buffer.str();
-
-                    mad->protocol(msg);
-                }
+                max_size = size;
             }
+
+            requests << (j == 0 ? "" : "/") << inst->requests;
+        }
+
+        oss << ", " << to_send << " bytes to send (max "
+            << mad->max_write_size << "), " << mad->write_rejected
+            << " messages rejected";
+
+        if ( mad->instances.size() > 1 )
+        {
+            oss << ", requests in progress " << requests.str();
         }
+
+        mad->max_write_size = max_size;
+        mad->write_rejected = 0;
+
+        pthread_mutex_unlock(&mad->write_mutex);
+
+        NebulaLog::log(module, Log::INFO, oss);
+    }
+
+    unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+extern "C" void * mad_worker_loop(void * _mw)
+{
+    MadWorker * mw;
+
+    mw = static_cast<MadWorker *>(_mw);
+
+    mw->am.loop(0, 0);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MadWorker::start()
+{
+    pthread_attr_t  pattr;
+
+    pthread_attr_init (&pattr);
+    pthread_attr_setdetachstate (&pattr, PTHREAD_CREATE_JOINABLE);
+
+    return pthread_create(&worker_thread, &pattr, mad_worker_loop,
+                          (void *) this);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MadWorker::stop()
+{
+    am.trigger(ACTION_FINALIZE, 0);
+
+    pthread_join(worker_thread, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MadWorker::do_action(const string& action, void * arg)
+{
+    if ( action == MESSAGE )
+    {
+        mm->process(static_cast<MadManager::MadMessage *>(arg));
     }
 }
 
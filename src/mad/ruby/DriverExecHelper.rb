@@ -47,6 +47,10 @@ module DriverExecHelper
 
         # mutex for logging
         @send_mutex = Mutex.new
+
+        # messages are sent as "<length>\n<message>" once the core accepts
+        # the framed protocol
+        @framed = false
     end
 
     #
@@ -97,10 +101,18 @@ module DriverExecHelper
     #
     #                METHODS FOR LOGS & COMMAND OUTPUT
     #     
-    # Sends a message to the OpenNebula core through stdout
+    # Sends a message to the OpenNebula core through stdout. The +info+ can
+    # be multiline if the framed protocol is used
     def send_message(action="-", result=RESULT[:failure], id="-", info="-")
+        msg = "#{action} #{result} #{id} #{info}"
+
         @send_mutex.synchronize {
-            STDOUT.puts "#{action} #{result} #{id} #{info}"
+            if @framed
+                STDOUT.write "#{msg.bytesize}\n#{msg}"
+            else
+                STDOUT.puts msg
+            end
+
             STDOUT.flush
         }
     end
@@ -47,12 +47,16 @@ class OpenNebulaDriver < ActionManager
     # @option options [Hash] :local_actions ({}) hash with the actions
     #   executed locally and the name of the script if it differs from the
     #   default one. This hash can be constructed using {parse_actions_list}
+    # @option options [Boolean] :framed (false) accepts the framed protocol if
+    #   offered by the core. Messages are sent as "<length>\n<message>" and
+    #   can include new lines, so the XML documents are not base64 encoded
     def initialize(directory, options={})
         @options={
             :concurrency => 10,
             :threaded    => true,
             :retries     => 0,
-            :local_actions => {}
+            :local_actions => {},
+            :framed      => false
         }.merge!(options)
 
         super(@options[:concurrency], @options[:threaded])
@@ -166,18 +170,62 @@ class OpenNebulaDriver < ActionManager
 
 private
 
-    def init
-        send_message("INIT",RESULT[:success])
+    # The core offers the framed protocol with "INIT FRAMED", the answer
+    # "INIT SUCCESS FRAMED" accepts it. Both directions are framed after it
+    def init(args=[])
+        if @options[:framed] && args.include?("FRAMED")
+            @send_mutex.synchronize {
+                @framed_input = true
+
+                STDOUT.puts "INIT #{RESULT[:success]} FRAMED"
+                STDOUT.flush
+
+                @framed = true
+            }
+        else
+            send_message("INIT",RESULT[:success])
+        end
+    end
+
+    # Reads the next message from the core, nil if there is nothing to read
+    def read_message
+        return STDIN.gets if !@framed_input
+
+        header = STDIN.gets
+        return nil if !header
+
+        STDIN.read(header.to_i)
+    end
+
+    # Splits a message in the action and its arguments. Framed messages
+    # keep the new lines of the last argument (e.g. an XML document)
+    def split_message(str)
+        return str.split(/\s+/) if !@framed_input
+
+        action = str[/\A\S+/]
+        return [] if !action
+
+        arity = 0
+
+        if @actions[action.upcase.to_sym]
+            arity = @actions[action.upcase.to_sym][:method].arity
+        end
+
+        if arity > 0
+            str.strip.split(/ +/, arity + 1)
+        else
+            str.split(/\s+/)
+        end
     end
 
     def loop
         while true
             exit(-1) if STDIN.eof?
 
-            str=STDIN.gets
+            str=read_message
             next if !str
 
-            args   = str.split(/\s+/)
+            args   = split_message(str)
             next if args.length == 0
 
             action = args.shift.upcase.to_sym
@@ -191,6 +239,9 @@ private
             if action == :DRIVER_CANCEL
                 cancel_action(action_id)
                 log(action_id,"Driver command for #{action_id} cancelled")
+            elsif action == :INIT
+                # Not threaded, the protocol of next messages depends on it
+                init(args)
             else
                 trigger_action(action,action_id,*args)
             end
@@ -39,6 +39,7 @@ class VirtualMachineDriver < OpenNebulaDriver
         :restore     => "RESTORE",
         :migrate     => "MIGRATE",
         :poll        => "POLL",
+        :poll_host   => "POLL_HOST",
         :log         => "LOG",
         :attach_disk => "ATTACHDISK",
         :detach_disk => "DETACHDISK",
@@ -87,21 +88,55 @@ class VirtualMachineDriver < OpenNebulaDriver
         register_action(ACTION[:restore].to_sym,     method("restore"))
         register_action(ACTION[:migrate].to_sym,     method("migrate"))
         register_action(ACTION[:poll].to_sym,        method("poll"))
+        register_action(ACTION[:poll_host].to_sym,   method("poll_host"))
         register_action(ACTION[:attach_disk].to_sym, method("attach_disk"))
         register_action(ACTION[:detach_disk].to_sym, method("detach_disk"))
     end
 
-    # Decodes the encoded XML driver message received from the core
+    # Decodes the XML driver message received from the core. It is base64
+    # encoded unless the framed protocol is used
     #
     # @param [String] drv_message the driver message
     # @return [REXML::Element] the root element of the decoded XML message
     def decode(drv_message)
-        message = Base64.decode64(drv_message)
+        if drv_message[0, 1] == '<'
+            message = drv_message
+        else
+            message = Base64.decode64(drv_message)
+        end
+
         xml_doc = REXML::Document.new(message)
 
         xml_doc.root
     end
 
+    # Decodes the driver message of the POLL and POLL_HOST actions. It is a
+    # plain list of attributes, not XML nor base64 encoded:
+    #   POLL:      HOST=<host>,DEPLOY_ID=<deploy_id>
+    #   POLL_HOST: HOST=<host>,VM=<id>:<deploy_id>,VM=<id>:<deploy_id>...
+    #
+    # @param [String] drv_message the driver message
+    # @return [Hash] with :host, :deploy_id and :vms (deploy_id => VM id)
+    def decode_poll(drv_message)
+        data = { :host => nil, :deploy_id => nil, :vms => {} }
+
+        drv_message.split(',').each do |attr|
+            name, value = attr.split('=', 2)
+
+            case name
+            when 'HOST'
+                data[:host] = value
+            when 'DEPLOY_ID'
+                data[:deploy_id] = value
+            when 'VM'
+                vm_id, deploy_id = value.split(':', 2)
+                data[:vms][deploy_id] = vm_id
+            end
+        end
+
+        data
+    end
+
     # Execute a command associated to an action and id in a remote host.
     def remotes_action(command, id, host, action, remote_dir, std_in=nil)
         super(command,id,host,ACTION[action],remote_dir,std_in)
@@ -158,6 +193,11 @@ class VirtualMachineDriver < OpenNebulaDriver
         send_message(ACTION[:poll],RESULT[:failure],id,error)
     end
 
+    def poll_host(id, drv_message)
+        error = "Action not implemented by driver #{self.class}"
+        send_message(ACTION[:poll_host],RESULT[:failure],id,error)
+    end
+
     def attach_disk(id, drv_message)
         error = "Action not implemented by driver #{self.class}"
         send_message(ACTION[:attach_disk],RESULT[:failure],id,error)
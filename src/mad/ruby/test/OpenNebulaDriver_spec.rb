@@ -120,6 +120,27 @@ describe OpenNebulaDriver do
         result[0].should == "action SUCCESS 15 some info"
     end
 
+    it 'should send framed messages if the protocol is accepted' do
+        result=[]
+        driver=OpenNebulaDriver.new(@directory, :framed => true)
+
+        MonkeyPatcher.patch do
+            patch_class(IO, :puts) do |*args|
+                result<<args[0]
+            end
+
+            patch_class(IO, :write) do |*args|
+                result<<args[0]
+            end
+
+            driver.send(:init, ['FRAMED'])
+            driver.send_message('action', 'SUCCESS', 15, "some\ninfo")
+        end
+
+        result[0].should == "INIT SUCCESS FRAMED"
+        result[1].should == "27\naction SUCCESS 15 some\ninfo"
+    end
+
     it 'should select remote or local execution correctly' do
         local_action=[]
         remotes_action=[]
@@ -0,0 +1,592 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include "test/OneUnitTest.h"
+#include "MadManager.h"
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <set>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+using namespace std;
+
+/* -------------------------------------------------------------------------- */
+
+class SeqMad : public Mad
+{
+public:
+    SeqMad(const map<string,string>& attrs, int _objects):
+        Mad(0, attrs, false), objects(_objects), count(0), errors(0),
+        slow_pid(0)
+    {
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&cond, 0);
+
+        last.resize(objects, -1);
+        threads.resize(objects);
+    };
+
+    ~SeqMad()
+    {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&cond);
+    };
+
+    void seq(int messages)
+    {
+        ostringstream os;
+
+        os << "SEQ " << objects << " " << messages << endl;
+
+        write(os);
+    };
+
+    int send(const string& message)
+    {
+        ostringstream os;
+
+        os << message << endl;
+
+        return write(os);
+    };
+
+    bool is_busy()
+    {
+        return busy();
+    };
+
+    bool is_framed()
+    {
+        return framed();
+    };
+
+    void wait(int messages)
+    {
+        pthread_mutex_lock(&mutex);
+
+        while ( count < messages )
+        {
+            pthread_cond_wait(&cond, &mutex);
+        }
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    int            objects;
+    int            count;
+    int            errors;
+
+    vector<int>               last;
+    vector<pthread_t>         threads;
+    set<pthread_t>            all_threads;
+
+    map<int,string>           echoes;
+
+    map<int,int>              pids;
+    set<int>                  all_pids;
+    int                       slow_pid;
+    map<int,int>              slow_pids;
+
+private:
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+
+    void protocol(string& message)
+    {
+        istringstream is(message);
+        string        action;
+        string        result;
+        int           oid;
+        int           n;
+
+        is >> action >> result >> oid >> n;
+
+        pthread_mutex_lock(&mutex);
+
+        if ( action == "ECHO" )
+        {
+            echoes[oid] = message;
+        }
+        else if ( action == "SLOW" )
+        {
+            slow_pid        = n;
+            slow_pids[oid]  = n;
+        }
+        else if ( action == "PID" )
+        {
+            // Driver process that answered each object
+            pids[oid] = n;
+            all_pids.insert(n);
+
+            if ( oid == 7 && slow_pid == 0 )
+            {
+                errors++;
+            }
+        }
+        else if ( action != "SEQ" )
+        {
+            // Answers to other commands are just counted
+        }
+        else if ( oid < 0 || oid >= objects || n <= last[oid] )
+        {
+            errors++;
+        }
+        else
+        {
+            // Messages of the same object are processed by the same thread
+            if ( last[oid] != -1 && threads[oid] != pthread_self() )
+            {
+                errors++;
+            }
+
+            last[oid]    = n;
+            threads[oid] = pthread_self();
+        }
+
+        all_threads.insert(pthread_self());
+
+        count++;
+
+        pthread_cond_signal(&cond);
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    void recover(){};
+};
+
+/* -------------------------------------------------------------------------- */
+
+class SeqManager : public MadManager
+{
+public:
+    SeqManager(vector<const Attribute *>& mads):MadManager(mads), mad(0){};
+
+    ~SeqManager()
+    {
+        stop();
+    };
+
+    void load_mads(int uid){};
+
+    void load_seq_mad(int            objects,
+                      const string&  instances = "1",
+                      const string&  arguments = "")
+    {
+        char               path[PATH_MAX];
+        map<string,string> attrs;
+
+        realpath("dummy", path);
+
+        attrs.insert(make_pair("EXECUTABLE", string(path)));
+        attrs.insert(make_pair("NAME", string("seq")));
+        attrs.insert(make_pair("INSTANCES", instances));
+        attrs.insert(make_pair("ARGUMENTS", arguments));
+
+        mad = new SeqMad(attrs, objects);
+
+        if ( add(mad) != 0 )
+        {
+            delete mad;
+            mad = 0;
+        }
+    };
+
+    int start()
+    {
+        return MadManager::start();
+    };
+
+    void log_stats()
+    {
+        MadManager::log_stats("MAD");
+    };
+
+    SeqMad * mad;
+};
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+class MadManagerTest : public OneUnitTest
+{
+    CPPUNIT_TEST_SUITE (MadManagerTest);
+
+    CPPUNIT_TEST (test_no_workers);
+    CPPUNIT_TEST (test_workers_order);
+    CPPUNIT_TEST (test_write_queue);
+    CPPUNIT_TEST (test_write_full);
+    CPPUNIT_TEST (test_instances);
+    CPPUNIT_TEST (test_cancel);
+    CPPUNIT_TEST (test_framed);
+    CPPUNIT_TEST (test_reload);
+
+    CPPUNIT_TEST_SUITE_END ();
+
+public:
+    void setUp(){};
+
+    void tearDown()
+    {
+        MadManager::mad_manager_system_init();
+    };
+
+    /* ---------------------------------------------------------------------- */
+
+    void run_seq(int workers, int objects, int messages, size_t& threads)
+    {
+        vector<const Attribute *> mads;
+
+        MadManager::mad_manager_system_init(workers);
+
+        SeqManager mm(mads);
+
+        CPPUNIT_ASSERT(mm.start() == 0);
+
+        mm.load_seq_mad(objects);
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+
+        mm.mad->seq(messages);
+        mm.mad->wait(messages);
+
+        mm.log_stats();
+
+        CPPUNIT_ASSERT(mm.mad->count  == messages);
+        CPPUNIT_ASSERT(mm.mad->errors == 0);
+
+        for (int i = 0; i < objects; i++)
+        {
+            CPPUNIT_ASSERT(mm.mad->last[i] == messages - objects + i);
+        }
+
+        threads = mm.mad->all_threads.size();
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_no_workers()
+    {
+        size_t threads;
+
+        // Messages are processed by the listener thread
+        run_seq(0, 8, 2000, threads);
+
+        CPPUNIT_ASSERT(threads == 1);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_workers_order()
+    {
+        size_t threads;
+
+        run_seq(4, 8, 20000, threads);
+
+        CPPUNIT_ASSERT(threads == 4);
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_write_queue()
+    {
+        vector<const Attribute *> mads;
+        string                    nop(100, 'x');
+
+        MadManager::mad_manager_system_init();
+
+        SeqManager mm(mads);
+
+        CPPUNIT_ASSERT(mm.start() == 0);
+
+        mm.load_seq_mad(1);
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+        CPPUNIT_ASSERT(mm.mad->send("BLOCK 1") == 0);
+
+        // The messages do not fit in the pipe, they are queued without
+        // blocking while the driver does not read
+        for (int i = 0; i < 2000; i++)
+        {
+            CPPUNIT_ASSERT(mm.mad->send("NOP " + nop) == 0);
+        }
+
+        CPPUNIT_ASSERT(mm.mad->is_busy() == true);
+
+        mm.mad->wait(2000);
+
+        CPPUNIT_ASSERT(mm.mad->is_busy() == false);
+
+        mm.log_stats();
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_write_full()
+    {
+        vector<const Attribute *> mads;
+        string                    msg(1024 * 1024, 'x');
+        int                       sent = 0;
+
+        MadManager::mad_manager_system_init();
+
+        SeqManager mm(mads);
+
+        CPPUNIT_ASSERT(mm.start() == 0);
+
+        mm.load_seq_mad(1);
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+        CPPUNIT_ASSERT(mm.mad->send("HANG 2") == 0);
+
+        // The queue is bounded, messages over the limit are rejected
+        for (int i = 0; i < 32; i++)
+        {
+            if ( mm.mad->send(msg) != 0 )
+            {
+                break;
+            }
+
+            sent++;
+        }
+
+        CPPUNIT_ASSERT(sent >= 16);
+        CPPUNIT_ASSERT(sent < 32);
+
+        CPPUNIT_ASSERT(mm.mad->is_busy() == true);
+
+        mm.log_stats();
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_instances()
+    {
+        vector<const Attribute *> mads;
+        ostringstream             oss;
+
+        MadManager::mad_manager_system_init();
+
+        SeqManager mm(mads);
+
+        CPPUNIT_ASSERT(mm.start() == 0);
+
+        mm.load_seq_mad(1, "3");
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+
+        // Object 7 is in progress in a process for a while, the next
+        // request of the object goes to the same process
+        CPPUNIT_ASSERT(mm.mad->send("SLOW 7 1") == 0);
+
+        for (int i = 0; i < 30; i++)
+        {
+            oss.str("");
+            oss << "PID " << i;
+
+            CPPUNIT_ASSERT(mm.mad->send(oss.str()) == 0);
+        }
+
+        mm.mad->wait(31);
+
+        // "PID 7" is answered after "SLOW 7 1", by the same process
+        CPPUNIT_ASSERT(mm.mad->errors == 0);
+        CPPUNIT_ASSERT(mm.mad->slow_pid != 0);
+        CPPUNIT_ASSERT(mm.mad->pids[7] == mm.mad->slow_pid);
+
+        // The requests of the other objects are balanced among the processes
+        CPPUNIT_ASSERT(mm.mad->pids.size() == 30);
+        CPPUNIT_ASSERT(mm.mad->all_pids.size() == 3);
+
+        mm.log_stats();
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_cancel()
+    {
+        vector<const Attribute *> mads;
+        ostringstream             oss;
+
+        MadManager::mad_manager_system_init();
+
+        SeqManager mm(mads);
+
+        CPPUNIT_ASSERT(mm.start() == 0);
+
+        mm.load_seq_mad(1, "2");
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+
+        // Three requests in progress in each process, objects 1, 3 and 5
+        // in the first one
+        for (int i = 1; i <= 6; i++)
+        {
+            oss.str("");
+            oss << "SLOW " << i << " 0.5";
+
+            CPPUNIT_ASSERT(mm.mad->send(oss.str()) == 0);
+        }
+
+        // The actions of the first process are cancelled, the next requests
+        // go to it while the second one has its three requests in progress
+        CPPUNIT_ASSERT(mm.mad->send("DRIVER_CANCEL 1") == 0);
+        CPPUNIT_ASSERT(mm.mad->send("DRIVER_CANCEL 3") == 0);
+        CPPUNIT_ASSERT(mm.mad->send("DRIVER_CANCEL 5") == 0);
+
+        for (int i = 10; i < 13; i++)
+        {
+            oss.str("");
+            oss << "PID " << i;
+
+            CPPUNIT_ASSERT(mm.mad->send(oss.str()) == 0);
+        }
+
+        mm.mad->wait(12);
+
+        CPPUNIT_ASSERT(mm.mad->slow_pids[1] == mm.mad->slow_pids[5]);
+        CPPUNIT_ASSERT(mm.mad->slow_pids[1] != mm.mad->slow_pids[2]);
+
+        for (int i = 10; i < 13; i++)
+        {
+            CPPUNIT_ASSERT(mm.mad->pids[i] == mm.mad->slow_pids[1]);
+        }
+
+        mm.log_stats();
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_framed()
+    {
+        vector<const Attribute *> mads;
+        string                    xml;
+
+        MadManager::mad_manager_system_init();
+
+        SeqManager mm(mads);
+
+        CPPUNIT_ASSERT(mm.start() == 0);
+
+        // Messages with new lines are not sent to line based drivers
+        mm.load_seq_mad(1);
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+        CPPUNIT_ASSERT(mm.mad->is_framed() == false);
+        CPPUNIT_ASSERT(mm.mad->send("ECHO 0 <A>\n</A>") == -1);
+
+        // Framed drivers get (and answer) them as they are
+        mm.load_seq_mad(1, "2", "framed");
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+        CPPUNIT_ASSERT(mm.mad->is_framed() == true);
+
+        for (int i = 0; i < 10000; i++)
+        {
+            xml += "<A>\n  text\n</A>\n";
+        }
+
+        CPPUNIT_ASSERT(mm.mad->send("ECHO 1 <A>\n</A>") == 0);
+        CPPUNIT_ASSERT(mm.mad->send("ECHO 2 " + xml) == 0);
+        CPPUNIT_ASSERT(mm.mad->send("ECHO 3") == 0);
+
+        mm.mad->wait(3);
+
+        CPPUNIT_ASSERT(mm.mad->echoes[1] == "ECHO SUCCESS 1 <A>\n</A>\n");
+        CPPUNIT_ASSERT(mm.mad->echoes[2] == "ECHO SUCCESS 2 " + xml + "\n");
+        CPPUNIT_ASSERT(mm.mad->echoes[3] == "ECHO SUCCESS 3\n");
+
+        mm.log_stats();
+    }
+
+    /* ---------------------------------------------------------------------- */
+
+    void test_reload()
+    {
+        vector<const Attribute *> mads;
+        ostringstream             oss;
+        struct timeval            start, end;
+        int                       old_pid;
+
+        MadManager::mad_manager_system_init();
+
+        SeqManager mm(mads);
+
+        CPPUNIT_ASSERT(mm.start() == 0);
+
+        mm.load_seq_mad(1, "1", "slow_restart");
+
+        CPPUNIT_ASSERT(mm.mad != 0);
+        CPPUNIT_ASSERT(mm.mad->send("PID 0") == 0);
+
+        mm.mad->wait(1);
+
+        old_pid = mm.mad->pids[0];
+
+        // The driver exits and it is restarted, the new process takes 1s
+        // to answer INIT
+        CPPUNIT_ASSERT(mm.mad->send("HANG 0") == 0);
+
+        usleep(300000);
+
+        // Messages sent meanwhile do not wait for the restart...
+        gettimeofday(&start, 0);
+
+        for (int i = 10; i < 20; i++)
+        {
+            oss.str("");
+            oss << "PID " << i;
+
+            CPPUNIT_ASSERT(mm.mad->send(oss.str()) == 0);
+        }
+
+        gettimeofday(&end, 0);
+
+        CPPUNIT_ASSERT((end.tv_sec - start.tv_sec) * 1000000 +
+                       (end.tv_usec - start.tv_usec) < 500000);
+
+        // ...and they are sent to the new process once it is started
+        mm.mad->wait(11);
+
+        for (int i = 10; i < 20; i++)
+        {
+            CPPUNIT_ASSERT(mm.mad->pids[i] != old_pid);
+        }
+
+        CPPUNIT_ASSERT(mm.mad->all_pids.size() == 2);
+
+        oss.str("");
+        oss << "dummy." << getpid();
+
+        unlink(oss.str().c_str());
+
+        mm.log_stats();
+    }
+};
+
+/* ************************************************************************** */
+/* ************************************************************************** */
+
+int main(int argc, char ** argv)
+{
+    return OneUnitTest::main(argc, argv, MadManagerTest::suite(),
+                            "MadManagerTest.xml");
+}
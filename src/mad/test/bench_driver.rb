@@ -0,0 +1,49 @@
+#!/usr/bin/env ruby
+
+# -------------------------------------------------------------------------- #
+# Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             #
+#                                                                            #
+# Licensed under the Apache License, Version 2.0 (the "License"); you may    #
+# not use this file except in compliance with the License. You may obtain    #
+# a copy of the License at                                                   #
+#                                                                            #
+# http://www.apache.org/licenses/LICENSE-2.0                                 #
+#                                                                            #
+# Unless required by applicable law or agreed to in writing, software        #
+# distributed under the License is distributed on an "AS IS" BASIS,          #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   #
+# See the License for the specific language governing permissions and        #
+# limitations under the License.                                             #
+#--------------------------------------------------------------------------- #
+
+# Driver for the deploy benchmark (deploy_bench). It gets the XML of the
+# DEPLOY messages as VirtualMachineDriver#decode does (without parsing it)
+# and answers with its size. Accepts the framed protocol if started with
+# "framed".
+
+BENCH_DIR = File.expand_path(File.dirname(__FILE__))
+
+$: << File.join(BENCH_DIR, '..', 'ruby')
+
+ENV['ONE_LOCATION'] ||= File.join(BENCH_DIR, '..', 'ruby', 'test', 'fixtures')
+
+require 'OpenNebulaDriver'
+require 'VirtualMachineDriver'
+
+class BenchDriver < VirtualMachineDriver
+    def initialize(framed)
+        super('vmm/bench', :concurrency => 1, :framed => framed)
+    end
+
+    def deploy(id, drv_message)
+        if drv_message[0, 1] == '<'
+            xml = drv_message
+        else
+            xml = Base64.decode64(drv_message)
+        end
+
+        send_message(ACTION[:deploy], RESULT[:success], id, xml.length)
+    end
+end
+
+BenchDriver.new(ARGV[0] == 'framed').start_driver
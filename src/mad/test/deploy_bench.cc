@@ -0,0 +1,272 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "NebulaLog.h"
+#include "MadManager.h"
+#include "Benchmark.h"
+#include "SSLTools.h"
+
+using namespace std;
+
+// Large DEPLOY messages for a Ruby driver (bench_driver.rb), with the line
+// protocol (base64 encoded XML) and the framed protocol (raw XML). The driver
+// gets the XML of each message as the VMM drivers do; the time to get all the
+// answers is measured for several message sizes.
+//
+// Usage: deploy_bench [total_mb]
+
+class DeployMad : public Mad
+{
+public:
+    DeployMad(const map<string,string>& attrs):Mad(0, attrs, false), count(0)
+    {
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&cond, 0);
+    };
+
+    ~DeployMad()
+    {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&cond);
+    };
+
+    /**
+     *  Sends a DEPLOY message as the VirtualMachineManagerDriver does
+     */
+    int deploy(int oid, const string& xml)
+    {
+        ostringstream os;
+
+        os << "DEPLOY " << oid << " ";
+
+        if ( framed() )
+        {
+            os << xml << endl;
+        }
+        else
+        {
+            string * xml64 = SSLTools::base64_encode(xml);
+
+            os << *xml64 << endl;
+
+            delete xml64;
+        }
+
+        return write(os);
+    };
+
+    void reset()
+    {
+        pthread_mutex_lock(&mutex);
+        count = 0;
+        pthread_mutex_unlock(&mutex);
+    };
+
+    void wait(int messages)
+    {
+        pthread_mutex_lock(&mutex);
+
+        while ( count < messages )
+        {
+            pthread_cond_wait(&cond, &mutex);
+        }
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    bool is_framed()
+    {
+        return framed();
+    };
+
+private:
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+
+    int             count;
+
+    void protocol(string& message)
+    {
+        pthread_mutex_lock(&mutex);
+
+        count++;
+
+        pthread_cond_signal(&cond);
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    void recover(){};
+};
+
+/* -------------------------------------------------------------------------- */
+
+class DeployManager : public MadManager
+{
+public:
+    DeployManager(vector<const Attribute *>& mads):MadManager(mads), mad(0){};
+
+    ~DeployManager()
+    {
+        stop();
+    };
+
+    void load_mads(int uid){};
+
+    void load_deploy_mad(bool framed)
+    {
+        char               path[PATH_MAX];
+        map<string,string> attrs;
+
+        // The driver is in the directory of the benchmark
+        realpath("bench_driver.rb", path);
+
+        attrs.insert(make_pair("EXECUTABLE", string(path)));
+
+        if ( framed )
+        {
+            attrs.insert(make_pair("ARGUMENTS", string("framed")));
+        }
+
+        mad = new DeployMad(attrs);
+
+        if ( add(mad) != 0 )
+        {
+            delete mad;
+            mad = 0;
+        }
+    };
+
+    int start()
+    {
+        return MadManager::start();
+    };
+
+    DeployMad * mad;
+};
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Builds a VMM_DRIVER_ACTION_DATA document of (about) size bytes, the VM
+ *  template has a multiline CONTEXT attribute to get the size.
+ */
+static string deploy_xml(int size)
+{
+    ostringstream oss;
+    string        line(60, 'x');
+
+    oss << "<VMM_DRIVER_ACTION_DATA><HOST>host01</HOST><NET_DRV>dummy</NET_DRV>"
+        << "<MIGR_HOST/><MIGR_NET_DRV/><DEPLOY_ID/>"
+        << "<LOCAL_DEPLOYMENT_FILE>/var/lib/one/0/deployment.0"
+        << "</LOCAL_DEPLOYMENT_FILE><REMOTE_DEPLOYMENT_FILE/>"
+        << "<CHECKPOINT_FILE/><TM_COMMAND/><DISK_TARGET_PATH/>"
+        << "<VM><ID>0</ID><NAME>bench</NAME><TEMPLATE><CONTEXT>\n";
+
+    for (int i = 0; oss.tellp() < size; i++)
+    {
+        oss << "<VAR_" << i << "><![CDATA[" << line << "\n" << line
+            << "]]></VAR_" << i << ">\n";
+    }
+
+    oss << "</CONTEXT></TEMPLATE></VM></VMM_DRIVER_ACTION_DATA>";
+
+    return oss.str();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    vector<const Attribute *> mads;
+    long                      total = 20;
+
+    // Messages in the driver pipe or queue
+    const int window = 8;
+
+    int sizes[] = {10240, 102400, 1048576};
+
+    ostringstream title;
+
+    BenchColumn columns[] = {
+        {"protocol", 10, 0}, {"size (B)", 12, 0}, {"messages", 12, 0},
+        {"ms", 12, 0}, {"messages/s", 14, 1}, {"MB/s", 12, 1}};
+
+    if ( argc > 1 )
+    {
+        total = atol(argv[1]);
+    }
+
+    total = total * 1024 * 1024;
+
+    NebulaLog::init_log_system(NebulaLog::FILE, Log::ERROR, "bench.log");
+
+    MadManager::mad_manager_system_init();
+
+    DeployManager mm(mads);
+
+    mm.start();
+
+    title << "DEPLOY messages, " << total / (1024 * 1024) << " MB of XML for "
+          << "each message size";
+
+    Benchmark bench(title.str(), columns, 6);
+
+    for (int f = 0; f < 2; f++)
+    {
+        mm.load_deploy_mad(f == 1);
+
+        if ( mm.mad == 0 || mm.mad->is_framed() != (f == 1) )
+        {
+            cout << "Could not start the benchmark driver" << endl;
+            return -1;
+        }
+
+        for (int i = 0; i < 3; i++)
+        {
+            string xml      = deploy_xml(sizes[i]);
+            int    messages = total / sizes[i];
+            double start    = Benchmark::now_ms();
+            double time;
+
+            mm.mad->reset();
+
+            for (int j = 0; j < messages; j++)
+            {
+                mm.mad->wait(j - window);
+                mm.mad->deploy(j, xml);
+            }
+
+            mm.mad->wait(messages);
+
+            time = Benchmark::now_ms() - start;
+
+            bench << (f == 1 ? "framed" : "line") << sizes[i] << messages
+                  << time << messages / (time / 1000)
+                  << (double) messages * sizes[i] / (1024*1024) / (time / 1000);
+        }
+    }
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "NebulaLog.h"
+#include "MadManager.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// Throughput of the driver message reader (MadManager listener). The dummy
+// driver answers "BENCH <n> <size>" with n messages of size bytes as fast as
+// it can; the time to receive all of them is measured for several message
+// sizes. Messages are processed by the listener thread, or by the given
+// number of worker threads.
+//
+// Usage: mad_bench [total_mb] [workers]
+
+class BenchMad : public Mad
+{
+public:
+    BenchMad(const map<string,string>& attrs):Mad(0, attrs, false), count(0)
+    {
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&cond, 0);
+    };
+
+    ~BenchMad()
+    {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&cond);
+    };
+
+    void bench(int messages, int size)
+    {
+        ostringstream os;
+
+        pthread_mutex_lock(&mutex);
+        count = 0;
+        pthread_mutex_unlock(&mutex);
+
+        os << "BENCH " << messages << " " << size << endl;
+
+        write(os);
+    };
+
+    void wait(int messages)
+    {
+        pthread_mutex_lock(&mutex);
+
+        while ( count < messages )
+        {
+            pthread_cond_wait(&cond, &mutex);
+        }
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+private:
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+
+    int             count;
+
+    void protocol(string& message)
+    {
+        pthread_mutex_lock(&mutex);
+
+        count++;
+
+        pthread_cond_signal(&cond);
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    void recover(){};
+};
+
+/* -------------------------------------------------------------------------- */
+
+class BenchManager : public MadManager
+{
+public:
+    BenchManager(vector<const Attribute *>& mads):MadManager(mads), mad(0){};
+
+    ~BenchManager()
+    {
+        stop();
+    };
+
+    void load_mads(int uid)
+    {
+        char               path[PATH_MAX];
+        map<string,string> attrs;
+
+        // The dummy driver is in the directory of the benchmark
+        realpath("dummy", path);
+
+        attrs.insert(make_pair("EXECUTABLE", string(path)));
+
+        mad = new BenchMad(attrs);
+
+        if ( add(mad) != 0 )
+        {
+            delete mad;
+            mad = 0;
+        }
+    };
+
+    int start()
+    {
+        return MadManager::start();
+    };
+
+    BenchMad * mad;
+};
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    vector<const Attribute *> mads;
+    long                      total = 100;
+    int                       workers = 0;
+
+    int sizes[] = {100, 1024, 10240, 102400};
+
+    ostringstream title;
+
+    BenchColumn columns[] = {
+        {"size (B)", 12, 0}, {"messages", 12, 0}, {"ms", 12, 0},
+        {"messages/s", 14, 0}, {"MB/s", 12, 1}};
+
+    if ( argc > 1 )
+    {
+        total = atol(argv[1]);
+    }
+
+    if ( argc > 2 )
+    {
+        workers = atoi(argv[2]);
+    }
+
+    total = total * 1024 * 1024;
+
+    NebulaLog::init_log_system(NebulaLog::FILE, Log::ERROR, "bench.log");
+
+    MadManager::mad_manager_system_init(workers);
+
+    BenchManager mm(mads);
+
+    mm.start();
+    mm.load_mads(0);
+
+    if ( mm.mad == 0 )
+    {
+        cout << "Could not start the dummy driver" << endl;
+        return -1;
+    }
+
+    title << "Driver messages, " << total / (1024 * 1024) << " MB for each "
+          << "message size, " << workers << " workers";
+
+    Benchmark bench(title.str(), columns, 5);
+
+    for (int i = 0; i < 4; i++)
+    {
+        int    messages = total / sizes[i];
+        double start    = Benchmark::now_ms();
+        double time;
+
+        mm.mad->bench(messages, sizes[i]);
+        mm.mad->wait(messages);
+
+        time = Benchmark::now_ms() - start;
+
+        bench << sizes[i] << messages << time << messages / (time / 1000)
+              << (double) messages * sizes[i] / (1024 * 1024) / (time / 1000);
+    }
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
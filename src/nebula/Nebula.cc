@@ -122,16 +122,16 @@ int SystemDB::check_db_version()
     string loaded_db_version = "";
 
     // Try to read latest version
-    set_callback( static_cast<Callbackable::Callback>(&SystemDB::select_cb),
-                  static_cast<void *>(&loaded_db_version) );
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&SystemDB::select_cb),
+                   static_cast<void *>(&loaded_db_version));
 
     oss << "SELECT version FROM " << ver_table
         << " WHERE oid=(SELECT MAX(oid) FROM " << ver_table << ")";
 
-    db->exec(oss, this);
+    db->exec(oss, &cb);
 
     oss.str("");
-    unset_callback();
 
     if( loaded_db_version == "" )
     {
@@ -247,15 +247,14 @@ int SystemDB::select_sys_attribute(const string& attr_name, string& attr_xml)
 
     int rc;
 
-    set_callback(static_cast<Callbackable::Callback>(&SystemDB::select_attr_cb),
-                 static_cast<void *>(&attr_xml) );
+    SqlCallback cb(this,
+            static_cast<Callbackable::Callback>(&SystemDB::select_attr_cb),
+            static_cast<void *>(&attr_xml));
 
     oss << "SELECT body FROM " << sys_table << " WHERE name = '"
         << attr_name << "'";
 
-    rc = db->exec(oss, this);
-
-    unset_callback();
+    rc = db->exec(oss, &cb);
 
     if (rc != 0)
     {
@@ -370,6 +369,8 @@ void Nebula::start()
         string user    = "oneadmin";
         string passwd  = "oneadmin";
         string db_name = "opennebula";
+        int    db_conns = -1;
+        int    db_group = 0;
 
         rc = nebula_configuration->get("DB", dbs);
 
@@ -419,6 +420,17 @@ void Nebula::start()
                 {
                     db_name = value;
                 }
+
+            }
+
+            if ( db->vector_value("CONNECTIONS", db_conns) != 0 )
+            {
+                db_conns = -1;
+            }
+
+            if ( db->vector_value("GROUP_COMMIT", db_group) != 0 )
+            {
+                db_group = 0;
             }
         }
 
@@ -426,29 +438,21 @@ void Nebula::start()
         {
             string  db_name = var_location + "one.db";
 
-            db = new SqliteDB(db_name);
+            if ( db_conns < 0 )
+            {
+                db_conns = 4;
+            }
+
+            db = new SqliteDB(db_name, db_conns, db_group);
         }
         else
         {
-            ostringstream   oss;
-
-            db = new MySqlDB(server,port,user,passwd,db_name);
-
-            oss << "CREATE DATABASE IF NOT EXISTS " << db_name;
-            rc = db->exec(oss);
-
-            if ( rc != 0 )
+            if ( db_conns < 1 )
             {
-                throw runtime_error("Could not create database.");
+                db_conns = 15;
             }
 
-            oss.str("");
-            oss << "USE " << db_name;
-            rc = db->exec(oss);
-            if ( rc != 0 )
-            {
-                throw runtime_error("Could not open database.");
-            }
+            db = new MySqlDB(server,port,user,passwd,db_name,db_conns);
         }
 
         // ---------------------------------------------------------------------
@@ -529,6 +533,8 @@ void Nebula::start()
         vector<const Attribute *> vm_restricted_attrs;
         vector<const Attribute *> img_restricted_attrs;
 
+        vector<const Attribute *> monitoring_rollups;
+
         clpool  = new ClusterPool(db);
         docpool = new DocumentPool(db);
 
@@ -545,6 +551,8 @@ void Nebula::start()
         nebula_configuration->get("VM_MONITORING_EXPIRATION_TIME",vm_expiration);
         nebula_configuration->get("HOST_MONITORING_EXPIRATION_TIME",host_expiration);
 
+        nebula_configuration->get("MONITORING_ROLLUP", monitoring_rollups);
+
         nebula_configuration->get("VM_SUBMIT_ON_HOLD",vm_submit_on_hold);
 
         vmpool = new VirtualMachinePool(db,
@@ -553,12 +561,14 @@ void Nebula::start()
                                         remotes_location,
                                         vm_restricted_attrs,
                                         vm_expiration,
+                                        monitoring_rollups,
                                         vm_submit_on_hold);
         hpool  = new HostPool(db,
                               host_hooks,
                               hook_location,
                               remotes_location,
-                              host_expiration);
+                              host_expiration,
+                              monitoring_rollups);
 
         nebula_configuration->get("MAC_PREFIX", mac_prefix);
         nebula_configuration->get("NETWORK_SIZE", size);
@@ -589,6 +599,37 @@ void Nebula::start()
 
         dspool = new DatastorePool(db);
 
+        // ---------------------------------------------------------------------
+        // Object cache size for each pool
+        // ---------------------------------------------------------------------
+
+        vector<const Attribute *> cache_attrs;
+
+        if ( nebula_configuration->get("POOL_CACHE_SIZE", cache_attrs) > 0 )
+        {
+            const VectorAttribute * cache_conf;
+
+            PoolSQL * pools[] = {vmpool, hpool, vnpool, ipool, upool,
+                                 tpool, gpool, dspool, clpool, docpool};
+
+            const char * names[] = {"VM", "HOST", "NET", "IMAGE", "USER",
+                                    "TEMPLATE", "GROUP", "DATASTORE",
+                                    "CLUSTER", "DOCUMENT"};
+
+            cache_conf = dynamic_cast<const VectorAttribute *>(cache_attrs[0]);
+
+            for (int i = 0; cache_conf != 0 && i < 10; i++)
+            {
+                int cache_size;
+
+                if ( cache_conf->vector_value(names[i], cache_size) == 0 &&
+                     cache_size > 0 )
+                {
+                    pools[i]->set_cache_size(cache_size);
+                }
+            }
+        }
+
         default_user_quota.select();
         default_group_quota.select();
     }
@@ -625,7 +666,11 @@ void Nebula::start()
     //Managers
     // -----------------------------------------------------------
 
-    MadManager::mad_manager_system_init();
+    int driver_workers;
+
+    nebula_configuration->get("DRIVER_WORKERS", driver_workers);
+
+    MadManager::mad_manager_system_init(driver_workers);
 
     time_t timer_period;
 
@@ -687,17 +732,48 @@ void Nebula::start()
         vector<const Attribute *>   im_mads;
         time_t                      monitor_period;
         int                         host_limit;
+        int                         max_inflight;
+
+        vector<const Attribute *>   receivers;
+        const VectorAttribute *     receiver = 0;
+        string                      receiver_address = "0.0.0.0";
+        int                         receiver_port    = 0;
+        string                      receiver_key;
 
         nebula_configuration->get("HOST_MONITORING_INTERVAL", monitor_period);
 
         nebula_configuration->get("HOST_PER_INTERVAL", host_limit);
 
+        nebula_configuration->get("HOST_MONITORING_INFLIGHT", max_inflight);
+
         nebula_configuration->get("IM_MAD", im_mads);
 
+        // Receiver of the monitoring reports pushed by the hosts (optional)
+        if ( nebula_configuration->get("MONITORING_RECEIVER", receivers) > 0 )
+        {
+            receiver = dynamic_cast<const VectorAttribute *>(receivers[0]);
+        }
+
+        if ( receiver != 0 )
+        {
+            if ( !receiver->vector_value("ADDRESS").empty() )
+            {
+                receiver_address = receiver->vector_value("ADDRESS");
+            }
+
+            receiver->vector_value("PORT", receiver_port);
+
+            receiver_key = receiver->vector_value("KEY");
+        }
+
         im = new InformationManager(hpool,
                                     timer_period,
                                     monitor_period,
                                     host_limit,
+                                    max_inflight,
+                                    receiver_address,
+                                    receiver_port,
+                                    receiver_key,
                                     remotes_location,
                                     im_mads);
     }
@@ -919,6 +995,33 @@ void Nebula::start()
     pthread_join(hm->get_thread_id(),0);
     pthread_join(imagem->get_thread_id(),0);
 
+    // -----------------------------------------------------------
+    // Log the pool cache statistics
+    // -----------------------------------------------------------
+
+    PoolSQL * pools[] = {vmpool, hpool, vnpool, ipool, upool,
+                         tpool, gpool, dspool, clpool, docpool};
+
+    for (int i = 0; i < 10; i++)
+    {
+        ostringstream oss;
+
+        pools[i]->print_cache_stats(oss);
+
+        NebulaLog::log("ONE", Log::INFO, oss);
+    }
+
+    MySqlDB * mysql_db = dynamic_cast<MySqlDB *>(db);
+
+    if ( mysql_db != 0 )
+    {
+        ostringstream oss;
+
+        mysql_db->print_stats(oss);
+
+        NebulaLog::log("ONE", Log::INFO, oss);
+    }
+
     //XML Library
     xmlCleanupParser();
 
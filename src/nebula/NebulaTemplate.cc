@@ -84,12 +84,19 @@ void OpenNebulaTemplate::set_conf_default()
 
     attribute = new SingleAttribute("MANAGER_TIMER",value);
     conf_default.insert(make_pair(attribute->name(),attribute));
+
+    // DRIVER_WORKERS
+    value = "4";
+
+    attribute = new SingleAttribute("DRIVER_WORKERS",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
 /*
 #*******************************************************************************
 # Daemon configuration attributes
 #-------------------------------------------------------------------------------
 #  HOST_MONITORING_INTERVAL
 #  HOST_PER_INTERVAL
+#  HOST_MONITORING_INFLIGHT
 #  HOST_MONITORING_EXPIRATION_TIME
 #  VM_POLLING_INTERVAL
 #  VM_PER_INTERVAL
@@ -113,6 +120,12 @@ void OpenNebulaTemplate::set_conf_default()
     attribute = new SingleAttribute("HOST_PER_INTERVAL",value);
     conf_default.insert(make_pair(attribute->name(),attribute));
 
+    // HOST_MONITORING_INFLIGHT
+    value = "15";
+
+    attribute = new SingleAttribute("HOST_MONITORING_INFLIGHT",value);
+    conf_default.insert(make_pair(attribute->name(),attribute));
+
     // HOST_MONITORING_EXPIRATION_TIME
     value = "86400";
 
@@ -110,16 +110,16 @@ int SystemDB::check_db_version()
     string loaded_db_version = "";
 
     // Try to read latest version
-    set_callback( static_cast<Callbackable::Callback>(&SystemDB::select_cb),
-                  static_cast<void *>(&loaded_db_version) );
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&SystemDB::select_cb),
+                   static_cast<void *>(&loaded_db_version));
 
     oss << "SELECT version FROM " << ver_table
         << " WHERE oid=(SELECT MAX(oid) FROM " << ver_table << ")";
 
-    db->exec(oss, this);
+    db->exec(oss, &cb);
 
     oss.str("");
-    unset_callback();
 
     if( loaded_db_version == "" )
     {
@@ -233,15 +233,14 @@ int SystemDB::select_sys_attribute(const string& attr_name, string& attr_xml)
 
     int rc;
 
-    set_callback(static_cast<Callbackable::Callback>(&SystemDB::select_attr_cb),
-                 static_cast<void *>(&attr_xml) );
+    SqlCallback cb(this,
+            static_cast<Callbackable::Callback>(&SystemDB::select_attr_cb),
+            static_cast<void *>(&attr_xml));
 
     oss << "SELECT body FROM " << sys_table << " WHERE name = '"
         << attr_name << "'";
 
-    rc = db->exec(oss, this);
-
-    unset_callback();
+    rc = db->exec(oss, &cb);
 
     if (rc != 0)
     {
@@ -56,6 +56,9 @@ module OpenNebula
         # Retrieves the monitoring data for all the Hosts in the pool
         #
         # @param [Array<String>] xpath_expressions Elements to retrieve.
+        # @param [Integer] resolution Optional size, in seconds, of the
+        #   monitoring rollups to retrieve (average values). Use 0 to retrieve
+        #   the monitoring samples.
         #
         # @return [Hash<String, <Hash<String, Array<Array<int>>>>>,
         #   OpenNebula::Error] The first level hash uses the Host ID as keys,
@@ -76,16 +79,20 @@ module OpenNebula
         #     {"TEMPLATE/CUSTOM_PROBE"=>[],
         #      "HOST_SHARE/FREE_CPU"=>[["1337609673", "800"]],
         #      "HOST_SHARE/RUNNING_VMS"=>[["1337609673", "3"]]}}
-        def monitoring(xpath_expressions)
+        def monitoring(xpath_expressions, resolution=0)
             return super(HOST_POOL_METHODS[:monitoring],
-                'HOST', 'LAST_MON_TIME', xpath_expressions)
+                'HOST', 'LAST_MON_TIME', xpath_expressions, resolution)
         end
 
         # Retrieves the monitoring data for all the Hosts in the pool, in XML
         #
+        # @param [Integer] resolution Optional size, in seconds, of the
+        #   monitoring rollups to retrieve. Use 0 to retrieve the monitoring
+        #   samples.
+        #
         # @return [String] VM monitoring data, in XML
-        def monitoring_xml()
-            return @client.call(HOST_POOL_METHODS[:monitoring])
+        def monitoring_xml(resolution=0)
+            return @client.call(HOST_POOL_METHODS[:monitoring], resolution)
         end
     end
 end
@@ -118,6 +118,9 @@ module OpenNebula
         # @param [Array<String>] xpath_expressions Elements to retrieve.
         # @param [Integer] filter_flag Optional filter flag to retrieve all or
         #   part of the Pool. Possible values: INFO_ALL, INFO_GROUP, INFO_MINE.
+        # @param [Integer] resolution Optional size, in seconds, of the
+        #   monitoring rollups to retrieve (average values). Use 0 to retrieve
+        #   the monitoring samples.
         #
         # @return [Hash<String, <Hash<String, Array<Array<int>>>>>,
         #   OpenNebula::Error] The first level hash uses the VM ID as keys, and
@@ -142,19 +145,23 @@ module OpenNebula
         #      [["1337608271", "510"], ["1337608301", "510"], ["1337608331", "520"]],
         #     "TEMPLATE/CUSTOM_PROBE"=>
         #      []}}
-        def monitoring(xpath_expressions, filter_flag=INFO_ALL)
+        def monitoring(xpath_expressions, filter_flag=INFO_ALL, resolution=0)
             return super(VM_POOL_METHODS[:monitoring],
-                'VM', 'LAST_POLL', xpath_expressions, filter_flag)
+                'VM', 'LAST_POLL', xpath_expressions, filter_flag, resolution)
         end
 
         # Retrieves the monitoring data for all the VMs in the pool, in XML
         #
         # @param [Integer] filter_flag Optional filter flag to retrieve all or
         #   part of the Pool. Possible values: INFO_ALL, INFO_GROUP, INFO_MINE.
+        # @param [Integer] resolution Optional size, in seconds, of the
+        #   monitoring rollups to retrieve. Use 0 to retrieve the monitoring
+        #   samples.
         #
         # @return [String] VM monitoring data, in XML
-        def monitoring_xml(filter_flag=INFO_ALL)
-            return @client.call(VM_POOL_METHODS[:monitoring], filter_flag)
+        def monitoring_xml(filter_flag=INFO_ALL, resolution=0)
+            return @client.call(VM_POOL_METHODS[:monitoring], filter_flag,
+                resolution)
         end
 
         # Retrieves the accounting data for all the VMs in the pool
@@ -345,6 +345,57 @@ module Migrator
         @db.run "DROP TABLE old_cluster_pool;"
 
 
+        ########################################################################
+        # Indexes for the VM monitoring, accounting and host monitoring
+        # queries
+        ########################################################################
+
+        @db.run "CREATE INDEX vm_pool_state_idx ON vm_pool (state, last_poll);"
+        @db.run "CREATE INDEX history_stime_idx ON history (stime);"
+        @db.run "CREATE INDEX history_etime_idx ON history (etime);"
+        @db.run "CREATE INDEX host_pool_mon_idx ON host_pool (last_mon_time);"
+
+
+        ########################################################################
+        # The IM driver of the hosts is stored in the im_mad column, so the
+        # hosts to monitor are discovered without parsing their bodies
+        ########################################################################
+
+        @db.run "ALTER TABLE host_pool ADD COLUMN im_mad VARCHAR(128);"
+
+        im_mads = {}
+
+        @db.fetch("SELECT oid,body FROM host_pool") do |row|
+            doc = Document.new(row[:body])
+
+            im_mads[row[:oid]] = doc.root.get_text("IM_MAD").to_s
+        end
+
+        im_mads.each do |oid, im_mad|
+            @db[:host_pool].where(:oid => oid).update(:im_mad => im_mad)
+        end
+
+
+        ########################################################################
+        # Monitoring is stored as compressed series of samples, and rollups.
+        # The old samples (one XML body per row) are discarded
+        ########################################################################
+
+        @db.run "DROP TABLE host_monitoring;"
+        @db.run "CREATE TABLE host_monitoring (hid INTEGER, start_time INTEGER, last_time INTEGER, body TEXT, PRIMARY KEY(hid, start_time));"
+        @db.run "CREATE INDEX host_monitoring_time_idx ON host_monitoring (last_time);"
+
+        @db.run "DROP TABLE vm_monitoring;"
+        @db.run "CREATE TABLE vm_monitoring (vmid INTEGER, start_time INTEGER, last_time INTEGER, body TEXT, PRIMARY KEY(vmid, start_time));"
+        @db.run "CREATE INDEX vm_monitoring_time_idx ON vm_monitoring (last_time);"
+
+        @db.run "CREATE TABLE host_monitoring_rollup (hid INTEGER, resolution INTEGER, start_time INTEGER, body TEXT, PRIMARY KEY(hid, resolution, start_time));"
+        @db.run "CREATE INDEX host_monitoring_rollup_idx ON host_monitoring_rollup (resolution, start_time);"
+
+        @db.run "CREATE TABLE vm_monitoring_rollup (vmid INTEGER, resolution INTEGER, start_time INTEGER, body TEXT, PRIMARY KEY(vmid, resolution, start_time));"
+        @db.run "CREATE INDEX vm_monitoring_rollup_idx ON vm_monitoring_rollup (resolution, start_time);"
+
+
         ########################################################################
         #
         # Banner for the new /var/lib/one/vms directory
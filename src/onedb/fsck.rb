@@ -708,7 +708,7 @@ module OneDBFsck
                 "name VARCHAR(128), body TEXT, state INTEGER, " <<
                 "last_mon_time INTEGER, uid INTEGER, gid INTEGER, " <<
                 "owner_u INTEGER, group_u INTEGER, other_u INTEGER, " <<
-                "UNIQUE(name));"
+                "im_mad VARCHAR(128), UNIQUE(name));"
 
         # Calculate the host's xml and write them to host_pool_new
         @db[:host_pool].each do |row|
@@ -765,6 +765,14 @@ module OneDBFsck
                 end
             }
 
+            # rewrite the IM driver column
+            im_mad = host_doc.root.get_text("IM_MAD").to_s
+
+            if row[:im_mad] != im_mad
+                log_error("Host #{hid} im_mad column has #{row[:im_mad]} \tis\t#{im_mad}")
+                row[:im_mad] = im_mad
+            end
+
             row[:body] = host_doc.to_s
 
             # commit
@@ -774,6 +782,7 @@ module OneDBFsck
         # Rename table
         @db.run("DROP TABLE host_pool")
         @db.run("ALTER TABLE host_pool_new RENAME TO host_pool")
+        @db.run("CREATE INDEX host_pool_mon_idx ON host_pool (last_mon_time)")
 
 
         ########################################################################
@@ -0,0 +1,325 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+
+#include "MonitoringChunk.h"
+#include "SSLTools.h"
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+const int MonitoringChunk::MAX_SAMPLES = 60;
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Reads the bits of an encoded chunk
+ */
+class MonitoringChunkReader
+{
+public:
+    MonitoringChunkReader(const string& _data):data(_data), pos(0){};
+
+    /**
+     *  Reads n bits
+     *    @param value read from the chunk
+     *    @return 0 on success, -1 if there are not enough bits
+     */
+    int read_bits(int n, unsigned long long& value)
+    {
+        if ( pos + n > data.size() * 8 )
+        {
+            return -1;
+        }
+
+        value = 0;
+
+        for (int i = 0; i < n; i++, pos++)
+        {
+            unsigned char byte = data[pos / 8];
+
+            value = (value << 1) | ((byte >> (7 - pos % 8)) & 1);
+        }
+
+        return 0;
+    };
+
+    /**
+     *  Reads a delta-of-delta, see MonitoringChunk for the encoding
+     */
+    int read_dod(unsigned long long& dod)
+    {
+        static const int widths[] = {7, 12, 20, 64};
+
+        unsigned long long bit;
+        unsigned long long zz;
+
+        int prefix;
+
+        for (prefix = 0; prefix < 4; prefix++)
+        {
+            if ( read_bits(1, bit) != 0 )
+            {
+                return -1;
+            }
+
+            if ( bit == 0 )
+            {
+                break;
+            }
+        }
+
+        if ( prefix == 0 )
+        {
+            dod = 0;
+            return 0;
+        }
+
+        if ( read_bits(widths[prefix - 1], zz) != 0 )
+        {
+            return -1;
+        }
+
+        dod = (zz >> 1) ^ (0ULL - (zz & 1));
+
+        return 0;
+    };
+
+private:
+    const string& data;
+
+    size_t        pos;
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MonitoringChunk::MonitoringChunk(int _num_metrics):
+    num_metrics(_num_metrics),
+    samples(0),
+    start_time(0),
+    last_time(0),
+    num_bits(0),
+    prev(_num_metrics + 1, 0),
+    prev_delta(_num_metrics + 1, 0)
+{
+    write_bits(0, 16);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitoringChunk::write_bits(unsigned long long value, int n)
+{
+    for (int i = n - 1; i >= 0; i--, num_bits++)
+    {
+        if ( num_bits % 8 == 0 )
+        {
+            data.push_back(0);
+        }
+
+        if ( (value >> i) & 1 )
+        {
+            data[num_bits / 8] |= 1 << (7 - num_bits % 8);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitoringChunk::write_dod(unsigned long long dod)
+{
+    unsigned long long zz = (dod << 1) ^ (0ULL - (dod >> 63));
+
+    if ( zz == 0 )
+    {
+        write_bits(0, 1);
+    }
+    else if ( zz < (1ULL << 7) )
+    {
+        write_bits(2, 2);
+        write_bits(zz, 7);
+    }
+    else if ( zz < (1ULL << 12) )
+    {
+        write_bits(6, 3);
+        write_bits(zz, 12);
+    }
+    else if ( zz < (1ULL << 20) )
+    {
+        write_bits(14, 4);
+        write_bits(zz, 20);
+    }
+    else
+    {
+        write_bits(15, 4);
+        write_bits(zz, 64);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitoringChunk::add(time_t time, const vector<long long>& values)
+{
+    if ( full() || static_cast<int>(values.size()) != num_metrics ||
+         (samples > 0 && time <= last_time) )
+    {
+        return -1;
+    }
+
+    for (int i = 0; i <= num_metrics; i++)
+    {
+        unsigned long long value;
+
+        if ( i == 0 )
+        {
+            value = static_cast<unsigned long long>(time);
+        }
+        else
+        {
+            value = static_cast<unsigned long long>(values[i-1]);
+        }
+
+        if ( samples == 0 )
+        {
+            write_bits(value, 64);
+        }
+        else
+        {
+            // Unsigned arithmetic, deltas wrap around in 64 bits
+            unsigned long long delta = value - prev[i];
+
+            write_dod(delta - prev_delta[i]);
+
+            prev_delta[i] = delta;
+        }
+
+        prev[i] = value;
+    }
+
+    if ( samples == 0 )
+    {
+        start_time = time;
+    }
+
+    last_time = time;
+
+    samples++;
+
+    data[0] = (samples >> 8) & 0xFF;
+    data[1] = samples & 0xFF;
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+string& MonitoringChunk::to_str(string& str) const
+{
+    string * str64 = SSLTools::base64_encode(data);
+
+    if ( str64 == 0 )
+    {
+        str = "";
+    }
+    else
+    {
+        str = *str64;
+
+        delete str64;
+    }
+
+    return str;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitoringChunk::decode(const string&                str,
+                            int                          num_metrics,
+                            vector<time_t>&              times,
+                            vector< vector<long long> >& values)
+{
+    string * bin = SSLTools::base64_decode(str);
+
+    times.clear();
+    values.clear();
+
+    if ( bin == 0 )
+    {
+        return -1;
+    }
+
+    MonitoringChunkReader reader(*bin);
+
+    vector<unsigned long long> prev(num_metrics + 1, 0);
+    vector<unsigned long long> prev_delta(num_metrics + 1, 0);
+
+    unsigned long long num_samples;
+    unsigned long long value = 0;
+
+    int rc = reader.read_bits(16, num_samples);
+
+    for (unsigned long long s = 0; rc == 0 && s < num_samples; s++)
+    {
+        vector<long long> sample(num_metrics);
+
+        for (int i = 0; rc == 0 && i <= num_metrics; i++)
+        {
+            if ( s == 0 )
+            {
+                rc = reader.read_bits(64, value);
+            }
+            else
+            {
+                unsigned long long dod = 0;
+
+                rc = reader.read_dod(dod);
+
+                prev_delta[i] += dod;
+                value = prev[i] + prev_delta[i];
+            }
+
+            prev[i] = value;
+
+            if ( i == 0 )
+            {
+                times.push_back(static_cast<time_t>(value));
+            }
+            else
+            {
+                sample[i-1] = static_cast<long long>(value);
+            }
+        }
+
+        if ( rc == 0 )
+        {
+            values.push_back(sample);
+        }
+    }
+
+    delete bin;
+
+    if ( rc != 0 || times.size() != values.size() )
+    {
+        times.resize(values.size());
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+
+#include "MonitoringRollup.h"
+
+#include <sstream>
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MonitoringRollup::MonitoringRollup(time_t _start_time, int _num_metrics):
+    start_time(_start_time),
+    num_metrics(_num_metrics),
+    samples(0),
+    min(_num_metrics, 0),
+    max(_num_metrics, 0),
+    sum(_num_metrics, 0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitoringRollup::add(const vector<long long>& values)
+{
+    if ( static_cast<int>(values.size()) != num_metrics )
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < num_metrics; i++)
+    {
+        if ( samples == 0 || values[i] < min[i] )
+        {
+            min[i] = values[i];
+        }
+
+        if ( samples == 0 || values[i] > max[i] )
+        {
+            max[i] = values[i];
+        }
+
+        sum[i] += values[i];
+    }
+
+    samples++;
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+string& MonitoringRollup::to_str(string& str) const
+{
+    ostringstream oss;
+
+    oss << samples;
+
+    for (int i = 0; i < num_metrics; i++)
+    {
+        oss << " " << min[i] << " " << max[i] << " " << sum[i];
+    }
+
+    str = oss.str();
+
+    return str;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitoringRollup::from_str(const string& str)
+{
+    istringstream iss(str);
+
+    iss >> samples;
+
+    for (int i = 0; i < num_metrics; i++)
+    {
+        iss >> min[i] >> max[i] >> sum[i];
+    }
+
+    if ( iss.fail() )
+    {
+        samples = 0;
+        return -1;
+    }
+
+    return 0;
+}
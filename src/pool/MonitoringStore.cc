@@ -0,0 +1,707 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+
+#include "MonitoringStore.h"
+#include "NebulaLog.h"
+
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+const time_t MonitoringStore::EXPIRATION_BUCKET = 3600;
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MonitoringStore::MonitoringStore(const char *  _table,
+                                 const char *  _rollup_table,
+                                 const char *  _id_column,
+                                 const char *  _obj_table,
+                                 const char *  _time_element,
+                                 const char ** _metrics,
+                                 time_t        _expiration):
+    table(_table),
+    rollup_table(_rollup_table),
+    id_column(_id_column),
+    obj_table(_obj_table),
+    time_element(_time_element),
+    expiration(_expiration),
+    last_bucket(0)
+{
+    for (int i = 0; _metrics[i] != 0; i++)
+    {
+        metrics.push_back(_metrics[i]);
+    }
+
+    pthread_mutex_init(&mutex,0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+MonitoringStore::~MonitoringStore()
+{
+    map<int, MonitoringChunk *>::iterator  it;
+    map<int, MonitoringRollup *>::iterator jt;
+
+    for (it = chunks.begin(); it != chunks.end(); it++)
+    {
+        delete it->second;
+    }
+
+    for (unsigned int i = 0; i < levels.size(); i++)
+    {
+        for (jt = levels[i].rollups.begin(); jt != levels[i].rollups.end();
+             jt++)
+        {
+            delete jt->second;
+        }
+    }
+
+    pthread_mutex_destroy(&mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::add_rollup(time_t resolution, time_t expiration)
+{
+    RollupLevel level;
+
+    if ( resolution <= 0 || expiration < 0 || has_resolution(resolution) )
+    {
+        return -1;
+    }
+
+    level.resolution = resolution;
+    level.expiration = expiration;
+
+    levels.push_back(level);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitoringStore::add_rollups(const vector<const Attribute *>& rollups)
+{
+    const VectorAttribute * vattr;
+
+    int resolution;
+    int expiration;
+
+    for (unsigned int i = 0 ; i < rollups.size() ; i++ )
+    {
+        vattr = dynamic_cast<const VectorAttribute *>(rollups[i]);
+
+        if ( vattr == 0 ||
+             vattr->vector_value("RESOLUTION", resolution) != 0 ||
+             vattr->vector_value("EXPIRATION", expiration) != 0 ||
+             add_rollup(resolution, expiration) != 0 )
+        {
+            NebulaLog::log("ONE", Log::WARNING, "Wrong or duplicated "
+                "MONITORING_ROLLUP definition, it will not be used.");
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool MonitoringStore::has_resolution(time_t resolution) const
+{
+    if ( resolution == 0 )
+    {
+        return true;
+    }
+
+    for (unsigned int i = 0; i < levels.size(); i++)
+    {
+        if ( levels[i].resolution == resolution )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::load_cb(void * _rollup, int num, char **values,
+                             char **names)
+{
+    MonitoringRollup * rollup;
+
+    rollup = static_cast<MonitoringRollup *>(_rollup);
+
+    if ( (!values[0]) || (num != 1) )
+    {
+        return -1;
+    }
+
+    return rollup->from_str(values[0]);
+}
+
+/* -------------------------------------------------------------------------- */
+
+MonitoringRollup * MonitoringStore::load_rollup(SqlDB * db,
+                                                int     oid,
+                                                time_t  resolution,
+                                                time_t  start_time)
+{
+    ostringstream oss;
+    SqlParams     params;
+
+    MonitoringRollup * rollup = new MonitoringRollup(start_time,
+                                                     metrics.size());
+
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&MonitoringStore::load_cb),
+                   static_cast<void *>(rollup));
+
+    oss << "SELECT body FROM " << rollup_table << " WHERE " << id_column
+        << " = ? AND resolution = ? AND start_time = ?";
+
+    params.add(oid)
+          .add(resolution)
+          .add(start_time);
+
+    if ( db->exec(oss, params, &cb) != 0 )
+    {
+        delete rollup;
+
+        rollup = new MonitoringRollup(start_time, metrics.size());
+    }
+
+    return rollup;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::add(SqlDB *                  db,
+                         int                      oid,
+                         time_t                   time,
+                         const vector<long long>& values)
+{
+    ostringstream   oss;
+    SqlParams       params;
+
+    vector<SqlParams> rollup_params;
+
+    MonitoringChunk * chunk;
+    string            body;
+    int               rc = 0;
+
+    map<int, MonitoringChunk *>::iterator  it;
+    map<int, MonitoringRollup *>::iterator jt;
+
+    // Read the current rollups of the object if they are not in memory. The
+    // samples of an object are added one at a time, so only this call will
+    // add them to the maps
+    for (unsigned int i = 0; i < levels.size(); i++)
+    {
+        RollupLevel& level = levels[i];
+
+        lock();
+
+        bool cached = level.rollups.count(oid) > 0;
+
+        unlock();
+
+        if ( !cached )
+        {
+            MonitoringRollup * rollup = load_rollup(db, oid, level.resolution,
+                    time - time % level.resolution);
+
+            lock();
+
+            if ( !level.rollups.insert(make_pair(oid, rollup)).second )
+            {
+                delete rollup;
+            }
+
+            unlock();
+        }
+    }
+
+    lock();
+
+    if ( expiration > 0 )
+    {
+        it = chunks.find(oid);
+
+        if ( it != chunks.end() && !it->second->full() )
+        {
+            chunk = it->second;
+
+            if ( chunk->add(time, values) != 0 )
+            {
+                unlock();
+                return -1;
+            }
+        }
+        else
+        {
+            chunk = new MonitoringChunk(metrics.size());
+
+            if ( chunk->add(time, values) != 0 )
+            {
+                unlock();
+
+                delete chunk;
+                return -1;
+            }
+
+            if ( it != chunks.end() )
+            {
+                delete it->second;
+
+                it->second = chunk;
+            }
+            else
+            {
+                chunks.insert(make_pair(oid, chunk));
+            }
+        }
+
+        chunk->to_str(body);
+
+        params.add(oid)
+              .add(chunk->get_start_time())
+              .add(chunk->get_last_time())
+              .add(body);
+    }
+
+    for (unsigned int i = 0; i < levels.size(); i++)
+    {
+        RollupLevel& level = levels[i];
+        SqlParams    rparams;
+
+        time_t start_time = time - time % level.resolution;
+
+        jt = level.rollups.find(oid);
+
+        if ( jt == level.rollups.end() )
+        {
+            continue; // Removed by clean_expired after being read
+        }
+        else if ( start_time < jt->second->get_start_time() )
+        {
+            continue; // Sample older than the current interval
+        }
+        else if ( start_time > jt->second->get_start_time() )
+        {
+            delete jt->second;
+
+            jt->second = new MonitoringRollup(start_time, metrics.size());
+        }
+
+        jt->second->add(values);
+
+        jt->second->to_str(body);
+
+        rparams.add(oid)
+               .add(level.resolution)
+               .add(start_time)
+               .add(body);
+
+        rollup_params.push_back(rparams);
+    }
+
+    unlock();
+
+    if ( params.size() > 0 )
+    {
+        oss << "REPLACE INTO " << table << " (" << id_column
+            << ", start_time, last_time, body) VALUES (?,?,?,?)";
+
+        rc = db->exec(oss, params);
+    }
+
+    for (unsigned int i = 0; i < rollup_params.size(); i++)
+    {
+        oss.str("");
+
+        oss << "REPLACE INTO " << rollup_table << " (" << id_column
+            << ", resolution, start_time, body) VALUES (?,?,?,?)";
+
+        rc += db->exec(oss, rollup_params[i]);
+    }
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void MonitoringStore::find_slots(const string& body, Slots& slots)
+{
+    for (int i = -1; i < static_cast<int>(metrics.size()); i++)
+    {
+        const string& name = (i == -1) ? time_element : metrics[i];
+
+        size_t start = body.find("<" + name + ">");
+
+        if ( start == string::npos )
+        {
+            continue;
+        }
+
+        start += name.length() + 2;
+
+        size_t end = body.find("</" + name + ">", start);
+
+        if ( end != string::npos )
+        {
+            slots.insert(make_pair(start, make_pair(end, i)));
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MonitoringStore::render(ostringstream *          oss,
+                             const string&            body,
+                             const Slots&             slots,
+                             time_t                   time,
+                             const vector<long long>& values,
+                             const string&            extra)
+{
+    Slots::const_iterator it;
+
+    size_t pos = 0;
+
+    for (it = slots.begin(); it != slots.end(); it++)
+    {
+        oss->write(body.data() + pos, it->first - pos);
+
+        if ( it->second.second == -1 )
+        {
+            *oss << time;
+        }
+        else
+        {
+            *oss << values[it->second.second];
+        }
+
+        pos = it->second.first;
+    }
+
+    if ( !extra.empty() )
+    {
+        size_t close = body.rfind("</");
+
+        if ( close != string::npos && close >= pos )
+        {
+            oss->write(body.data() + pos, close - pos);
+
+            *oss << extra;
+
+            pos = close;
+        }
+    }
+
+    oss->write(body.data() + pos, body.length() - pos);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::dump_cb(void * _oss, int num, char **values, char **names)
+{
+    ostringstream * oss;
+
+    vector<time_t>              times;
+    vector< vector<long long> > samples;
+
+    Slots slots;
+
+    oss = static_cast<ostringstream *>(_oss);
+
+    if ( (!values[0]) || (!values[1]) || (num != 2) )
+    {
+        return -1;
+    }
+
+    string body = values[0];
+
+    if ( MonitoringChunk::decode(values[1], metrics.size(), times, samples)
+            != 0 )
+    {
+        NebulaLog::log("ONE", Log::ERROR, "Error decoding monitoring chunk "
+            "from table " + table);
+        return 0;
+    }
+
+    find_slots(body, slots);
+
+    time_t min_time = time(0) - expiration;
+
+    for (size_t s = 0; s < times.size(); s++)
+    {
+        if ( times[s] >= min_time )
+        {
+            render(oss, body, slots, times[s], samples[s]);
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::dump_rollup_cb(void * _oss, int num, char **values,
+                                    char **names)
+{
+    ostringstream * oss;
+    ostringstream   extra;
+
+    vector<long long> avg;
+
+    Slots slots;
+
+    oss = static_cast<ostringstream *>(_oss);
+
+    if ( (!values[0]) || (!values[1]) || (!values[2]) || (!values[3]) ||
+         (num != 4) )
+    {
+        return -1;
+    }
+
+    string body       = values[0];
+    time_t start_time = static_cast<time_t>(atoll(values[1]));
+
+    MonitoringRollup rollup(start_time, metrics.size());
+
+    if ( rollup.from_str(values[3]) != 0 )
+    {
+        NebulaLog::log("ONE", Log::ERROR, "Error decoding monitoring rollup "
+            "from table " + rollup_table);
+        return 0;
+    }
+
+    extra << "<MONITORING_ROLLUP>"
+          << "<RESOLUTION>" << values[2] << "</RESOLUTION>"
+          << "<SAMPLES>" << rollup.size() << "</SAMPLES>"
+          << "<MIN>";
+
+    for (unsigned int i = 0; i < metrics.size(); i++)
+    {
+        extra << "<" << metrics[i] << ">" << rollup.get_min(i)
+              << "</" << metrics[i] << ">";
+    }
+
+    extra << "</MIN><MAX>";
+
+    for (unsigned int i = 0; i < metrics.size(); i++)
+    {
+        extra << "<" << metrics[i] << ">" << rollup.get_max(i)
+              << "</" << metrics[i] << ">";
+
+        avg.push_back(rollup.get_avg(i));
+    }
+
+    extra << "</MAX></MONITORING_ROLLUP>";
+
+    find_slots(body, slots);
+
+    render(oss, body, slots, start_time, avg, extra.str());
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::dump(SqlDB *        db,
+                          ostringstream& oss,
+                          const string&  where,
+                          time_t         resolution)
+{
+    ostringstream cmd;
+    int           rc;
+
+    Callbackable::Callback callback;
+
+    if ( !has_resolution(resolution) )
+    {
+        return -1;
+    }
+
+    if ( resolution == 0 )
+    {
+        cmd << "SELECT " << obj_table << ".body, " << table << ".body"
+            << " FROM " << table << " INNER JOIN " << obj_table
+            << " WHERE " << id_column << " = oid";
+
+        callback = static_cast<Callbackable::Callback>(
+                &MonitoringStore::dump_cb);
+    }
+    else
+    {
+        cmd << "SELECT " << obj_table << ".body, " << rollup_table
+            << ".start_time, resolution, " << rollup_table << ".body"
+            << " FROM " << rollup_table << " INNER JOIN " << obj_table
+            << " WHERE " << id_column << " = oid"
+            << " AND resolution = " << resolution;
+
+        callback = static_cast<Callbackable::Callback>(
+                &MonitoringStore::dump_rollup_cb);
+    }
+
+    if ( !where.empty() )
+    {
+        cmd << " AND " << where;
+    }
+
+    if ( resolution == 0 )
+    {
+        cmd << " ORDER BY " << id_column << ", " << table << ".start_time";
+    }
+    else
+    {
+        cmd << " ORDER BY " << id_column << ", " << rollup_table
+            << ".start_time";
+    }
+
+    oss << "<MONITORING_DATA>";
+
+    SqlCallback cb(this, callback, static_cast<void *>(&oss));
+
+    rc = db->exec(cmd, &cb);
+
+    oss << "</MONITORING_DATA>";
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::clean_expired(SqlDB * db)
+{
+    ostringstream oss;
+    int           rc = 0;
+
+    map<int, MonitoringChunk *>::iterator  it;
+    map<int, MonitoringRollup *>::iterator jt;
+
+    time_t now    = time(0);
+    time_t bucket = now - now % EXPIRATION_BUCKET;
+
+    // Samples are dumped only if not expired, so the rows can be kept until
+    // the whole bucket expires
+    time_t max_time = bucket - expiration;
+
+    lock();
+
+    if ( bucket == last_bucket )
+    {
+        unlock();
+        return 0;
+    }
+
+    last_bucket = bucket;
+
+    // Objects with expired chunks are no longer monitored (e.g. deleted VMs)
+    for (it = chunks.begin(); it != chunks.end(); )
+    {
+        if ( it->second->get_last_time() < max_time )
+        {
+            delete it->second;
+
+            chunks.erase(it++);
+        }
+        else
+        {
+            it++;
+        }
+    }
+
+    // Same for the rollups not updated in the last 10 intervals
+    for (unsigned int i = 0; i < levels.size(); i++)
+    {
+        map<int, MonitoringRollup *>& rollups = levels[i].rollups;
+
+        time_t max_start = now - 10 * levels[i].resolution;
+
+        for (jt = rollups.begin(); jt != rollups.end(); )
+        {
+            if ( jt->second->get_start_time() < max_start )
+            {
+                delete jt->second;
+
+                rollups.erase(jt++);
+            }
+            else
+            {
+                jt++;
+            }
+        }
+    }
+
+    unlock();
+
+    if ( expiration > 0 )
+    {
+        oss << "DELETE FROM " << table << " WHERE last_time < " << max_time;
+
+        rc = db->exec(oss);
+    }
+
+    for (unsigned int i = 0; i < levels.size(); i++)
+    {
+        if ( levels[i].expiration == 0 )
+        {
+            continue;
+        }
+
+        oss.str("");
+
+        oss << "DELETE FROM " << rollup_table
+            << " WHERE resolution = " << levels[i].resolution
+            << " AND start_time < " << bucket - levels[i].expiration;
+
+        rc += db->exec(oss);
+    }
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MonitoringStore::clean_all(SqlDB * db)
+{
+    ostringstream oss;
+
+    map<int, MonitoringChunk *>::iterator it;
+
+    lock();
+
+    for (it = chunks.begin(); it != chunks.end(); it++)
+    {
+        delete it->second;
+    }
+
+    chunks.clear();
+
+    unlock();
+
+    oss << "DELETE FROM " << table;
+
+    return db->exec(oss);
+}
@@ -42,27 +42,28 @@ string& PoolObjectSQL::to_xml64(string &xml64)
 int PoolObjectSQL::select(SqlDB *db)
 {
     ostringstream   oss;
+    SqlParams       params;
     int             rc;
     int             boid;
 
-    set_callback(
+    SqlCallback cb(this,
             static_cast<Callbackable::Callback>(&PoolObjectSQL::select_cb));
 
-    oss << "SELECT body FROM " << table << " WHERE oid = " << oid;
+    oss << "SELECT body FROM " << table << " WHERE oid = ?";
+
+    params.add(oid);
 
     boid = oid;
     oid  = -1;
 
-    rc = db->exec(oss, this);
-
-    unset_callback();
+    rc = db->exec(oss, params, &cb);
 
     if ((rc != 0) || (oid != boid ))
     {
         return -1;
     }
 
-    return 0;
+    return post_select(db);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -71,42 +72,35 @@ int PoolObjectSQL::select(SqlDB *db)
 int PoolObjectSQL::select(SqlDB *db, const string& _name, int _uid)
 {
     ostringstream oss;
+    SqlParams     params;
 
     int rc;
-    char * sql_name;
-
-    sql_name = db->escape_str(_name.c_str());
 
-    if ( sql_name == 0 )
-    {
-        return -1;
-    }
-
-    set_callback(
+    SqlCallback cb(this,
             static_cast<Callbackable::Callback>(&PoolObjectSQL::select_cb));
 
-    oss << "SELECT body FROM " << table << " WHERE name = '" << sql_name << "'";
+    oss << "SELECT body FROM " << table << " WHERE name = ?";
+
+    params.add(_name);
 
     if ( _uid != -1 )
     {
-        oss << " AND uid = " << _uid;
+        oss << " AND uid = ?";
+
+        params.add(_uid);
     }
 
     name  = "";
     uid   = -1;
 
-    rc = db->exec(oss, this);
-
-    unset_callback();
-
-    db->free_str(sql_name);
+    rc = db->exec(oss, params, &cb);
 
     if ((rc != 0) || (_name != name) || (_uid != -1 && _uid != uid))
     {
         return -1;
     }
 
-    return 0;
+    return post_select(db);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -34,6 +34,8 @@
 
 const unsigned int PoolSQL::MAX_POOL_SIZE = 15000;
 
+const unsigned int PoolSQL::CACHE_PARTITIONS = 16;
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
@@ -52,19 +54,33 @@ int PoolSQL::init_cb(void *nil, int num, char **values, char **names)
 /* -------------------------------------------------------------------------- */
 
 PoolSQL::PoolSQL(SqlDB * _db, const char * _table, bool cache_by_name):
-    db(_db), lastOID(-1), table(_table), uses_name_pool(cache_by_name)
+    db(_db), allocate_in_transaction(true), cache_size(MAX_POOL_SIZE),
+    lastOID(-1), table(_table), uses_name_pool(cache_by_name)
 {
     ostringstream   oss;
 
     pthread_mutex_init(&mutex,0);
+    pthread_mutex_init(&name_mutex,0);
 
-    set_callback(static_cast<Callbackable::Callback>(&PoolSQL::init_cb));
+    partitions = new CachePartition[CACHE_PARTITIONS];
 
-    oss << "SELECT last_oid FROM pool_control WHERE tablename='" << table <<"'";
+    for (unsigned int i = 0 ; i < CACHE_PARTITIONS ; i++)
+    {
+        pthread_mutex_init(&(partitions[i].mutex),0);
+        pthread_cond_init(&(partitions[i].cond),0);
+
+        partitions[i].size      = cache_size / CACHE_PARTITIONS + 1;
+        partitions[i].hits      = 0;
+        partitions[i].misses    = 0;
+        partitions[i].evictions = 0;
+    }
 
-    db->exec(oss,this);
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&PoolSQL::init_cb));
 
-    unset_callback();
+    oss << "SELECT last_oid FROM pool_control WHERE tablename='" << table <<"'";
+
+    db->exec(oss, &cb);
 };
 
 /* -------------------------------------------------------------------------- */
@@ -74,17 +90,28 @@ PoolSQL::~PoolSQL()
 {
     map<int,PoolObjectSQL *>::iterator  it;
 
-    pthread_mutex_lock(&mutex);
-
-    for ( it = pool.begin(); it != pool.end(); it++)
+    for (unsigned int i = 0 ; i < CACHE_PARTITIONS ; i++)
     {
-        it->second->lock();
+        CachePartition& part = partitions[i];
 
-        delete it->second;
+        pthread_mutex_lock(&(part.mutex));
+
+        for ( it = part.pool.begin(); it != part.pool.end(); it++)
+        {
+            it->second->lock();
+
+            delete it->second;
+        }
+
+        pthread_mutex_unlock(&(part.mutex));
+
+        pthread_cond_destroy(&(part.cond));
+        pthread_mutex_destroy(&(part.mutex));
     }
 
-    pthread_mutex_unlock(&mutex);
+    delete [] partitions;
 
+    pthread_mutex_destroy(&name_mutex);
     pthread_mutex_destroy(&mutex);
 }
 
@@ -113,10 +140,23 @@ int PoolSQL::allocate(
 
     objsql->oid = ++lastOID;
 
+    // The object and the new lastOID are stored in the same transaction,
+    // the hooks are triggered once it is committed
+    SqlTransaction tx(allocate_in_transaction ? db : 0);
+
     rc = objsql->insert(db,error_str);
 
+    if ( rc == 0 )
+    {
+        update_lastOID();
+
+        rc = tx.commit();
+    }
+
     if ( rc != 0 )
     {
+        tx.rollback();
+
         lastOID--;
         rc = -1;
     }
@@ -130,11 +170,6 @@ int PoolSQL::allocate(
 
     delete objsql;
 
-    if( rc != -1 )
-    {
-        update_lastOID();
-    }
-
     unlock();
 
     return rc;
@@ -174,95 +209,255 @@ PoolObjectSQL * PoolSQL::get(
         return objectsql;
     }
 
-    lock();
+    CachePartition& part = partition(oid);
 
-    index = pool.find(oid);
+    pthread_mutex_lock(&(part.mutex));
 
-    if ( index != pool.end() )
+    // Wait for other threads loading this object from the DB
+    while ( part.loading.count(oid) > 0 )
     {
-        if ( index->second->isValid() == false )
-        {
-            objectsql = 0;
-        }
-        else
-        {
-            objectsql = index->second;
+        pthread_cond_wait(&(part.cond), &(part.mutex));
+    }
 
-            if ( olock == true )
-            {
-                objectsql->lock();
+    index = part.pool.find(oid);
 
-                if ( objectsql->isValid() == false )
-                {
-                    objectsql->unlock();
-                    objectsql = 0;
-                }
-            }
-        }
+    if ( index != part.pool.end() )
+    {
+        part.hits++;
+
+        index->second->referenced = true;
 
-        unlock();
+        objectsql = check_object(index->second, olock);
+
+        pthread_mutex_unlock(&(part.mutex));
 
         return objectsql;
     }
-    else
+
+    // Load the object from the DB without holding the partition lock
+
+    part.misses++;
+    part.loading.insert(oid);
+
+    pthread_mutex_unlock(&(part.mutex));
+
+    objectsql = create();
+
+    objectsql->oid = oid;
+
+    rc = objectsql->select(db);
+
+    pthread_mutex_lock(&(part.mutex));
+
+    part.loading.erase(oid);
+
+    pthread_cond_broadcast(&(part.cond));
+
+    if ( rc != 0 )
+    {
+        delete objectsql;
+
+        pthread_mutex_unlock(&(part.mutex));
+
+        return 0;
+    }
+
+    objectsql = cache_insert(part, objectsql);
+
+    if ( objectsql != 0 )
     {
-        objectsql = create();
+        objectsql = check_object(objectsql, olock);
+    }
+
+    pthread_mutex_unlock(&(part.mutex));
+
+    return objectsql;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int PoolSQL::get_many_cb(void * _bodies, int num, char **values, char **names)
+{
+    vector<string> * bodies;
+
+    bodies = static_cast<vector<string> *>(_bodies);
+
+    if ( (!values[0]) || (num != 1) )
+    {
+        return -1;
+    }
+
+    bodies->push_back(values[0]);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int PoolSQL::get_many(const vector<int>&        oids,
+                      vector<PoolObjectSQL *>&  objects,
+                      bool                      olock)
+{
+    vector<int>           sorted;
+    vector<int>           missing;
+    vector<int>::iterator it;
+
+    vector<string>           bodies;
+    vector<string>::iterator bit;
+
+    map<int,PoolObjectSQL *>           loaded;
+    map<int,PoolObjectSQL *>::iterator lit;
 
-        objectsql->oid = oid;
+    PoolObjectSQL * objectsql;
 
-        rc = objectsql->select(db);
+    sorted = oids;
 
-        if ( rc != 0 )
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+
+    // Find the objects that are not cached, and mark them as being loaded
+    for ( it = sorted.begin() ; it != sorted.end() ; it++ )
+    {
+        if ( *it < 0 )
         {
-            delete objectsql;
+            continue;
+        }
 
-            unlock();
+        CachePartition& part = partition(*it);
 
-            objectsql = 0;
-            return 0;
+        pthread_mutex_lock(&(part.mutex));
+
+        while ( part.loading.count(*it) > 0 )
+        {
+            pthread_cond_wait(&(part.cond), &(part.mutex));
         }
 
-        if ( uses_name_pool )
+        if ( part.pool.count(*it) > 0 )
         {
-            map<string,PoolObjectSQL *>::iterator name_index;
-            string okey;
+            part.hits++;
+        }
+        else
+        {
+            part.misses++;
+            part.loading.insert(*it);
+
+            missing.push_back(*it);
+        }
+
+        pthread_mutex_unlock(&(part.mutex));
+    }
+
+    // Load all the missing objects with a single query
+    if ( !missing.empty() )
+    {
+        ostringstream oss;
 
-            okey       = key(objectsql->name,objectsql->uid);
-            name_index = name_pool.find(okey);
+        oss << "SELECT body FROM " << table << " WHERE oid IN (";
 
-            if ( name_index != name_pool.end() )
+        for ( it = missing.begin() ; it != missing.end() ; it++ )
+        {
+            if ( it != missing.begin() )
             {
-                name_index->second->lock();
+                oss << ",";
+            }
+
+            oss << *it;
+        }
+
+        oss << ")";
 
-                PoolObjectSQL * tmp_ptr  = name_index->second;
+        SqlCallback cb(this,
+                static_cast<Callbackable::Callback>(&PoolSQL::get_many_cb),
+                static_cast<void *>(&bodies));
 
-                name_pool.erase(okey);
-                pool.erase(tmp_ptr->oid);
+        db->exec(oss, &cb);
 
-                delete tmp_ptr;
+        // Objects are built once the query is done, as they may need to read
+        // additional data from the DB
+        for ( bit = bodies.begin() ; bit != bodies.end() ; bit++ )
+        {
+            objectsql = create();
+
+            if ( objectsql->from_db_body(*bit) != 0 ||
+                 objectsql->post_select(db) != 0 )
+            {
+                delete objectsql;
+                continue;
             }
 
-            name_pool.insert(make_pair(okey, objectsql));
+            loaded.insert(make_pair(objectsql->oid, objectsql));
+        }
+    }
+
+    // Cache the loaded objects
+    for ( it = missing.begin() ; it != missing.end() ; it++ )
+    {
+        CachePartition& part = partition(*it);
+
+        pthread_mutex_lock(&(part.mutex));
+
+        part.loading.erase(*it);
+
+        pthread_cond_broadcast(&(part.cond));
+
+        lit = loaded.find(*it);
+
+        if ( lit != loaded.end() )
+        {
+            cache_insert(part, lit->second);
         }
 
-        pool.insert(make_pair(objectsql->oid,objectsql));
+        pthread_mutex_unlock(&(part.mutex));
+    }
+
+    // Get (and lock) the objects in order
+    for ( it = sorted.begin() ; it != sorted.end() ; it++ )
+    {
+        map<int,PoolObjectSQL *>::iterator index;
 
-        if ( olock == true )
+        if ( *it < 0 )
         {
-            objectsql->lock();
+            continue;
         }
 
-        oid_queue.push(objectsql->oid);
+        CachePartition& part = partition(*it);
+
+        pthread_mutex_lock(&(part.mutex));
+
+        index = part.pool.find(*it);
 
-        if ( pool.size() > MAX_POOL_SIZE )
+        if ( index != part.pool.end() )
         {
-            replace();
+            index->second->referenced = true;
+
+            objectsql = check_object(index->second, olock);
+
+            pthread_mutex_unlock(&(part.mutex));
         }
+        else
+        {
+            pthread_mutex_unlock(&(part.mutex));
 
-        unlock();
+            // Evicted, does not exist or being loaded by other thread
+            if ( loaded.count(*it) > 0 || binary_search(missing.begin(),
+                    missing.end(), *it) == false )
+            {
+                objectsql = get(*it, olock);
+            }
+            else
+            {
+                objectsql = 0;
+            }
+        }
 
-        return objectsql;
+        if ( objectsql != 0 )
+        {
+            objects.push_back(objectsql);
+        }
     }
+
+    return loaded.size();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -270,89 +465,79 @@ PoolObjectSQL * PoolSQL::get(
 
 PoolObjectSQL * PoolSQL::get(const string& name, int ouid, bool olock)
 {
-    map<string,PoolObjectSQL *>::iterator  index;
+    map<string,int>::iterator  index;
 
     PoolObjectSQL *  objectsql;
     int              rc;
-
-    lock();
+    int              oid = -1;
 
     if ( uses_name_pool == false )
     {
-        unlock();
         return 0;
     }
 
-    index = name_pool.find(key(name,ouid));
+    string okey = key(name,ouid);
+
+    pthread_mutex_lock(&name_mutex);
 
-    if ( index != name_pool.end() && index->second->isValid() == true )
+    index = name_pool.find(okey);
+
+    if ( index != name_pool.end() )
     {
-        objectsql = index->second;
+        oid = index->second;
+    }
+
+    pthread_mutex_unlock(&name_mutex);
+
+    // The name index may be outdated, check the object is the one requested
+
+    if ( oid != -1 )
+    {
+        objectsql = get(oid, olock);
 
-        if ( olock == true )
+        if ( objectsql != 0 )
         {
-            objectsql->lock();
+            if ( key(objectsql->name,objectsql->uid) == okey )
+            {
+                return objectsql;
+            }
 
-            if ( objectsql->isValid() == false )
+            if ( olock == true )
             {
                 objectsql->unlock();
-                objectsql = 0;
             }
         }
-
-        unlock();
-
-        return objectsql;
     }
-    else
-    {
-        objectsql = create();
 
-        rc = objectsql->select(db,name,ouid);
+    // Not cached, load the object from the DB
 
-        if ( rc != 0 )
-        {
-            delete objectsql;
-
-            unlock();
+    objectsql = create();
 
-            return 0;
-        }
-
-        if ( index != name_pool.end() && index->second->isValid() == false )
-        {
-            index->second->lock();
+    rc = objectsql->select(db,name,ouid);
 
-            PoolObjectSQL * tmp_ptr  = index->second;
-            string          tmp_okey = key(tmp_ptr->name,tmp_ptr->uid);
-
-            pool.erase(tmp_ptr->oid);
-            name_pool.erase(tmp_okey);
+    if ( rc != 0 )
+    {
+        delete objectsql;
 
-            delete tmp_ptr;
-        }
+        return 0;
+    }
 
-        string okey = key(objectsql->name,objectsql->uid);
+    CachePartition& part = partition(objectsql->oid);
 
-        pool.insert(make_pair(objectsql->oid, objectsql));
-        name_pool.insert(make_pair(okey, objectsql));
+    pthread_mutex_lock(&(part.mutex));
 
-        if ( olock == true )
-        {
-            objectsql->lock();
-        }
+    part.misses++;
 
-        oid_queue.push(objectsql->oid);
+    objectsql = cache_insert(part, objectsql);
 
-        if ( pool.size() > MAX_POOL_SIZE )
-        {
-            replace();
-        }
+    if ( objectsql != 0 )
+    {
+        objectsql = check_object(objectsql, olock);
+    }
 
-        unlock();
+    pthread_mutex_unlock(&(part.mutex));
 
-        return objectsql;
-    }
+    return objectsql;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -363,56 +548,156 @@ void PoolSQL::update_cache_index(string& old_name,
                                  string& new_name,
                                  int     new_uid)
 {
-    map<string,PoolObjectSQL *>::iterator  index;
-    PoolObjectSQL * the_object;
-
-    lock();
+    map<string,int>::iterator  index;
+    int the_oid;
 
     if ( uses_name_pool == false )
     {
-        unlock();
         return;
     }
 
     string old_key  = key(old_name, old_uid);
     string new_key  = key(new_name, new_uid);
 
+    pthread_mutex_lock(&name_mutex);
+
     index = name_pool.find(old_key);
 
     if ( index != name_pool.end() )
     {
-        the_object = index->second;
+        the_oid = index->second;
 
         name_pool.erase(old_key);
 
         if ( name_pool.find(new_key) == name_pool.end())
         {
-            name_pool.insert(make_pair(new_key, the_object));
+            name_pool.insert(make_pair(new_key, the_oid));
         }
     }
 
-    unlock();
+    pthread_mutex_unlock(&name_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+PoolObjectSQL * PoolSQL::check_object(PoolObjectSQL * objectsql, bool olock)
+{
+    if ( objectsql->isValid() == false )
+    {
+        return 0;
+    }
+
+    if ( olock == true )
+    {
+        objectsql->lock();
+
+        if ( objectsql->isValid() == false )
+        {
+            objectsql->unlock();
+            objectsql = 0;
+        }
+    }
+
+    return objectsql;
 }
 
 /* -------------------------------------------------------------------------- */
+
+PoolObjectSQL * PoolSQL::cache_insert(CachePartition& part,
+                                      PoolObjectSQL * objectsql)
+{
+    map<int,PoolObjectSQL *>::iterator index;
+
+    index = part.pool.find(objectsql->oid);
+
+    if ( index != part.pool.end() ) // Cached by other thread
+    {
+        delete objectsql;
+
+        return index->second;
+    }
+
+    if ( uses_name_pool )
+    {
+        string okey = key(objectsql->name,objectsql->uid);
+
+        pthread_mutex_lock(&name_mutex);
+
+        name_pool[okey] = objectsql->oid;
+
+        pthread_mutex_unlock(&name_mutex);
+    }
+
+    // Make room before inserting, so the new object is not replaced before
+    // it is returned (and locked) to the caller
+
+    if ( part.pool.size() >= part.size )
+    {
+        replace(part);
+    }
+
+    part.pool.insert(make_pair(objectsql->oid,objectsql));
+
+    // Objects start with the reference bit cleared, so they are replaced
+    // before others already accessed from the cache
+
+    objectsql->referenced = false;
+
+    part.oid_queue.push(objectsql->oid);
+
+    return objectsql;
+}
+
 /* -------------------------------------------------------------------------- */
 
-void PoolSQL::replace()
+void PoolSQL::erase_name_index(PoolObjectSQL * objectsql)
+{
+    map<string,int>::iterator  index;
+
+    if ( uses_name_pool == false )
+    {
+        return;
+    }
+
+    string okey = key(objectsql->name,objectsql->uid);
+
+    pthread_mutex_lock(&name_mutex);
+
+    index = name_pool.find(okey);
+
+    if ( index != name_pool.end() && index->second == objectsql->oid )
+    {
+        name_pool.erase(index);
+    }
+
+    pthread_mutex_unlock(&name_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void PoolSQL::replace(CachePartition& part)
 {
-    bool removed = false;
     int  oid;
     int  rc;
 
     map<int,PoolObjectSQL *>::iterator  index;
 
-    while (!removed)
+    // Two passes over the clock: the first one clears the reference bits,
+    // in the second one only locked objects are left
+    unsigned int tries = 2 * part.oid_queue.size();
+
+    for (unsigned int i = 0 ; i < tries && !part.oid_queue.empty() ; i++)
     {
-        oid   = oid_queue.front();
-        index = pool.find(oid);
+        oid = part.oid_queue.front();
 
-        if ( index == pool.end())
+        part.oid_queue.pop();
+
+        index = part.pool.find(oid);
+
+        if ( index == part.pool.end())
         {
-            oid_queue.pop();
             continue;
         }
 
@@ -420,25 +705,28 @@ void PoolSQL::replace()
 
         if ( rc == EBUSY ) // In use by other thread, move to back
         {
-            oid_queue.pop();
-            oid_queue.push(oid);
+            part.oid_queue.push(oid);
+        }
+        else if ( index->second->referenced ) // Recently used, second chance
+        {
+            index->second->referenced = false;
+            index->second->unlock();
+
+            part.oid_queue.push(oid);
         }
         else
         {
             PoolObjectSQL * tmp_ptr = index->second;
 
-            pool.erase(index);
+            part.pool.erase(index);
 
-            if ( uses_name_pool )
-            {
-                string okey = key(tmp_ptr->name,tmp_ptr->uid);
-                name_pool.erase(okey);
-            }
+            erase_name_index(tmp_ptr);
 
             delete tmp_ptr;
 
-            oid_queue.pop();
-            removed = true;
+            part.evictions++;
+
+            return;
         }
     }
 }
@@ -446,23 +734,105 @@ void PoolSQL::replace()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void PoolSQL::set_cache_size(unsigned int size)
+{
+    if ( size < 1 )
+    {
+        return;
+    }
+
+    cache_size = size;
+
+    for (unsigned int i = 0 ; i < CACHE_PARTITIONS ; i++)
+    {
+        pthread_mutex_lock(&(partitions[i].mutex));
+
+        partitions[i].size = cache_size / CACHE_PARTITIONS + 1;
+
+        pthread_mutex_unlock(&(partitions[i].mutex));
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PoolSQL::get_cache_stats(unsigned long& hits,
+                              unsigned long& misses,
+                              unsigned long& evictions)
+{
+    hits      = 0;
+    misses    = 0;
+    evictions = 0;
+
+    for (unsigned int i = 0 ; i < CACHE_PARTITIONS ; i++)
+    {
+        pthread_mutex_lock(&(partitions[i].mutex));
+
+        hits      += partitions[i].hits;
+        misses    += partitions[i].misses;
+        evictions += partitions[i].evictions;
+
+        pthread_mutex_unlock(&(partitions[i].mutex));
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PoolSQL::print_cache_stats(ostringstream& oss)
+{
+    unsigned long hits, misses, evictions;
+    unsigned long objects = 0;
+
+    get_cache_stats(hits, misses, evictions);
+
+    for (unsigned int i = 0 ; i < CACHE_PARTITIONS ; i++)
+    {
+        pthread_mutex_lock(&(partitions[i].mutex));
+
+        objects += partitions[i].pool.size();
+
+        pthread_mutex_unlock(&(partitions[i].mutex));
+    }
+
+    oss << table << " cache: " << objects << "/" << cache_size
+        << " objects, " << hits << " hits, " << misses
+        << " misses, " << evictions << " evictions";
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void PoolSQL::clean()
 {
     map<int,PoolObjectSQL *>::iterator  it;
 
-    lock();
-
-    for ( it = pool.begin(); it != pool.end(); it++)
+    for (unsigned int i = 0 ; i < CACHE_PARTITIONS ; i++)
     {
-        it->second->lock();
+        CachePartition& part = partitions[i];
+
+        pthread_mutex_lock(&(part.mutex));
+
+        for ( it = part.pool.begin(); it != part.pool.end(); it++)
+        {
+            it->second->lock();
+
+            delete it->second;
+        }
+
+        part.pool.clear();
+
+        while ( !part.oid_queue.empty() )
+        {
+            part.oid_queue.pop();
+        }
 
-        delete it->second;
+        pthread_mutex_unlock(&(part.mutex));
     }
 
-    pool.clear();
+    pthread_mutex_lock(&name_mutex);
+
     name_pool.clear();
 
-    unlock();
+    pthread_mutex_unlock(&name_mutex);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -515,15 +885,14 @@ int PoolSQL::dump(ostringstream&  oss,
 
     oss << "<" << root_elem_name << ">";
 
-    set_callback(static_cast<Callbackable::Callback>(&PoolSQL::dump_cb),
-                 static_cast<void *>(&oss));
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&PoolSQL::dump_cb),
+                   static_cast<void *>(&oss));
 
-    rc = db->exec(sql_query, this);
+    rc = db->exec(sql_query, &cb);
 
     oss << "</" << root_elem_name << ">";
 
-    unset_callback();
-
     return rc;
 }
 
@@ -556,14 +925,13 @@ int PoolSQL::search(
     ostringstream   sql;
     int             rc;
 
-    set_callback(static_cast<Callbackable::Callback>(&PoolSQL::search_cb),
-                 static_cast<void *>(&oids));
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&PoolSQL::search_cb),
+                   static_cast<void *>(&oids));
 
     sql  << "SELECT oid FROM " <<  table << " WHERE " << where;
 
-    rc = db->exec(sql, this);
-
-    unset_callback();
+    rc = db->exec(sql, &cb);
 
     return rc;
 }
@@ -57,28 +57,11 @@ int TestObjectSQL::update(SqlDB *db)
 int TestObjectSQL::insert_replace(SqlDB *db, bool replace)
 {
     ostringstream   oss;
+    SqlParams       params;
 
-    int    rc;
     string xml_body;
 
-    char * sql_name;
-    char * sql_xml;
-
-    // Update the User
-
-    sql_name = db->escape_str(name.c_str());
-
-    if ( sql_name == 0 )
-    {
-        goto error_name;
-    }
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
+    to_xml(xml_body);
 
     // Construct the SQL statement to Insert or Replace
     if(replace)
@@ -91,21 +74,13 @@ int TestObjectSQL::insert_replace(SqlDB *db, bool replace)
     }
 
     oss << " INTO " << table << " ("<< db_names <<") VALUES ("
-        <<          oid             << ","
-        << "'" <<   sql_name        << "',"
-        << "'" <<   sql_xml         << "',"
-        <<          uid             << ","
-        <<          number          << ")";
-
-    rc = db->exec(oss);
-
-    db->free_str(sql_name);
-    db->free_str(sql_xml);
+        << "?,?,?,?,?)";
 
-    return rc;
+    params.add(oid)
+          .add(name)
+          .add(xml_body)
+          .add(uid)
+          .add(number);
 
-error_body:
-    db->free_str(sql_name);
-error_name:
-    return -1;
+    return db->exec(oss, params);
 }
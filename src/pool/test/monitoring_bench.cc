@@ -0,0 +1,170 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "NebulaLog.h"
+#include "SqliteDB.h"
+#include "MonitoringStore.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// Time of a timer tick (clean_expired) on a host_monitoring table with a
+// large number of rows spread over two days:
+//   - DELETE without index: a full scan of the table on every tick
+//   - DELETE with index: the time index, nothing expired
+//   - bucket expiration: drop the rows of the expired bucket, and the
+//     following ticks in the same bucket
+//
+// Usage: monitoring_bench [num_rows]
+
+static const char * monit_bootstrap = "CREATE TABLE IF NOT EXISTS "
+    "host_monitoring (hid INTEGER, start_time INTEGER, last_time INTEGER, "
+    "body TEXT, PRIMARY KEY(hid, start_time))";
+
+static const char * monit_index = "CREATE INDEX host_monitoring_time_idx "
+    "ON host_monitoring (last_time)";
+
+static const char * rollup_bootstrap = "CREATE TABLE IF NOT EXISTS "
+    "host_monitoring_rollup (hid INTEGER, resolution INTEGER, "
+    "start_time INTEGER, body TEXT, PRIMARY KEY(hid, resolution, start_time))";
+
+static const char * metrics[] = {"FREE_CPU", 0};
+
+static const int    NUM_HOSTS  = 10000;
+static const time_t EXPIRATION = 86400;
+
+/* -------------------------------------------------------------------------- */
+
+static double timed_exec(SqlDB * db, ostringstream& cmd)
+{
+    double start = Benchmark::now_ms();
+
+    db->exec(cmd);
+
+    return Benchmark::now_ms() - start;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    string db_name  = "ONE_monitoring_bench";
+    long   num_rows = 10000000;
+
+    ostringstream cmd;
+    ostringstream title;
+    double        start;
+
+    BenchColumn columns[] = {{"timer tick", -40, 2}, {"ms", 12, 2}};
+
+    if ( argc > 1 )
+    {
+        num_rows = atol(argv[1]);
+    }
+
+    NebulaLog::init_log_system(NebulaLog::FILE, Log::ERROR, "bench.log");
+
+    unlink(db_name.c_str());
+
+    SqlDB * db = new SqliteDB(db_name);
+
+    ostringstream oss_monit(monit_bootstrap);
+    ostringstream oss_rollup(rollup_bootstrap);
+
+    db->exec(oss_monit);
+    db->exec(oss_rollup);
+
+    // Rows of the last two days, each chunk covers one hour of a host
+    time_t now  = time(0);
+    time_t base = now - 2 * EXPIRATION;
+    long   step = (2 * EXPIRATION * NUM_HOSTS) / num_rows;
+
+    if ( step == 0 )
+    {
+        step = 1;
+    }
+
+    cout << "Filling host_monitoring with " << num_rows << " rows..." << flush;
+
+    start = Benchmark::now_ms();
+
+    cmd << "INSERT INTO host_monitoring (hid, start_time, last_time, body) "
+        << "WITH RECURSIVE c(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM c "
+        << "WHERE i < " << num_rows - 1 << ") "
+        << "SELECT i % " << NUM_HOSTS << ", "
+        << base << " + (i / " << NUM_HOSTS << ") * " << step * NUM_HOSTS
+        << " + i % " << NUM_HOSTS << ", "
+        << base << " + (i / " << NUM_HOSTS << ") * " << step * NUM_HOSTS
+        << " + i % " << NUM_HOSTS << " + 3540, hex(randomblob(64)) FROM c";
+
+    db->exec(cmd);
+
+    cout << " " << fixed << setprecision(0)
+         << (Benchmark::now_ms() - start) / 1000 << "s" << endl << endl;
+
+    title << "clean_expired() of " << num_rows << " rows";
+
+    Benchmark bench(title.str(), columns, 2);
+
+    // Old behaviour: DELETE on every tick, scanning the whole table
+    cmd.str("");
+    cmd << "DELETE FROM host_monitoring WHERE last_time < " << base;
+
+    bench << "DELETE, no index" << timed_exec(db, cmd);
+
+    ostringstream oss_index(monit_index);
+
+    db->exec(oss_index);
+
+    bench << "DELETE, time index" << timed_exec(db, cmd);
+
+    // Bucket expiration, the first tick drops the expired buckets (one day
+    // of samples), the following ticks of the bucket do not hit the DB
+    MonitoringStore store("host_monitoring", "host_monitoring_rollup", "hid",
+                          "host_pool", "LAST_MON_TIME", metrics, EXPIRATION);
+
+    start = Benchmark::now_ms();
+
+    store.clean_expired(db);
+
+    bench << "bucket expiration, first tick" << Benchmark::now_ms() - start;
+
+    start = Benchmark::now_ms();
+
+    for (int i = 0 ; i < 100 ; i++)
+    {
+        store.clean_expired(db);
+    }
+
+    bench << "bucket expiration, next ticks"
+          << (Benchmark::now_ms() - start) / 100;
+
+    delete db;
+
+    unlink(db_name.c_str());
+    unlink((db_name + "-wal").c_str());
+    unlink((db_name + "-shm").c_str());
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
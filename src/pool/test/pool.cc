@@ -17,16 +17,250 @@
 #include <string>
 #include <iostream>
 #include <getopt.h>
+#include <errno.h>
+#include <unistd.h>
 
 #include "test/OneUnitTest.h"
 #include "PoolSQL.h"
 #include "TestPoolSQL.h"
+#include "MonitoringStore.h"
 
 using namespace std;
 
 /* ************************************************************************* */
 /* ************************************************************************* */
 
+struct GetArgs
+{
+    TestPool *   pool;
+    unsigned int seed;
+    int          errors;
+};
+
+extern "C" void * get_loop(void * _args)
+{
+    GetArgs * args = static_cast<GetArgs *>(_args);
+
+    for (int i=0 ; i < 5000 ; i++)
+    {
+        int oid = rand_r(&(args->seed)) % 200;
+
+        TestObjectSQL * obj = args->pool->get(oid, true);
+
+        if ( obj == 0 )
+        {
+            args->errors++;
+            continue;
+        }
+
+        if ( obj->number != oid )
+        {
+            args->errors++;
+        }
+
+        obj->unlock();
+    }
+
+    return 0;
+}
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+// Select callback that blocks in the first row until released
+class BlockingSelect : public Callbackable
+{
+public:
+    BlockingSelect():rows(0),released(false)
+    {
+        pthread_mutex_init(&mutex,0);
+        pthread_cond_init(&cond,0);
+    };
+
+    ~BlockingSelect()
+    {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&cond);
+    };
+
+    int select_cb(void *nil, int num, char **values, char **names)
+    {
+        struct timespec timeout;
+
+        pthread_mutex_lock(&mutex);
+
+        rows++;
+
+        pthread_cond_broadcast(&cond);
+
+        timeout.tv_sec  = time(0) + 5;
+        timeout.tv_nsec = 0;
+
+        while ( !released )
+        {
+            if (pthread_cond_timedwait(&cond,&mutex,&timeout) == ETIMEDOUT)
+            {
+                released = true;
+            }
+        }
+
+        pthread_mutex_unlock(&mutex);
+
+        return 0;
+    };
+
+    // Counts the rows without blocking
+    int count_cb(void *_count, int num, char **values, char **names)
+    {
+        int * count = static_cast<int *>(_count);
+
+        (*count)++;
+
+        return 0;
+    };
+
+    void wait_row()
+    {
+        pthread_mutex_lock(&mutex);
+
+        while ( rows == 0 )
+        {
+            pthread_cond_wait(&cond,&mutex);
+        }
+
+        pthread_mutex_unlock(&mutex);
+    };
+
+    bool release()
+    {
+        bool was_released;
+
+        pthread_mutex_lock(&mutex);
+
+        was_released = released;
+        released     = true;
+
+        pthread_cond_broadcast(&cond);
+
+        pthread_mutex_unlock(&mutex);
+
+        return was_released;
+    };
+
+    int  rows;
+
+private:
+    bool released;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+};
+
+// Select callback that runs more distinct prepared statements than the
+// statement cache of the connection holds, while the select is being stepped
+class NestedSelect : public Callbackable
+{
+public:
+    NestedSelect(SqlDB * _db):rows(0),errors(0),db(_db){};
+
+    int nested_cb(void *nil, int num, char **values, char **names)
+    {
+        for (int i = 0 ; i < 300 ; i++)
+        {
+            ostringstream oss;
+            int           value    = -1;
+            int           expected = rows * 1000 + i;
+
+            SqlCallback cb(this,
+                    static_cast<Callbackable::Callback>(&NestedSelect::value_cb),
+                    static_cast<void *>(&value));
+
+            SqlParams params;
+
+            oss << "SELECT " << expected << " + ?";
+
+            params.add(0);
+
+            if ( db->exec(oss, params, &cb) != 0 || value != expected )
+            {
+                errors++;
+            }
+        }
+
+        rows++;
+
+        return 0;
+    };
+
+    int value_cb(void *_value, int num, char **values, char **names)
+    {
+        int * value = static_cast<int *>(_value);
+
+        *value = atoi(values[0]);
+
+        return 0;
+    };
+
+    int  rows;
+    int  errors;
+
+private:
+    SqlDB * db;
+};
+
+struct SelectArgs
+{
+    SqlDB *          db;
+    BlockingSelect * obj;
+    int              rc;
+};
+
+extern "C" void * select_thread(void * _args)
+{
+    SelectArgs *  args = static_cast<SelectArgs *>(_args);
+    ostringstream oss;
+
+    oss << "SELECT oid FROM test_pool";
+
+    SqlCallback cb(args->obj,
+            static_cast<Callbackable::Callback>(&BlockingSelect::select_cb));
+
+    args->rc = args->db->exec(oss, &cb);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+struct UpdateArgs
+{
+    TestPool *  pool;
+    int         oid;
+    int         rc;
+};
+
+extern "C" void * update_thread(void * _args)
+{
+    UpdateArgs *    args = static_cast<UpdateArgs *>(_args);
+    TestObjectSQL * obj  = args->pool->get(args->oid, true);
+
+    if ( obj == 0 )
+    {
+        return 0;
+    }
+
+    obj->number = args->oid + 100;
+
+    args->rc = args->pool->update(obj);
+
+    obj->unlock();
+
+    return 0;
+}
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
 class PoolTest : public OneUnitTest
 {
     CPPUNIT_TEST_SUITE (PoolTest);
@@ -35,6 +269,17 @@ class PoolTest : public OneUnitTest
     CPPUNIT_TEST (search);
     CPPUNIT_TEST (cache_test);
     CPPUNIT_TEST (cache_name_test);
+    CPPUNIT_TEST (cache_replace_test);
+    CPPUNIT_TEST (concurrent_get);
+    CPPUNIT_TEST (get_many);
+    CPPUNIT_TEST (concurrent_read_write);
+    CPPUNIT_TEST (concurrent_callbacks);
+    CPPUNIT_TEST (stmt_cache);
+    CPPUNIT_TEST (transaction);
+    CPPUNIT_TEST (group_commit);
+    CPPUNIT_TEST (monitoring_chunk);
+    CPPUNIT_TEST (monitoring_store);
+    CPPUNIT_TEST (monitoring_rollup);
     CPPUNIT_TEST_SUITE_END ();
 
 private:
@@ -48,6 +293,20 @@ private:
         return pool->allocate(obj, err);
     };
 
+    void monitoring_bootstrap()
+    {
+        ostringstream bootstrap("CREATE TABLE test_monitoring (tid INTEGER, "
+            "start_time INTEGER, last_time INTEGER, body TEXT, "
+            "PRIMARY KEY(tid, start_time))");
+
+        ostringstream rollup("CREATE TABLE test_rollup (tid INTEGER, "
+            "resolution INTEGER, start_time INTEGER, body TEXT, "
+            "PRIMARY KEY(tid, resolution, start_time))");
+
+        CPPUNIT_ASSERT(db->exec(bootstrap) == 0);
+        CPPUNIT_ASSERT(db->exec(rollup) == 0);
+    };
+
 public:
     PoolTest(){};
 
@@ -292,6 +551,734 @@ public:
             }
         }
     };
+
+    void cache_replace_test()
+    {
+        TestObjectSQL *obj;
+        TestObjectSQL *obj_0;
+
+        unsigned long hits, misses, evictions;
+
+        int parts = PoolSQL::CACHE_PARTITIONS;
+
+        // 3 objects per cache partition
+        pool->set_cache_size(2 * parts);
+
+        for (int i=0 ; i < 4 * parts ; i++)
+        {
+            ostringstream name;
+            name << "obj_" << i;
+
+            create_allocate(i, name.str());
+        }
+
+        // Objects 0, parts, 2*parts and 3*parts share a cache partition
+        for (int i=0 ; i < 3 ; i++)
+        {
+            obj = pool->get(i * parts, false);
+            CPPUNIT_ASSERT(obj != 0);
+        }
+
+        // Reference object 0, it should survive the next replacement
+        obj_0 = pool->get(0, false);
+        CPPUNIT_ASSERT(obj_0 != 0);
+
+        obj = pool->get(3 * parts, false);
+        CPPUNIT_ASSERT(obj != 0);
+
+        pool->get_cache_stats(hits, misses, evictions);
+
+        CPPUNIT_ASSERT(hits      == 1);
+        CPPUNIT_ASSERT(misses    == 4);
+        CPPUNIT_ASSERT(evictions == 1);
+
+        // Object 0 is still cached, the second object was evicted
+        obj = pool->get(0, false);
+        CPPUNIT_ASSERT(obj == obj_0);
+
+        obj = pool->get(parts, false);
+        CPPUNIT_ASSERT(obj != 0);
+        CPPUNIT_ASSERT(obj->number == parts);
+
+        pool->get_cache_stats(hits, misses, evictions);
+
+        CPPUNIT_ASSERT(hits      == 2);
+        CPPUNIT_ASSERT(misses    == 5);
+        CPPUNIT_ASSERT(evictions == 2);
+    };
+
+    void get_many()
+    {
+        vector<int>             oids;
+        vector<PoolObjectSQL *> objs;
+
+        unsigned long hits, misses, evictions;
+        int rc;
+
+        for (int i=0 ; i < 10 ; i++)
+        {
+            ostringstream name;
+            name << "obj_" << i;
+
+            create_allocate(i, name.str());
+        }
+
+        // Cache objects 2 and 5
+        CPPUNIT_ASSERT(pool->get(2, false) != 0);
+        CPPUNIT_ASSERT(pool->get(5, false) != 0);
+
+        oids.push_back(7);
+        oids.push_back(2);
+        oids.push_back(15); //Does not exist
+        oids.push_back(5);
+        oids.push_back(0);
+        oids.push_back(7);
+
+        rc = pool->get_many(oids, objs, true);
+
+        CPPUNIT_ASSERT(rc == 2);
+        CPPUNIT_ASSERT(objs.size() == 4);
+
+        int expected[] = {0, 2, 5, 7};
+
+        for (unsigned int i=0 ; i < objs.size() ; i++)
+        {
+            TestObjectSQL * obj = static_cast<TestObjectSQL *>(objs[i]);
+
+            CPPUNIT_ASSERT(obj->get_oid() == expected[i]);
+            CPPUNIT_ASSERT(obj->number    == expected[i]);
+
+            obj->unlock();
+        }
+
+        pool->get_cache_stats(hits, misses, evictions);
+
+        CPPUNIT_ASSERT(hits   == 2);
+        CPPUNIT_ASSERT(misses == 5);
+
+        // All the objects are now cached
+        objs.clear();
+
+        rc = pool->get_many(oids, objs, false);
+
+        CPPUNIT_ASSERT(rc == 0);
+        CPPUNIT_ASSERT(objs.size() == 4);
+    };
+
+    void concurrent_get()
+    {
+        pthread_t threads[8];
+        GetArgs   args[8];
+
+        for (int i=0 ; i < 200 ; i++)
+        {
+            ostringstream name;
+            name << "obj_" << i;
+
+            create_allocate(i, name.str());
+        }
+
+        pool->set_cache_size(50);
+
+        for (int i=0 ; i < 8 ; i++)
+        {
+            args[i].pool   = pool;
+            args[i].seed   = i;
+            args[i].errors = 0;
+
+            pthread_create(&threads[i], 0, get_loop, &args[i]);
+        }
+
+        for (int i=0 ; i < 8 ; i++)
+        {
+            pthread_join(threads[i], 0);
+
+            CPPUNIT_ASSERT(args[i].errors == 0);
+        }
+    };
+
+    // Updates must not wait for a SELECT in a read-only connection
+    void concurrent_read_write()
+    {
+        if ( mysql )
+        {
+            return;
+        }
+
+        string         wal_name = "ONE_wal_test_database";
+        SqlDB *        wal_db;
+        TestPool *     wal_pool;
+        BlockingSelect select;
+        SelectArgs     args;
+        pthread_t      thread;
+        string         err;
+
+        unlink(wal_name.c_str());
+
+        wal_db = new SqliteDB(wal_name, 2);
+
+        TestObjectSQL::bootstrap(wal_db);
+
+        wal_pool = new TestPool(wal_db);
+
+        for (int i=0 ; i < 10 ; i++)
+        {
+            wal_pool->allocate(new TestObjectSQL(i, "obj"), err);
+        }
+
+        args.db  = wal_db;
+        args.obj = &select;
+        args.rc  = -1;
+
+        pthread_create(&thread, 0, select_thread, &args);
+
+        select.wait_row();
+
+        TestObjectSQL * obj = wal_pool->get(0, true);
+
+        CPPUNIT_ASSERT(obj != 0);
+
+        obj->number = 100;
+
+        CPPUNIT_ASSERT(wal_pool->update(obj) == 0);
+
+        obj->unlock();
+
+        CPPUNIT_ASSERT(wal_pool->allocate(new TestObjectSQL(10,"obj"),err)==10);
+
+        // The select is still blocked in the first row
+        CPPUNIT_ASSERT(select.release() == false);
+
+        pthread_join(thread, 0);
+
+        CPPUNIT_ASSERT(args.rc == 0);
+        CPPUNIT_ASSERT(select.rows == 10);
+
+        delete wal_pool;
+        delete wal_db;
+
+        unlink(wal_name.c_str());
+        unlink((wal_name + "-wal").c_str());
+        unlink((wal_name + "-shm").c_str());
+    };
+
+    // A query can use a callback of an object while another query is running
+    // a callback of the same object
+    void concurrent_callbacks()
+    {
+        if ( mysql )
+        {
+            return;
+        }
+
+        string         wal_name = "ONE_wal_test_database";
+        SqlDB *        wal_db;
+        TestPool *     wal_pool;
+        BlockingSelect select;
+        SelectArgs     args;
+        pthread_t      thread;
+        string         err;
+        ostringstream  oss;
+        int            count = 0;
+
+        unlink(wal_name.c_str());
+
+        wal_db = new SqliteDB(wal_name, 2);
+
+        TestObjectSQL::bootstrap(wal_db);
+
+        wal_pool = new TestPool(wal_db);
+
+        for (int i=0 ; i < 10 ; i++)
+        {
+            wal_pool->allocate(new TestObjectSQL(i, "obj"), err);
+        }
+
+        args.db  = wal_db;
+        args.obj = &select;
+        args.rc  = -1;
+
+        pthread_create(&thread, 0, select_thread, &args);
+
+        select.wait_row();
+
+        SqlCallback cb(&select,
+                static_cast<Callbackable::Callback>(&BlockingSelect::count_cb),
+                static_cast<void *>(&count));
+
+        oss << "SELECT oid FROM test_pool";
+
+        CPPUNIT_ASSERT(wal_db->exec(oss, &cb) == 0);
+        CPPUNIT_ASSERT(count == 10);
+
+        // The first select is still blocked in the first row
+        CPPUNIT_ASSERT(select.release() == false);
+
+        pthread_join(thread, 0);
+
+        CPPUNIT_ASSERT(args.rc == 0);
+        CPPUNIT_ASSERT(select.rows == 10);
+
+        delete wal_pool;
+        delete wal_db;
+
+        unlink(wal_name.c_str());
+        unlink((wal_name + "-wal").c_str());
+        unlink((wal_name + "-shm").c_str());
+    };
+
+    // Statements are replaced one at a time when the cache is full, the
+    // statement being stepped is not finalized
+    void stmt_cache()
+    {
+        NestedSelect  select(db);
+        ostringstream oss;
+        SqlParams     params;
+
+        create_allocate(1, "obj_1");
+        create_allocate(2, "obj_2");
+        create_allocate(3, "obj_3");
+
+        SqlCallback cb(&select,
+                static_cast<Callbackable::Callback>(&NestedSelect::nested_cb));
+
+        oss << "SELECT oid FROM test_pool WHERE oid >= ?";
+
+        params.add(0);
+
+        // In a transaction all the statements use the same connection
+        CPPUNIT_ASSERT(db->begin() == 0);
+
+        CPPUNIT_ASSERT(db->exec(oss, params, &cb) == 0);
+
+        CPPUNIT_ASSERT(db->commit() == 0);
+
+        CPPUNIT_ASSERT(select.rows   == 3);
+        CPPUNIT_ASSERT(select.errors == 0);
+    };
+
+    void transaction()
+    {
+        TestObjectSQL * obj;
+
+        create_allocate(1, "obj_1");
+
+        obj = pool->get(0, true);
+
+        // A nested rollback makes the whole transaction roll back
+        CPPUNIT_ASSERT(db->begin() == 0);
+
+        obj->number = 10;
+        CPPUNIT_ASSERT(pool->update(obj) == 0);
+
+        CPPUNIT_ASSERT(db->begin() == 0);
+        CPPUNIT_ASSERT(db->rollback() == 0);
+
+        CPPUNIT_ASSERT(db->commit() == -1);
+
+        obj->unlock();
+
+        pool->clean();
+
+        obj = pool->get(0, true);
+
+        CPPUNIT_ASSERT(obj->number == 1);
+
+        // Both updates are committed
+        {
+            SqlTransaction tx(db);
+
+            obj->number = 20;
+            CPPUNIT_ASSERT(pool->update(obj) == 0);
+
+            obj->text = "updated";
+            CPPUNIT_ASSERT(pool->update(obj) == 0);
+
+            CPPUNIT_ASSERT(tx.commit() == 0);
+        }
+
+        // Not committed, rolled back when the transaction goes out of scope
+        {
+            SqlTransaction tx(db);
+
+            obj->number = 30;
+            CPPUNIT_ASSERT(pool->update(obj) == 0);
+        }
+
+        obj->unlock();
+
+        pool->clean();
+
+        obj = pool->get(0, false);
+
+        CPPUNIT_ASSERT(obj->number == 20);
+        CPPUNIT_ASSERT(obj->text   == "updated");
+    };
+
+    // Updates from several threads are committed together
+    void group_commit()
+    {
+        if ( mysql )
+        {
+            return;
+        }
+
+        string     gc_name = "ONE_group_commit_database";
+        SqlDB *    gc_db;
+        TestPool * gc_pool;
+        pthread_t  threads[8];
+        UpdateArgs args[8];
+        string     err;
+
+        unlink(gc_name.c_str());
+
+        gc_db = new SqliteDB(gc_name, 2, 50);
+
+        TestObjectSQL::bootstrap(gc_db);
+
+        gc_pool = new TestPool(gc_db);
+
+        for (int i=0 ; i < 8 ; i++)
+        {
+            gc_pool->allocate(new TestObjectSQL(i, "obj"), err);
+        }
+
+        for (int i=0 ; i < 8 ; i++)
+        {
+            args[i].pool = gc_pool;
+            args[i].oid  = i;
+            args[i].rc   = -1;
+
+            pthread_create(&threads[i], 0, update_thread, &args[i]);
+        }
+
+        for (int i=0 ; i < 8 ; i++)
+        {
+            pthread_join(threads[i], 0);
+
+            CPPUNIT_ASSERT(args[i].rc == 0);
+        }
+
+        // The updates are in the DB once update() returns
+        delete gc_pool;
+        delete gc_db;
+
+        gc_db   = new SqliteDB(gc_name);
+        gc_pool = new TestPool(gc_db);
+
+        for (int i=0 ; i < 8 ; i++)
+        {
+            TestObjectSQL * obj = gc_pool->get(i, false);
+
+            CPPUNIT_ASSERT(obj != 0);
+            CPPUNIT_ASSERT(obj->number == i + 100);
+        }
+
+        delete gc_pool;
+        delete gc_db;
+
+        unlink(gc_name.c_str());
+        unlink((gc_name + "-wal").c_str());
+        unlink((gc_name + "-shm").c_str());
+    };
+
+    // Samples are encoded and decoded without loss
+    void monitoring_chunk()
+    {
+        MonitoringChunk   chunk(4);
+        vector<long long> values(4);
+
+        vector<time_t>              times;
+        vector< vector<long long> > samples;
+
+        string str;
+
+        for (int i = 0 ; i < MonitoringChunk::MAX_SAMPLES ; i++)
+        {
+            values[0] = 1024;                      // constant
+            values[1] = i * 10;                    // constant rate
+            values[2] = (i % 7) * 1000 - 3000;     // changes, negative
+            values[3] = (1LL << 40) + i * (i % 3) * 123456789LL;
+
+            CPPUNIT_ASSERT(chunk.add(1000 + i * 60 + i % 2, values) == 0);
+        }
+
+        CPPUNIT_ASSERT(chunk.full());
+        CPPUNIT_ASSERT(chunk.add(100000, values) == -1);
+
+        CPPUNIT_ASSERT(chunk.get_start_time() == 1000);
+        CPPUNIT_ASSERT(chunk.get_last_time() ==
+                       1000 + (MonitoringChunk::MAX_SAMPLES - 1) * 60 + 1);
+
+        chunk.to_str(str);
+
+        CPPUNIT_ASSERT(MonitoringChunk::decode(str, 4, times, samples) == 0);
+
+        CPPUNIT_ASSERT(times.size() == (size_t) MonitoringChunk::MAX_SAMPLES);
+        CPPUNIT_ASSERT(samples.size() == (size_t) MonitoringChunk::MAX_SAMPLES);
+
+        for (int i = 0 ; i < MonitoringChunk::MAX_SAMPLES ; i++)
+        {
+            CPPUNIT_ASSERT(times[i] == 1000 + i * 60 + i % 2);
+
+            CPPUNIT_ASSERT(samples[i][0] == 1024);
+            CPPUNIT_ASSERT(samples[i][1] == i * 10);
+            CPPUNIT_ASSERT(samples[i][2] == (i % 7) * 1000 - 3000);
+            CPPUNIT_ASSERT(samples[i][3] ==
+                           (1LL << 40) + i * (i % 3) * 123456789LL);
+        }
+
+        // Times must increase
+        MonitoringChunk other(1);
+        vector<long long> one(1, 5);
+
+        CPPUNIT_ASSERT(other.add(100, one) == 0);
+        CPPUNIT_ASSERT(other.add(100, one) == -1);
+        CPPUNIT_ASSERT(other.add(200, values) == -1);
+        CPPUNIT_ASSERT(other.add(200, one) == 0);
+        CPPUNIT_ASSERT(other.size() == 2);
+
+        CPPUNIT_ASSERT(MonitoringChunk::decode("", 1, times, samples) == -1);
+    };
+
+    // Samples are dumped as the object body with the metrics of each sample
+    void monitoring_store()
+    {
+        const char * metrics[] = {"UID", "GID", 0};
+
+        monitoring_bootstrap();
+
+        create_allocate(1, "obj_1");
+        create_allocate(2, "obj_2");
+
+        MonitoringStore * store = new MonitoringStore("test_monitoring",
+                "test_rollup", "tid", "test_pool", "NUMBER", metrics, 3600);
+
+        vector<long long> values(2);
+        ostringstream     oss;
+        string            expected;
+
+        time_t now = time(0);
+
+        values[0] = 5;
+        values[1] = 7;
+
+        // Expired sample, not dumped
+        CPPUNIT_ASSERT(store->add(db, 0, now - 4000, values) == 0);
+
+        for (int i = 0 ; i < 3 ; i++)
+        {
+            values[0] = i;
+
+            CPPUNIT_ASSERT(store->add(db, 0, now - 30 + i * 10, values) == 0);
+        }
+
+        CPPUNIT_ASSERT(store->add(db, 0, now - 10, values) == -1);
+        CPPUNIT_ASSERT(store->add(db, 1, now, values) == 0);
+
+        for (int i = 0 ; i < 3 ; i++)
+        {
+            ostringstream sample;
+
+            sample << "<TEST><ID>0</ID><UID>" << i << "</UID><GID>7</GID>"
+                   << "<UNAME></UNAME><GNAME></GNAME>"
+                   << "<NAME>obj_1</NAME><NUMBER>" << now - 30 + i * 10
+                   << "</NUMBER><TEXT>obj_1</TEXT></TEST>";
+
+            expected += sample.str();
+        }
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "oid = 0") == 0);
+        CPPUNIT_ASSERT(oss.str() == "<MONITORING_DATA>" + expected +
+                                    "</MONITORING_DATA>");
+
+        // The samples are dumped from the DB, a new store without chunks in
+        // memory gets the ones of both objects
+        delete store;
+
+        store = new MonitoringStore("test_monitoring", "test_rollup", "tid",
+                "test_pool", "NUMBER", metrics, 3600);
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "") == 0);
+        CPPUNIT_ASSERT(oss.str().find(expected) != string::npos);
+        CPPUNIT_ASSERT(oss.str().find("<NAME>obj_2</NAME>") != string::npos);
+
+        CPPUNIT_ASSERT(store->clean_expired(db) == 0);
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "oid = 0") == 0);
+        CPPUNIT_ASSERT(oss.str() == "<MONITORING_DATA>" + expected +
+                                    "</MONITORING_DATA>");
+
+        // Expired rows are deleted once per bucket, a store with a longer
+        // expiration is used to check them. The check must run in a single
+        // bucket, so it waits for the next one when close to its end
+        MonitoringStore * check = new MonitoringStore("test_monitoring",
+                "test_rollup", "tid", "test_pool", "NUMBER", metrics, 100000);
+
+        time_t bucket = now - now % MonitoringStore::EXPIRATION_BUCKET;
+        time_t left   = bucket + MonitoringStore::EXPIRATION_BUCKET - time(0);
+
+        if ( left < 10 )
+        {
+            sleep(left + 1);
+
+            bucket += MonitoringStore::EXPIRATION_BUCKET;
+        }
+
+        create_allocate(3, "obj_3");
+
+        // First clean in this bucket, the next one is skipped
+        CPPUNIT_ASSERT(store->clean_expired(db) == 0);
+
+        CPPUNIT_ASSERT(store->add(db, 2, bucket - 3600 - 10, values) == 0);
+        CPPUNIT_ASSERT(store->clean_expired(db) == 0);
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(check->dump(db, oss, "oid = 2") == 0);
+        CPPUNIT_ASSERT(oss.str().find("obj_3") != string::npos);
+
+        delete store;
+
+        store = new MonitoringStore("test_monitoring", "test_rollup", "tid",
+                "test_pool", "NUMBER", metrics, 3600);
+
+        CPPUNIT_ASSERT(store->clean_expired(db) == 0);
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(check->dump(db, oss, "oid = 2") == 0);
+        CPPUNIT_ASSERT(oss.str() == "<MONITORING_DATA></MONITORING_DATA>");
+
+        delete check;
+
+        CPPUNIT_ASSERT(store->clean_all(db) == 0);
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "") == 0);
+        CPPUNIT_ASSERT(oss.str() == "<MONITORING_DATA></MONITORING_DATA>");
+
+        delete store;
+    };
+
+    // Samples are aggregated in rollups of each resolution
+    void monitoring_rollup()
+    {
+        const char * metrics[] = {"UID", "GID", 0};
+
+        monitoring_bootstrap();
+
+        create_allocate(1, "obj_1");
+
+        MonitoringStore * store = new MonitoringStore("test_monitoring",
+                "test_rollup", "tid", "test_pool", "NUMBER", metrics, 0);
+
+        vector<long long> values(2);
+        ostringstream     oss;
+
+        CPPUNIT_ASSERT(store->add_rollup(60, 0) == 0);
+        CPPUNIT_ASSERT(store->add_rollup(3600, 0) == 0);
+        CPPUNIT_ASSERT(store->add_rollup(60, 0) == -1);
+        CPPUNIT_ASSERT(store->add_rollup(0, 0) == -1);
+
+        CPPUNIT_ASSERT(store->has_resolution(0));
+        CPPUNIT_ASSERT(store->has_resolution(60));
+        CPPUNIT_ASSERT(!store->has_resolution(300));
+        CPPUNIT_ASSERT(store->dump(db, oss, "", 300) == -1);
+
+        time_t start = (time(0) / 3600) * 3600 - 3600;
+
+        // Samples at start, +30, +60, +90: two 60s intervals, one 3600s
+        for (int i = 0 ; i < 4 ; i++)
+        {
+            values[0] = i;
+            values[1] = 100 * (i % 2);
+
+            CPPUNIT_ASSERT(store->add(db, 0, start + i * 30, values) == 0);
+        }
+
+        // Samples are not stored, expiration is 0
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "", 0) == 0);
+        CPPUNIT_ASSERT(oss.str() == "<MONITORING_DATA></MONITORING_DATA>");
+
+        // A new store reads the open intervals from the DB with the first
+        // sample of the object, that is added to the 60s interval of start+60
+        delete store;
+
+        store = new MonitoringStore("test_monitoring", "test_rollup", "tid",
+                "test_pool", "NUMBER", metrics, 0);
+
+        store->add_rollup(60, 0);
+        store->add_rollup(3600, 0);
+
+        values[0] = 10;
+        values[1] = 50;
+
+        CPPUNIT_ASSERT(store->add(db, 0, start + 100, values) == 0);
+
+        ostringstream expected;
+
+        expected << "<MONITORING_DATA>"
+            << "<TEST><ID>0</ID><UID>0</UID><GID>50</GID><UNAME></UNAME>"
+            << "<GNAME></GNAME><NAME>obj_1</NAME><NUMBER>" << start
+            << "</NUMBER><TEXT>obj_1</TEXT><MONITORING_ROLLUP>"
+            << "<RESOLUTION>60</RESOLUTION><SAMPLES>2</SAMPLES>"
+            << "<MIN><UID>0</UID><GID>0</GID></MIN>"
+            << "<MAX><UID>1</UID><GID>100</GID></MAX>"
+            << "</MONITORING_ROLLUP></TEST>"
+            << "<TEST><ID>0</ID><UID>5</UID><GID>50</GID><UNAME></UNAME>"
+            << "<GNAME></GNAME><NAME>obj_1</NAME><NUMBER>" << start + 60
+            << "</NUMBER><TEXT>obj_1</TEXT><MONITORING_ROLLUP>"
+            << "<RESOLUTION>60</RESOLUTION><SAMPLES>3</SAMPLES>"
+            << "<MIN><UID>2</UID><GID>0</GID></MIN>"
+            << "<MAX><UID>10</UID><GID>100</GID></MAX>"
+            << "</MONITORING_ROLLUP></TEST>"
+            << "</MONITORING_DATA>";
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "oid = 0", 60) == 0);
+        CPPUNIT_ASSERT(oss.str() == expected.str());
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "oid = 0", 3600) == 0);
+        CPPUNIT_ASSERT(oss.str().find("<UID>3</UID><GID>50</GID>")
+                       != string::npos);
+        CPPUNIT_ASSERT(oss.str().find("<SAMPLES>5</SAMPLES>")
+                       != string::npos);
+
+        delete store;
+
+        // Expired rollups are deleted
+        store = new MonitoringStore("test_monitoring", "test_rollup", "tid",
+                "test_pool", "NUMBER", metrics, 0);
+
+        store->add_rollup(60, 600);
+        store->add_rollup(3600, 0);
+
+        CPPUNIT_ASSERT(store->clean_expired(db) == 0);
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "", 60) == 0);
+        CPPUNIT_ASSERT(oss.str() == "<MONITORING_DATA></MONITORING_DATA>");
+
+        oss.str("");
+
+        CPPUNIT_ASSERT(store->dump(db, oss, "", 3600) == 0);
+        CPPUNIT_ASSERT(oss.str().find("<SAMPLES>5</SAMPLES>")
+                       != string::npos);
+
+        delete store;
+    };
 };
 
 /* ************************************************************************* */
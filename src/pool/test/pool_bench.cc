@@ -0,0 +1,161 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "NebulaLog.h"
+#include "SqliteDB.h"
+#include "TestPoolSQL.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// PoolSQL::get() calls per second with an increasing number of threads, with
+// a cache that holds all the objects (hits) and with a cache that holds a 10%
+// of them (misses).
+//
+// Usage: bench [num_objects] [gets_per_thread]
+
+struct BenchArgs
+{
+    TestPool *   pool;
+    int          num_objects;
+    int          num_gets;
+    unsigned int seed;
+};
+
+/* -------------------------------------------------------------------------- */
+
+extern "C" void * bench_loop(void * _args)
+{
+    BenchArgs * args = static_cast<BenchArgs *>(_args);
+
+    for (int i = 0 ; i < args->num_gets ; i++)
+    {
+        int oid = rand_r(&(args->seed)) % args->num_objects;
+
+        TestObjectSQL * obj = args->pool->get(oid, true);
+
+        if ( obj != 0 )
+        {
+            obj->unlock();
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double run(TestPool * pool, int num_threads, int num_objects,
+                  int num_gets)
+{
+    BenchArgs * args = new BenchArgs[num_threads];
+    double      ms;
+
+    for (int i = 0 ; i < num_threads ; i++)
+    {
+        args[i].pool        = pool;
+        args[i].num_objects = num_objects;
+        args[i].num_gets    = num_gets;
+        args[i].seed        = i;
+    }
+
+    ms = Benchmark::run_threads(bench_loop, args, num_threads);
+
+    delete [] args;
+
+    return (num_threads * num_gets) / (ms / 1000);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    string db_name     = "ONE_bench_database";
+    int    num_objects = 5000;
+    int    num_gets    = 50000;
+    string error;
+
+    ostringstream title;
+
+    BenchColumn columns[] = {
+        {"threads", 8, 0}, {"cached", 16, 0}, {"10% cached", 16, 0}};
+
+    if ( argc > 1 )
+    {
+        num_objects = atoi(argv[1]);
+    }
+
+    if ( argc > 2 )
+    {
+        num_gets = atoi(argv[2]);
+    }
+
+    NebulaLog::init_log_system(NebulaLog::FILE, Log::ERROR, "bench.log");
+
+    unlink(db_name.c_str());
+
+    SqlDB * db = new SqliteDB(db_name);
+
+    TestObjectSQL::bootstrap(db);
+
+    TestPool * pool = new TestPool(db);
+
+    for (int i = 0 ; i < num_objects ; i++)
+    {
+        ostringstream name;
+        name << "obj_" << i;
+
+        pool->allocate(new TestObjectSQL(i, name.str()), error);
+    }
+
+    title << "get() calls per second, " << num_objects << " objects, "
+          << num_gets << " gets per thread";
+
+    Benchmark bench(title.str(), columns, 3);
+
+    for (int threads = 1 ; threads <= 16 ; threads *= 2)
+    {
+        double hits, misses;
+
+        pool->clean();
+        pool->set_cache_size(num_objects);
+
+        run(pool, 1, num_objects, num_objects); //Warm up the cache
+
+        hits = run(pool, threads, num_objects, num_gets);
+
+        pool->clean();
+        pool->set_cache_size(num_objects / 10);
+
+        misses = run(pool, threads, num_objects, num_gets / 10);
+
+        bench << threads << hits << misses;
+    }
+
+    delete pool;
+    delete db;
+
+    unlink(db_name.c_str());
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "NebulaLog.h"
+#include "SqliteDB.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// VM updates (REPLACE INTO vm_pool) per second, with the escaped SQL string
+// executed with SqlDB::exec(cmd) and with the bound statement executed with
+// SqlDB::exec(cmd, params).
+//
+// Usage: update_bench [num_vms] [updates]
+
+static const char * vm_bootstrap = "CREATE TABLE IF NOT EXISTS "
+    "vm_pool (oid INTEGER PRIMARY KEY, name VARCHAR(128), body TEXT, "
+    "uid INTEGER, gid INTEGER, last_poll INTEGER, state INTEGER, "
+    "lcm_state INTEGER, owner_u INTEGER, group_u INTEGER, other_u INTEGER)";
+
+static const char * vm_names = "oid, name, body, uid, gid, last_poll, state, "
+    "lcm_state, owner_u, group_u, other_u";
+
+/* -------------------------------------------------------------------------- */
+
+static string vm_body(int oid)
+{
+    ostringstream oss;
+
+    oss << "<VM><ID>" << oid << "</ID><NAME>vm-" << oid << "</NAME>"
+        << "<STATE>3</STATE><LCM_STATE>3</LCM_STATE><TEMPLATE>"
+        << "<CONTEXT><FILES><![CDATA[/srv/one's context/init.sh]]></FILES>"
+        << "</CONTEXT>";
+
+    for (int i = 0 ; i < 40 ; i++)
+    {
+        oss << "<DISK><DISK_ID>" << i << "</DISK_ID><SOURCE>"
+            << "/var/lib/one/datastores/1/0123456789abcdef" << i
+            << "</SOURCE><TARGET>hd" << i << "</TARGET></DISK>";
+    }
+
+    oss << "</TEMPLATE></VM>";
+
+    return oss.str();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double update_escaped(SqlDB * db, int num_vms, int updates,
+                             const string& body)
+{
+    double start = Benchmark::now_ms();
+
+    for (int i = 0 ; i < updates ; i++)
+    {
+        ostringstream oss;
+        int           oid = i % num_vms;
+
+        char * sql_name = db->escape_str("vm-name");
+        char * sql_xml  = db->escape_str(body);
+
+        oss << "REPLACE INTO vm_pool (" << vm_names << ") VALUES ("
+            << oid << ",'" << sql_name << "','" << sql_xml << "',"
+            << 0 << "," << 0 << "," << i << "," << 3 << "," << 3 << ","
+            << 1 << "," << 0 << "," << 0 << ")";
+
+        db->free_str(sql_name);
+        db->free_str(sql_xml);
+
+        db->exec(oss);
+    }
+
+    return updates / ((Benchmark::now_ms() - start) / 1000);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double update_bound(SqlDB * db, int num_vms, int updates,
+                           const string& body)
+{
+    double start = Benchmark::now_ms();
+
+    for (int i = 0 ; i < updates ; i++)
+    {
+        ostringstream oss;
+        SqlParams     params;
+        int           oid = i % num_vms;
+
+        oss << "REPLACE INTO vm_pool (" << vm_names << ") VALUES "
+            << "(?,?,?,?,?,?,?,?,?,?,?)";
+
+        params.add(oid).add(string("vm-name")).add(body).add(0).add(0)
+              .add(i).add(3).add(3).add(1).add(0).add(0);
+
+        db->exec(oss, params);
+    }
+
+    return updates / ((Benchmark::now_ms() - start) / 1000);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    string db_name = "ONE_update_bench_database";
+    int    num_vms = 1000;
+    int    updates = 5000;
+
+    ostringstream title;
+
+    BenchColumn columns[] = {{"escaped", 16, 0}, {"bound", 16, 0}};
+
+    if ( argc > 1 )
+    {
+        num_vms = atoi(argv[1]);
+    }
+
+    if ( argc > 2 )
+    {
+        updates = atoi(argv[2]);
+    }
+
+    NebulaLog::init_log_system(NebulaLog::FILE, Log::ERROR, "bench.log");
+
+    unlink(db_name.c_str());
+
+    SqlDB * db = new SqliteDB(db_name);
+
+    ostringstream oss(vm_bootstrap);
+    db->exec(oss);
+
+    // Updates are synchronous writes, measure the statement cost instead
+    oss.str("PRAGMA synchronous = OFF");
+    db->exec(oss);
+
+    string body = vm_body(0);
+
+    update_bound(db, num_vms, num_vms, body); //Populate the table
+
+    title << "VM updates per second, " << num_vms << " VMs, " << updates
+          << " updates, " << body.size() << " bytes body";
+
+    Benchmark bench(title.str(), columns, 2);
+
+    for (int i = 0 ; i < 3 ; i++)
+    {
+        double escaped = update_escaped(db, num_vms, updates, body);
+        double bound   = update_bound(db, num_vms, updates, body);
+
+        bench << escaped << bound;
+    }
+
+    delete db;
+
+    unlink(db_name.c_str());
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
@@ -136,11 +136,19 @@ void VirtualMachinePoolMonitoring::request_execute(
         RequestAttributes& att)
 {
     int filter_flag = xmlrpc_c::value_int(paramList.getInt(1));
+    int resolution  = 0;
+
+    VirtualMachinePool * vmpool = static_cast<VirtualMachinePool *>(pool);
 
     ostringstream oss;
     string        where;
     int           rc;
 
+    if ( paramList.size() > 2 )
+    {
+        resolution = xmlrpc_c::value_int(paramList.getInt(2));
+    }
+
     if ( filter_flag < MINE )
     {
         failure_response(XML_RPC_API,
@@ -149,9 +157,17 @@ void VirtualMachinePoolMonitoring::request_execute(
         return;
     }
 
+    if ( !vmpool->has_monitoring_resolution(resolution) )
+    {
+        failure_response(XML_RPC_API,
+                request_error("No monitoring rollups for that resolution",""),
+                att);
+        return;
+    }
+
     where_filter(att, filter_flag, -1, -1, "", "", where);
 
-    rc = (static_cast<VirtualMachinePool *>(pool))->dump_monitoring(oss, where);
+    rc = vmpool->dump_monitoring(oss, where, resolution);
 
     if ( rc != 0 )
     {
@@ -181,13 +197,30 @@ void HostPoolMonitoring::request_execute(
         xmlrpc_c::paramList const& paramList,
         RequestAttributes& att)
 {
+    int resolution = 0;
+
+    HostPool * hpool = static_cast<HostPool *>(pool);
+
     ostringstream oss;
     string        where;
     int           rc;
 
+    if ( paramList.size() > 1 )
+    {
+        resolution = xmlrpc_c::value_int(paramList.getInt(1));
+    }
+
+    if ( !hpool->has_monitoring_resolution(resolution) )
+    {
+        failure_response(XML_RPC_API,
+                request_error("No monitoring rollups for that resolution",""),
+                att);
+        return;
+    }
+
     where_filter(att, ALL, -1, -1, "", "", where);
 
-    rc = (static_cast<HostPool *>(pool))->dump_monitoring(oss, where);
+    rc = hpool->dump_monitoring(oss, where, resolution);
 
     if ( rc != 0 )
     {
@@ -28,56 +28,366 @@ MySqlDB::MySqlDB(
         int           _port,
         const string& _user,
         const string& _password,
-        const string& _database)
+        const string& _database,
+        int           _connections)
 {
+    MYSQL *       db;
+    ostringstream oss;
+
     server   = _server;
     port     = _port;
     user     = _user;
     password = _password;
     database = _database;
 
+    checkouts  = 0;
+    waits      = 0;
+    wait_usec  = 0;
+    max_in_use = 0;
+
+    if ( _connections < 1 )
+    {
+        _connections = 1;
+    }
+
     // Initialize the MySQL library
     mysql_library_init(0, NULL, NULL);
 
-    // Initialize a connection handler
-    db = mysql_init(NULL);
+    // Create the database, if needed, before opening the pool
+    db = connect("");
 
-    // Connect to the server
-    if (!mysql_real_connect(db, server.c_str(), user.c_str(),
-                            password.c_str(), 0, port, NULL, 0))
+    if ( db == 0 )
     {
         throw runtime_error("Could not open database.");
     }
 
+    oss << "CREATE DATABASE IF NOT EXISTS " << database;
+
+    if ( mysql_query(db, oss.str().c_str()) != 0 )
+    {
+        mysql_close(db);
+
+        throw runtime_error("Could not create database.");
+    }
+
+    mysql_close(db);
+
+    // Open the connection pool
+    for (int i = 0 ; i < _connections ; i++)
+    {
+        db = connect(database);
+
+        if ( db == 0 )
+        {
+            for (unsigned int j = 0 ; j < connections.size() ; j++)
+            {
+                mysql_close(connections[j]);
+            }
+
+            throw runtime_error("Could not open database.");
+        }
+
+        connections.push_back(db);
+        free_connections.push(db);
+    }
+
     pthread_mutex_init(&mutex,0);
+
+    pthread_cond_init(&cond,0);
+
+    pthread_key_create(&tx_key,0);
 }
 
 /* -------------------------------------------------------------------------- */
 
 MySqlDB::~MySqlDB()
 {
-    // Close the connection to the MySQL server
-    mysql_close(db);
+    // Close the connections to the MySQL server
+    for (unsigned int i = 0 ; i < connections.size() ; i++)
+    {
+        mysql_close(connections[i]);
+    }
 
     // End use of the MySQL library
     mysql_library_end();
 
     pthread_mutex_destroy(&mutex);
+
+    pthread_cond_destroy(&cond);
+
+    pthread_key_delete(tx_key);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MYSQL * MySqlDB::connect(const string& _database)
+{
+    MYSQL *      db;
+    const char * db_name = 0;
+
+    // Initialize a connection handler
+    db = mysql_init(NULL);
+
+    if ( db == 0 )
+    {
+        return 0;
+    }
+
+    if ( !_database.empty() )
+    {
+        db_name = _database.c_str();
+    }
+
+    // Connect to the server
+    if (!mysql_real_connect(db, server.c_str(), user.c_str(),
+                            password.c_str(), db_name, port, NULL, 0))
+    {
+        mysql_close(db);
+
+        return 0;
+    }
+
+    return db;
+}
+
+/* -------------------------------------------------------------------------- */
+
+MYSQL * MySqlDB::get_db_connection()
+{
+    MYSQL *        db;
+    unsigned int   in_use;
+    struct timeval start, end;
+
+    Transaction * tx = static_cast<Transaction *>(pthread_getspecific(tx_key));
+
+    if ( tx != 0 )
+    {
+        return tx->db;
+    }
+
+    lock();
+
+    checkouts++;
+
+    if ( free_connections.empty() )
+    {
+        waits++;
+
+        gettimeofday(&start, 0);
+
+        while ( free_connections.empty() )
+        {
+            pthread_cond_wait(&cond, &mutex);
+        }
+
+        gettimeofday(&end, 0);
+
+        wait_usec += (end.tv_sec - start.tv_sec) * 1000000 +
+                     (end.tv_usec - start.tv_usec);
+    }
+
+    db = free_connections.front();
+
+    free_connections.pop();
+
+    in_use = connections.size() - free_connections.size();
+
+    if ( in_use > max_in_use )
+    {
+        max_in_use = in_use;
+    }
+
+    unlock();
+
+    return db;
 }
 
 /* -------------------------------------------------------------------------- */
 
-int MySqlDB::exec(ostringstream& cmd, Callbackable* obj)
+void MySqlDB::free_db_connection(MYSQL * db)
+{
+    Transaction * tx = static_cast<Transaction *>(pthread_getspecific(tx_key));
+
+    if ( tx != 0 && tx->db == db )
+    {
+        return;
+    }
+
+    lock();
+
+    free_connections.push(db);
+
+    pthread_cond_signal(&cond);
+
+    unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MySqlDB::reconnect(MYSQL *& db)
+{
+    MYSQL * new_db = connect(database);
+
+    if ( new_db == 0 )
+    {
+        return -1;
+    }
+
+    lock();
+
+    for (unsigned int i = 0 ; i < connections.size() ; i++)
+    {
+        if ( connections[i] == db )
+        {
+            connections[i] = new_db;
+            break;
+        }
+    }
+
+    unlock();
+
+    // The transaction using the connection was lost with it
+    Transaction * tx = static_cast<Transaction *>(pthread_getspecific(tx_key));
+
+    if ( tx != 0 && tx->db == db )
+    {
+        tx->db       = new_db;
+        tx->rollback = true;
+    }
+
+    mysql_close(db);
+
+    db = new_db;
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MySqlDB::begin()
+{
+    Transaction * tx = static_cast<Transaction *>(pthread_getspecific(tx_key));
+
+    if ( tx != 0 )
+    {
+        tx->depth++;
+
+        return 0;
+    }
+
+    MYSQL * db = get_db_connection();
+
+    if ( mysql_query(db, "START TRANSACTION") != 0 )
+    {
+        ostringstream oss;
+
+        oss << "Could not start transaction, error " << mysql_errno(db)
+            << " : " << mysql_error(db);
+
+        NebulaLog::log("ONE",Log::ERROR,oss);
+
+        free_db_connection(db);
+
+        return -1;
+    }
+
+    tx = new Transaction;
+
+    tx->db       = db;
+    tx->depth    = 1;
+    tx->rollback = false;
+
+    pthread_setspecific(tx_key, tx);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MySqlDB::commit()
+{
+    return end_transaction(true);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MySqlDB::rollback()
+{
+    return end_transaction(false);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MySqlDB::end_transaction(bool do_commit)
+{
+    int rc = 0;
+
+    Transaction * tx = static_cast<Transaction *>(pthread_getspecific(tx_key));
+
+    if ( tx == 0 )
+    {
+        return -1;
+    }
+
+    if ( !do_commit )
+    {
+        tx->rollback = true;
+    }
+
+    if ( --tx->depth > 0 )
+    {
+        return 0;
+    }
+
+    pthread_setspecific(tx_key, 0);
+
+    if ( !tx->rollback && mysql_query(tx->db, "COMMIT") != 0 )
+    {
+        ostringstream oss;
+
+        oss << "Could not commit transaction, error " << mysql_errno(tx->db)
+            << " : " << mysql_error(tx->db);
+
+        NebulaLog::log("ONE",Log::ERROR,oss);
+
+        tx->rollback = true;
+    }
+
+    if ( tx->rollback )
+    {
+        mysql_query(tx->db, "ROLLBACK");
+
+        if ( do_commit )
+        {
+            rc = -1;
+        }
+    }
+
+    free_db_connection(tx->db);
+
+    delete tx;
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int MySqlDB::exec(ostringstream& cmd, SqlCallback* cb)
 {
     int          rc;
 
     const char * c_str;
     string       str;
 
+    MYSQL *      db;
+
     str   = cmd.str();
     c_str = str.c_str();
 
-    lock();
+    db = get_db_connection();
 
     rc = mysql_query(db, c_str);
 
@@ -92,9 +402,7 @@ int MySqlDB::exec(ostringstream& cmd, Callbackable* obj)
             oss << "MySQL connection error " << err_num << " : " << err_msg;
 
             // Try to re-connect
-            if (mysql_real_connect(db, server.c_str(), user.c_str(),
-                                    password.c_str(), database.c_str(),
-                                    port, NULL, 0))
+            if ( reconnect(db) == 0 )
             {
                 oss << "... Reconnected.";
             }
@@ -111,13 +419,13 @@ int MySqlDB::exec(ostringstream& cmd, Callbackable* obj)
 
         NebulaLog::log("ONE",Log::ERROR,oss);
 
-        unlock();
+        free_db_connection(db);
 
         return -1;
     }
 
 
-    if ( (obj != 0) && (obj->isCallBackSet()) )
+    if ( cb != 0 )
     {
 
         MYSQL_RES *         result;
@@ -139,7 +447,7 @@ int MySqlDB::exec(ostringstream& cmd, Callbackable* obj)
 
             NebulaLog::log("ONE",Log::ERROR,oss);
 
-            unlock();
+            free_db_connection(db);
 
             return -1;
         }
@@ -158,7 +466,7 @@ int MySqlDB::exec(ostringstream& cmd, Callbackable* obj)
         // Fetch each row, and call-back the object waiting for them
         while((row = mysql_fetch_row(result)))
         {
-            obj->do_callback(num_fields, row, names);
+            cb->do_callback(num_fields, row, names);
         }
 
         // Free the result object
@@ -167,7 +475,7 @@ int MySqlDB::exec(ostringstream& cmd, Callbackable* obj)
         delete[] names;
     }
 
-    unlock();
+    free_db_connection(db);
 
     return 0;
 }
@@ -176,10 +484,13 @@ int MySqlDB::exec(ostringstream& cmd, Callbackable* obj)
 
 char * MySqlDB::escape_str(const string& str)
 {
-    char * result = new char[str.size()*2+1];
+    char *  result = new char[str.size()*2+1];
+    MYSQL * db     = get_db_connection();
 
     mysql_real_escape_string(db, result, str.c_str(), str.size());
 
+    free_db_connection(db);
+
     return result;
 }
 
@@ -191,3 +502,37 @@ void MySqlDB::free_str(char * str)
 }
 
 /* -------------------------------------------------------------------------- */
+
+void MySqlDB::get_stats(unsigned long& _checkouts,
+                        unsigned long& _waits,
+                        unsigned long& _wait_usec,
+                        unsigned int&  _in_use,
+                        unsigned int&  _max_in_use)
+{
+    lock();
+
+    _checkouts  = checkouts;
+    _waits      = waits;
+    _wait_usec  = wait_usec;
+    _in_use     = connections.size() - free_connections.size();
+    _max_in_use = max_in_use;
+
+    unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MySqlDB::print_stats(ostringstream& oss)
+{
+    unsigned long _checkouts, _waits, _wait_usec;
+    unsigned int  _in_use, _max_in_use;
+
+    get_stats(_checkouts, _waits, _wait_usec, _in_use, _max_in_use);
+
+    oss << "MySQL connection pool: " << connections.size() << " connections, "
+        << _in_use << " in use (max " << _max_in_use << "), "
+        << _checkouts << " requests, " << _waits << " waited for "
+        << _wait_usec / 1000 << " ms.";
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,81 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+
+#include "SqlDB.h"
+#include "NebulaLog.h"
+
+/* -------------------------------------------------------------------------- */
+
+int SqlDB::exec(ostringstream& cmd, const SqlParams& params, SqlCallback* cb)
+{
+    ostringstream oss;
+    string        str = cmd.str();
+    unsigned int  i   = 0;
+
+    for (string::size_type pos = 0 ; pos < str.size() ; pos++)
+    {
+        if ( str[pos] != '?' )
+        {
+            oss << str[pos];
+            continue;
+        }
+
+        if ( i >= params.size() )
+        {
+            goto error_params;
+        }
+
+        if ( params.type(i) == SqlParams::INTEGER )
+        {
+            oss << params.integer(i);
+        }
+        else
+        {
+            char * sql_str = escape_str(params.text(i));
+
+            if ( sql_str == 0 )
+            {
+                return -1;
+            }
+
+            oss << "'" << sql_str << "'";
+
+            free_str(sql_str);
+        }
+
+        i++;
+    }
+
+    if ( i != params.size() )
+    {
+        goto error_params;
+    }
+
+    return exec(oss, cb);
+
+error_params:
+    ostringstream error;
+
+    error << "Wrong number of parameters (" << params.size()
+          << ") for SQL command: " << str;
+
+    NebulaLog::log("ONE",Log::ERROR,error);
+
+    return -1;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -17,64 +17,481 @@
 
 #include "SqliteDB.h"
 
+#include <strings.h>
+#include <errno.h>
+
 using namespace std;
 
 /* -------------------------------------------------------------------------- */
 
 extern "C" int sqlite_callback (
-        void *                  _obj,
+        void *                  _cb,
         int                     num,
         char **                 values,
         char **                 names)
 {
-    Callbackable *obj;
+    SqlCallback *cb;
 
-    obj = static_cast<Callbackable *>(_obj);
+    cb = static_cast<SqlCallback *>(_cb);
 
-    if (obj == 0)
+    if (cb == 0)
     {
         return -1;
     }
 
-    return obj->do_callback(num,values,names);
+    return cb->do_callback(num,values,names);
 };
 
 /* -------------------------------------------------------------------------- */
 
-SqliteDB::SqliteDB(string& db_name)
+const unsigned int SqliteDB::STMT_CACHE_SIZE = 128;
+
+const int SqliteDB::BUSY_TIMEOUT = 10000;
+
+/* -------------------------------------------------------------------------- */
+
+SqliteDB::SqliteDB(string& db_name, int num_readers, int _group_commit)
 {
-    int rc;
+    sqlite3_stmt *      stmt;
+    bool                wal = false;
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+    pthread_mutex_init(&mutex,&attr);
+
+    pthread_mutexattr_destroy(&attr);
+
+    pthread_key_create(&tx_key,0);
+
+    tx_rollback = false;
+
+    group_commit = _group_commit;
+    batch        = 0;
+
+    pthread_cond_init(&batch_cond,0);
 
-    pthread_mutex_init(&mutex,0);
+    pthread_mutex_init(&readers_mutex,0);
 
-    rc = sqlite3_open(db_name.c_str(), &db);
+    pthread_cond_init(&readers_cond,0);
 
-    if ( rc != SQLITE_OK )
+    if ( open_connection(db_name,
+            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, writer) != 0 )
     {
         throw runtime_error("Could not open database.");
     }
+
+    if ( num_readers <= 0 )
+    {
+        return;
+    }
+
+    // Readers do not block the writer (and viceversa) only in WAL mode
+    if (sqlite3_prepare_v2(writer.db,"PRAGMA journal_mode=WAL",-1,&stmt,0)
+            == SQLITE_OK)
+    {
+        if ( sqlite3_step(stmt) == SQLITE_ROW )
+        {
+            const char * mode = reinterpret_cast<const char *>(
+                    sqlite3_column_text(stmt, 0));
+
+            wal = (mode != 0 && strcasecmp(mode, "wal") == 0);
+        }
+
+        sqlite3_finalize(stmt);
+    }
+
+    if ( !wal )
+    {
+        NebulaLog::log("ONE", Log::WARNING, "Could not set WAL journal mode "
+            "for the database, all statements will use a single connection.");
+        return;
+    }
+
+    for (int i = 0 ; i < num_readers ; i++)
+    {
+        Connection * conn = new Connection;
+
+        if (open_connection(db_name, SQLITE_OPEN_READONLY, *conn) != 0)
+        {
+            delete conn;
+            break;
+        }
+
+        readers.push_back(conn);
+        free_readers.push(conn);
+    }
 }
 
 /* -------------------------------------------------------------------------- */
 
 SqliteDB::~SqliteDB()
 {
+    lock();
+
+    close_batch();
+
+    unlock();
+
+    for (unsigned int i = 0 ; i < readers.size() ; i++)
+    {
+        close_connection(*readers[i]);
+
+        delete readers[i];
+    }
+
+    close_connection(writer);
+
     pthread_mutex_destroy(&mutex);
 
-    sqlite3_close(db);
+    pthread_cond_destroy(&batch_cond);
+
+    pthread_mutex_destroy(&readers_mutex);
+
+    pthread_cond_destroy(&readers_cond);
+
+    pthread_key_delete(tx_key);
 }
 
+/* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int SqliteDB::exec(ostringstream& cmd, Callbackable* obj)
+int SqliteDB::open_connection(const string& db_name, int flags,
+                              Connection& conn)
+{
+    if ( sqlite3_open_v2(db_name.c_str(), &conn.db, flags, 0) != SQLITE_OK )
+    {
+        ostringstream oss;
+
+        oss << "Could not open database " << db_name << ": "
+            << sqlite3_errmsg(conn.db);
+
+        NebulaLog::log("ONE", Log::ERROR, oss);
+
+        sqlite3_close(conn.db);
+
+        return -1;
+    }
+
+    // Wait for the locks without holding any mutex of this class other than
+    // the one of the connection
+    sqlite3_busy_timeout(conn.db, BUSY_TIMEOUT);
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void SqliteDB::close_connection(Connection& conn)
+{
+    map<string, CachedStmt>::iterator it;
+
+    for (it = conn.stmt_cache.begin(); it != conn.stmt_cache.end(); it++)
+    {
+        sqlite3_finalize(it->second.stmt);
+    }
+
+    conn.stmt_cache.clear();
+
+    queue<string>().swap(conn.stmt_queue);
+
+    sqlite3_close(conn.db);
+}
+
+/* -------------------------------------------------------------------------- */
+
+SqliteDB::Connection * SqliteDB::get_connection(const string& sql)
+{
+    Connection * conn;
+
+    string::size_type pos = sql.find_first_not_of(" \t\n(");
+
+    if ( readers.empty() || pos == string::npos || in_transaction() ||
+         strncasecmp(sql.c_str() + pos, "SELECT", 6) != 0 )
+    {
+        lock();
+
+        return &writer;
+    }
+
+    pthread_mutex_lock(&readers_mutex);
+
+    while ( free_readers.empty() )
+    {
+        pthread_cond_wait(&readers_cond, &readers_mutex);
+    }
+
+    conn = free_readers.front();
+
+    free_readers.pop();
+
+    pthread_mutex_unlock(&readers_mutex);
+
+    return conn;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int SqliteDB::put_connection(Connection * conn, Batch * joined, int rc)
+{
+    if ( conn != &writer )
+    {
+        pthread_mutex_lock(&readers_mutex);
+
+        free_readers.push(conn);
+
+        pthread_cond_signal(&readers_cond);
+
+        pthread_mutex_unlock(&readers_mutex);
+
+        return rc;
+    }
+
+    if ( joined != 0 )
+    {
+        while ( !joined->done )
+        {
+            if ( pthread_cond_timedwait(&batch_cond, &mutex,
+                    &joined->deadline) == ETIMEDOUT && !joined->done )
+            {
+                close_batch();
+            }
+        }
+
+        if ( joined->rc != 0 )
+        {
+            rc = -1;
+        }
+
+        if ( --joined->refs == 0 )
+        {
+            delete joined;
+        }
+    }
+
+    unlock();
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+SqliteDB::Batch * SqliteDB::join_batch()
+{
+    struct timeval now;
+
+    if ( group_commit <= 0 || in_transaction() )
+    {
+        return 0;
+    }
+
+    // The transaction was rolled back by an error in one of the statements
+    if ( batch != 0 && sqlite3_get_autocommit(writer.db) != 0 )
+    {
+        close_batch();
+    }
+
+    if ( batch == 0 )
+    {
+        if ( sqlite3_exec(writer.db, "BEGIN", 0, 0, 0) != SQLITE_OK )
+        {
+            return 0;
+        }
+
+        gettimeofday(&now, 0);
+
+        now.tv_usec += group_commit * 1000;
+
+        batch = new Batch;
+
+        batch->rc   = 0;
+        batch->refs = 0;
+        batch->done = false;
+
+        batch->deadline.tv_sec  = now.tv_sec + now.tv_usec / 1000000;
+        batch->deadline.tv_nsec = (now.tv_usec % 1000000) * 1000;
+    }
+
+    batch->refs++;
+
+    return batch;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void SqliteDB::close_batch()
+{
+    char * err_msg = 0;
+
+    if ( batch == 0 )
+    {
+        return;
+    }
+
+    if ( sqlite3_get_autocommit(writer.db) != 0 )
+    {
+        batch->rc = -1;
+    }
+    else if ( sqlite3_exec(writer.db, "COMMIT", 0, 0, &err_msg) != SQLITE_OK )
+    {
+        ostringstream oss;
+
+        oss << "Could not commit batch of statements, error: ";
+
+        if ( err_msg != 0 )
+        {
+            oss << err_msg;
+            sqlite3_free(err_msg);
+        }
+
+        NebulaLog::log("ONE",Log::ERROR,oss);
+
+        sqlite3_exec(writer.db, "ROLLBACK", 0, 0, 0);
+
+        batch->rc = -1;
+    }
+
+    batch->done = true;
+
+    if ( batch->refs == 0 )
+    {
+        delete batch;
+    }
+
+    batch = 0;
+
+    pthread_cond_broadcast(&batch_cond);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int SqliteDB::begin()
+{
+    char * err_msg = 0;
+
+    lock();
+
+    if ( in_transaction() )
+    {
+        set_tx_depth(get_tx_depth() + 1);
+
+        return 0;
+    }
+
+    close_batch();
+
+    if ( sqlite3_exec(writer.db, "BEGIN", 0, 0, &err_msg) != SQLITE_OK )
+    {
+        ostringstream oss;
+
+        oss << "Could not start transaction, error: ";
+
+        if ( err_msg != 0 )
+        {
+            oss << err_msg;
+            sqlite3_free(err_msg);
+        }
+
+        NebulaLog::log("ONE",Log::ERROR,oss);
+
+        unlock();
+
+        return -1;
+    }
+
+    set_tx_depth(1);
+
+    tx_rollback = false;
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int SqliteDB::commit()
+{
+    return end_transaction(true);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int SqliteDB::rollback()
+{
+    return end_transaction(false);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int SqliteDB::end_transaction(bool do_commit)
+{
+    int    rc      = 0;
+    char * err_msg = 0;
+    int    depth   = get_tx_depth();
+
+    if ( depth <= 0 )
+    {
+        return -1;
+    }
+
+    if ( !do_commit )
+    {
+        tx_rollback = true;
+    }
+
+    set_tx_depth(--depth);
+
+    if ( depth == 0 )
+    {
+        if ( !tx_rollback &&
+             sqlite3_exec(writer.db, "COMMIT", 0, 0, &err_msg) != SQLITE_OK )
+        {
+            ostringstream oss;
+
+            oss << "Could not commit transaction, error: ";
+
+            if ( err_msg != 0 )
+            {
+                oss << err_msg;
+                sqlite3_free(err_msg);
+            }
+
+            NebulaLog::log("ONE",Log::ERROR,oss);
+
+            tx_rollback = true;
+        }
+
+        if ( tx_rollback )
+        {
+            sqlite3_exec(writer.db, "ROLLBACK", 0, 0, 0);
+
+            if ( do_commit )
+            {
+                rc = -1;
+            }
+        }
+    }
+
+    unlock();
+
+    return rc;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+int SqliteDB::exec(ostringstream& cmd, SqlCallback* cb)
 {
     int          rc;
 
     const char * c_str;
     string       str;
 
-    int          counter = 0;
     char *       err_msg = 0;
+    Connection * conn;
+    Batch *      joined  = 0;
 
     int   (*callback)(void*,int,char**,char**);
     void * arg;
@@ -85,35 +502,20 @@ int SqliteDB::exec(ostringstream& cmd, Callbackable* obj)
     callback = 0;
     arg      = 0;
 
-    if ((obj != 0)&&(obj->isCallBackSet()))
+    if (cb != 0)
     {
         callback = sqlite_callback;
-        arg      = static_cast<void *>(obj);
+        arg      = static_cast<void *>(cb);
     }
 
-    lock();
+    conn = get_connection(str);
 
-    do
+    if ( conn == &writer )
     {
-        counter++;
-
-        rc = sqlite3_exec(db, c_str, callback, arg, &err_msg);
-
-        if (rc == SQLITE_BUSY || rc == SQLITE_IOERR)
-        {
-            struct timeval timeout;
-            fd_set zero;
-
-            FD_ZERO(&zero);
-            timeout.tv_sec  = 0;
-            timeout.tv_usec = 250000;
-
-            select(0, &zero, &zero, &zero, &timeout);
-        }
-    }while( (rc == SQLITE_BUSY || rc == SQLITE_IOERR) &&
-            (counter < 10));
+        joined = join_batch();
+    }
 
-    unlock();
+    rc = sqlite3_exec(conn->db, c_str, callback, arg, &err_msg);
 
     if (rc != SQLITE_OK)
     {
@@ -127,10 +529,228 @@ int SqliteDB::exec(ostringstream& cmd, Callbackable* obj)
             sqlite3_free(err_msg);
         }
 
-        return -1;
+        rc = -1;
     }
 
-    return 0;
+    return put_connection(conn, joined, rc);
+}
+
+/* -------------------------------------------------------------------------- */
+
+sqlite3_stmt * SqliteDB::get_stmt(Connection * conn, const string& sql)
+{
+    map<string, CachedStmt>::iterator it;
+    CachedStmt     cached;
+    sqlite3_stmt * stmt;
+
+    it = conn->stmt_cache.find(sql);
+
+    if ( it != conn->stmt_cache.end() )
+    {
+        it->second.referenced = true;
+
+        return it->second.stmt;
+    }
+
+    if (sqlite3_prepare_v2(conn->db, sql.c_str(), -1, &stmt, 0) != SQLITE_OK)
+    {
+        ostringstream oss;
+
+        oss << "SQL command was: " << sql << ", error: "
+            << sqlite3_errmsg(conn->db);
+
+        NebulaLog::log("ONE",Log::ERROR,oss);
+
+        return 0;
+    }
+
+    if ( conn->stmt_cache.size() >= STMT_CACHE_SIZE )
+    {
+        replace_stmt(conn);
+    }
+
+    cached.stmt       = stmt;
+    cached.referenced = false;
+
+    conn->stmt_cache.insert(make_pair(sql, cached));
+
+    conn->stmt_queue.push(sql);
+
+    return stmt;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void SqliteDB::replace_stmt(Connection * conn)
+{
+    map<string, CachedStmt>::iterator it;
+
+    // Two passes over the clock: the first one clears the reference bits,
+    // in the second one only the statements being stepped are left
+    unsigned int tries = 2 * conn->stmt_queue.size();
+
+    for (unsigned int i = 0 ; i < tries && !conn->stmt_queue.empty() ; i++)
+    {
+        string sql = conn->stmt_queue.front();
+
+        conn->stmt_queue.pop();
+
+        it = conn->stmt_cache.find(sql);
+
+        if ( it == conn->stmt_cache.end() )
+        {
+            continue;
+        }
+
+        // In use by a callback of a nested statement, move to back
+        if ( sqlite3_stmt_busy(it->second.stmt) )
+        {
+            conn->stmt_queue.push(sql);
+        }
+        else if ( it->second.referenced ) // Recently used, second chance
+        {
+            it->second.referenced = false;
+
+            conn->stmt_queue.push(sql);
+        }
+        else
+        {
+            sqlite3_finalize(it->second.stmt);
+
+            conn->stmt_cache.erase(it);
+
+            return;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+int SqliteDB::exec(ostringstream& cmd, const SqlParams& params,
+                   SqlCallback* cb)
+{
+    int            rc;
+
+    string         str;
+    Connection *   conn;
+    Batch *        joined = 0;
+    sqlite3_stmt * stmt;
+
+    bool           callback;
+    int            num;
+    char **        values = 0;
+    char **        names  = 0;
+
+    str      = cmd.str();
+    callback = (cb != 0);
+
+    conn = get_connection(str);
+
+    stmt = get_stmt(conn, str);
+
+    if ( stmt == 0 )
+    {
+        return put_connection(conn, 0, -1);
+    }
+
+    if ( static_cast<int>(params.size()) != sqlite3_bind_parameter_count(stmt) )
+    {
+        ostringstream oss;
+
+        oss << "Wrong number of parameters (" << params.size()
+            << ") for SQL command: " << str;
+        NebulaLog::log("ONE",Log::ERROR,oss);
+
+        return put_connection(conn, 0, -1);
+    }
+
+    if ( conn == &writer )
+    {
+        joined = join_batch();
+    }
+
+    for (unsigned int i = 0; i < params.size(); i++)
+    {
+        if ( params.type(i) == SqlParams::INTEGER )
+        {
+            sqlite3_bind_int64(stmt, i+1, params.integer(i));
+        }
+        else
+        {
+            const string& text = params.text(i);
+
+            sqlite3_bind_text(stmt, i+1, text.c_str(), text.size(),
+                              SQLITE_STATIC);
+        }
+    }
+
+    num = sqlite3_column_count(stmt);
+
+    if ( callback && num > 0 )
+    {
+        values = new char*[num];
+        names  = new char*[num];
+
+        for (int i = 0; i < num; i++)
+        {
+            names[i] = const_cast<char *>(sqlite3_column_name(stmt, i));
+        }
+    }
+
+    while ( (rc = sqlite3_step(stmt)) == SQLITE_ROW )
+    {
+        if ( !callback )
+        {
+            continue;
+        }
+
+        for (int i = 0; i < num; i++)
+        {
+            values[i] = reinterpret_cast<char *>(
+                    const_cast<unsigned char *>(sqlite3_column_text(stmt, i)));
+        }
+
+        if ( cb->do_callback(num, values, names) != 0 )
+        {
+            rc = SQLITE_ABORT;
+            break;
+        }
+    }
+
+    if ( rc != SQLITE_DONE )
+    {
+        ostringstream oss;
+
+        oss << "SQL command was: " << str << ", error: ";
+
+        if ( rc == SQLITE_ABORT )
+        {
+            oss << "callback requested abort";
+        }
+        else
+        {
+            oss << sqlite3_errmsg(conn->db);
+        }
+
+        NebulaLog::log("ONE",Log::ERROR,oss);
+    }
+
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    delete[] values;
+    delete[] names;
+
+    if ( rc != SQLITE_DONE )
+    {
+        rc = -1;
+    }
+    else
+    {
+        rc = 0;
+    }
+
+    return put_connection(conn, joined, rc);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -146,4 +766,3 @@ void SqliteDB::free_str(char * str)
 {
     sqlite3_free(str);
 }
-
@@ -21,6 +21,7 @@
 #include <sstream>
 #include <cstring>
 #include <cstdio>
+#include <cctype>
 
 #define TO_UPPER(S) transform(S.begin(),S.end(),S.begin(),(int(*)(int))toupper)
 
@@ -40,21 +41,26 @@ Template::~Template()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-pthread_mutex_t Template::mutex = PTHREAD_MUTEX_INITIALIZER;
-
 extern "C"
 {
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     typedef struct yy_buffer_state * YY_BUFFER_STATE;
 
-    extern FILE *template_in, *template_out;
+    int template_parse(Template * tmpl, char ** errmsg, yyscan_t scanner);
 
-    int template_parse(Template * tmpl, char ** errmsg);
+    int template_lex_init(yyscan_t * scanner);
 
-    int template_lex_destroy();
+    int template_lex_destroy(yyscan_t scanner);
 
-    YY_BUFFER_STATE template__scan_string(const char * str);
+    void template_set_in(FILE * in, yyscan_t scanner);
 
-    void template__delete_buffer(YY_BUFFER_STATE);
+    YY_BUFFER_STATE template__scan_string(const char * str, yyscan_t scanner);
+
+    void template__delete_buffer(YY_BUFFER_STATE, yyscan_t scanner);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -62,34 +68,41 @@ extern "C"
 
 int Template::parse(const char * filename, char **error_msg)
 {
-    int     rc;
-
-    pthread_mutex_lock(&mutex);
+    int         rc;
+    FILE *      file;
+    yyscan_t    scanner;
 
     *error_msg = 0;
 
-    template_in = fopen (filename, "r");
+    file = fopen (filename, "r");
 
-    if ( template_in == 0 )
+    if ( file == 0 )
     {
         goto error_open;
     }
 
-    rc = template_parse(this,error_msg);
+    if ( template_lex_init(&scanner) != 0 )
+    {
+        fclose(file);
+        goto error_scanner;
+    }
+
+    template_set_in(file, scanner);
 
-    fclose(template_in);
+    rc = template_parse(this, error_msg, scanner);
 
-    template_lex_destroy();
+    template_lex_destroy(scanner);
 
-    pthread_mutex_unlock(&mutex);
+    fclose(file);
 
     return rc;
 
 error_open:
     *error_msg = strdup("Error opening template file");
+    return -1;
 
-    pthread_mutex_unlock(&mutex);
-
+error_scanner:
+    *error_msg = strdup("Error initializing template scanner");
     return -1;
 }
 
@@ -101,27 +114,30 @@ int Template::parse(const string &parse_str, char **error_msg)
     YY_BUFFER_STATE     str_buffer = 0;
     const char *        str;
     int                 rc;
-
-    pthread_mutex_lock(&mutex);
+    yyscan_t            scanner;
 
     *error_msg = 0;
 
+    if ( template_lex_init(&scanner) != 0 )
+    {
+        *error_msg = strdup("Error initializing template scanner");
+        return -1;
+    }
+
     str = parse_str.c_str();
 
-    str_buffer = template__scan_string(str);
+    str_buffer = template__scan_string(str, scanner);
 
     if (str_buffer == 0)
     {
         goto error_yy;
     }
 
-    rc = template_parse(this,error_msg);
-
-    template__delete_buffer(str_buffer);
+    rc = template_parse(this, error_msg, scanner);
 
-    template_lex_destroy();
+    template__delete_buffer(str_buffer, scanner);
 
-    pthread_mutex_unlock(&mutex);
+    template_lex_destroy(scanner);
 
     return rc;
 
@@ -129,7 +145,199 @@ error_yy:
 
     *error_msg=strdup("Error setting scan buffer");
 
-    pthread_mutex_unlock(&mutex);
+    template_lex_destroy(scanner);
+
+    return -1;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+static inline bool kv_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/* -------------------------------------------------------------------------- */
+
+static inline bool kv_name(char c)
+{
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ *  Returns the position after the closing quote of the string starting at
+ *  pos, following the STRING token of template_parser.l: \" is escaped.
+ */
+static size_t kv_end_quote(const string& str, size_t pos)
+{
+    size_t len = str.length();
+
+    for (pos++; pos < len; pos++)
+    {
+        if ( str[pos] == '\\' && pos + 1 < len && str[pos+1] == '"' )
+        {
+            pos++;
+        }
+        else if ( str[pos] == '"' )
+        {
+            return pos + 1;
+        }
+    }
+
+    return string::npos;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int Template::parse_kv(const string &parse_str, char **error_msg)
+{
+    const string& s   = parse_str;
+    size_t        len = s.length();
+    size_t        pos = 0;
+    size_t        start;
+
+    string        name;
+    string        value;
+    string        vectors;
+
+    *error_msg = 0;
+
+    while ( pos < len )
+    {
+        char c = s[pos];
+
+        if ( kv_blank(c) || c == '\n' || c == ',' )
+        {
+            pos++;
+            continue;
+        }
+
+        if ( c == '#' )
+        {
+            pos = s.find('\n', pos);
+            continue;
+        }
+
+        // ---------------------------------------------------------------------
+        // Attribute name
+        // ---------------------------------------------------------------------
+        for (start = pos; pos < len && kv_name(s[pos]); pos++);
+
+        if ( start == pos )
+        {
+            goto error_syntax;
+        }
+
+        name.assign(s, start, pos - start);
+
+        for (; pos < len && kv_blank(s[pos]); pos++);
+
+        if ( pos == len || s[pos] != '=' )
+        {
+            goto error_syntax;
+        }
+
+        for (pos++; pos < len && kv_blank(s[pos]); pos++);
+
+        // ---------------------------------------------------------------------
+        // Attribute value: empty, vector, quoted string or single token
+        // ---------------------------------------------------------------------
+        if ( pos == len || s[pos] == '\n' || s[pos] == ',' )
+        {
+            value.clear();
+        }
+        else if ( s[pos] == '[' )
+        {
+            while ( pos < len && s[pos] != ']' )
+            {
+                if ( s[pos] != '"' )
+                {
+                    pos++;
+                    continue;
+                }
+
+                size_t end = kv_end_quote(s, pos);
+
+                if ( end == string::npos )
+                {
+                    goto error_syntax;
+                }
+
+                pos = end;
+            }
+
+            if ( pos >= len )
+            {
+                goto error_syntax;
+            }
+
+            vectors.append(s, start, ++pos - start);
+            vectors.push_back('\n');
+
+            continue;
+        }
+        else if ( s[pos] == '"' )
+        {
+            size_t end = kv_end_quote(s, pos);
+
+            if ( end == string::npos )
+            {
+                goto error_syntax;
+            }
+
+            value.assign(s, pos + 1, end - pos - 2);
+
+            for (size_t i = value.find("\\\""); i != string::npos;
+                 i = value.find("\\\"", i + 1))
+            {
+                value.replace(i, 2, "\"");
+            }
+
+            pos = end;
+        }
+        else
+        {
+            start = pos;
+            pos   = s.find_first_of("=#[] \t\r\n,", pos);
+
+            if ( pos == string::npos )
+            {
+                pos = len;
+            }
+
+            if ( start == pos )
+            {
+                goto error_syntax;
+            }
+
+            value.assign(s, start, pos - start);
+        }
+
+        if ( pos < len && !kv_blank(s[pos]) && s[pos] != '\n' && s[pos] != ','
+             && s[pos] != '#' )
+        {
+            goto error_syntax;
+        }
+
+        set(new SingleAttribute(name, value));
+    }
+
+    if ( !vectors.empty() )
+    {
+        return parse(vectors, error_msg);
+    }
+
+    return 0;
+
+error_syntax:
+    ostringstream oss;
+
+    oss << "syntax error at position " << pos << " of: " << s;
+
+    *error_msg = strdup(oss.str().c_str());
 
     return -1;
 }
@@ -93,25 +93,35 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void template__error(
         YYLTYPE *       llocp,
         mem_collector * mc,
         Template *      tmpl,
         char **         error_msg,
+        yyscan_t        scanner,
         const char *    str);
 
-    int template__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int template__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                       yyscan_t scanner);
 
-    int template__parse(mem_collector * mc, Template * tmpl, char ** errmsg);
+    int template__parse(mem_collector * mc,
+                        Template *      tmpl,
+                        char **         errmsg,
+                        yyscan_t        scanner);
 
-    int template_parse(Template * tmpl, char ** errmsg)
+    int template_parse(Template * tmpl, char ** errmsg, yyscan_t scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = template__parse(&mc, tmpl, errmsg);
+        rc = template__parse(&mc, tmpl, errmsg, scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -123,7 +133,7 @@ extern "C"
 
 
 /* Line 360 of yacc.c  */
-#line 127 "template_syntax.cc"
+#line 137 "template_syntax.cc"
 
 # ifndef YY_NULL
 #  if defined __cplusplus && 201103L <= __cplusplus
@@ -174,14 +184,14 @@ extern int template__debug;
 typedef union YYSTYPE
 {
 /* Line 376 of yacc.c  */
-#line 74 "template_syntax.y"
+#line 86 "template_syntax.y"
 
     char * val_str;
     void * val_attr;
 
 
 /* Line 376 of yacc.c  */
-#line 185 "template_syntax.cc"
+#line 195 "template_syntax.cc"
 } YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define yystype YYSTYPE /* obsolescent; will be withdrawn */
@@ -210,7 +220,7 @@ int template__parse ();
 #endif
 #else /* ! YYPARSE_PARAM */
 #if defined __STDC__ || defined __cplusplus
-int template__parse (mem_collector * mc, Template *      tmpl, char **         error_msg);
+int template__parse (mem_collector * mc, Template *      tmpl, char **         error_msg, yyscan_t        scanner);
 #else
 int template__parse ();
 #endif
@@ -221,7 +231,7 @@ int template__parse ();
 /* Copy the second part of user declarations.  */
 
 /* Line 379 of yacc.c  */
-#line 225 "template_syntax.cc"
+#line 235 "template_syntax.cc"
 
 #ifdef short
 # undef short
@@ -652,7 +662,7 @@ do                                                              \
     }                                                           \
   else                                                          \
     {                                                           \
-      yyerror (&yylloc, mc, tmpl, error_msg, YY_("syntax error: cannot back up")); \
+      yyerror (&yylloc, mc, tmpl, error_msg, scanner, YY_("syntax error: cannot back up")); \
       YYERROR;							\
     }								\
 while (YYID (0))
@@ -713,7 +723,7 @@ while (YYID (0))
 #ifdef YYLEX_PARAM
 # define YYLEX yylex (&yylval, &yylloc, YYLEX_PARAM)
 #else
-# define YYLEX yylex (&yylval, &yylloc, mc)
+# define YYLEX yylex (&yylval, &yylloc, mc, scanner)
 #endif
 
 /* Enable debugging if requested.  */
@@ -736,7 +746,7 @@ do {									  \
     {									  \
       YYFPRINTF (stderr, "%s ", Title);					  \
       yy_symbol_print (stderr,						  \
-		  Type, Value, Location, mc, tmpl, error_msg); \
+		  Type, Value, Location, mc, tmpl, error_msg, scanner); \
       YYFPRINTF (stderr, "\n");						  \
     }									  \
 } while (YYID (0))
@@ -750,10 +760,10 @@ do {									  \
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, Template *      tmpl, char **         error_msg)
+yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, Template *      tmpl, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg)
+yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -761,6 +771,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_
     mem_collector * mc;
     Template *      tmpl;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   FILE *yyo = yyoutput;
@@ -771,6 +782,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_
   YYUSE (mc);
   YYUSE (tmpl);
   YYUSE (error_msg);
+  YYUSE (scanner);
 # ifdef YYPRINT
   if (yytype < YYNTOKENS)
     YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
@@ -792,10 +804,10 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, Template *      tmpl, char **         error_msg)
+yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, Template *      tmpl, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg)
+yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -803,6 +815,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg)
     mem_collector * mc;
     Template *      tmpl;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   if (yytype < YYNTOKENS)
@@ -812,7 +825,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg)
 
   YY_LOCATION_PRINT (yyoutput, *yylocationp);
   YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg);
+  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg, scanner);
   YYFPRINTF (yyoutput, ")");
 }
 
@@ -855,16 +868,17 @@ do {								\
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, Template *      tmpl, char **         error_msg)
+yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, Template *      tmpl, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yy_reduce_print (yyvsp, yylsp, yyrule, mc, tmpl, error_msg)
+yy_reduce_print (yyvsp, yylsp, yyrule, mc, tmpl, error_msg, scanner)
     YYSTYPE *yyvsp;
     YYLTYPE *yylsp;
     int yyrule;
     mem_collector * mc;
     Template *      tmpl;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   int yynrhs = yyr2[yyrule];
@@ -878,7 +892,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, tmpl, error_msg)
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
 		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, tmpl, error_msg);
+		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, tmpl, error_msg, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -886,7 +900,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, tmpl, error_msg)
 # define YY_REDUCE_PRINT(Rule)		\
 do {					\
   if (yydebug)				\
-    yy_reduce_print (yyvsp, yylsp, Rule, mc, tmpl, error_msg); \
+    yy_reduce_print (yyvsp, yylsp, Rule, mc, tmpl, error_msg, scanner); \
 } while (YYID (0))
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1163,10 +1177,10 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, Template *      tmpl, char **         error_msg)
+yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, Template *      tmpl, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg)
+yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg, scanner)
     const char *yymsg;
     int yytype;
     YYSTYPE *yyvaluep;
@@ -1174,6 +1188,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg)
     mem_collector * mc;
     Template *      tmpl;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   YYUSE (yyvaluep);
@@ -1181,6 +1196,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, tmpl, error_msg)
   YYUSE (mc);
   YYUSE (tmpl);
   YYUSE (error_msg);
+  YYUSE (scanner);
 
   if (!yymsg)
     yymsg = "Deleting";
@@ -1215,13 +1231,14 @@ yyparse (YYPARSE_PARAM)
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 int
-yyparse (mem_collector * mc, Template *      tmpl, char **         error_msg)
+yyparse (mem_collector * mc, Template *      tmpl, char **         error_msg, yyscan_t        scanner)
 #else
 int
-yyparse (mc, tmpl, error_msg)
+yyparse (mc, tmpl, error_msg, scanner)
     mem_collector * mc;
     Template *      tmpl;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 #endif
 {
@@ -1517,7 +1534,7 @@ yyreduce:
     {
         case 6:
 /* Line 1778 of yacc.c  */
-#line 103 "template_syntax.y"
+#line 115 "template_syntax.y"
     {
                 Attribute * pattr;
                 string      name((yyvsp[(1) - (3)].val_str));
@@ -1531,7 +1548,7 @@ yyreduce:
 
   case 7:
 /* Line 1778 of yacc.c  */
-#line 113 "template_syntax.y"
+#line 125 "template_syntax.y"
     {
                 Attribute * pattr;
                 string      name((yyvsp[(1) - (5)].val_str));
@@ -1548,7 +1565,7 @@ yyreduce:
 
   case 8:
 /* Line 1778 of yacc.c  */
-#line 126 "template_syntax.y"
+#line 138 "template_syntax.y"
     {
                 Attribute * pattr;
                 string      name((yyvsp[(1) - (2)].val_str));
@@ -1562,7 +1579,7 @@ yyreduce:
 
   case 9:
 /* Line 1778 of yacc.c  */
-#line 138 "template_syntax.y"
+#line 150 "template_syntax.y"
     {
                 map<string,string>* vattr;
                 string              name((yyvsp[(1) - (3)].val_str));
@@ -1579,7 +1596,7 @@ yyreduce:
 
   case 10:
 /* Line 1778 of yacc.c  */
-#line 151 "template_syntax.y"
+#line 163 "template_syntax.y"
     {
                 string               name((yyvsp[(3) - (5)].val_str));
                 string               value((yyvsp[(5) - (5)].val_str));
@@ -1596,7 +1613,7 @@ yyreduce:
 
 
 /* Line 1778 of yacc.c  */
-#line 1600 "template_syntax.cc"
+#line 1617 "template_syntax.cc"
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1647,7 +1664,7 @@ yyerrlab:
     {
       ++yynerrs;
 #if ! YYERROR_VERBOSE
-      yyerror (&yylloc, mc, tmpl, error_msg, YY_("syntax error"));
+      yyerror (&yylloc, mc, tmpl, error_msg, scanner, YY_("syntax error"));
 #else
 # define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
                                         yyssp, yytoken)
@@ -1674,7 +1691,7 @@ yyerrlab:
                 yymsgp = yymsg;
               }
           }
-        yyerror (&yylloc, mc, tmpl, error_msg, yymsgp);
+        yyerror (&yylloc, mc, tmpl, error_msg, scanner, yymsgp);
         if (yysyntax_error_status == 2)
           goto yyexhaustedlab;
       }
@@ -1698,7 +1715,7 @@ yyerrlab:
       else
 	{
 	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, &yylloc, mc, tmpl, error_msg);
+		      yytoken, &yylval, &yylloc, mc, tmpl, error_msg, scanner);
 	  yychar = YYEMPTY;
 	}
     }
@@ -1755,7 +1772,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, yylsp, mc, tmpl, error_msg);
+		  yystos[yystate], yyvsp, yylsp, mc, tmpl, error_msg, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1797,7 +1814,7 @@ yyabortlab:
 | yyexhaustedlab -- memory exhaustion comes here.  |
 `-------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (&yylloc, mc, tmpl, error_msg, YY_("memory exhausted"));
+  yyerror (&yylloc, mc, tmpl, error_msg, scanner, YY_("memory exhausted"));
   yyresult = 2;
   /* Fall through.  */
 #endif
@@ -1809,7 +1826,7 @@ yyreturn:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc, mc, tmpl, error_msg);
+                  yytoken, &yylval, &yylloc, mc, tmpl, error_msg, scanner);
     }
   /* Do not reclaim the symbols of the rule which action triggered
      this YYABORT or YYACCEPT.  */
@@ -1818,7 +1835,7 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, yylsp, mc, tmpl, error_msg);
+		  yystos[*yyssp], yyvsp, yylsp, mc, tmpl, error_msg, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -1835,7 +1852,7 @@ yyreturn:
 
 
 /* Line 2041 of yacc.c  */
-#line 164 "template_syntax.y"
+#line 176 "template_syntax.y"
 
 
 string& unescape (string &str)
@@ -1855,6 +1872,7 @@ extern "C" void template__error(
     mem_collector * mc,
     Template *      tmpl,
     char **         error_msg,
+    yyscan_t        scanner,
     const char *    str)
 {
     int length;
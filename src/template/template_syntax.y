@@ -35,25 +35,35 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void template__error(
         YYLTYPE *       llocp,
         mem_collector * mc,
         Template *      tmpl,
         char **         error_msg,
+        yyscan_t        scanner,
         const char *    str);
 
-    int template__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int template__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                       yyscan_t scanner);
 
-    int template__parse(mem_collector * mc, Template * tmpl, char ** errmsg);
+    int template__parse(mem_collector * mc,
+                        Template *      tmpl,
+                        char **         errmsg,
+                        yyscan_t        scanner);
 
-    int template_parse(Template * tmpl, char ** errmsg)
+    int template_parse(Template * tmpl, char ** errmsg, yyscan_t scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = template__parse(&mc, tmpl, errmsg);
+        rc = template__parse(&mc, tmpl, errmsg, scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -68,8 +78,10 @@ extern "C"
 %parse-param {mem_collector * mc}
 %parse-param {Template *      tmpl}
 %parse-param {char **         error_msg}
+%parse-param {yyscan_t        scanner}
 
 %lex-param {mem_collector * mc}
+%lex-param {yyscan_t        scanner}
 
 %union {
     char * val_str;
@@ -180,6 +192,7 @@ extern "C" void template__error(
     mem_collector * mc,
     Template *      tmpl,
     char **         error_msg,
+    yyscan_t        scanner,
     const char *    str)
 {
     int length;
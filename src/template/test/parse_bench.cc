@@ -0,0 +1,136 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <sstream>
+#include <stdlib.h>
+
+#include "Template.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// Reports parsed per second with an increasing number of threads, with the
+// template grammar (as the InformationManager did, rewriting the commas to
+// new lines) and with Template::parse_kv().
+//
+// Usage: parse_bench [parses_per_thread]
+
+static const string report =
+    "HYPERVISOR=kvm,TOTALCPU=800,CPUSPEED=2400,TOTALMEMORY=16331948,"
+    "USEDMEMORY=4413276,FREEMEMORY=11918672,FREECPU=763.2,USEDCPU=36.8,"
+    "NETRX=1239840218,NETTX=397410232,"
+    "MODELNAME=\"Intel(R) Xeon(R) CPU E5620 @ 2.40GHz\","
+    "HOSTNAME=node01.example.com,ARCH=x86_64,DS_LOCATION_USED_MB=1033,"
+    "DS_LOCATION_TOTAL_MB=235520,DS_LOCATION_FREE_MB=222288,"
+    "VERSION=\"3.9.80\",RUNNING_VMS=4";
+
+struct BenchArgs
+{
+    bool kv;
+    int  num_parses;
+};
+
+/* -------------------------------------------------------------------------- */
+
+extern "C" void * bench_loop(void * _args)
+{
+    BenchArgs * args = static_cast<BenchArgs *>(_args);
+
+    for (int i = 0 ; i < args->num_parses ; i++)
+    {
+        Template tmpl;
+        char *   error = 0;
+
+        if ( args->kv )
+        {
+            tmpl.parse_kv(report, &error);
+        }
+        else
+        {
+            string hinfo = report;
+            size_t pos;
+
+            for (pos=hinfo.find(',');pos!=string::npos;pos=hinfo.find(','))
+            {
+                hinfo.replace(pos,1,"\n");
+            }
+
+            hinfo += "\n";
+
+            tmpl.parse(hinfo, &error);
+        }
+
+        if ( error != 0 )
+        {
+            cerr << error << endl;
+            free(error);
+        }
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double run(bool kv, int num_threads, int num_parses)
+{
+    BenchArgs * args = new BenchArgs[num_threads];
+    double      ms;
+
+    for (int i = 0 ; i < num_threads ; i++)
+    {
+        args[i].kv         = kv;
+        args[i].num_parses = num_parses;
+    }
+
+    ms = Benchmark::run_threads(bench_loop, args, num_threads);
+
+    delete [] args;
+
+    return (num_threads * num_parses) / (ms / 1000);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    int           num_parses = 20000;
+    ostringstream title;
+
+    BenchColumn columns[] = {
+        {"threads", 8, 0}, {"parse", 16, 0}, {"parse_kv", 16, 0}};
+
+    if ( argc > 1 )
+    {
+        num_parses = atoi(argv[1]);
+    }
+
+    title << "reports parsed per second, " << num_parses
+          << " parses per thread";
+
+    Benchmark bench(title.str(), columns, 3);
+
+    for (int threads = 1 ; threads <= 16 ; threads *= 2)
+    {
+        double grammar = run(false, threads, num_parses);
+        double kv      = run(true, threads, num_parses);
+
+        bench << threads << grammar << kv;
+    }
+
+    return 0;
+}
@@ -2,11 +2,53 @@
 
 #include <string>
 #include <iostream>
+#include <pthread.h>
 
 #include "test/OneUnitTest.h"
 
 using namespace std;
 
+/* ************************************************************************* */
+/* Concurrent parsing: each thread parses its template several times and     */
+/* checks the result, a shared scanner state would mix the inputs            */
+/* ************************************************************************* */
+
+struct ParseArgs
+{
+    const string * str;
+    const string * marshall;
+    int            errors;
+};
+
+static void * parse_thread(void *arg)
+{
+    ParseArgs * args = static_cast<ParseArgs *>(arg);
+
+    for (int i = 0 ; i < 500 ; i++)
+    {
+        Template tmpl;
+        string   tmp;
+        char *   error = 0;
+
+        if ( tmpl.parse(*(args->str), &error) != 0 )
+        {
+            args->errors++;
+            free(error);
+
+            continue;
+        }
+
+        tmpl.marshall(tmp);
+
+        if ( tmp != *(args->marshall) )
+        {
+            args->errors++;
+        }
+    }
+
+    return 0;
+}
+
 /* ************************************************************************* */
 /* ************************************************************************* */
 /* ************************************************************************* */
@@ -24,6 +66,8 @@ class TemplateTest : public OneUnitTest
     CPPUNIT_TEST (test_set);
     CPPUNIT_TEST (test_erase);
     CPPUNIT_TEST (test_from_xml);
+    CPPUNIT_TEST (test_parse_kv);
+    CPPUNIT_TEST (test_parse_threads);
 
     CPPUNIT_TEST_SUITE_END ();
 
@@ -354,6 +398,113 @@ public:
 
         CPPUNIT_ASSERT(str1 == str2);
     }
+
+    /* --------------------------------------------------------------------- */
+
+    void test_parse_kv()
+    {
+        Template tkv;
+        Template tmon;
+        Template terr;
+
+        char * error = 0;
+        int    rc;
+        string tmp;
+
+        // Same attributes as the template grammar
+        rc = tkv.parse_kv(test_ok, &error);
+
+        CPPUNIT_ASSERT(rc == 0);
+        CPPUNIT_ASSERT(error == 0);
+
+        tkv.marshall(tmp);
+
+        CPPUNIT_ASSERT(test_ok_marshall == tmp);
+
+        // Monitoring probes output, comma separated in a single line
+        rc = tmon.parse_kv("HYPERVISOR=kvm,TOTALCPU=800,CPUSPEED= 2400,"
+            "MODELNAME=\"Intel(R) Xeon(R) CPU, 2.4GHz\",NETRX=,FREECPU=790",
+            &error);
+
+        CPPUNIT_ASSERT(rc == 0);
+
+        tmp = "";
+        tmon.marshall(tmp);
+
+        CPPUNIT_ASSERT(tmp == "CPUSPEED=2400\nFREECPU=790\nHYPERVISOR=kvm\n"
+            "MODELNAME=Intel(R) Xeon(R) CPU, 2.4GHz\nNETRX=\nTOTALCPU=800\n");
+
+        // Syntax errors
+        rc = terr.parse_kv("TOTALCPU=800,FREECPU", &error);
+
+        CPPUNIT_ASSERT(rc != 0);
+        CPPUNIT_ASSERT(error != 0);
+
+        free(error);
+
+        rc = terr.parse_kv("DISK=[FILE=\"path]", &error);
+
+        CPPUNIT_ASSERT(rc != 0);
+
+        free(error);
+    }
+
+    /* ********************************************************************* */
+
+    void test_parse_threads()
+    {
+        const int num_threads = 8;
+
+        pthread_t threads[num_threads];
+        ParseArgs args[num_threads];
+
+        string    strs[num_threads];
+        string    marshalls[num_threads];
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            ostringstream oss;
+
+            oss << "ID = " << i << "\n"
+                << "NAME = \"template " << i << "\"\n"
+                << "DISK = [ SIZE = " << i * 1024 << ", TARGET = hd" << i
+                << " ]\n";
+
+            strs[i] = oss.str();
+
+            oss.str("");
+
+            oss << "DISK=SIZE=" << i * 1024 << "@^_^@TARGET=hd" << i << "\n"
+                << "ID=" << i << "\n"
+                << "NAME=template " << i << "\n";
+
+            marshalls[i] = oss.str();
+
+            args[i].str      = &strs[i];
+            args[i].marshall = &marshalls[i];
+            args[i].errors   = 0;
+        }
+
+        // Odd threads use the test template, its error-free parse is checked
+        // along with the others
+        for (int i = 1 ; i < num_threads ; i += 2)
+        {
+            strs[i]      = test_ok;
+            marshalls[i] = test_ok_marshall;
+        }
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_create(&threads[i], 0, parse_thread, &args[i]);
+        }
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_join(threads[i], 0);
+
+            CPPUNIT_ASSERT(args[i].errors == 0);
+        }
+    }
 };
 
 /* ************************************************************************* */
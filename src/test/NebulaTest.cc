@@ -23,14 +23,18 @@ VirtualMachinePool* NebulaTest::create_vmpool(SqlDB* db, string hook_location,
 {
     vector<const Attribute *> hooks;
     vector<const Attribute *> restricted_attrs;
+    vector<const Attribute *> rollups;
 
-    return new VirtualMachinePool(db, hooks, hook_location, vloc, restricted_attrs, 0);
+    return new VirtualMachinePool(db, hooks, hook_location, vloc,
+                                  restricted_attrs, 0, rollups, false);
 }
 
 HostPool* NebulaTest::create_hpool(SqlDB* db, string hook_location, string vloc)
 {
     vector<const Attribute *> hooks;
-    return new HostPool(db, hooks, hook_location, vloc, 0);
+    vector<const Attribute *> rollups;
+
+    return new HostPool(db, hooks, hook_location, vloc, 0, rollups);
 }
 
 VirtualNetworkPool* NebulaTest::create_vnpool(SqlDB* db, string mac_prefix, int size)
@@ -112,6 +116,10 @@ InformationManager* NebulaTest::create_im(HostPool*   hpool,
                                   timer_period,
                                   monitor_period,
                                   15,
+                                  0,
+                                  "0.0.0.0",
+                                  0,
+                                  "",
                                   remotes_location,
                                   im_mads);
 }
@@ -400,6 +400,27 @@ static string prolog_os_transfer_commands(
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+int TransferManager::send_transfer(
+    const TransferManagerDriver *   tm_md,
+    int                             vid,
+    const string&                   xfr_name,
+    const char *                    action,
+    ostringstream&                  os)
+{
+    if ( tm_md->transfer(vid, xfr_name) != 0 )
+    {
+        os.str("");
+        os << action << ", transfer driver is busy, could not send the transfer";
+
+        return -1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void TransferManager::prolog_action(int vid)
 {
     ofstream      xfr;
@@ -552,7 +573,10 @@ void TransferManager::prolog_action(int vid)
 
     xfr.close();
 
-    tm_md->transfer(vid,xfr_name);
+    if ( send_transfer(tm_md, vid, xfr_name, "prolog", os) != 0 )
+    {
+        goto error_common;
+    }
 
     vm->unlock();
     return;
@@ -713,7 +737,10 @@ void TransferManager::prolog_migr_action(int vid)
 
     xfr.close();
 
-    tm_md->transfer(vid,xfr_name);
+    if ( send_transfer(tm_md, vid, xfr_name, "prolog_migr", os) != 0 )
+    {
+        goto error_common;
+    }
 
     vm->unlock();
     return;
@@ -850,7 +877,10 @@ void TransferManager::prolog_resume_action(int vid)
 
     xfr.close();
 
-    tm_md->transfer(vid,xfr_name);
+    if ( send_transfer(tm_md, vid, xfr_name, "prolog_resume", os) != 0 )
+    {
+        goto error_common;
+    }
 
     vm->unlock();
     return;
@@ -1028,7 +1058,10 @@ void TransferManager::epilog_action(int vid)
 
     xfr.close();
 
-    tm_md->transfer(vid,xfr_name);
+    if ( send_transfer(tm_md, vid, xfr_name, "epilog", os) != 0 )
+    {
+        goto error_common;
+    }
 
     vm->unlock();
     return;
@@ -1166,7 +1199,10 @@ void TransferManager::epilog_stop_action(int vid)
 
     xfr.close();
 
-    tm_md->transfer(vid,xfr_name);
+    if ( send_transfer(tm_md, vid, xfr_name, "epilog_stop", os) != 0 )
+    {
+        goto error_common;
+    }
 
     vm->unlock();
 
@@ -1327,7 +1363,10 @@ void TransferManager::epilog_delete_action(bool local, int vid)
 
     xfr.close();
 
-    tm_md->transfer(vid,xfr_name);
+    if ( send_transfer(tm_md, vid, xfr_name, "epilog_delete", os) != 0 )
+    {
+        goto error_common;
+    }
 
     vm->unlock();
     return;
@@ -1464,7 +1503,10 @@ void TransferManager::epilog_delete_previous_action(int vid)
 
     xfr.close();
 
-    tm_md->transfer(vid,xfr_name);
+    if ( send_transfer(tm_md,vid,xfr_name,"epilog_delete_previous",os) != 0 )
+    {
+        goto error_common;
+    }
 
     vm->unlock();
     return;
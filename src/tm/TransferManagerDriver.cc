@@ -25,7 +25,7 @@
 /* Driver ASCII Protocol Implementation                                       */
 /* ************************************************************************** */
 
-void TransferManagerDriver::transfer (
+int TransferManagerDriver::transfer (
         const int oid,
         const string& xfr_file) const
 {
@@ -33,7 +33,7 @@ void TransferManagerDriver::transfer (
 
     os << "TRANSFER " << oid << " " << xfr_file << endl;
 
-    write(os);
+    return write(os);
 };
 
 
@@ -46,7 +46,8 @@ class TransferManagerDriver < OpenNebulaDriver
         @options={
             :concurrency => 15,
             :threaded    => true,
-            :retries     => 0
+            :retries     => 0,
+            :framed      => true
         }.merge!(options)
 
         super('tm/', @options)
@@ -50,35 +50,17 @@ const char * User::db_bootstrap = "CREATE TABLE IF NOT EXISTS user_pool ("
 int User::insert_replace(SqlDB *db, bool replace, string& error_str)
 {
     ostringstream   oss;
+    SqlParams       params;
 
-    int    rc;
     string xml_body;
 
-    char * sql_username;
-    char * sql_xml;
-
     // Set itself as the owner
     set_user(oid, name);
 
-    // Update the User
-
-    sql_username = db->escape_str(name.c_str());
-
-    if ( sql_username == 0 )
+    if ( validate_xml(to_xml(xml_body)) != 0 )
     {
-        goto error_username;
-    }
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
-    if ( validate_xml(sql_xml) != 0 )
-    {
-        goto error_xml;
+        error_str = "Error transforming the User to XML.";
+        return -1;
     }
 
     // Construct the SQL statement to Insert or Replace
@@ -92,42 +74,18 @@ int User::insert_replace(SqlDB *db, bool replace, string& error_str)
     }
 
     oss << " INTO " << table << " ("<< db_names <<") VALUES ("
-        <<          oid             << ","
-        << "'" <<   sql_username    << "',"
-        << "'" <<   sql_xml         << "',"
-        <<          uid             << ","
-        <<          gid             << ","
-        <<          owner_u         << ","
-        <<          group_u         << ","
-        <<          other_u         << ")";
-
-
-    rc = db->exec(oss);
-
-    db->free_str(sql_username);
-    db->free_str(sql_xml);
-
-    return rc;
-
-error_xml:
-    db->free_str(sql_username);
-    db->free_str(sql_xml);
-
-    error_str = "Error transforming the User to XML.";
-
-    goto error_common;
-
-error_body:
-    db->free_str(sql_username);
-    goto error_generic;
-
-error_username:
-    goto error_generic;
-
-error_generic:
-    error_str = "Error inserting User in DB.";
-error_common:
-    return -1;
+        << "?,?,?,?,?,?,?,?)";
+
+    params.add(oid)
+          .add(name)
+          .add(xml_body)
+          .add(uid)
+          .add(gid)
+          .add(owner_u)
+          .add(group_u)
+          .add(other_u);
+
+    return db->exec(oss, params);
 }
 
 /* ************************************************************************** */
@@ -31,6 +31,13 @@ const char * History::db_bootstrap = "CREATE TABLE IF NOT EXISTS "
     "history (vid INTEGER, seq INTEGER, body TEXT, "
     "stime INTEGER, etime INTEGER,PRIMARY KEY(vid,seq))";
 
+// Indexes for the time frame of the accounting queries
+const char * History::stime_db_index =
+    "CREATE INDEX history_stime_idx ON history (stime)";
+
+const char * History::etime_db_index =
+    "CREATE INDEX history_etime_idx ON history (etime)";
+
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
@@ -148,24 +155,15 @@ void History::non_persistent_data()
 int History::insert_replace(SqlDB *db, bool replace)
 {
     ostringstream   oss;
+    SqlParams       params;
 
     string xml_body;
-    char * sql_xml;
-
-    int    rc;
 
     if (seq == -1)
     {
         return 0;
     }
 
-    sql_xml = db->escape_str(to_db_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
     if(replace)
     {
         oss << "REPLACE";
@@ -175,21 +173,15 @@ int History::insert_replace(SqlDB *db, bool replace)
         oss << "INSERT";
     }
 
-    oss << " INTO " << table << " ("<< db_names <<") VALUES ("
-        <<          oid             << ","
-        <<          seq             << ","
-        << "'" <<   sql_xml         << "',"
-        <<          stime           << ","
-        <<          etime           << ")";
-
-    rc = db->exec(oss);
+    oss << " INTO " << table << " ("<< db_names <<") VALUES (?,?,?,?,?)";
 
-    db->free_str(sql_xml);
+    params.add(oid)
+          .add(seq)
+          .add(to_db_xml(xml_body))
+          .add(stime)
+          .add(etime);
 
-    return rc;
-
-error_body:
-    return -1;
+    return db->exec(oss, params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -229,11 +221,10 @@ int History::select(SqlDB * db)
             << " AND seq = " << seq;
     }
 
-    set_callback(static_cast<Callbackable::Callback>(&History::select_cb));
-
-    rc = db->exec(oss,this);
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&History::select_cb));
 
-    unset_callback();
+    rc = db->exec(oss, &cb);
 
     if ( rc == 0 ) // Regenerate non-persistent data
     {
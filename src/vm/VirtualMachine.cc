@@ -103,19 +103,43 @@ const char * VirtualMachine::db_bootstrap = "CREATE TABLE IF NOT EXISTS "
     "gid INTEGER, last_poll INTEGER, state INTEGER, lcm_state INTEGER, "
     "owner_u INTEGER, group_u INTEGER, other_u INTEGER)";
 
+// Index to get the VMs in a state, ordered by last_poll for the VMs to be
+// monitored (VirtualMachinePool::get_running)
+const char * VirtualMachine::db_index =
+    "CREATE INDEX vm_pool_state_idx ON vm_pool (state, last_poll)";
 
-const char * VirtualMachine::monit_table = "vm_monitoring";
 
-const char * VirtualMachine::monit_db_names = "vmid, last_poll, body";
+const char * VirtualMachine::monit_table = "vm_monitoring";
 
 const char * VirtualMachine::monit_db_bootstrap = "CREATE TABLE IF NOT EXISTS "
-    "vm_monitoring (vmid INTEGER, last_poll INTEGER, body TEXT, "
-    "PRIMARY KEY(vmid, last_poll))";
+    "vm_monitoring (vmid INTEGER, start_time INTEGER, last_time INTEGER, "
+    "body TEXT, PRIMARY KEY(vmid, start_time))";
+
+// Index to delete the expired samples (MonitoringStore::clean_expired)
+const char * VirtualMachine::monit_db_index = "CREATE INDEX "
+    "vm_monitoring_time_idx ON vm_monitoring (last_time)";
+
+const char * VirtualMachine::monit_rollup_table = "vm_monitoring_rollup";
+
+const char * VirtualMachine::monit_rollup_db_bootstrap = "CREATE TABLE IF NOT "
+    "EXISTS vm_monitoring_rollup (vmid INTEGER, resolution INTEGER, "
+    "start_time INTEGER, body TEXT, PRIMARY KEY(vmid, resolution, start_time))";
+
+// Index to delete the expired rollups (MonitoringStore::clean_expired)
+const char * VirtualMachine::monit_rollup_db_index = "CREATE INDEX "
+    "vm_monitoring_rollup_idx ON vm_monitoring_rollup (resolution, "
+    "start_time)";
+
+// Metrics of the monitoring samples (MonitoringStore), the sample time is
+// LAST_POLL
+const char * VirtualMachine::monit_metrics[] = {
+    "STATE", "LCM_STATE", "MEMORY", "CPU", "NET_TX", "NET_RX", 0
+};
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int VirtualMachine::select(SqlDB * db)
+int VirtualMachine::post_select(SqlDB * db)
 {
     ostringstream   oss;
     ostringstream   ose;
@@ -126,14 +150,6 @@ int VirtualMachine::select(SqlDB * db)
 
     Nebula& nd = Nebula::instance();
 
-    // Rebuild the VirtualMachine object
-    rc = PoolObjectSQL::select(db);
-
-    if( rc != 0 )
-    {
-        return rc;
-    }
-
     //Get History Records. Current history is built in from_xml() (if any).
     if( hasHistory() )
     {
@@ -958,29 +974,14 @@ error_common:
 int VirtualMachine::insert_replace(SqlDB *db, bool replace, string& error_str)
 {
     ostringstream   oss;
-    int             rc;
+    SqlParams       params;
 
     string xml_body;
-    char * sql_name;
-    char * sql_xml;
-
-    sql_name =  db->escape_str(name.c_str());
-
-    if ( sql_name == 0 )
-    {
-        goto error_generic;
-    }
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
 
-    if ( sql_xml == 0 )
+    if ( validate_xml(to_xml(xml_body)) != 0 )
     {
-        goto error_body;
-    }
-
-    if ( validate_xml(sql_xml) != 0 )
-    {
-        goto error_xml;
+        error_str = "Error transforming the VM to XML.";
+        return -1;
     }
 
     if(replace)
@@ -993,95 +994,36 @@ int VirtualMachine::insert_replace(SqlDB *db, bool replace, string& error_str)
     }
 
     oss << " INTO " << table << " ("<< db_names <<") VALUES ("
-        <<          oid             << ","
-        << "'" <<   sql_name        << "',"
-        << "'" <<   sql_xml         << "',"
-        <<          uid             << ","
-        <<          gid             << ","
-        <<          last_poll       << ","
-        <<          state           << ","
-        <<          lcm_state       << ","
-        <<          owner_u         << ","
-        <<          group_u         << ","
-        <<          other_u         << ")";
-
-    db->free_str(sql_name);
-    db->free_str(sql_xml);
-
-    rc = db->exec(oss);
-
-    return rc;
-
-error_xml:
-    db->free_str(sql_name);
-    db->free_str(sql_xml);
-
-    error_str = "Error transforming the VM to XML.";
-
-    goto error_common;
-
-error_body:
-    db->free_str(sql_name);
-    goto error_generic;
-
-error_generic:
-    error_str = "Error inserting VM in DB.";
-error_common:
-    return -1;
+        << "?,?,?,?,?,?,?,?,?,?,?)";
+
+    params.add(oid)
+          .add(name)
+          .add(xml_body)
+          .add(uid)
+          .add(gid)
+          .add(last_poll)
+          .add(state)
+          .add(lcm_state)
+          .add(owner_u)
+          .add(group_u)
+          .add(other_u);
+
+    return db->exec(oss, params);
 }
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int VirtualMachine::update_monitoring(SqlDB * db)
+void VirtualMachine::get_monitoring(vector<long long>& values) const
 {
-    ostringstream   oss;
-    int             rc;
-
-    string xml_body;
-    string error_str;
-    char * sql_xml;
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
-    if ( validate_xml(sql_xml) != 0 )
-    {
-        goto error_xml;
-    }
-
-    oss << "INSERT INTO " << monit_table << " ("<< monit_db_names <<") VALUES ("
-        <<          oid             << ","
-        <<          last_poll       << ","
-        << "'" <<   sql_xml         << "')";
-
-    db->free_str(sql_xml);
-
-    rc = db->exec(oss);
-
-    return rc;
-
-error_xml:
-    db->free_str(sql_xml);
-
-    error_str = "could not transform the VM to XML.";
-
-    goto error_common;
-
-error_body:
-    error_str = "could not insert the VM in the DB.";
-
-error_common:
-    oss.str("");
-    oss << "Error updating VM monitoring information, " << error_str;
-
-    NebulaLog::log("ONE",Log::ERROR, oss);
-
-    return -1;
+    values.clear();
+
+    values.push_back(state);
+    values.push_back(lcm_state);
+    values.push_back(memory);
+    values.push_back(cpu);
+    values.push_back(net_tx);
+    values.push_back(net_rx);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -2076,25 +2018,32 @@ void VirtualMachine::set_auth_request(int uid,
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-pthread_mutex_t VirtualMachine::lex_mutex = PTHREAD_MUTEX_INITIALIZER;
-
 extern "C"
 {
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     typedef struct yy_buffer_state * YY_BUFFER_STATE;
 
     int vm_var_parse (VirtualMachine * vm,
                       ostringstream *  parsed,
-                      char **          errmsg);
+                      char **          errmsg,
+                      yyscan_t         scanner);
 
     int vm_file_var_parse (VirtualMachine * vm,
                            vector<int> *    img_ids,
-                           char **          errmsg);
+                           char **          errmsg,
+                           yyscan_t         scanner);
+
+    int vm_var_lex_init(yyscan_t * scanner);
 
-    int vm_var_lex_destroy();
+    int vm_var_lex_destroy(yyscan_t scanner);
 
-    YY_BUFFER_STATE vm_var__scan_string(const char * str);
+    YY_BUFFER_STATE vm_var__scan_string(const char * str, yyscan_t scanner);
 
-    void vm_var__delete_buffer(YY_BUFFER_STATE);
+    void vm_var__delete_buffer(YY_BUFFER_STATE, yyscan_t scanner);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -2108,24 +2057,27 @@ int VirtualMachine::parse_template_attribute(const string& attribute,
     int              rc;
     ostringstream    oss_parsed;
     char *           error_msg = 0;
+    yyscan_t         scanner;
 
-    pthread_mutex_lock(&lex_mutex);
+    if ( vm_var_lex_init(&scanner) != 0 )
+    {
+        log("VM",Log::ERROR,"Error initializing attribute scanner");
+        return -1;
+    }
 
     str        = attribute.c_str();
-    str_buffer = vm_var__scan_string(str);
+    str_buffer = vm_var__scan_string(str, scanner);
 
     if (str_buffer == 0)
     {
         goto error_yy;
     }
 
-    rc = vm_var_parse(this, &oss_parsed, &error_msg);
-
-    vm_var__delete_buffer(str_buffer);
+    rc = vm_var_parse(this, &oss_parsed, &error_msg, scanner);
 
-    vm_var_lex_destroy();
+    vm_var__delete_buffer(str_buffer, scanner);
 
-    pthread_mutex_unlock(&lex_mutex);
+    vm_var_lex_destroy(scanner);
 
     if ( rc != 0 && error_msg != 0 )
     {
@@ -2145,7 +2097,7 @@ int VirtualMachine::parse_template_attribute(const string& attribute,
 
 error_yy:
     log("VM",Log::ERROR,"Error setting scan buffer");
-    pthread_mutex_unlock(&lex_mutex);
+    vm_var_lex_destroy(scanner);
     return -1;
 }
 
@@ -2160,6 +2112,7 @@ int VirtualMachine::parse_file_attribute(string       attribute,
     int              rc;
     ostringstream    oss_parsed;
     char *           error_msg = 0;
+    yyscan_t         scanner;
 
     size_t non_blank_pos;
 
@@ -2172,23 +2125,25 @@ int VirtualMachine::parse_file_attribute(string       attribute,
         attribute.erase(0, non_blank_pos);
     }
 
-    pthread_mutex_lock(&lex_mutex);
+    if ( vm_var_lex_init(&scanner) != 0 )
+    {
+        log("VM",Log::ERROR,"Error initializing attribute scanner");
+        return -1;
+    }
 
     str        = attribute.c_str();
-    str_buffer = vm_var__scan_string(str);
+    str_buffer = vm_var__scan_string(str, scanner);
 
     if (str_buffer == 0)
     {
         goto error_yy;
     }
 
-    rc = vm_file_var_parse(this, &img_ids, &error_msg);
-
-    vm_var__delete_buffer(str_buffer);
+    rc = vm_file_var_parse(this, &img_ids, &error_msg, scanner);
 
-    vm_var_lex_destroy();
+    vm_var__delete_buffer(str_buffer, scanner);
 
-    pthread_mutex_unlock(&lex_mutex);
+    vm_var_lex_destroy(scanner);
 
     if ( rc != 0  )
     {
@@ -2211,7 +2166,7 @@ int VirtualMachine::parse_file_attribute(string       attribute,
 
 error_yy:
     log("VM",Log::ERROR,"Error setting scan buffer");
-    pthread_mutex_unlock(&lex_mutex);
+    vm_var_lex_destroy(scanner);
     return -1;
 }
 /* -------------------------------------------------------------------------- */
@@ -37,8 +37,13 @@ VirtualMachinePool::VirtualMachinePool(
         const string&               remotes_location,
         vector<const Attribute *>&  restricted_attrs,
         time_t                      expire_time,
+        const vector<const Attribute *>& rollups,
         bool                        on_hold)
-    : PoolSQL(db, VirtualMachine::table, false)
+    : PoolSQL(db, VirtualMachine::table, false),
+      monitoring(VirtualMachine::monit_table,
+                 VirtualMachine::monit_rollup_table, "vmid",
+                 VirtualMachine::table, "LAST_POLL",
+                 VirtualMachine::monit_metrics, expire_time)
 {
     const VectorAttribute * vattr;
 
@@ -53,11 +58,16 @@ VirtualMachinePool::VirtualMachinePool(
     _monitor_expiration = expire_time;
     _submit_on_hold = on_hold;
 
+    // VirtualMachine::insert locks the images and networks of the VM
+    allocate_in_transaction = false;
+
     if ( _monitor_expiration == 0 )
     {
         clean_all_monitoring();
     }
 
+    monitoring.add_rollups(rollups);
+
     for (unsigned int i = 0 ; i < hook_mads.size() ; i++ )
     {
         vattr = static_cast<const VectorAttribute *>(hook_mads[i]);
@@ -308,9 +318,15 @@ int VirtualMachinePool::dump_acct(ostringstream& oss,
         {
             cmd << " AND stime < " << time_end;
         }
-    }
 
-    cmd << " GROUP BY vid,seq";
+        // The records in the time frame are got with the time indexes and
+        // then sorted, sqlite would scan the whole primary key otherwise
+        cmd << " ORDER BY +vid,+seq";
+    }
+    else
+    {
+        cmd << " ORDER BY vid,seq";
+    }
 
     return PoolSQL::dump(oss, "HISTORY_RECORDS", cmd);
 };
@@ -320,23 +336,7 @@ int VirtualMachinePool::dump_acct(ostringstream& oss,
 
 int VirtualMachinePool::clean_expired_monitoring()
 {
-    if ( _monitor_expiration == 0 )
-    {
-        return 0;
-    }
-
-    time_t          max_last_poll;
-    int             rc;
-    ostringstream   oss;
-
-    max_last_poll = time(0) - _monitor_expiration;
-
-    oss << "DELETE FROM " << VirtualMachine::monit_table
-        << " WHERE last_poll < " << max_last_poll;
-
-    rc = db->exec(oss);
-
-    return rc;
+    return monitoring.clean_expired(db);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -344,14 +344,7 @@ int VirtualMachinePool::clean_expired_monitoring()
 
 int VirtualMachinePool::clean_all_monitoring()
 {
-    ostringstream   oss;
-    int             rc;
-
-    oss << "DELETE FROM " << VirtualMachine::monit_table;
-
-    rc = db->exec(oss);
-
-    return rc;
+    return monitoring.clean_all(db);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -359,21 +352,8 @@ int VirtualMachinePool::clean_all_monitoring()
 
 int VirtualMachinePool::dump_monitoring(
         ostringstream& oss,
-        const string&  where)
+        const string&  where,
+        int            resolution)
 {
-    ostringstream cmd;
-
-    cmd << "SELECT " << VirtualMachine::monit_table << ".body FROM "
-        << VirtualMachine::monit_table
-        << " INNER JOIN " << VirtualMachine::table
-        << " WHERE vmid = oid";
-
-    if ( !where.empty() )
-    {
-        cmd << " AND " << where;
-    }
-
-    cmd << " ORDER BY vmid, " << VirtualMachine::monit_table << ".last_poll;";
-
-    return PoolSQL::dump(oss, "MONITORING_DATA", cmd);
+    return monitoring.dump(db, oss, where, resolution);
 }
@@ -21,6 +21,7 @@
 #include "VirtualMachinePool.h"
 #include "ImagePool.h"
 #include "PoolTest.h"
+#include "QueryPlanDB.h"
 
 using namespace std;
 
@@ -44,6 +45,44 @@ const string templates[] =
     "CPU    = 1"
 };
 
+struct ParseArgs
+{
+    VirtualMachine * vm;
+    string           attr;
+    string           parsed;
+    string           file_attr;
+    string           file_error;
+    int              errors;
+};
+
+static void * parse_thread(void *arg)
+{
+    ParseArgs * args = static_cast<ParseArgs *>(arg);
+
+    for (int i = 0 ; i < 200 ; i++)
+    {
+        string      parsed;
+        string      error;
+        vector<int> img_ids;
+
+        if ( args->vm->parse_template_attribute(args->attr, parsed, error) != 0
+             || parsed != args->parsed )
+        {
+            args->errors++;
+        }
+
+        error = "";
+
+        if ( args->vm->parse_file_attribute(args->file_attr, img_ids, error)
+                == 0 || error != args->file_error || !img_ids.empty() )
+        {
+            args->errors++;
+        }
+    }
+
+    return 0;
+}
+
 /* ************************************************************************* */
 /* ************************************************************************* */
 #include "NebulaTest.h"
@@ -67,7 +106,8 @@ public:
             vector<const Attribute *> hook_mads,
             vector<const Attribute *> restricted_attrs):
                 VirtualMachinePool(db, hook_mads,
-                        "./", "./", restricted_attrs, 0)
+                        "./", "./", restricted_attrs, 0,
+                        vector<const Attribute *>(), false)
         {};
 
 
@@ -113,6 +153,8 @@ class VirtualMachinePoolTest : public PoolTest
 
     CPPUNIT_TEST (update);
     CPPUNIT_TEST (history);
+    CPPUNIT_TEST (parse_threads);
+    CPPUNIT_TEST (query_plans);
 
     CPPUNIT_TEST_SUITE_END ();
 
@@ -305,6 +347,121 @@ public:
 
         CPPUNIT_ASSERT( vm->get_previous_reason() == History::ERROR );
     }
+
+    // The VM attributes are parsed from several threads, each one with its
+    // own VM, the results of every thread are checked
+    void parse_threads()
+    {
+        const int num_threads = 8;
+
+        VirtualMachinePoolFriend * vmp =
+                                static_cast<VirtualMachinePoolFriend*>(pool);
+
+        pthread_t   threads[num_threads];
+        ParseArgs   args[num_threads];
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            ostringstream oss;
+            vector<int>   img_ids;
+            int           oid;
+
+            oss << "NAME   = \"VM " << i << "\"\n"
+                << "MEMORY = " << 128 * (i + 1) << "\n"
+                << "CPU    = 1\n"
+                << "DATA   = [ TARGET = hd" << i << ", SIZE = " << i * 1024
+                << " ]";
+
+            CPPUNIT_ASSERT( vmp->allocate(uids[0], oss.str(), &oid) >= 0 );
+
+            args[i].vm = vmp->get(oid, false);
+
+            CPPUNIT_ASSERT( args[i].vm != 0 );
+
+            oss.str("");
+            oss << "$NAME:$MEMORY:$DATA[TARGET]:$DATA[SIZE,TARGET=\"hd" << i
+                << "\"]";
+
+            args[i].attr = oss.str();
+
+            oss.str("");
+            oss << "VM " << i << ":" << 128 * (i + 1) << ":hd" << i << ":"
+                << i * 1024;
+
+            args[i].parsed = oss.str();
+
+            // Syntax error, its position depends on the thread
+            args[i].file_attr = "$FILE[IMAGE_ID" + string(i, ' ') + "]";
+
+            CPPUNIT_ASSERT( args[i].vm->parse_file_attribute(args[i].file_attr,
+                                img_ids, args[i].file_error) != 0 );
+
+            if ( i > 0 )
+            {
+                CPPUNIT_ASSERT( args[i].file_error != args[i-1].file_error );
+            }
+
+            args[i].errors = 0;
+        }
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_create(&threads[i], 0, parse_thread, &args[i]);
+        }
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_join(threads[i], 0);
+
+            CPPUNIT_ASSERT( args[i].errors == 0 );
+        }
+    }
+
+    // The monitoring and accounting queries must use the table indexes
+    void query_plans()
+    {
+        if ( mysql )
+        {
+            return;
+        }
+
+        vector<const Attribute *> hook;
+        vector<const Attribute *> restricted;
+        vector<int>               oids;
+        ostringstream             oss;
+
+        QueryPlanDB               plan_db(db);
+        VirtualMachinePoolFriend  vmp(&plan_db, hook, restricted);
+
+        plan_db.clear();
+
+        CPPUNIT_ASSERT( vmp.get_running(oids, 10, time(0)) == 0 );
+
+        CPPUNIT_ASSERT( plan_db.uses_index("vm_pool_state_idx") );
+        CPPUNIT_ASSERT( plan_db.full_scan() == false );
+        CPPUNIT_ASSERT( plan_db.temp_sort() == false );
+
+        plan_db.clear();
+
+        CPPUNIT_ASSERT( vmp.get_pending(oids) == 0 );
+
+        CPPUNIT_ASSERT( plan_db.uses_index("vm_pool_state_idx") );
+        CPPUNIT_ASSERT( plan_db.full_scan() == false );
+
+        plan_db.clear();
+
+        CPPUNIT_ASSERT( vmp.dump_acct(oss, "", 100, 200) == 0 );
+
+        CPPUNIT_ASSERT( plan_db.uses_index("history_stime_idx") );
+        CPPUNIT_ASSERT( plan_db.full_scan() == false );
+
+        plan_db.clear();
+
+        CPPUNIT_ASSERT( vmp.dump_acct(oss, "", 100, -1) == 0 );
+
+        CPPUNIT_ASSERT( plan_db.uses_index("history_etime_idx") );
+        CPPUNIT_ASSERT( plan_db.full_scan() == false );
+    }
 };
 
 
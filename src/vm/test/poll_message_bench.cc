@@ -0,0 +1,198 @@
+/* -------------------------------------------------------------------------- */
+/* Copyright 2002-2012, OpenNebula Project Leads (OpenNebula.org)             */
+/*                                                                            */
+/* Licensed under the Apache License, Version 2.0 (the "License"); you may    */
+/* not use this file except in compliance with the License. You may obtain    */
+/* a copy of the License at                                                   */
+/*                                                                            */
+/* http://www.apache.org/licenses/LICENSE-2.0                                 */
+/*                                                                            */
+/* Unless required by applicable law or agreed to in writing, software        */
+/* distributed under the License is distributed on an "AS IS" BASIS,          */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   */
+/* See the License for the specific language governing permissions and        */
+/* limitations under the License.                                             */
+/* -------------------------------------------------------------------------- */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdlib.h>
+
+#include "NebulaLog.h"
+#include "SSLTools.h"
+#include "VirtualMachine.h"
+#include "VirtualMachineManager.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// CPU time to build the POLL messages of a poll cycle, with the VM XML
+// wrapped in a base64 VMM_DRIVER_ACTION_DATA document (as
+// VirtualMachineManager::format_message does for the other actions) and with
+// the compact POLL message.
+//
+// Usage: poll_message_bench [num_vms] [cycles]
+
+static const char * vm_template =
+    "NAME   = \"bench vm\"\n"
+    "MEMORY = 1024\n"
+    "CPU    = 1\n"
+    "VCPU   = 2\n"
+    "OS     = [ ARCH = x86_64, BOOT = hd ]\n"
+    "DISK   = [ IMAGE_ID = 3, SOURCE = /var/lib/one/datastores/1/0123456789,"
+    " TARGET = hda, DRIVER = qcow2, DATASTORE = default, DATASTORE_ID = 1 ]\n"
+    "DISK   = [ TYPE = swap, SIZE = 1024, TARGET = hdb ]\n"
+    "NIC    = [ NETWORK = public, NETWORK_ID = 0, BRIDGE = br0,"
+    " IP = 10.0.0.10, MAC = 02:00:0a:00:00:0a ]\n"
+    "NIC    = [ NETWORK = private, NETWORK_ID = 1, BRIDGE = br1,"
+    " IP = 192.168.0.10, MAC = 02:00:c0:a8:00:0a ]\n"
+    "GRAPHICS = [ TYPE = vnc, LISTEN = 0.0.0.0, PORT = 5910 ]\n"
+    "CONTEXT  = [ HOSTNAME = bench, FILES = \"/srv/one/context/init.sh\","
+    " TARGET = hdc ]\n"
+    "REQUIREMENTS = \"CLUSTER_ID = 100\"\n";
+
+/* -------------------------------------------------------------------------- */
+
+class BenchVM : public VirtualMachine
+{
+public:
+    BenchVM(int oid, VirtualMachineTemplate * tmpl):
+        VirtualMachine(oid, 0, 0, "oneadmin", "oneadmin", tmpl){};
+
+    ~BenchVM(){};
+};
+
+/* -------------------------------------------------------------------------- */
+
+static string * xml_poll_message(VirtualMachine * vm)
+{
+    ostringstream oss;
+    string        vm_xml;
+
+    oss << "<VMM_DRIVER_ACTION_DATA>"
+        <<   "<HOST>"    << vm->get_hostname() << "</HOST>"
+        <<   "<NET_DRV>" << vm->get_vnm_mad()  << "</NET_DRV>"
+        <<   "<MIGR_HOST/><MIGR_NET_DRV/>"
+        <<   "<DEPLOY_ID>" << vm->get_deploy_id() << "</DEPLOY_ID>"
+        <<   "<LOCAL_DEPLOYMENT_FILE/><REMOTE_DEPLOYMENT_FILE/>"
+        <<   "<CHECKPOINT_FILE/><TM_COMMAND/><DISK_TARGET_PATH/>"
+        <<   vm->to_xml(vm_xml)
+        << "</VMM_DRIVER_ACTION_DATA>";
+
+    return SSLTools::base64_encode(oss.str());
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double poll_xml(vector<BenchVM *>& vms, size_t& bytes)
+{
+    double start = Benchmark::cpu_ms();
+
+    bytes = 0;
+
+    for (size_t i = 0 ; i < vms.size() ; i++)
+    {
+        string * msg = xml_poll_message(vms[i]);
+
+        bytes += msg->size();
+
+        delete msg;
+    }
+
+    return Benchmark::cpu_ms() - start;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static double poll_compact(vector<BenchVM *>& vms, size_t& bytes)
+{
+    double start = Benchmark::cpu_ms();
+
+    bytes = 0;
+
+    for (size_t i = 0 ; i < vms.size() ; i++)
+    {
+        string msg = VirtualMachineManager::format_poll_message(
+                        vms[i]->get_hostname(), vms[i]->get_deploy_id());
+
+        bytes += msg.size();
+    }
+
+    return Benchmark::cpu_ms() - start;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char ** argv)
+{
+    int num_vms = 10000;
+    int cycles  = 5;
+
+    vector<BenchVM *> vms;
+
+    ostringstream title;
+
+    BenchColumn columns[] = {
+        {"xml+base64 (ms)", 16, 1}, {"compact (ms)", 16, 1},
+        {"xml bytes", 16, 0}, {"compact bytes", 16, 0}};
+
+    if ( argc > 1 )
+    {
+        num_vms = atoi(argv[1]);
+    }
+
+    if ( argc > 2 )
+    {
+        cycles = atoi(argv[2]);
+    }
+
+    NebulaLog::init_log_system(NebulaLog::FILE, Log::ERROR, "bench.log");
+
+    for (int i = 0 ; i < num_vms ; i++)
+    {
+        VirtualMachineTemplate * tmpl = new VirtualMachineTemplate;
+        ostringstream            oss;
+        char *                   error = 0;
+
+        tmpl->parse(vm_template, &error);
+
+        BenchVM * vm = new BenchVM(i, tmpl);
+
+        oss << "host" << i / 40;
+
+        vm->add_history(i / 40, oss.str(), "vmm_kvm", "dummy", "shared",
+                        "/var/lib/one/datastores", 0);
+
+        oss.str("");
+        oss << "one-" << i;
+
+        vm->update_info(oss.str());
+
+        vms.push_back(vm);
+    }
+
+    title << "CPU time to build the POLL messages of " << num_vms << " VMs";
+
+    Benchmark bench(title.str(), columns, 4);
+
+    for (int i = 0 ; i < cycles ; i++)
+    {
+        size_t xml_bytes, compact_bytes;
+
+        double xml     = poll_xml(vms, xml_bytes);
+        double compact = poll_compact(vms, compact_bytes);
+
+        bench << xml << compact << xml_bytes / num_vms
+              << compact_bytes / num_vms;
+    }
+
+    for (size_t i = 0 ; i < vms.size() ; i++)
+    {
+        delete vms[i];
+    }
+
+    NebulaLog::finalize_log_system();
+
+    return 0;
+}
@@ -98,31 +98,40 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void vm_file_var__error(
         YYLTYPE *        llocp,
         mem_collector *  mc,
         VirtualMachine * vm,
         vector<int> *    img_ids,
         char **          errmsg,
+        yyscan_t         scanner,
         const char *     str);
 
-    int vm_file_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int vm_file_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                          yyscan_t scanner);
 
     int vm_file_var__parse (mem_collector *  mc,
                             VirtualMachine * vm,
                             vector<int> *    img_ids,
-                            char **          errmsg);
+                            char **          errmsg,
+                            yyscan_t         scanner);
 
     int vm_file_var_parse (VirtualMachine * vm,
                            vector<int> *    img_ids,
-                           char **          errmsg)
+                           char **          errmsg,
+                           yyscan_t         scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = vm_file_var__parse(&mc, vm, img_ids, errmsg);
+        rc = vm_file_var__parse(&mc, vm, img_ids, errmsg, scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -218,7 +227,7 @@ int get_image_path(VirtualMachine * vm,
 
 
 /* Line 360 of yacc.c  */
-#line 222 "vm_file_var_syntax.cc"
+#line 231 "vm_file_var_syntax.cc"
 
 # ifndef YY_NULL
 #  if defined __cplusplus && 201103L <= __cplusplus
@@ -271,7 +280,7 @@ extern int vm_file_var__debug;
 typedef union YYSTYPE
 {
 /* Line 376 of yacc.c  */
-#line 170 "vm_file_var_syntax.y"
+#line 181 "vm_file_var_syntax.y"
 
     char * val_str;
     int    val_int;
@@ -279,7 +288,7 @@ typedef union YYSTYPE
 
 
 /* Line 376 of yacc.c  */
-#line 283 "vm_file_var_syntax.cc"
+#line 292 "vm_file_var_syntax.cc"
 } YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define yystype YYSTYPE /* obsolescent; will be withdrawn */
@@ -308,7 +317,7 @@ int vm_file_var__parse ();
 #endif
 #else /* ! YYPARSE_PARAM */
 #if defined __STDC__ || defined __cplusplus
-int vm_file_var__parse (mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg);
+int vm_file_var__parse (mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg, yyscan_t         scanner);
 #else
 int vm_file_var__parse ();
 #endif
@@ -319,7 +328,7 @@ int vm_file_var__parse ();
 /* Copy the second part of user declarations.  */
 
 /* Line 379 of yacc.c  */
-#line 323 "vm_file_var_syntax.cc"
+#line 332 "vm_file_var_syntax.cc"
 
 #ifdef short
 # undef short
@@ -746,7 +755,7 @@ do                                                              \
     }                                                           \
   else                                                          \
     {                                                           \
-      yyerror (&yylloc, mc, vm, img_ids, errmsg, YY_("syntax error: cannot back up")); \
+      yyerror (&yylloc, mc, vm, img_ids, errmsg, scanner, YY_("syntax error: cannot back up")); \
       YYERROR;							\
     }								\
 while (YYID (0))
@@ -807,7 +816,7 @@ while (YYID (0))
 #ifdef YYLEX_PARAM
 # define YYLEX yylex (&yylval, &yylloc, YYLEX_PARAM)
 #else
-# define YYLEX yylex (&yylval, &yylloc, mc)
+# define YYLEX yylex (&yylval, &yylloc, mc, scanner)
 #endif
 
 /* Enable debugging if requested.  */
@@ -830,7 +839,7 @@ do {									  \
     {									  \
       YYFPRINTF (stderr, "%s ", Title);					  \
       yy_symbol_print (stderr,						  \
-		  Type, Value, Location, mc, vm, img_ids, errmsg); \
+		  Type, Value, Location, mc, vm, img_ids, errmsg, scanner); \
       YYFPRINTF (stderr, "\n");						  \
     }									  \
 } while (YYID (0))
@@ -844,10 +853,10 @@ do {									  \
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg)
+yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg)
+yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -856,6 +865,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids,
     VirtualMachine * vm;
     vector<int> *    img_ids;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   FILE *yyo = yyoutput;
@@ -867,6 +877,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids,
   YYUSE (vm);
   YYUSE (img_ids);
   YYUSE (errmsg);
+  YYUSE (scanner);
 # ifdef YYPRINT
   if (yytype < YYNTOKENS)
     YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
@@ -888,10 +899,10 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids,
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg)
+yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg)
+yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -900,6 +911,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errms
     VirtualMachine * vm;
     vector<int> *    img_ids;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   if (yytype < YYNTOKENS)
@@ -909,7 +921,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errms
 
   YY_LOCATION_PRINT (yyoutput, *yylocationp);
   YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg);
+  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg, scanner);
   YYFPRINTF (yyoutput, ")");
 }
 
@@ -952,10 +964,10 @@ do {								\
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg)
+yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, img_ids, errmsg)
+yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, img_ids, errmsg, scanner)
     YYSTYPE *yyvsp;
     YYLTYPE *yylsp;
     int yyrule;
@@ -963,6 +975,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, img_ids, errmsg)
     VirtualMachine * vm;
     vector<int> *    img_ids;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   int yynrhs = yyr2[yyrule];
@@ -976,7 +989,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, img_ids, errmsg)
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
 		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, vm, img_ids, errmsg);
+		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, vm, img_ids, errmsg, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -984,7 +997,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, img_ids, errmsg)
 # define YY_REDUCE_PRINT(Rule)		\
 do {					\
   if (yydebug)				\
-    yy_reduce_print (yyvsp, yylsp, Rule, mc, vm, img_ids, errmsg); \
+    yy_reduce_print (yyvsp, yylsp, Rule, mc, vm, img_ids, errmsg, scanner); \
 } while (YYID (0))
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1261,10 +1274,10 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg)
+yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg)
+yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg, scanner)
     const char *yymsg;
     int yytype;
     YYSTYPE *yyvaluep;
@@ -1273,6 +1286,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg)
     VirtualMachine * vm;
     vector<int> *    img_ids;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   YYUSE (yyvaluep);
@@ -1281,6 +1295,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, img_ids, errmsg)
   YYUSE (vm);
   YYUSE (img_ids);
   YYUSE (errmsg);
+  YYUSE (scanner);
 
   if (!yymsg)
     yymsg = "Deleting";
@@ -1315,14 +1330,15 @@ yyparse (YYPARSE_PARAM)
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 int
-yyparse (mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg)
+yyparse (mem_collector *  mc, VirtualMachine * vm, vector<int> *    img_ids, char **          errmsg, yyscan_t         scanner)
 #else
 int
-yyparse (mc, vm, img_ids, errmsg)
+yyparse (mc, vm, img_ids, errmsg, scanner)
     mem_collector *  mc;
     VirtualMachine * vm;
     vector<int> *    img_ids;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 #endif
 {
@@ -1618,7 +1634,7 @@ yyreduce:
     {
         case 4:
 /* Line 1778 of yacc.c  */
-#line 200 "vm_file_var_syntax.y"
+#line 211 "vm_file_var_syntax.y"
     {
         string file((yyvsp[(1) - (7)].val_str));
         string var1((yyvsp[(3) - (7)].val_str));
@@ -1640,7 +1656,7 @@ yyreduce:
 
   case 5:
 /* Line 1778 of yacc.c  */
-#line 218 "vm_file_var_syntax.y"
+#line 229 "vm_file_var_syntax.y"
     {
         string file((yyvsp[(1) - (11)].val_str));
         string var1((yyvsp[(3) - (11)].val_str));
@@ -1665,7 +1681,7 @@ yyreduce:
 
 
 /* Line 1778 of yacc.c  */
-#line 1669 "vm_file_var_syntax.cc"
+#line 1685 "vm_file_var_syntax.cc"
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1716,7 +1732,7 @@ yyerrlab:
     {
       ++yynerrs;
 #if ! YYERROR_VERBOSE
-      yyerror (&yylloc, mc, vm, img_ids, errmsg, YY_("syntax error"));
+      yyerror (&yylloc, mc, vm, img_ids, errmsg, scanner, YY_("syntax error"));
 #else
 # define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
                                         yyssp, yytoken)
@@ -1743,7 +1759,7 @@ yyerrlab:
                 yymsgp = yymsg;
               }
           }
-        yyerror (&yylloc, mc, vm, img_ids, errmsg, yymsgp);
+        yyerror (&yylloc, mc, vm, img_ids, errmsg, scanner, yymsgp);
         if (yysyntax_error_status == 2)
           goto yyexhaustedlab;
       }
@@ -1767,7 +1783,7 @@ yyerrlab:
       else
 	{
 	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, &yylloc, mc, vm, img_ids, errmsg);
+		      yytoken, &yylval, &yylloc, mc, vm, img_ids, errmsg, scanner);
 	  yychar = YYEMPTY;
 	}
     }
@@ -1824,7 +1840,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, yylsp, mc, vm, img_ids, errmsg);
+		  yystos[yystate], yyvsp, yylsp, mc, vm, img_ids, errmsg, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1866,7 +1882,7 @@ yyabortlab:
 | yyexhaustedlab -- memory exhaustion comes here.  |
 `-------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (&yylloc, mc, vm, img_ids, errmsg, YY_("memory exhausted"));
+  yyerror (&yylloc, mc, vm, img_ids, errmsg, scanner, YY_("memory exhausted"));
   yyresult = 2;
   /* Fall through.  */
 #endif
@@ -1878,7 +1894,7 @@ yyreturn:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc, mc, vm, img_ids, errmsg);
+                  yytoken, &yylval, &yylloc, mc, vm, img_ids, errmsg, scanner);
     }
   /* Do not reclaim the symbols of the rule which action triggered
      this YYABORT or YYACCEPT.  */
@@ -1887,7 +1903,7 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, yylsp, mc, vm, img_ids, errmsg);
+		  yystos[*yyssp], yyvsp, yylsp, mc, vm, img_ids, errmsg, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -1904,7 +1920,7 @@ yyreturn:
 
 
 /* Line 2041 of yacc.c  */
-#line 239 "vm_file_var_syntax.y"
+#line 250 "vm_file_var_syntax.y"
 
 
 extern "C" void vm_file_var__error(
@@ -1913,6 +1929,7 @@ extern "C" void vm_file_var__error(
     VirtualMachine * vm,
     vector<int> *    img_ids,
     char **          error_msg,
+    yyscan_t         scanner,
     const char *     str)
 {
     int length;
@@ -40,31 +40,40 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void vm_file_var__error(
         YYLTYPE *        llocp,
         mem_collector *  mc,
         VirtualMachine * vm,
         vector<int> *    img_ids,
         char **          errmsg,
+        yyscan_t         scanner,
         const char *     str);
 
-    int vm_file_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int vm_file_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                          yyscan_t scanner);
 
     int vm_file_var__parse (mem_collector *  mc,
                             VirtualMachine * vm,
                             vector<int> *    img_ids,
-                            char **          errmsg);
+                            char **          errmsg,
+                            yyscan_t         scanner);
 
     int vm_file_var_parse (VirtualMachine * vm,
                            vector<int> *    img_ids,
-                           char **          errmsg)
+                           char **          errmsg,
+                           yyscan_t         scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = vm_file_var__parse(&mc, vm, img_ids, errmsg);
+        rc = vm_file_var__parse(&mc, vm, img_ids, errmsg, scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -164,8 +173,10 @@ int get_image_path(VirtualMachine * vm,
 %parse-param {VirtualMachine * vm}
 %parse-param {vector<int> *    img_ids}
 %parse-param {char **          errmsg}
+%parse-param {yyscan_t         scanner}
 
 %lex-param {mem_collector * mc}
+%lex-param {yyscan_t        scanner}
 
 %union {
     char * val_str;
@@ -244,6 +255,7 @@ extern "C" void vm_file_var__error(
     VirtualMachine * vm,
     vector<int> *    img_ids,
     char **          error_msg,
+    yyscan_t         scanner,
     const char *     str)
 {
     int length;
@@ -97,31 +97,40 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void vm_var__error(
         YYLTYPE *        llocp,
         mem_collector *  mc,
         VirtualMachine * vm,
         ostringstream *  parsed,
         char **          errmsg,
+        yyscan_t         scanner,
         const char *     str);
 
-    int vm_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int vm_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                     yyscan_t scanner);
 
     int vm_var__parse (mem_collector *  mc,
                        VirtualMachine * vm,
                        ostringstream *  parsed,
-                       char **          errmsg);
+                       char **          errmsg,
+                       yyscan_t         scanner);
 
     int vm_var_parse (VirtualMachine * vm,
                       ostringstream *  parsed,
-                      char **          errmsg)
+                      char **          errmsg,
+                      yyscan_t         scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = vm_var__parse(&mc, vm, parsed, errmsg);
+        rc = vm_var__parse(&mc, vm, parsed, errmsg, scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -464,7 +473,7 @@ void insert_vector(VirtualMachine * vm,
 
 
 /* Line 360 of yacc.c  */
-#line 468 "vm_var_syntax.cc"
+#line 477 "vm_var_syntax.cc"
 
 # ifndef YY_NULL
 #  if defined __cplusplus && 201103L <= __cplusplus
@@ -517,7 +526,7 @@ extern int vm_var__debug;
 typedef union YYSTYPE
 {
 /* Line 376 of yacc.c  */
-#line 416 "vm_var_syntax.y"
+#line 427 "vm_var_syntax.y"
 
     char * val_str;
     int    val_int;
@@ -525,7 +534,7 @@ typedef union YYSTYPE
 
 
 /* Line 376 of yacc.c  */
-#line 529 "vm_var_syntax.cc"
+#line 538 "vm_var_syntax.cc"
 } YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define yystype YYSTYPE /* obsolescent; will be withdrawn */
@@ -554,7 +563,7 @@ int vm_var__parse ();
 #endif
 #else /* ! YYPARSE_PARAM */
 #if defined __STDC__ || defined __cplusplus
-int vm_var__parse (mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg);
+int vm_var__parse (mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg, yyscan_t         scanner);
 #else
 int vm_var__parse ();
 #endif
@@ -565,7 +574,7 @@ int vm_var__parse ();
 /* Copy the second part of user declarations.  */
 
 /* Line 379 of yacc.c  */
-#line 569 "vm_var_syntax.cc"
+#line 578 "vm_var_syntax.cc"
 
 #ifdef short
 # undef short
@@ -992,7 +1001,7 @@ do                                                              \
     }                                                           \
   else                                                          \
     {                                                           \
-      yyerror (&yylloc, mc, vm, parsed, errmsg, YY_("syntax error: cannot back up")); \
+      yyerror (&yylloc, mc, vm, parsed, errmsg, scanner, YY_("syntax error: cannot back up")); \
       YYERROR;							\
     }								\
 while (YYID (0))
@@ -1053,7 +1062,7 @@ while (YYID (0))
 #ifdef YYLEX_PARAM
 # define YYLEX yylex (&yylval, &yylloc, YYLEX_PARAM)
 #else
-# define YYLEX yylex (&yylval, &yylloc, mc)
+# define YYLEX yylex (&yylval, &yylloc, mc, scanner)
 #endif
 
 /* Enable debugging if requested.  */
@@ -1076,7 +1085,7 @@ do {									  \
     {									  \
       YYFPRINTF (stderr, "%s ", Title);					  \
       yy_symbol_print (stderr,						  \
-		  Type, Value, Location, mc, vm, parsed, errmsg); \
+		  Type, Value, Location, mc, vm, parsed, errmsg, scanner); \
       YYFPRINTF (stderr, "\n");						  \
     }									  \
 } while (YYID (0))
@@ -1090,10 +1099,10 @@ do {									  \
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg)
+yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg)
+yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -1102,6 +1111,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed,
     VirtualMachine * vm;
     ostringstream *  parsed;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   FILE *yyo = yyoutput;
@@ -1113,6 +1123,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed,
   YYUSE (vm);
   YYUSE (parsed);
   YYUSE (errmsg);
+  YYUSE (scanner);
 # ifdef YYPRINT
   if (yytype < YYNTOKENS)
     YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
@@ -1134,10 +1145,10 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed,
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg)
+yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg)
+yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -1146,6 +1157,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg
     VirtualMachine * vm;
     ostringstream *  parsed;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   if (yytype < YYNTOKENS)
@@ -1155,7 +1167,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg
 
   YY_LOCATION_PRINT (yyoutput, *yylocationp);
   YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg);
+  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg, scanner);
   YYFPRINTF (yyoutput, ")");
 }
 
@@ -1198,10 +1210,10 @@ do {								\
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg)
+yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, parsed, errmsg)
+yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, parsed, errmsg, scanner)
     YYSTYPE *yyvsp;
     YYLTYPE *yylsp;
     int yyrule;
@@ -1209,6 +1221,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, parsed, errmsg)
     VirtualMachine * vm;
     ostringstream *  parsed;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   int yynrhs = yyr2[yyrule];
@@ -1222,7 +1235,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, parsed, errmsg)
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
 		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, vm, parsed, errmsg);
+		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, vm, parsed, errmsg, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1230,7 +1243,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, vm, parsed, errmsg)
 # define YY_REDUCE_PRINT(Rule)		\
 do {					\
   if (yydebug)				\
-    yy_reduce_print (yyvsp, yylsp, Rule, mc, vm, parsed, errmsg); \
+    yy_reduce_print (yyvsp, yylsp, Rule, mc, vm, parsed, errmsg, scanner); \
 } while (YYID (0))
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1507,10 +1520,10 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg)
+yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg, yyscan_t         scanner)
 #else
 static void
-yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg)
+yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg, scanner)
     const char *yymsg;
     int yytype;
     YYSTYPE *yyvaluep;
@@ -1519,6 +1532,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg)
     VirtualMachine * vm;
     ostringstream *  parsed;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 {
   YYUSE (yyvaluep);
@@ -1527,6 +1541,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, vm, parsed, errmsg)
   YYUSE (vm);
   YYUSE (parsed);
   YYUSE (errmsg);
+  YYUSE (scanner);
 
   if (!yymsg)
     yymsg = "Deleting";
@@ -1561,14 +1576,15 @@ yyparse (YYPARSE_PARAM)
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 int
-yyparse (mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg)
+yyparse (mem_collector * mc, VirtualMachine * vm, ostringstream *  parsed, char **          errmsg, yyscan_t         scanner)
 #else
 int
-yyparse (mc, vm, parsed, errmsg)
+yyparse (mc, vm, parsed, errmsg, scanner)
     mem_collector * mc;
     VirtualMachine * vm;
     ostringstream *  parsed;
     char **          errmsg;
+    yyscan_t         scanner;
 #endif
 #endif
 {
@@ -1864,7 +1880,7 @@ yyreduce:
     {
         case 4:
 /* Line 1778 of yacc.c  */
-#line 445 "vm_var_syntax.y"
+#line 456 "vm_var_syntax.y"
     {
         (*parsed) << (yyvsp[(1) - (1)].val_str);
     }
@@ -1872,7 +1888,7 @@ yyreduce:
 
   case 5:
 /* Line 1778 of yacc.c  */
-#line 449 "vm_var_syntax.y"
+#line 460 "vm_var_syntax.y"
     {
         string name((yyvsp[(1) - (2)].val_str));
 
@@ -1889,7 +1905,7 @@ yyreduce:
 
   case 6:
 /* Line 1778 of yacc.c  */
-#line 462 "vm_var_syntax.y"
+#line 473 "vm_var_syntax.y"
     {
         string name((yyvsp[(1) - (5)].val_str));
         string vname((yyvsp[(3) - (5)].val_str));
@@ -1908,7 +1924,7 @@ yyreduce:
 
   case 7:
 /* Line 1778 of yacc.c  */
-#line 477 "vm_var_syntax.y"
+#line 488 "vm_var_syntax.y"
     {
         string name((yyvsp[(1) - (9)].val_str));
         string vname((yyvsp[(3) - (9)].val_str));
@@ -1930,7 +1946,7 @@ yyreduce:
 
 
 /* Line 1778 of yacc.c  */
-#line 1934 "vm_var_syntax.cc"
+#line 1950 "vm_var_syntax.cc"
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1981,7 +1997,7 @@ yyerrlab:
     {
       ++yynerrs;
 #if ! YYERROR_VERBOSE
-      yyerror (&yylloc, mc, vm, parsed, errmsg, YY_("syntax error"));
+      yyerror (&yylloc, mc, vm, parsed, errmsg, scanner, YY_("syntax error"));
 #else
 # define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
                                         yyssp, yytoken)
@@ -2008,7 +2024,7 @@ yyerrlab:
                 yymsgp = yymsg;
               }
           }
-        yyerror (&yylloc, mc, vm, parsed, errmsg, yymsgp);
+        yyerror (&yylloc, mc, vm, parsed, errmsg, scanner, yymsgp);
         if (yysyntax_error_status == 2)
           goto yyexhaustedlab;
       }
@@ -2032,7 +2048,7 @@ yyerrlab:
       else
 	{
 	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, &yylloc, mc, vm, parsed, errmsg);
+		      yytoken, &yylval, &yylloc, mc, vm, parsed, errmsg, scanner);
 	  yychar = YYEMPTY;
 	}
     }
@@ -2089,7 +2105,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, yylsp, mc, vm, parsed, errmsg);
+		  yystos[yystate], yyvsp, yylsp, mc, vm, parsed, errmsg, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2131,7 +2147,7 @@ yyabortlab:
 | yyexhaustedlab -- memory exhaustion comes here.  |
 `-------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (&yylloc, mc, vm, parsed, errmsg, YY_("memory exhausted"));
+  yyerror (&yylloc, mc, vm, parsed, errmsg, scanner, YY_("memory exhausted"));
   yyresult = 2;
   /* Fall through.  */
 #endif
@@ -2143,7 +2159,7 @@ yyreturn:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc, mc, vm, parsed, errmsg);
+                  yytoken, &yylval, &yylloc, mc, vm, parsed, errmsg, scanner);
     }
   /* Do not reclaim the symbols of the rule which action triggered
      this YYABORT or YYACCEPT.  */
@@ -2152,7 +2168,7 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, yylsp, mc, vm, parsed, errmsg);
+		  yystos[*yyssp], yyvsp, yylsp, mc, vm, parsed, errmsg, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -2169,7 +2185,7 @@ yyreturn:
 
 
 /* Line 2041 of yacc.c  */
-#line 495 "vm_var_syntax.y"
+#line 506 "vm_var_syntax.y"
 
 
 extern "C" void vm_var__error(
@@ -2178,6 +2194,7 @@ extern "C" void vm_var__error(
     VirtualMachine * vm,
     ostringstream *  parsed,
     char **          error_msg,
+    yyscan_t         scanner,
     const char *     str)
 {
     int length;
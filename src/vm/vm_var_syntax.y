@@ -39,31 +39,40 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void vm_var__error(
         YYLTYPE *        llocp,
         mem_collector *  mc,
         VirtualMachine * vm,
         ostringstream *  parsed,
         char **          errmsg,
+        yyscan_t         scanner,
         const char *     str);
 
-    int vm_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int vm_var__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                     yyscan_t scanner);
 
     int vm_var__parse (mem_collector *  mc,
                        VirtualMachine * vm,
                        ostringstream *  parsed,
-                       char **          errmsg);
+                       char **          errmsg,
+                       yyscan_t         scanner);
 
     int vm_var_parse (VirtualMachine * vm,
                       ostringstream *  parsed,
-                      char **          errmsg)
+                      char **          errmsg,
+                      yyscan_t         scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = vm_var__parse(&mc, vm, parsed, errmsg);
+        rc = vm_var__parse(&mc, vm, parsed, errmsg, scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -410,8 +419,10 @@ void insert_vector(VirtualMachine * vm,
 %parse-param {VirtualMachine * vm}
 %parse-param {ostringstream *  parsed}
 %parse-param {char **          errmsg}
+%parse-param {yyscan_t         scanner}
 
 %lex-param {mem_collector * mc}
+%lex-param {yyscan_t        scanner}
 
 %union {
     char * val_str;
@@ -500,6 +511,7 @@ extern "C" void vm_var__error(
     VirtualMachine * vm,
     ostringstream *  parsed,
     char **          error_msg,
+    yyscan_t         scanner,
     const char *     str)
 {
     int length;
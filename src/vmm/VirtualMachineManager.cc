@@ -356,7 +356,45 @@ string * VirtualMachineManager::format_message(
     oss << tmpl
         << "</VMM_DRIVER_ACTION_DATA>";
 
-    return SSLTools::base64_encode(oss.str());
+    return new string(oss.str());
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+string VirtualMachineManager::format_poll_message(
+    const string& hostname,
+    const string& domain)
+{
+    string msg;
+
+    msg.reserve(hostname.size() + domain.size() + 16);
+
+    msg.append("HOST=").append(hostname);
+    msg.append(",DEPLOY_ID=").append(domain);
+
+    return msg;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+string VirtualMachineManager::format_poll_host_message(
+    const string&                     hostname,
+    const vector< pair<int,string> >& vms)
+{
+    ostringstream oss;
+
+    vector< pair<int,string> >::const_iterator it;
+
+    oss << "HOST=" << hostname;
+
+    for (it = vms.begin(); it != vms.end(); it++)
+    {
+        oss << ",VM=" << it->first << ":" << it->second;
+    }
+
+    return oss.str();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -420,14 +458,25 @@ void VirtualMachineManager::deploy_action(int vid)
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->deploy(vid, *drv_msg);
+    rc = vmd->deploy(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "deploy_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "deploy_action, VM has no history";
@@ -461,6 +510,7 @@ void VirtualMachineManager::save_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     string        hostname, vnm_mad;
     string        vm_tmpl;
@@ -519,14 +569,25 @@ void VirtualMachineManager::save_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->save(vid, *drv_msg);
+    rc = vmd->save(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "save_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "save_action, VM has no history";
@@ -560,6 +621,7 @@ void VirtualMachineManager::shutdown_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     string        vm_tmpl;
     string *      drv_msg;
@@ -600,14 +662,25 @@ void VirtualMachineManager::shutdown_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->shutdown(vid, *drv_msg);
+    rc = vmd->shutdown(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "shutdown_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "shutdown_action, VM has no history";
@@ -636,6 +709,7 @@ void VirtualMachineManager::reboot_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     string        vm_tmpl;
     string *      drv_msg;
@@ -676,14 +750,25 @@ void VirtualMachineManager::reboot_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->reboot(vid, *drv_msg);
+    rc = vmd->reboot(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "reboot_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "reboot_action, VM has no history";
@@ -707,6 +792,7 @@ void VirtualMachineManager::reset_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     string        vm_tmpl;
     string *      drv_msg;
@@ -747,14 +833,25 @@ void VirtualMachineManager::reset_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->reset(vid, *drv_msg);
+    rc = vmd->reset(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "reset_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "reset_action, VM has no history";
@@ -783,6 +880,7 @@ void VirtualMachineManager::cancel_action(
     string * drv_msg;
 
     const VirtualMachineManagerDriver *   vmd;
+    int                                   rc;
 
     // Get the VM from the pool
     vm = vmpool->get(vid,true);
@@ -819,14 +917,25 @@ void VirtualMachineManager::cancel_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->cancel(vid, *drv_msg);
+    rc = vmd->cancel(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "cancel_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "cancel_action, VM has no history";
@@ -863,6 +972,7 @@ void VirtualMachineManager::cancel_previous_action(
     string * drv_msg;
 
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     // Get the VM from the pool
     vm = vmpool->get(vid,true);
@@ -899,14 +1009,25 @@ void VirtualMachineManager::cancel_previous_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->cancel(vid, *drv_msg);
+    rc = vmd->cancel(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "cancel_previous_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "cancel_previous_action, VM has no history";
@@ -930,6 +1051,7 @@ void VirtualMachineManager::migrate_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     ostringstream os;
     string   vm_tmpl;
@@ -977,14 +1099,25 @@ void VirtualMachineManager::migrate_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->migrate(vid, *drv_msg);
+    rc = vmd->migrate(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "migrate_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "migrate_action, VM has no history";
@@ -1018,6 +1151,7 @@ void VirtualMachineManager::restore_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     ostringstream os;
 
@@ -1059,14 +1193,25 @@ void VirtualMachineManager::restore_action(
         "",
         vm->to_xml(vm_tmpl));
 
-    vmd->restore(vid, *drv_msg);
+    rc = vmd->restore(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "restore_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "restore_action, VM has no history";
@@ -1095,12 +1240,10 @@ void VirtualMachineManager::poll_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     ostringstream os;
 
-    string   vm_tmpl;
-    string * drv_msg;
-
     // Get the VM from the pool
     vm = vmpool->get(vid,true);
 
@@ -1123,29 +1266,26 @@ void VirtualMachineManager::poll_action(
     }
 
     // Invoke driver method
-    drv_msg = format_message(
-        vm->get_hostname(),
-        vm->get_vnm_mad(),
-        "",
-        "",
-        vm->get_deploy_id(),
-        "",
-        "",
-        "",
-        "",
-        "",
-        vm->to_xml(vm_tmpl));
-
     vm->set_last_poll(time(0));
 
-    vmd->poll(vid, *drv_msg);
+    rc = vmd->poll(vid, format_poll_message(vm->get_hostname(),
+                                            vm->get_deploy_id()));
 
-    delete drv_msg;
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
 
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "poll_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_history:
     os.str("");
     os << "poll_action, VM has no history";
@@ -1221,18 +1361,22 @@ void VirtualMachineManager::timer_action()
 {
     static int mark = 0;
 
-    VirtualMachine *        vm;
-    vector<int>             oids;
-    vector<int>::iterator   it;
-    int                     rc;
-    ostringstream           os;
+    VirtualMachine *                    vm;
+    vector<int>                         oids;
+    vector<int>::iterator               it;
+    vector<PoolObjectSQL *>             vms;
+    int                                 rc;
+    ostringstream                       os;
 
     time_t thetime = time(0);
 
     const VirtualMachineManagerDriver * vmd;
 
-    string   vm_tmpl;
-    string * drv_msg;
+    // VMs of drivers with POLL_HOST support, grouped by host and driver
+    map<pair<int,string>, vector< pair<int,string> > >           host_vms;
+    map<pair<int,string>, vector< pair<int,string> > >::iterator hit;
+    map<int,string>                                              host_names;
+    vector<int>                                                  vids;
 
     mark = mark + timer_period;
 
@@ -1240,6 +1384,8 @@ void VirtualMachineManager::timer_action()
     {
         NebulaLog::log("VMM",Log::INFO,"--Mark--");
         mark = 0;
+
+        log_stats("VMM");
     }
 
     // Clear the expired monitoring records
@@ -1253,6 +1399,10 @@ void VirtualMachineManager::timer_action()
         return;
     }
 
+    // Load the VMs not in the pool cache with a single query. They are not
+    // locked here, each VM is locked only while it is processed
+    vmpool->get_many(oids, vms, false);
+
     for ( it = oids.begin(); it != oids.end(); it++ )
     {
         vm = vmpool->get(*it,true);
@@ -1265,48 +1415,97 @@ void VirtualMachineManager::timer_action()
         if (!vm->hasHistory())
         {
             os.str("");
-            os << "Monitoring VM " << *it << " but it has no history.";
+            os << "Monitoring VM " << vm->get_oid() << " but it has no history.";
             NebulaLog::log("VMM", Log::ERROR, os);
 
             vm->unlock();
             continue;
         }
 
+        vmd = get(vm->get_vmm_mad());
+
+        // The VM is polled in the next timer when the driver catches up
+        if ( vmd == 0 || vmd->busy() )
+        {
+            vm->unlock();
+            continue;
+        }
+
         os.str("");
 
-        os << "Monitoring VM " << *it << ".";
+        os << "Monitoring VM " << vm->get_oid() << ".";
         NebulaLog::log("VMM", Log::INFO, os);
 
-        vm->set_last_poll(thetime);
+        // The VMs are polled in the next loop, with one message per host
+        if ( vmd->is_poll_host() )
+        {
+            host_vms[make_pair(vm->get_hid(), vm->get_vmm_mad())].push_back(
+                make_pair(vm->get_oid(), vm->get_deploy_id()));
 
-        vmd = get(vm->get_vmm_mad());
+            host_names[vm->get_hid()] = vm->get_hostname();
 
-        if ( vmd == 0 )
-        {
             vm->unlock();
             continue;
         }
 
-        drv_msg = format_message(
-            vm->get_hostname(),
-            vm->get_vnm_mad(),
-            "",
-            "",
-            vm->get_deploy_id(),
-            "",
-            "",
-            "",
-            "",
-            "",
-            vm->to_xml(vm_tmpl));
+        // The VM is only set as polled if the message is sent
+        rc = vmd->poll(vm->get_oid(), format_poll_message(vm->get_hostname(),
+                                                          vm->get_deploy_id()));
+        if ( rc == 0 )
+        {
+            vm->set_last_poll(thetime);
+
+            vmpool->update(vm);
+        }
+
+        vm->unlock();
+    }
+
+    // One POLL_HOST action per host for the drivers that support it
+    for ( hit = host_vms.begin(); hit != host_vms.end(); hit++ )
+    {
+        vmd = get(hit->first.second);
+
+        if ( vmd == 0 || vmd->busy() )
+        {
+            continue;
+        }
+
+        os.str("");
 
-        vmd->poll(*it, *drv_msg);
+        os << "Monitoring VMs in host " << hit->first.first << ".";
+        NebulaLog::log("VMM", Log::INFO, os);
 
-        delete drv_msg;
+        vids.clear();
 
-        vmpool->update(vm);
+        for (unsigned int i = 0; i < hit->second.size(); i++)
+        {
+            vids.push_back(hit->second[i].first);
+        }
 
-        vm->unlock();
+        rc = vmd->poll_host(hit->first.first, vids,
+            format_poll_host_message(host_names[hit->first.first],hit->second));
+
+        if ( rc != 0 )
+        {
+            continue;
+        }
+
+        for (unsigned int i = 0; i < vids.size(); i++)
+        {
+            vm = vmpool->get(vids[i], true);
+
+            if ( vm == 0 )
+            {
+                continue;
+            }
+
+            vm->set_last_poll(thetime);
+
+            vmpool->update(vm);
+
+            vm->unlock();
+        }
     }
 }
 
@@ -1404,14 +1603,25 @@ void VirtualMachineManager::attach_action(
         vm->to_xml(vm_tmpl));
 
 
-    vmd->attach(vid, *drv_msg);
+    rc = vmd->attach(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "attach_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_disk:
     os.str("");
     os << "attach_action, could not find disk to attach";
@@ -1451,6 +1661,7 @@ void VirtualMachineManager::detach_action(
 {
     VirtualMachine *                    vm;
     const VirtualMachineManagerDriver * vmd;
+    int                                 rc;
 
     ostringstream os;
     string        vm_tmpl;
@@ -1523,14 +1734,25 @@ void VirtualMachineManager::detach_action(
         disk_path,
         vm->to_xml(vm_tmpl));
 
-    vmd->detach(vid, *drv_msg);
+    rc = vmd->detach(vid, *drv_msg);
 
     delete drv_msg;
 
+    if ( rc != 0 )
+    {
+        goto error_write;
+    }
+
     vm->unlock();
 
     return;
 
+error_write:
+    os.str("");
+    os << "detach_action, driver " << vm->get_vmm_mad()
+       << " is busy, could not send the action";
+    goto error_common;
+
 error_disk:
     os.str("");
     os << "detach_action, could not find disk to detach";
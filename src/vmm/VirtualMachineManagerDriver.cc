@@ -19,21 +19,38 @@
 #include "LifeCycleManager.h"
 
 #include "Nebula.h"
+#include "SSLTools.h"
 #include <sstream>
+#include <algorithm>
 
 VirtualMachineManagerDriver::VirtualMachineManagerDriver(
     int                         userid,
     const map<string,string>&   attrs,
     bool                        sudo,
     VirtualMachinePool *        pool):
-        Mad(userid,attrs,sudo),driver_conf(true),vmpool(pool)
+        Mad(userid,attrs,sudo),driver_conf(true),vmpool(pool),
+        poll_host_enabled(false)
 {
     map<string,string>::const_iterator  it;
+
+    pthread_mutex_init(&poll_host_mutex, 0);
     char *          error_msg = 0;
     const char *    cfile;
     string          file;
     int             rc;
 
+    it = attrs.find("POLL_HOST");
+
+    if ( it != attrs.end() )
+    {
+        string poll_host = it->second;
+
+        transform(poll_host.begin(), poll_host.end(), poll_host.begin(),
+                  (int(*)(int))toupper);
+
+        poll_host_enabled = (poll_host == "YES");
+    }
+
     it = attrs.find("DEFAULT");
 
     if ( it != attrs.end() )
@@ -102,6 +119,62 @@ void VirtualMachineManagerDriver::get_default(
 /* MAD Interface                                                              */
 /* ************************************************************************** */
 
+int VirtualMachineManagerDriver::write_drv_xml(
+    const char *    aname,
+    const int       oid,
+    const string&   xml) const
+{
+    ostringstream os;
+
+    os << aname << " " << oid << " ";
+
+    if ( framed() )
+    {
+        os << xml << endl;
+    }
+    else
+    {
+        string * xml64 = SSLTools::base64_encode(xml);
+
+        os << *xml64 << endl;
+
+        delete xml64;
+    }
+
+    return write(os);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int VirtualMachineManagerDriver::poll_host(
+    const int           hid,
+    const vector<int>&  vids,
+    const string&       drv_msg) const
+{
+    int rc;
+
+    // The VMs are set before sending, the response may arrive before write
+    // returns
+    pthread_mutex_lock(&poll_host_mutex);
+
+    poll_host_vms[hid] = vids;
+
+    pthread_mutex_unlock(&poll_host_mutex);
+
+    rc = write_drv("POLL_HOST", hid, drv_msg);
+
+    if ( rc != 0 )
+    {
+        pthread_mutex_lock(&poll_host_mutex);
+
+        poll_host_vms.erase(hid);
+
+        pthread_mutex_unlock(&poll_host_mutex);
+    }
+
+    return rc;
+}
+
 /* -------------------------------------------------------------------------- */
 /* Helpers for the protocol function                                          */
 /* -------------------------------------------------------------------------- */
@@ -178,6 +251,17 @@ void VirtualMachineManagerDriver::protocol(
     else
         return;
 
+    // POLL_HOST messages are identified by the host id
+    if ( action == "POLL_HOST" )
+    {
+        string info;
+
+        getline(is,info);
+
+        process_poll_host(id, result, info);
+        return;
+    }
+
     // Get the VM from the pool
     vm = vmpool->get(id,true);
 
@@ -377,172 +461,326 @@ void VirtualMachineManagerDriver::protocol(
     {
         if (result == "SUCCESS")
         {
-            size_t          pos;
+            string monitor_str;
 
-            string          tmp;
-            string          var;
-            ostringstream   os;
-            istringstream   tiss;
+            getline(is,monitor_str);
 
-            int             cpu    = -1;
-            int             memory = -1;
-            long long       net_tx = -1;
-            long long       net_rx = -1;
-            char            state  = '-';
+            process_poll(vm, monitor_str);
+        }
+        else
+        {
+            log_error(vm,os,is,"Error monitoring VM");
+            vmpool->update(vm);
 
-            string monitor_str = is.str();
-            bool   parse_error = false;
+            vm->log("VMM",Log::ERROR,os);
+        }
+    }
+    else if (action == "LOG")
+    {
+        string info;
 
-            while(is.good())
-            {
-                is >> tmp >> ws;
-
-                pos = tmp.find('=');
-
-                if ( pos == string::npos )
-                {
-                    parse_error = true;
-                    continue;
-                }
-
-                tmp.replace(pos,1," ");
-
-                tiss.clear();
-
-                tiss.str(tmp);
-
-                tiss >> var >> ws;
-
-                if (!tiss.good())
-                {
-                    parse_error = true;
-                    continue;
-                }
-
-                if (var == "USEDMEMORY")
-                {
-                    tiss >> memory;
-                }
-                else if (var == "USEDCPU")
-                {
-                    tiss >> cpu;
-                }
-                else if (var == "NETRX")
-                {
-                    tiss >> net_rx;
-                }
-                else if (var == "NETTX")
-                {
-                    tiss >> net_tx;
-                }
-                else if (var == "STATE")
-                {
-                    tiss >> state;
-                }
-                else if (!var.empty())
-                {
-                    string val;
-
-                    os.str("");
-                    os << "Adding custom monitoring attribute: " << tmp;
-
-                    vm->log("VMM",Log::WARNING,os);
-
-                    tiss >> val;
-
-                    vm->replace_template_attribute(var,val);
-                }
-            }
+        getline(is,info);
+        vm->log("VMM",log_type(result[0]),info.c_str());
+    }
 
-            if (parse_error)
-            {
-                os.str("");
-                os << "Error parsing monitoring str:\"" << monitor_str <<"\"";
+    vm->unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
 
-                vm->log("VMM",Log::ERROR,os);
+void VirtualMachineManagerDriver::process_poll(
+    VirtualMachine * vm,
+    const string&    monitor_str)
+{
+    size_t          pos;
 
-                vm->set_template_error_message(os.str());
-                vmpool->update(vm);
+    string          tmp;
+    string          var;
+    ostringstream   os;
+    istringstream   tiss;
 
-                vm->unlock();
-                return;
-            }
+    int             cpu    = -1;
+    int             memory = -1;
+    long long       net_tx = -1;
+    long long       net_rx = -1;
+    char            state  = '-';
 
-            vm->update_info(memory,cpu,net_tx,net_rx);
-            vm->set_vm_info();
+    bool            parse_error = false;
+    istringstream   is(monitor_str);
 
-            vmpool->update(vm);
-            vmpool->update_history(vm);
-            vmpool->update_monitoring(vm);
+    // Nothing to update, the driver got no information of the VM
+    if ( monitor_str.empty() )
+    {
+        return;
+    }
+
+    while(is.good())
+    {
+        is >> tmp >> ws;
+
+        pos = tmp.find('=');
 
-            if (state != '-' &&
-                (vm->get_lcm_state() == VirtualMachine::RUNNING ||
-                 vm->get_lcm_state() == VirtualMachine::UNKNOWN))
+        if ( pos == string::npos )
+        {
+            parse_error = true;
+            continue;
+        }
+
+        tmp.replace(pos,1," ");
+
+        tiss.clear();
+
+        tiss.str(tmp);
+
+        tiss >> var >> ws;
+
+        if (!tiss.good())
+        {
+            parse_error = true;
+            continue;
+        }
+
+        if (var == "USEDMEMORY")
+        {
+            tiss >> memory;
+        }
+        else if (var == "USEDCPU")
+        {
+            tiss >> cpu;
+        }
+        else if (var == "NETRX")
+        {
+            tiss >> net_rx;
+        }
+        else if (var == "NETTX")
+        {
+            tiss >> net_tx;
+        }
+        else if (var == "STATE")
+        {
+            tiss >> state;
+        }
+        else if (!var.empty())
+        {
+            string val;
+
+            os.str("");
+            os << "Adding custom monitoring attribute: " << tmp;
+
+            vm->log("VMM",Log::WARNING,os);
+
+            tiss >> val;
+
+            vm->replace_template_attribute(var,val);
+        }
+    }
+
+    if (parse_error)
+    {
+        os.str("");
+        os << "Error parsing monitoring str:\"" << monitor_str <<"\"";
+
+        vm->log("VMM",Log::ERROR,os);
+
+        vm->set_template_error_message(os.str());
+        vmpool->update(vm);
+
+        return;
+    }
+
+    vm->update_info(memory,cpu,net_tx,net_rx);
+    vm->set_vm_info();
+
+    vmpool->update(vm);
+    vmpool->update_history(vm);
+    vmpool->update_monitoring(vm);
+
+    if (state != '-' &&
+        (vm->get_lcm_state() == VirtualMachine::RUNNING ||
+         vm->get_lcm_state() == VirtualMachine::UNKNOWN))
+    {
+        Nebula              &ne  = Nebula::instance();
+        LifeCycleManager *  lcm = ne.get_lcm();
+
+        switch (state)
+        {
+        case 'a': // Still active, good!
+            os.str("");
+            os  << "Monitor Information:\n"
+                << "\tCPU   : "<< cpu    << "\n"
+                << "\tMemory: "<< memory << "\n"
+                << "\tNet_TX: "<< net_tx << "\n"
+                << "\tNet_RX: "<< net_rx;
+            vm->log("VMM",Log::DEBUG,os);
+
+            if ( vm->get_lcm_state() == VirtualMachine::UNKNOWN)
             {
-                Nebula              &ne  = Nebula::instance();
-                LifeCycleManager *  lcm = ne.get_lcm();
-
-                switch (state)
-                {
-                case 'a': // Still active, good!
-                    os.str("");
-                    os  << "Monitor Information:\n"
-                        << "\tCPU   : "<< cpu    << "\n"
-                        << "\tMemory: "<< memory << "\n"
-                        << "\tNet_TX: "<< net_tx << "\n"
-                        << "\tNet_RX: "<< net_rx;
-                    vm->log("VMM",Log::DEBUG,os);
-
-                    if ( vm->get_lcm_state() == VirtualMachine::UNKNOWN)
-                    {
-                        vm->log("VMM",Log::INFO,"VM was now found, new state is"
-                                " RUNNING");
-                        vm->set_state(VirtualMachine::RUNNING);
-                        vmpool->update(vm);
-                    }
-                    break;
-
-                case 'p': // It's paused
-                    vm->log("VMM",Log::INFO,"VM running but new state "
-                            "from monitor is PAUSED.");
-
-                    lcm->trigger(LifeCycleManager::MONITOR_SUSPEND, id);
-                    break;
-
-                case 'e': //Failed
-                    vm->log("VMM",Log::INFO,"VM running but new state "
-                            "from monitor is ERROR.");
-
-                    lcm->trigger(LifeCycleManager::MONITOR_FAILURE, id);
-                    break;
-
-                case 'd': //The VM was not found
-                    vm->log("VMM",Log::INFO,"VM running but it was not found."
-                            " Restart and delete actions available or try to"
-                            " recover it manually");
-
-                    lcm->trigger(LifeCycleManager::MONITOR_DONE, id);
-                    break;
-                }
+                vm->log("VMM",Log::INFO,"VM was now found, new state is"
+                        " RUNNING");
+                vm->set_state(VirtualMachine::RUNNING);
+                vmpool->update(vm);
             }
+            break;
+
+        case 'p': // It's paused
+            vm->log("VMM",Log::INFO,"VM running but new state "
+                    "from monitor is PAUSED.");
+
+            lcm->trigger(LifeCycleManager::MONITOR_SUSPEND, vm->get_oid());
+            break;
+
+        case 'e': //Failed
+            vm->log("VMM",Log::INFO,"VM running but new state "
+                    "from monitor is ERROR.");
+
+            lcm->trigger(LifeCycleManager::MONITOR_FAILURE, vm->get_oid());
+            break;
+
+        case 'd': //The VM was not found
+            vm->log("VMM",Log::INFO,"VM running but it was not found."
+                    " Restart and delete actions available or try to"
+                    " recover it manually");
+
+            lcm->trigger(LifeCycleManager::MONITOR_DONE, vm->get_oid());
+            break;
         }
-        else
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void VirtualMachineManagerDriver::process_poll_host(
+    int           hid,
+    const string& result,
+    const string& info)
+{
+    ostringstream        os;
+    Template             tmpl;
+    char *               error_msg = 0;
+    int                  rc;
+    VirtualMachine *     vm;
+
+    vector<int>                    vids;
+    map<int, vector<int> >::iterator  vit;
+
+    vector<Attribute *>            vms;
+    vector<Attribute *>::iterator  it;
+
+    pthread_mutex_lock(&poll_host_mutex);
+
+    vit = poll_host_vms.find(hid);
+
+    if ( vit != poll_host_vms.end() )
+    {
+        vids.swap(vit->second);
+
+        poll_host_vms.erase(vit);
+    }
+
+    pthread_mutex_unlock(&poll_host_mutex);
+
+    if ( result != "SUCCESS" )
+    {
+        os << "Error monitoring VM";
+
+        if ( !info.empty() && info[0] != '-' )
         {
-            log_error(vm,os,is,"Error monitoring VM");
-            vmpool->update(vm);
+            os << ": " << info;
+        }
 
-            vm->log("VMM",Log::ERROR,os);
+        goto error_common;
+    }
+
+    rc = tmpl.parse(info, &error_msg);
+
+    if ( rc != 0 )
+    {
+        os << "Error parsing monitoring information";
+
+        if ( error_msg != 0 )
+        {
+            os << ": " << error_msg;
+            free(error_msg);
         }
+
+        goto error_common;
     }
-    else if (action == "LOG")
+
+    tmpl.get("VM", vms);
+
+    for (it = vms.begin(); it != vms.end(); it++)
     {
-        string info;
+        VectorAttribute * vattr = dynamic_cast<VectorAttribute *>(*it);
+        int               vid;
 
-        getline(is,info);
-        vm->log("VMM",log_type(result[0]),info.c_str());
+        if ( vattr == 0 || vattr->vector_value("ID", vid) != 0 )
+        {
+            continue;
+        }
+
+        vm = get_host_vm(vid, hid);
+
+        if ( vm == 0 )
+        {
+            continue;
+        }
+
+        process_poll(vm, vattr->vector_value("POLL"));
+
+        vm->unlock();
     }
 
-    vm->unlock();
+    return;
+
+error_common:
+    // The error is reported in each VM of the request, as for a POLL
+    for (unsigned int i = 0; i < vids.size(); i++)
+    {
+        vm = get_host_vm(vids[i], hid);
+
+        if ( vm == 0 )
+        {
+            continue;
+        }
+
+        vm->set_template_error_message(os.str());
+
+        vm->log("VMM", Log::ERROR, os);
+
+        vmpool->update(vm);
+
+        vm->unlock();
+    }
+
+    os << " (host " << hid << ")";
+
+    NebulaLog::log("VMM", Log::ERROR, os);
+}
+
+/* -------------------------------------------------------------------------- */
+
+VirtualMachine * VirtualMachineManagerDriver::get_host_vm(int vid, int hid)
+{
+    VirtualMachine * vm = vmpool->get(vid, true);
+
+    if ( vm == 0 )
+    {
+        return 0;
+    }
+
+    // The VM may have left the host since the POLL_HOST was sent
+    if ( !vm->hasHistory() || vm->get_hid() != hid ||
+         vm->get_lcm_state() == VirtualMachine::CLEANUP ||
+         vm->get_lcm_state() == VirtualMachine::FAILURE ||
+         vm->get_lcm_state() == VirtualMachine::LCM_INIT )
+    {
+        vm->unlock();
+        return 0;
+    }
+
+    return vm;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -61,6 +61,7 @@ class DummyDriver < VirtualMachineDriver
         `mkdir #{DUMMY_ACTIONS_DIR}`
 
         @actions_counter = Hash.new(0)
+        @net_counters    = Hash.new
     end
 
     def deploy(id, drv_message)
@@ -77,6 +78,8 @@ class DummyDriver < VirtualMachineDriver
     def shutdown(id, drv_message)
         result = retrieve_result("shutdown")
 
+        @net_counters.delete(id) if result == RESULT[:success]
+
         send_message(ACTION[:shutdown],result,id)
     end
 
@@ -95,12 +98,16 @@ class DummyDriver < VirtualMachineDriver
     def cancel(id, drv_message)
         result = retrieve_result("cancel")
 
+        @net_counters.delete(id) if result == RESULT[:success]
+
         send_message(ACTION[:cancel],result,id)
     end
 
     def save(id, drv_message)
         result = retrieve_result("save")
 
+        @net_counters.delete(id) if result == RESULT[:success]
+
         send_message(ACTION[:save],result,id)
     end
 
@@ -131,33 +138,21 @@ class DummyDriver < VirtualMachineDriver
     def poll(id, drv_message)
         result = retrieve_result("poll")
 
-        msg = decode(drv_message)
-
+        # The poll message does not include the VM template, use default
+        # capacity and keep the network counters in the driver until the VM
+        # is shut down, cancelled or saved
         max_memory = 256
-        if msg.elements["VM/TEMPLATE/MEMORY"]
-            max_memory = msg.elements["VM/TEMPLATE/MEMORY"].text.to_i * 1024
-        end
+        max_cpu    = 100
 
-        max_cpu = 100
-        if msg.elements["VM/TEMPLATE/CPU"]
-            max_cpu = msg.elements["VM/TEMPLATE/CPU"].text.to_i * 100
-        end
+        prev_nettx, prev_netrx = @net_counters[id] || [0, 0]
 
-        prev_nettx = 0
-        if msg.elements["VM/NET_TX"]
-            prev_nettx = msg.elements["VM/NET_TX"].text.to_i
-        end
-
-        prev_netrx = 0
-        if msg.elements["VM/NET_RX"]
-            prev_netrx = msg.elements["VM/NET_RX"].text.to_i
-        end
+        @net_counters[id] = [prev_nettx+(50*rand(3)), prev_netrx+(100*rand(4))]
 
         # monitor_info: string in the form "VAR=VAL VAR=VAL ... VAR=VAL"
         # known VAR are in POLL_ATTRIBUTES. VM states VM_STATES
         monitor_info = "#{POLL_ATTRIBUTE[:state]}=#{VM_STATE[:active]} " \
-                       "#{POLL_ATTRIBUTE[:nettx]}=#{prev_nettx+(50*rand(3))} " \
-                       "#{POLL_ATTRIBUTE[:netrx]}=#{prev_netrx+(100*rand(4))} " \
+                       "#{POLL_ATTRIBUTE[:nettx]}=#{@net_counters[id][0]} " \
+                       "#{POLL_ATTRIBUTE[:netrx]}=#{@net_counters[id][1]} " \
                        "#{POLL_ATTRIBUTE[:usedmemory]}=#{max_memory * (rand(80)+20)/100} " \
                        "#{POLL_ATTRIBUTE[:usedcpu]}=#{max_cpu * (rand(95)+5)/100}" 
 
@@ -250,9 +250,7 @@ class EC2Driver < VirtualMachineDriver
 
     # Get info (IP, and state) for a EC2 instance
     def poll(id, drv_message)
-        msg = decode(drv_message)
-
-        deploy_id = msg.elements["DEPLOY_ID"].text
+        deploy_id = decode_poll(drv_message)[:deploy_id]
 
         info =  "#{POLL_ATTRIBUTE[:usedmemory]}=0 " \
                 "#{POLL_ATTRIBUTE[:usedcpu]}=0 " \
@@ -238,7 +238,8 @@ class ExecDriver < VirtualMachineDriver
     # @param [OpenNebulaDriver::options]
     def initialize(hypervisor, options={})
         @options={
-            :threaded => true
+            :threaded => true,
+            :framed   => true
         }.merge!(options)
 
         if options[:shell]
@@ -489,13 +490,51 @@ class ExecDriver < VirtualMachineDriver
     # POLL action, gets information of a VM
     #
     def poll(id, drv_message)
-        data      = decode(drv_message)
-        host      = data.elements['HOST'].text
-        deploy_id = data.elements['DEPLOY_ID'].text
+        data      = decode_poll(drv_message)
+        host      = data[:host]
+        deploy_id = data[:deploy_id]
 
         do_action("#{deploy_id} #{host}", id, host, ACTION[:poll])
     end
 
+    #
+    # POLL_HOST action, gets information of all the VMs running in a host
+    # with a single execution of the poll script. The id is the host id, the
+    # result is a VM=[ID=...,DEPLOY_ID=...,POLL="..."] attribute per VM.
+    #
+    def poll_host(id, drv_message)
+        data = decode_poll(drv_message)
+        host = data[:host]
+        vms  = data[:vms]
+
+        # Logs are not related to a VM, use "-" as id so they go to oned.log
+        result, info = do_action("--all", "-", host, ACTION[:poll],
+                                 :respond => false)
+
+        if result == RESULT[:failure]
+            send_message(ACTION[:poll_host], result, id, info)
+            return
+        end
+
+        polled = {}
+
+        info.each_line do |line|
+            deploy_id, poll = line.strip.split(/\s+/, 2)
+            polled[deploy_id] = poll if deploy_id
+        end
+
+        monitor = vms.map do |deploy_id, vm_id|
+            poll = polled[deploy_id] || "#{POLL_ATTRIBUTE[:state]}=" \
+                                        "#{VM_STATE[:deleted]}"
+
+            "VM=[ID=#{vm_id},DEPLOY_ID=#{deploy_id}," \
+                "POLL=\"#{poll.gsub('"', '\\"')}\"]"
+        end
+
+        send_message(ACTION[:poll_host], RESULT[:success], id,
+                     monitor.join(' '))
+    end
+
     #
     # REBOOT action, reboots a running VM
     #
@@ -332,6 +332,21 @@ def print_one_vm_info(hypervisor, vm_id)
     puts values.zip.join(' ')
 end
 
+# Prints a line per VM in the host: "<deploy_id> VAR=VAL VAR=VAL ..."
+def print_host_vm_info(hypervisor)
+    vms=hypervisor.get_all_vm_info
+
+    exit(-1) if !vms
+
+    vms.each do |name, info|
+        values=info.map do |key, value|
+            print_data(key, value) if key != :name
+        end
+
+        puts "#{name} #{values.compact.join(' ')}"
+    end
+end
+
 def print_all_vm_info(hypervisor)
     require 'yaml'
     require 'base64'
@@ -354,7 +369,9 @@ load_vars(hypervisor)
 
 vm_id=ARGV[0]
 
-if vm_id
+if vm_id == '--all'
+    print_host_vm_info(hypervisor)
+elsif vm_id
     print_one_vm_info(hypervisor, vm_id)
 else
     print_all_vm_info(hypervisor)
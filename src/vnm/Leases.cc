@@ -261,6 +261,8 @@ int Leases::Lease::from_xml(const string &xml_str)
     rc += xpath(int_used          , "/LEASE/USED"       , 0);
     rc += xpath(vid               , "/LEASE/VID"        , 0);
 
+    free_xml();
+
     used = static_cast<bool>(int_used);
 
     if (rc != 0)
@@ -325,13 +327,12 @@ int Leases::select(SqlDB * db)
     // Reset the used leases counter
     n_used = 0;
 
-    set_callback(static_cast<Callbackable::Callback>(&Leases::select_cb));
+    SqlCallback cb(this,
+                   static_cast<Callbackable::Callback>(&Leases::select_cb));
 
     oss << "SELECT body FROM " << table << " WHERE oid = " << oid;
 
-    rc = db->exec(oss,this);
-
-    unset_callback();
+    rc = db->exec(oss, &cb);
 
     if (rc != 0)
     {
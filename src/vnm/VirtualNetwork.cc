@@ -88,38 +88,6 @@ const char * VirtualNetwork::db_bootstrap = "CREATE TABLE IF NOT EXISTS"
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-int VirtualNetwork::select(SqlDB * db)
-{
-    int             rc;
-
-    rc = PoolObjectSQL::select(db);
-
-    if ( rc != 0 )
-    {
-        return rc;
-    }
-
-    return select_leases(db);
-}
-
-/* -------------------------------------------------------------------------- */
-
-int VirtualNetwork::select(SqlDB * db, const string& name, int uid)
-{
-    int             rc;
-
-    rc = PoolObjectSQL::select(db,name,uid);
-
-    if ( rc != 0 )
-    {
-        return rc;
-    }
-
-    return select_leases(db);
-}
-
-/* -------------------------------------------------------------------------- */
-
 int VirtualNetwork::select_leases(SqlDB * db)
 {
     ostringstream   oss;
@@ -347,32 +315,14 @@ error_common:
 int VirtualNetwork::insert_replace(SqlDB *db, bool replace, string& error_str)
 {
     ostringstream   oss;
-    int             rc;
-
+    SqlParams       params;
 
     string xml_body;
 
-    char * sql_name;
-    char * sql_xml;
-
-
-    sql_name = db->escape_str(name.c_str());
-
-    if ( sql_name == 0 )
+    if ( validate_xml(to_xml(xml_body)) != 0 )
     {
-        goto error_name;
-    }
-
-    sql_xml = db->escape_str(to_xml(xml_body).c_str());
-
-    if ( sql_xml == 0 )
-    {
-        goto error_body;
-    }
-
-    if ( validate_xml(sql_xml) != 0 )
-    {
-        goto error_xml;
+        error_str = "Error transforming the Virtual Network to XML.";
+        return -1;
     }
 
     // Construct the SQL statement to Insert or Replace
@@ -386,41 +336,18 @@ int VirtualNetwork::insert_replace(SqlDB *db, bool replace, string& error_str)
     }
 
     oss << " INTO " << table << " (" << db_names << ") VALUES ("
-        <<          oid         << ","
-        << "'" <<   sql_name    << "',"
-        << "'" <<   sql_xml     << "',"
-        <<          uid         << ","
-        <<          gid         << ","
-        <<          owner_u     << ","
-        <<          group_u     << ","
-        <<          other_u     << ")";
-
-    rc = db->exec(oss);
-
-    db->free_str(sql_name);
-    db->free_str(sql_xml);
-
-    return rc;
-
-error_xml:
-    db->free_str(sql_name);
-    db->free_str(sql_xml);
-
-    error_str = "Error transforming the Virtual Network to XML.";
-
-    goto error_common;
-
-error_body:
-    db->free_str(sql_name);
-    goto error_generic;
-
-error_name:
-    goto error_generic;
-
-error_generic:
-    error_str = "Error inserting Virtual Network in DB.";
-error_common:
-    return -1;
+        << "?,?,?,?,?,?,?,?)";
+
+    params.add(oid)
+          .add(name)
+          .add(xml_body)
+          .add(uid)
+          .add(gid)
+          .add(owner_u)
+          .add(group_u)
+          .add(other_u);
+
+    return db->exec(oss, params);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -90,6 +90,11 @@ vector<string> ObjectXML::operator[] (const char * xpath_expr)
     xmlXPathObjectPtr obj;
     vector<string>    content;
 
+    if ( ctx == 0 )
+    {
+        return content;
+    }
+
     obj = xmlXPathEvalExpression(
         reinterpret_cast<const xmlChar *>(xpath_expr), ctx);
 
@@ -340,6 +345,11 @@ int ObjectXML::get_nodes (const char * xpath_expr, vector<xmlNodePtr>& content)
 {
     xmlXPathObjectPtr obj;
 
+    if ( ctx == 0 )
+    {
+        return 0;
+    }
+
     obj = xmlXPathEvalExpression(
         reinterpret_cast<const xmlChar *>(xpath_expr), ctx);
 
@@ -377,15 +387,7 @@ int ObjectXML::get_nodes (const char * xpath_expr, vector<xmlNodePtr>& content)
 
 int ObjectXML::update_from_str(const string &xml_doc)
 {
-    if (xml != 0)
-    {
-        xmlFreeDoc(xml);
-    }
-
-    if ( ctx != 0)
-    {
-        xmlXPathFreeContext(ctx);
-    }
+    free_xml();
 
     try
     {
@@ -404,15 +406,7 @@ int ObjectXML::update_from_str(const string &xml_doc)
 
 int ObjectXML::update_from_node(const xmlNodePtr node)
 {
-    if (xml != 0)
-    {
-        xmlFreeDoc(xml);
-    }
-
-    if ( ctx != 0)
-    {
-        xmlXPathFreeContext(ctx);
-    }
+    free_xml();
 
     xml = xmlNewDoc(reinterpret_cast<const xmlChar *>("1.0"));
 
@@ -425,7 +419,7 @@ int ObjectXML::update_from_node(const xmlNodePtr node)
 
     if (ctx == 0)
     {
-        xmlFreeDoc(xml);
+        free_xml();
         return -1;
     }
 
@@ -433,8 +427,7 @@ int ObjectXML::update_from_node(const xmlNodePtr node)
 
     if (root_node == 0)
     {
-        xmlXPathFreeContext(ctx);
-        xmlFreeDoc(xml);
+        free_xml();
         return -1;
     }
 
@@ -446,6 +439,24 @@ int ObjectXML::update_from_node(const xmlNodePtr node)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+void ObjectXML::free_xml()
+{
+    if ( ctx != 0 )
+    {
+        xmlXPathFreeContext(ctx);
+        ctx = 0;
+    }
+
+    if ( xml != 0 )
+    {
+        xmlFreeDoc(xml);
+        xml = 0;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 int ObjectXML::validate_xml(const string &xml_doc)
 {
     xmlDocPtr tmp_xml = 0;
@@ -477,7 +488,7 @@ void ObjectXML::xml_parse(const string &xml_doc)
 
     if (ctx == 0)
     {
-        xmlFreeDoc(xml);
+        free_xml();
         throw runtime_error("Unable to create new XPath context");
     }
 }
@@ -489,17 +500,30 @@ void ObjectXML::xml_parse(const string &xml_doc)
 
 extern "C"
 {
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     typedef struct yy_buffer_state * YY_BUFFER_STATE;
 
-    int expr_bool_parse(ObjectXML * oxml, bool& result, char ** errmsg);
+    int expr_bool_parse(ObjectXML * oxml,
+                        bool&       result,
+                        char **     errmsg,
+                        yyscan_t    scanner);
 
-    int expr_arith_parse(ObjectXML * oxml, int& result, char ** errmsg);
+    int expr_arith_parse(ObjectXML * oxml,
+                         int&        result,
+                         char **     errmsg,
+                         yyscan_t    scanner);
 
-    int expr_lex_destroy();
+    int expr_lex_init(yyscan_t * scanner);
 
-    YY_BUFFER_STATE expr__scan_string(const char * str);
+    int expr_lex_destroy(yyscan_t scanner);
 
-    void expr__delete_buffer(YY_BUFFER_STATE);
+    YY_BUFFER_STATE expr__scan_string(const char * str, yyscan_t scanner);
+
+    void expr__delete_buffer(YY_BUFFER_STATE, yyscan_t scanner);
 }
 
 /* ------------------------------------------------------------------------ */
@@ -510,23 +534,30 @@ int ObjectXML::eval_bool(const string& expr, bool& result, char **errmsg)
     YY_BUFFER_STATE     str_buffer = 0;
     const char *        str;
     int                 rc;
+    yyscan_t            scanner;
 
     *errmsg = 0;
 
+    if ( expr_lex_init(&scanner) != 0 )
+    {
+        *errmsg = strdup("Error initializing expression scanner");
+        return -1;
+    }
+
     str = expr.c_str();
 
-    str_buffer = expr__scan_string(str);
+    str_buffer = expr__scan_string(str, scanner);
 
     if (str_buffer == 0)
     {
         goto error_yy;
     }
 
-    rc = expr_bool_parse(this,result,errmsg);
+    rc = expr_bool_parse(this, result, errmsg, scanner);
 
-    expr__delete_buffer(str_buffer);
+    expr__delete_buffer(str_buffer, scanner);
 
-    expr_lex_destroy();
+    expr_lex_destroy(scanner);
 
     return rc;
 
@@ -534,6 +565,8 @@ error_yy:
 
     *errmsg=strdup("Error setting scan buffer");
 
+    expr_lex_destroy(scanner);
+
     return -1;
 }
 
@@ -545,23 +578,30 @@ int ObjectXML::eval_arith(const string& expr, int& result, char **errmsg)
     YY_BUFFER_STATE     str_buffer = 0;
     const char *        str;
     int                 rc;
+    yyscan_t            scanner;
 
     *errmsg = 0;
 
+    if ( expr_lex_init(&scanner) != 0 )
+    {
+        *errmsg = strdup("Error initializing expression scanner");
+        return -1;
+    }
+
     str = expr.c_str();
 
-    str_buffer = expr__scan_string(str);
+    str_buffer = expr__scan_string(str, scanner);
 
     if (str_buffer == 0)
     {
         goto error_yy;
     }
 
-    rc = expr_arith_parse(this,result,errmsg);
+    rc = expr_arith_parse(this, result, errmsg, scanner);
 
-    expr__delete_buffer(str_buffer);
+    expr__delete_buffer(str_buffer, scanner);
 
-    expr_lex_destroy();
+    expr_lex_destroy(scanner);
 
     return rc;
 
@@ -569,6 +609,8 @@ error_yy:
 
     *errmsg=strdup("Error setting scan buffer");
 
+    expr_lex_destroy(scanner);
+
     return -1;
 }
 
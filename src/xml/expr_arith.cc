@@ -94,29 +94,38 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void expr_arith__error(
         YYLTYPE *       llocp,
         mem_collector * mc,
         ObjectXML *     oxml,
         int&            result,
         char **         error_msg,
+        yyscan_t        scanner,
         const char *    str);
 
-    int expr_arith__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int expr_arith__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                         yyscan_t scanner);
 
     int expr_arith__parse(mem_collector * mc,
                           ObjectXML *     oxml,
                           int&            result,
-                          char **         errmsg);
+                          char **         errmsg,
+                          yyscan_t        scanner);
 
-    int expr_arith_parse(ObjectXML *oxml, int& result, char ** errmsg)
+    int expr_arith_parse(ObjectXML *oxml, int& result, char ** errmsg,
+                         yyscan_t scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = expr_arith__parse(&mc,oxml,result,errmsg);
+        rc = expr_arith__parse(&mc,oxml,result,errmsg,scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -126,7 +135,7 @@ extern "C"
 
 
 /* Line 360 of yacc.c  */
-#line 130 "expr_arith.cc"
+#line 139 "expr_arith.cc"
 
 # ifndef YY_NULL
 #  if defined __cplusplus && 201103L <= __cplusplus
@@ -173,7 +182,7 @@ extern int expr_arith__debug;
 typedef union YYSTYPE
 {
 /* Line 376 of yacc.c  */
-#line 78 "expr_arith.y"
+#line 89 "expr_arith.y"
 
     char *  val_str;
     int     val_int;
@@ -181,7 +190,7 @@ typedef union YYSTYPE
 
 
 /* Line 376 of yacc.c  */
-#line 185 "expr_arith.cc"
+#line 194 "expr_arith.cc"
 } YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define yystype YYSTYPE /* obsolescent; will be withdrawn */
@@ -210,7 +219,7 @@ int expr_arith__parse ();
 #endif
 #else /* ! YYPARSE_PARAM */
 #if defined __STDC__ || defined __cplusplus
-int expr_arith__parse (mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg);
+int expr_arith__parse (mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg, yyscan_t    scanner);
 #else
 int expr_arith__parse ();
 #endif
@@ -221,7 +230,7 @@ int expr_arith__parse ();
 /* Copy the second part of user declarations.  */
 
 /* Line 379 of yacc.c  */
-#line 225 "expr_arith.cc"
+#line 234 "expr_arith.cc"
 
 #ifdef short
 # undef short
@@ -654,7 +663,7 @@ do                                                              \
     }                                                           \
   else                                                          \
     {                                                           \
-      yyerror (&yylloc, mc, oxml, result, error_msg, YY_("syntax error: cannot back up")); \
+      yyerror (&yylloc, mc, oxml, result, error_msg, scanner, YY_("syntax error: cannot back up")); \
       YYERROR;							\
     }								\
 while (YYID (0))
@@ -715,7 +724,7 @@ while (YYID (0))
 #ifdef YYLEX_PARAM
 # define YYLEX yylex (&yylval, &yylloc, YYLEX_PARAM)
 #else
-# define YYLEX yylex (&yylval, &yylloc, mc)
+# define YYLEX yylex (&yylval, &yylloc, mc, scanner)
 #endif
 
 /* Enable debugging if requested.  */
@@ -738,7 +747,7 @@ do {									  \
     {									  \
       YYFPRINTF (stderr, "%s ", Title);					  \
       yy_symbol_print (stderr,						  \
-		  Type, Value, Location, mc, oxml, result, error_msg); \
+		  Type, Value, Location, mc, oxml, result, error_msg, scanner); \
       YYFPRINTF (stderr, "\n");						  \
     }									  \
 } while (YYID (0))
@@ -752,10 +761,10 @@ do {									  \
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg)
+yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg, yyscan_t    scanner)
 #else
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
+yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -764,6 +773,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result
     ObjectXML * oxml;
     int&        result;
     char **     error_msg;
+    yyscan_t    scanner;
 #endif
 {
   FILE *yyo = yyoutput;
@@ -775,6 +785,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result
   YYUSE (oxml);
   YYUSE (result);
   YYUSE (error_msg);
+  YYUSE (scanner);
 # ifdef YYPRINT
   if (yytype < YYNTOKENS)
     YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
@@ -796,10 +807,10 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg)
+yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg, yyscan_t    scanner)
 #else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
+yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -808,6 +819,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, erro
     ObjectXML * oxml;
     int&        result;
     char **     error_msg;
+    yyscan_t    scanner;
 #endif
 {
   if (yytype < YYNTOKENS)
@@ -817,7 +829,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, erro
 
   YY_LOCATION_PRINT (yyoutput, *yylocationp);
   YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg);
+  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner);
   YYFPRINTF (yyoutput, ")");
 }
 
@@ -860,10 +872,10 @@ do {								\
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg)
+yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg, yyscan_t    scanner)
 #else
 static void
-yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
+yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg, scanner)
     YYSTYPE *yyvsp;
     YYLTYPE *yylsp;
     int yyrule;
@@ -871,6 +883,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
     ObjectXML * oxml;
     int&        result;
     char **     error_msg;
+    yyscan_t    scanner;
 #endif
 {
   int yynrhs = yyr2[yyrule];
@@ -884,7 +897,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
 		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, oxml, result, error_msg);
+		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, oxml, result, error_msg, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -892,7 +905,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
 # define YY_REDUCE_PRINT(Rule)		\
 do {					\
   if (yydebug)				\
-    yy_reduce_print (yyvsp, yylsp, Rule, mc, oxml, result, error_msg); \
+    yy_reduce_print (yyvsp, yylsp, Rule, mc, oxml, result, error_msg, scanner); \
 } while (YYID (0))
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1169,10 +1182,10 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg)
+yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg, yyscan_t    scanner)
 #else
 static void
-yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
+yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner)
     const char *yymsg;
     int yytype;
     YYSTYPE *yyvaluep;
@@ -1181,6 +1194,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
     ObjectXML * oxml;
     int&        result;
     char **     error_msg;
+    yyscan_t    scanner;
 #endif
 {
   YYUSE (yyvaluep);
@@ -1189,6 +1203,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
   YYUSE (oxml);
   YYUSE (result);
   YYUSE (error_msg);
+  YYUSE (scanner);
 
   if (!yymsg)
     yymsg = "Deleting";
@@ -1223,14 +1238,15 @@ yyparse (YYPARSE_PARAM)
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 int
-yyparse (mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg)
+yyparse (mem_collector * mc, ObjectXML * oxml, int&        result, char **     error_msg, yyscan_t    scanner)
 #else
 int
-yyparse (mc, oxml, result, error_msg)
+yyparse (mc, oxml, result, error_msg, scanner)
     mem_collector * mc;
     ObjectXML * oxml;
     int&        result;
     char **     error_msg;
+    yyscan_t    scanner;
 #endif
 #endif
 {
@@ -1526,19 +1542,19 @@ yyreduce:
     {
         case 2:
 /* Line 1778 of yacc.c  */
-#line 100 "expr_arith.y"
+#line 111 "expr_arith.y"
     { result = static_cast<int>((yyvsp[(1) - (1)].val_float));}
     break;
 
   case 3:
 /* Line 1778 of yacc.c  */
-#line 101 "expr_arith.y"
+#line 112 "expr_arith.y"
     { result = 0; }
     break;
 
   case 4:
 /* Line 1778 of yacc.c  */
-#line 104 "expr_arith.y"
+#line 115 "expr_arith.y"
     { float val = 0.0;
 
                               ostringstream  xpath_t;
@@ -1568,55 +1584,55 @@ yyreduce:
 
   case 5:
 /* Line 1778 of yacc.c  */
-#line 129 "expr_arith.y"
+#line 140 "expr_arith.y"
     { (yyval.val_float) = (yyvsp[(1) - (1)].val_float); }
     break;
 
   case 6:
 /* Line 1778 of yacc.c  */
-#line 130 "expr_arith.y"
+#line 141 "expr_arith.y"
     { (yyval.val_float) = static_cast<float>((yyvsp[(1) - (1)].val_int)); }
     break;
 
   case 7:
 /* Line 1778 of yacc.c  */
-#line 131 "expr_arith.y"
+#line 142 "expr_arith.y"
     { (yyval.val_float) = (yyvsp[(1) - (3)].val_float) + (yyvsp[(3) - (3)].val_float);}
     break;
 
   case 8:
 /* Line 1778 of yacc.c  */
-#line 132 "expr_arith.y"
+#line 143 "expr_arith.y"
     { (yyval.val_float) = (yyvsp[(1) - (3)].val_float) - (yyvsp[(3) - (3)].val_float);}
     break;
 
   case 9:
 /* Line 1778 of yacc.c  */
-#line 133 "expr_arith.y"
+#line 144 "expr_arith.y"
     { (yyval.val_float) = (yyvsp[(1) - (3)].val_float) * (yyvsp[(3) - (3)].val_float);}
     break;
 
   case 10:
 /* Line 1778 of yacc.c  */
-#line 134 "expr_arith.y"
+#line 145 "expr_arith.y"
     { (yyval.val_float) = (yyvsp[(1) - (3)].val_float) / (yyvsp[(3) - (3)].val_float);}
     break;
 
   case 11:
 /* Line 1778 of yacc.c  */
-#line 135 "expr_arith.y"
+#line 146 "expr_arith.y"
     { (yyval.val_float) = - (yyvsp[(2) - (2)].val_float);}
     break;
 
   case 12:
 /* Line 1778 of yacc.c  */
-#line 136 "expr_arith.y"
+#line 147 "expr_arith.y"
     { (yyval.val_float) = (yyvsp[(2) - (3)].val_float);}
     break;
 
 
 /* Line 1778 of yacc.c  */
-#line 1620 "expr_arith.cc"
+#line 1636 "expr_arith.cc"
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1667,7 +1683,7 @@ yyerrlab:
     {
       ++yynerrs;
 #if ! YYERROR_VERBOSE
-      yyerror (&yylloc, mc, oxml, result, error_msg, YY_("syntax error"));
+      yyerror (&yylloc, mc, oxml, result, error_msg, scanner, YY_("syntax error"));
 #else
 # define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
                                         yyssp, yytoken)
@@ -1694,7 +1710,7 @@ yyerrlab:
                 yymsgp = yymsg;
               }
           }
-        yyerror (&yylloc, mc, oxml, result, error_msg, yymsgp);
+        yyerror (&yylloc, mc, oxml, result, error_msg, scanner, yymsgp);
         if (yysyntax_error_status == 2)
           goto yyexhaustedlab;
       }
@@ -1718,7 +1734,7 @@ yyerrlab:
       else
 	{
 	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, &yylloc, mc, oxml, result, error_msg);
+		      yytoken, &yylval, &yylloc, mc, oxml, result, error_msg, scanner);
 	  yychar = YYEMPTY;
 	}
     }
@@ -1775,7 +1791,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, yylsp, mc, oxml, result, error_msg);
+		  yystos[yystate], yyvsp, yylsp, mc, oxml, result, error_msg, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1817,7 +1833,7 @@ yyabortlab:
 | yyexhaustedlab -- memory exhaustion comes here.  |
 `-------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (&yylloc, mc, oxml, result, error_msg, YY_("memory exhausted"));
+  yyerror (&yylloc, mc, oxml, result, error_msg, scanner, YY_("memory exhausted"));
   yyresult = 2;
   /* Fall through.  */
 #endif
@@ -1829,7 +1845,7 @@ yyreturn:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc, mc, oxml, result, error_msg);
+                  yytoken, &yylval, &yylloc, mc, oxml, result, error_msg, scanner);
     }
   /* Do not reclaim the symbols of the rule which action triggered
      this YYABORT or YYACCEPT.  */
@@ -1838,7 +1854,7 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, yylsp, mc, oxml, result, error_msg);
+		  yystos[*yyssp], yyvsp, yylsp, mc, oxml, result, error_msg, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -1855,7 +1871,7 @@ yyreturn:
 
 
 /* Line 2041 of yacc.c  */
-#line 139 "expr_arith.y"
+#line 150 "expr_arith.y"
 
 
 extern "C" void expr_arith__error(
@@ -1864,6 +1880,7 @@ extern "C" void expr_arith__error(
     ObjectXML *     oxml,
     int&            result,
     char **         error_msg,
+    yyscan_t        scanner,
     const char *    str)
 {
     int length;
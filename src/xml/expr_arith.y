@@ -36,29 +36,38 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void expr_arith__error(
         YYLTYPE *       llocp,
         mem_collector * mc,
         ObjectXML *     oxml,
         int&            result,
         char **         error_msg,
+        yyscan_t        scanner,
         const char *    str);
 
-    int expr_arith__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int expr_arith__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                         yyscan_t scanner);
 
     int expr_arith__parse(mem_collector * mc,
                           ObjectXML *     oxml,
                           int&            result,
-                          char **         errmsg);
+                          char **         errmsg,
+                          yyscan_t        scanner);
 
-    int expr_arith_parse(ObjectXML *oxml, int& result, char ** errmsg)
+    int expr_arith_parse(ObjectXML *oxml, int& result, char ** errmsg,
+                         yyscan_t scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = expr_arith__parse(&mc,oxml,result,errmsg);
+        rc = expr_arith__parse(&mc,oxml,result,errmsg,scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -72,8 +81,10 @@ extern "C"
 %parse-param {ObjectXML * oxml}
 %parse-param {int&        result}
 %parse-param {char **     error_msg}
+%parse-param {yyscan_t    scanner}
 
 %lex-param {mem_collector * mc}
+%lex-param {yyscan_t        scanner}
 
 %union {
     char *  val_str;
@@ -144,6 +155,7 @@ extern "C" void expr_arith__error(
     ObjectXML *     oxml,
     int&            result,
     char **         error_msg,
+    yyscan_t        scanner,
     const char *    str)
 {
     int length;
@@ -93,29 +93,38 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void expr_bool__error(
         YYLTYPE *       llocp,
         mem_collector * mc,
         ObjectXML *     oxml,
         bool&           result,
         char **         error_msg,
+        yyscan_t        scanner,
         const char *    str);
 
-    int expr_bool__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int expr_bool__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                        yyscan_t scanner);
 
     int expr_bool__parse(mem_collector * mc,
                          ObjectXML *     oxml,
                          bool&           result,
-                         char **         errmsg);
+                         char **         errmsg,
+                         yyscan_t        scanner);
 
-    int expr_bool_parse(ObjectXML *oxml, bool& result, char ** errmsg)
+    int expr_bool_parse(ObjectXML *oxml, bool& result, char ** errmsg,
+                        yyscan_t scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = expr_bool__parse(&mc,oxml,result,errmsg);
+        rc = expr_bool__parse(&mc,oxml,result,errmsg,scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -131,7 +140,7 @@ void get_xml_attribute(ObjectXML * oxml, const char* attr, string& val);
 
 
 /* Line 360 of yacc.c  */
-#line 135 "expr_bool.cc"
+#line 144 "expr_bool.cc"
 
 # ifndef YY_NULL
 #  if defined __cplusplus && 201103L <= __cplusplus
@@ -178,7 +187,7 @@ extern int expr_bool__debug;
 typedef union YYSTYPE
 {
 /* Line 376 of yacc.c  */
-#line 83 "expr_bool.y"
+#line 94 "expr_bool.y"
 
     char * 	val_str;
     int 	val_int;
@@ -186,7 +195,7 @@ typedef union YYSTYPE
 
 
 /* Line 376 of yacc.c  */
-#line 190 "expr_bool.cc"
+#line 199 "expr_bool.cc"
 } YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define yystype YYSTYPE /* obsolescent; will be withdrawn */
@@ -215,7 +224,7 @@ int expr_bool__parse ();
 #endif
 #else /* ! YYPARSE_PARAM */
 #if defined __STDC__ || defined __cplusplus
-int expr_bool__parse (mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg);
+int expr_bool__parse (mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg, yyscan_t        scanner);
 #else
 int expr_bool__parse ();
 #endif
@@ -226,7 +235,7 @@ int expr_bool__parse ();
 /* Copy the second part of user declarations.  */
 
 /* Line 379 of yacc.c  */
-#line 230 "expr_bool.cc"
+#line 239 "expr_bool.cc"
 
 #ifdef short
 # undef short
@@ -665,7 +674,7 @@ do                                                              \
     }                                                           \
   else                                                          \
     {                                                           \
-      yyerror (&yylloc, mc, oxml, result, error_msg, YY_("syntax error: cannot back up")); \
+      yyerror (&yylloc, mc, oxml, result, error_msg, scanner, YY_("syntax error: cannot back up")); \
       YYERROR;							\
     }								\
 while (YYID (0))
@@ -726,7 +735,7 @@ while (YYID (0))
 #ifdef YYLEX_PARAM
 # define YYLEX yylex (&yylval, &yylloc, YYLEX_PARAM)
 #else
-# define YYLEX yylex (&yylval, &yylloc, mc)
+# define YYLEX yylex (&yylval, &yylloc, mc, scanner)
 #endif
 
 /* Enable debugging if requested.  */
@@ -749,7 +758,7 @@ do {									  \
     {									  \
       YYFPRINTF (stderr, "%s ", Title);					  \
       yy_symbol_print (stderr,						  \
-		  Type, Value, Location, mc, oxml, result, error_msg); \
+		  Type, Value, Location, mc, oxml, result, error_msg, scanner); \
       YYFPRINTF (stderr, "\n");						  \
     }									  \
 } while (YYID (0))
@@ -763,10 +772,10 @@ do {									  \
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg)
+yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
+yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -775,6 +784,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result
     ObjectXML *     oxml;
     bool&           result;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   FILE *yyo = yyoutput;
@@ -786,6 +796,7 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result
   YYUSE (oxml);
   YYUSE (result);
   YYUSE (error_msg);
+  YYUSE (scanner);
 # ifdef YYPRINT
   if (yytype < YYNTOKENS)
     YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
@@ -807,10 +818,10 @@ yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg)
+yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
+yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner)
     FILE *yyoutput;
     int yytype;
     YYSTYPE const * const yyvaluep;
@@ -819,6 +830,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, erro
     ObjectXML *     oxml;
     bool&           result;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   if (yytype < YYNTOKENS)
@@ -828,7 +840,7 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, erro
 
   YY_LOCATION_PRINT (yyoutput, *yylocationp);
   YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg);
+  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner);
   YYFPRINTF (yyoutput, ")");
 }
 
@@ -871,10 +883,10 @@ do {								\
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg)
+yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
+yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg, scanner)
     YYSTYPE *yyvsp;
     YYLTYPE *yylsp;
     int yyrule;
@@ -882,6 +894,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
     ObjectXML *     oxml;
     bool&           result;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   int yynrhs = yyr2[yyrule];
@@ -895,7 +908,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
 		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, oxml, result, error_msg);
+		       , &(yylsp[(yyi + 1) - (yynrhs)])		       , mc, oxml, result, error_msg, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -903,7 +916,7 @@ yy_reduce_print (yyvsp, yylsp, yyrule, mc, oxml, result, error_msg)
 # define YY_REDUCE_PRINT(Rule)		\
 do {					\
   if (yydebug)				\
-    yy_reduce_print (yyvsp, yylsp, Rule, mc, oxml, result, error_msg); \
+    yy_reduce_print (yyvsp, yylsp, Rule, mc, oxml, result, error_msg, scanner); \
 } while (YYID (0))
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1180,10 +1193,10 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg)
+yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg, yyscan_t        scanner)
 #else
 static void
-yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
+yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg, scanner)
     const char *yymsg;
     int yytype;
     YYSTYPE *yyvaluep;
@@ -1192,6 +1205,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
     ObjectXML *     oxml;
     bool&           result;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 {
   YYUSE (yyvaluep);
@@ -1200,6 +1214,7 @@ yydestruct (yymsg, yytype, yyvaluep, yylocationp, mc, oxml, result, error_msg)
   YYUSE (oxml);
   YYUSE (result);
   YYUSE (error_msg);
+  YYUSE (scanner);
 
   if (!yymsg)
     yymsg = "Deleting";
@@ -1234,14 +1249,15 @@ yyparse (YYPARSE_PARAM)
 #if (defined __STDC__ || defined __C99__FUNC__ \
      || defined __cplusplus || defined _MSC_VER)
 int
-yyparse (mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg)
+yyparse (mem_collector * mc, ObjectXML *     oxml, bool&           result, char **         error_msg, yyscan_t        scanner)
 #else
 int
-yyparse (mc, oxml, result, error_msg)
+yyparse (mc, oxml, result, error_msg, scanner)
     mem_collector * mc;
     ObjectXML *     oxml;
     bool&           result;
     char **         error_msg;
+    yyscan_t        scanner;
 #endif
 #endif
 {
@@ -1537,19 +1553,19 @@ yyreduce:
     {
         case 2:
 /* Line 1778 of yacc.c  */
-#line 103 "expr_bool.y"
+#line 114 "expr_bool.y"
     { result=(yyvsp[(1) - (1)].val_int);   }
     break;
 
   case 3:
 /* Line 1778 of yacc.c  */
-#line 104 "expr_bool.y"
+#line 115 "expr_bool.y"
     { result=true; }
     break;
 
   case 4:
 /* Line 1778 of yacc.c  */
-#line 107 "expr_bool.y"
+#line 118 "expr_bool.y"
     { int val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (3)].val_str),val);
@@ -1558,7 +1574,7 @@ yyreduce:
 
   case 5:
 /* Line 1778 of yacc.c  */
-#line 112 "expr_bool.y"
+#line 123 "expr_bool.y"
     { int val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (4)].val_str),val);
@@ -1567,7 +1583,7 @@ yyreduce:
 
   case 6:
 /* Line 1778 of yacc.c  */
-#line 117 "expr_bool.y"
+#line 128 "expr_bool.y"
     { int val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (3)].val_str),val);
@@ -1576,7 +1592,7 @@ yyreduce:
 
   case 7:
 /* Line 1778 of yacc.c  */
-#line 122 "expr_bool.y"
+#line 133 "expr_bool.y"
     { int val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (3)].val_str),val);
@@ -1585,7 +1601,7 @@ yyreduce:
 
   case 8:
 /* Line 1778 of yacc.c  */
-#line 127 "expr_bool.y"
+#line 138 "expr_bool.y"
     { float val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (3)].val_str),val);
@@ -1594,7 +1610,7 @@ yyreduce:
 
   case 9:
 /* Line 1778 of yacc.c  */
-#line 132 "expr_bool.y"
+#line 143 "expr_bool.y"
     { float val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (4)].val_str),val);
@@ -1603,7 +1619,7 @@ yyreduce:
 
   case 10:
 /* Line 1778 of yacc.c  */
-#line 137 "expr_bool.y"
+#line 148 "expr_bool.y"
     { float val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (3)].val_str),val);
@@ -1612,7 +1628,7 @@ yyreduce:
 
   case 11:
 /* Line 1778 of yacc.c  */
-#line 142 "expr_bool.y"
+#line 153 "expr_bool.y"
     { float val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (3)].val_str),val);
@@ -1621,7 +1637,7 @@ yyreduce:
 
   case 12:
 /* Line 1778 of yacc.c  */
-#line 147 "expr_bool.y"
+#line 158 "expr_bool.y"
     { string val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (3)].val_str),val);
@@ -1630,7 +1646,7 @@ yyreduce:
 
   case 13:
 /* Line 1778 of yacc.c  */
-#line 152 "expr_bool.y"
+#line 163 "expr_bool.y"
     { string val;
 
             get_xml_attribute(oxml,(yyvsp[(1) - (4)].val_str),val);
@@ -1639,31 +1655,31 @@ yyreduce:
 
   case 14:
 /* Line 1778 of yacc.c  */
-#line 157 "expr_bool.y"
+#line 168 "expr_bool.y"
     { (yyval.val_int) = (yyvsp[(1) - (3)].val_int) && (yyvsp[(3) - (3)].val_int); }
     break;
 
   case 15:
 /* Line 1778 of yacc.c  */
-#line 158 "expr_bool.y"
+#line 169 "expr_bool.y"
     { (yyval.val_int) = (yyvsp[(1) - (3)].val_int) || (yyvsp[(3) - (3)].val_int); }
     break;
 
   case 16:
 /* Line 1778 of yacc.c  */
-#line 159 "expr_bool.y"
+#line 170 "expr_bool.y"
     { (yyval.val_int) = ! (yyvsp[(2) - (2)].val_int); }
     break;
 
   case 17:
 /* Line 1778 of yacc.c  */
-#line 160 "expr_bool.y"
+#line 171 "expr_bool.y"
     { (yyval.val_int) =   (yyvsp[(2) - (3)].val_int); }
     break;
 
 
 /* Line 1778 of yacc.c  */
-#line 1667 "expr_bool.cc"
+#line 1683 "expr_bool.cc"
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1714,7 +1730,7 @@ yyerrlab:
     {
       ++yynerrs;
 #if ! YYERROR_VERBOSE
-      yyerror (&yylloc, mc, oxml, result, error_msg, YY_("syntax error"));
+      yyerror (&yylloc, mc, oxml, result, error_msg, scanner, YY_("syntax error"));
 #else
 # define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
                                         yyssp, yytoken)
@@ -1741,7 +1757,7 @@ yyerrlab:
                 yymsgp = yymsg;
               }
           }
-        yyerror (&yylloc, mc, oxml, result, error_msg, yymsgp);
+        yyerror (&yylloc, mc, oxml, result, error_msg, scanner, yymsgp);
         if (yysyntax_error_status == 2)
           goto yyexhaustedlab;
       }
@@ -1765,7 +1781,7 @@ yyerrlab:
       else
 	{
 	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, &yylloc, mc, oxml, result, error_msg);
+		      yytoken, &yylval, &yylloc, mc, oxml, result, error_msg, scanner);
 	  yychar = YYEMPTY;
 	}
     }
@@ -1822,7 +1838,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, yylsp, mc, oxml, result, error_msg);
+		  yystos[yystate], yyvsp, yylsp, mc, oxml, result, error_msg, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1864,7 +1880,7 @@ yyabortlab:
 | yyexhaustedlab -- memory exhaustion comes here.  |
 `-------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (&yylloc, mc, oxml, result, error_msg, YY_("memory exhausted"));
+  yyerror (&yylloc, mc, oxml, result, error_msg, scanner, YY_("memory exhausted"));
   yyresult = 2;
   /* Fall through.  */
 #endif
@@ -1876,7 +1892,7 @@ yyreturn:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc, mc, oxml, result, error_msg);
+                  yytoken, &yylval, &yylloc, mc, oxml, result, error_msg, scanner);
     }
   /* Do not reclaim the symbols of the rule which action triggered
      this YYABORT or YYACCEPT.  */
@@ -1885,7 +1901,7 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, yylsp, mc, oxml, result, error_msg);
+		  yystos[*yyssp], yyvsp, yylsp, mc, oxml, result, error_msg, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -1902,7 +1918,7 @@ yyreturn:
 
 
 /* Line 2041 of yacc.c  */
-#line 163 "expr_bool.y"
+#line 174 "expr_bool.y"
 
 
 extern "C" void expr_bool__error(
@@ -1911,6 +1927,7 @@ extern "C" void expr_bool__error(
     ObjectXML *     oxml,
     bool&           result,
     char **         error_msg,
+    yyscan_t        scanner,
     const char *    str)
 {
     int length;
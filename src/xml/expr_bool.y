@@ -35,29 +35,38 @@ extern "C"
 {
     #include "mem_collector.h"
 
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void * yyscan_t;
+    #endif
+
     void expr_bool__error(
         YYLTYPE *       llocp,
         mem_collector * mc,
         ObjectXML *     oxml,
         bool&           result,
         char **         error_msg,
+        yyscan_t        scanner,
         const char *    str);
 
-    int expr_bool__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc);
+    int expr_bool__lex (YYSTYPE *lvalp, YYLTYPE *llocp, mem_collector * mc,
+                        yyscan_t scanner);
 
     int expr_bool__parse(mem_collector * mc,
                          ObjectXML *     oxml,
                          bool&           result,
-                         char **         errmsg);
+                         char **         errmsg,
+                         yyscan_t        scanner);
 
-    int expr_bool_parse(ObjectXML *oxml, bool& result, char ** errmsg)
+    int expr_bool_parse(ObjectXML *oxml, bool& result, char ** errmsg,
+                        yyscan_t scanner)
     {
         mem_collector mc;
         int           rc;
 
         mem_collector_init(&mc);
 
-        rc = expr_bool__parse(&mc,oxml,result,errmsg);
+        rc = expr_bool__parse(&mc,oxml,result,errmsg,scanner);
 
         mem_collector_cleanup(&mc);
 
@@ -77,8 +86,10 @@ void get_xml_attribute(ObjectXML * oxml, const char* attr, string& val);
 %parse-param {ObjectXML *     oxml}
 %parse-param {bool&           result}
 %parse-param {char **         error_msg}
+%parse-param {yyscan_t        scanner}
 
 %lex-param {mem_collector * mc}
+%lex-param {yyscan_t        scanner}
 
 %union {
     char * 	val_str;
@@ -168,6 +179,7 @@ extern "C" void expr_bool__error(
     ObjectXML *     oxml,
     bool&           result,
     char **         error_msg,
+    yyscan_t        scanner,
     const char *    str)
 {
     int length;
@@ -18,10 +18,76 @@
 #include <iostream>
 #include <stdlib.h>
 #include <stdexcept>
+#include <sstream>
 
 #include "ObjectXML.h"
 #include "test/OneUnitTest.h"
 
+struct EvalArgs
+{
+    ObjectXML *    obj;
+    const string * hostname;
+    int            vms;
+    int            errors;
+};
+
+static void * eval_thread(void *arg)
+{
+    EvalArgs * args = static_cast<EvalArgs *>(arg);
+
+    ostringstream oss;
+
+    string  reqs_vms;
+    string  reqs_name;
+    string  rank;
+
+    oss << "RUNNING_VMS = " << args->vms;
+    reqs_vms = oss.str();
+
+    oss.str("");
+    oss << "HOSTNAME = \"" << *(args->hostname) << "\"";
+    reqs_name = oss.str();
+
+    oss.str("");
+    oss << "RUNNING_VMS * 10 + " << args->vms;
+    rank = oss.str();
+
+    for (int i = 0 ; i < 500 ; i++)
+    {
+        char * err = 0;
+        bool   res;
+        int    value;
+
+        if ( args->obj->eval_bool(reqs_vms, res, &err) != 0 || res != true )
+        {
+            args->errors++;
+        }
+
+        if ( args->obj->eval_bool(reqs_name, res, &err) != 0 || res != true )
+        {
+            args->errors++;
+        }
+
+        if ( args->obj->eval_arith(rank, value, &err) != 0 ||
+             value != args->vms * 11 )
+        {
+            args->errors++;
+        }
+
+        if ( args->obj->eval_bool("RUNNING_VMS ^ * - = abc", res, &err) == 0 )
+        {
+            args->errors++;
+        }
+
+        if ( err != 0 )
+        {
+            free(err);
+        }
+    }
+
+    return 0;
+}
+
 /* ************************************************************************* */
 /* ************************************************************************* */
 
@@ -36,6 +102,7 @@ class ObjectXMLTest : public OneUnitTest
     CPPUNIT_TEST( rank );
     CPPUNIT_TEST( xpath );
     CPPUNIT_TEST( xpath_value );
+    CPPUNIT_TEST( eval_threads );
 
     CPPUNIT_TEST_SUITE_END ();
 
@@ -369,6 +436,55 @@ public:
         }
     };
 
+    // Expressions are evaluated from several threads, each one on its own
+    // host, the results of every thread are checked
+    void eval_threads()
+    {
+        const int num_threads = 8;
+
+        pthread_t   threads[num_threads];
+        EvalArgs    args[num_threads];
+        string      hostnames[num_threads];
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            ostringstream oss;
+            string        xml = host;
+
+            oss << "ursa" << i;
+
+            hostnames[i] = oss.str();
+
+            oss.str("");
+            oss << "<RUNNING_VMS>" << i * 3 << "</RUNNING_VMS>";
+
+            xml.replace(xml.find("<RUNNING_VMS>12</RUNNING_VMS>"),
+                        29, oss.str());
+
+            xml.replace(xml.find("<HOSTNAME>ursa12</HOSTNAME>"),
+                        27, "<HOSTNAME>" + hostnames[i] + "</HOSTNAME>");
+
+            args[i].obj      = new ObjectXML(xml);
+            args[i].hostname = &hostnames[i];
+            args[i].vms      = i * 3;
+            args[i].errors   = 0;
+        }
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_create(&threads[i], 0, eval_thread, &args[i]);
+        }
+
+        for (int i = 0 ; i < num_threads ; i++)
+        {
+            pthread_join(threads[i], 0);
+
+            CPPUNIT_ASSERT(args[i].errors == 0);
+
+            delete args[i].obj;
+        }
+    };
+
     static const string xml_history_dump;
     static const string xml_history_dump2;
     static const string host;